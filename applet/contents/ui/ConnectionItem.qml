@@ -38,6 +38,8 @@ ListItem {
     property bool passwordIsStatic: (SecurityType == PlasmaNM.Enums.StaticWep || SecurityType == PlasmaNM.Enums.WpaPsk ||
                                      SecurityType == PlasmaNM.Enums.Wpa2Psk || SecurityType == PlasmaNM.Enums.SAE)
     property bool predictableWirelessPassword: !Uuid && Type == PlasmaNM.Enums.Wireless && passwordIsStatic
+    // Network restored from the scan cache, its access point is only known after a scan
+    property bool staleAccessPoint: Stale && !Uuid
     property bool showSpeed: plasmoid.expanded &&
                              ConnectionState == PlasmaNM.Enums.Activated &&
                              (Type == PlasmaNM.Enums.Wired ||
@@ -155,6 +157,7 @@ ListItem {
                     opacity: connectionView.currentVisibleButtonIndex == index ? 1 : 0
                     visible: opacity != 0
                     text: (ConnectionState == PlasmaNM.Enums.Deactivated) ? i18n("Connect") : i18n("Disconnect")
+                    enabled: !staleAccessPoint
 
                     Behavior on opacity { NumberAnimation { duration: units.shortDuration } }
 
@@ -198,6 +201,7 @@ ListItem {
         PlasmaComponents.MenuItem {
             text: stateChangeButton.text
             icon: (ConnectionState == PlasmaNM.Enums.Deactivated) ? "network-connect" : "network-disconnect"
+            enabled: !staleAccessPoint
             onClicked: changeState()
         }
         PlasmaComponents.MenuItem {
@@ -359,6 +363,9 @@ ListItem {
 
     function changeState() {
         visibleDetails = false
+        if (staleAccessPoint) {
+            return
+        }
         if (Uuid || !predictableWirelessPassword || visiblePasswordDialog) {
             if (ConnectionState == PlasmaNM.Enums.Deactivated) {
                 if (!predictableWirelessPassword && !Uuid) {
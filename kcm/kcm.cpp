@@ -23,7 +23,9 @@
 #include "debug.h"
 #include "connectioneditordialog.h"
 #include "mobileconnectionwizard.h"
+#include "networkmanagerloader.h"
 #include "uiutils.h"
+#include "vpnexportarchive.h"
 #include "vpnuiplugin.h"
 #include "settings/wireguardinterfacewidget.h"
 
@@ -51,6 +53,9 @@
 
 // Qt
 #include <QFileDialog>
+#include <QHash>
+#include <QPair>
+#include <QVector>
 #include <QMenu>
 #include <QVBoxLayout>
 #include <QTimer>
@@ -124,6 +129,7 @@ KCMNetworkmanagement::KCMNetworkmanagement(QWidget *parent, const QVariantList &
     connect(rootItem, SIGNAL(selectedConnectionChanged(QString)), this, SLOT(onSelectedConnectionChanged(QString)));
     connect(rootItem, SIGNAL(requestCreateConnection(int,QString,QString,bool)), this, SLOT(onRequestCreateConnection(int,QString,QString,bool)));
     connect(rootItem, SIGNAL(requestExportConnection(QString)), this, SLOT(onRequestExportConnection(QString)));
+    connect(rootItem, SIGNAL(requestExportAllConnections()), this, SLOT(onRequestExportAllConnections()));
     connect(rootItem, SIGNAL(requestToChangeConnection(QString,QString)), this, SLOT(onRequestToChangeConnection(QString,QString)));
 
     QVBoxLayout *l = new QVBoxLayout(this);
@@ -158,16 +164,32 @@ KCMNetworkmanagement::KCMNetworkmanagement(QWidget *parent, const QVariantList &
 
     // Select the very first connection as a fallback
     if (!selectedConnection || !selectedConnection->isValid()) {
-        NetworkManager::Connection::List connectionList = NetworkManager::listConnections();
-        std::sort(connectionList.begin(), connectionList.end(), [] (const NetworkManager::Connection::Ptr &left, const NetworkManager::Connection::Ptr &right)
+        // Settings of all connections, from the startup snapshot unless it couldn't be loaded
+        typedef QPair<QString, NetworkManager::ConnectionSettings::Ptr> ConnectionEntry;
+        QVector<ConnectionEntry> connectionList;
+        NetworkManagerLoader *loader = NetworkManagerLoader::self();
+        if (loader->isLoaded()) {
+            for (const QString &path : loader->objects(QStringLiteral(NM_DBUS_INTERFACE_SETTINGS_CONNECTION))) {
+                const NMVariantMapMap settings = loader->settings(path);
+                if (!settings.isEmpty()) {
+                    connectionList << qMakePair(path, NetworkManager::ConnectionSettings::Ptr(new NetworkManager::ConnectionSettings(settings)));
+                }
+            }
+        } else {
+            for (const NetworkManager::Connection::Ptr &connection : NetworkManager::listConnections()) {
+                connectionList << qMakePair(connection->path(), connection->settings());
+            }
+        }
+
+        std::sort(connectionList.begin(), connectionList.end(), [] (const ConnectionEntry &left, const ConnectionEntry &right)
         {
-            const QString leftName = left->settings()->id();
-            const UiUtils::SortedConnectionType leftType = UiUtils::connectionTypeToSortedType(left->settings()->connectionType());
-            const QDateTime leftDate = left->settings()->timestamp();
+            const QString leftName = left.second->id();
+            const UiUtils::SortedConnectionType leftType = UiUtils::connectionTypeToSortedType(left.second->connectionType());
+            const QDateTime leftDate = left.second->timestamp();
 
-            const QString rightName = right->settings()->id();
-            const UiUtils::SortedConnectionType rightType = UiUtils::connectionTypeToSortedType(right->settings()->connectionType());
-            const QDateTime rightDate = right->settings()->timestamp();
+            const QString rightName = right.second->id();
+            const UiUtils::SortedConnectionType rightType = UiUtils::connectionTypeToSortedType(right.second->connectionType());
+            const QDateTime rightDate = right.second->timestamp();
 
             if (leftType < rightType) {
                 return true;
@@ -188,11 +210,10 @@ KCMNetworkmanagement::KCMNetworkmanagement(QWidget *parent, const QVariantList &
             }
         });
 
-        for (const NetworkManager::Connection::Ptr &connection : connectionList) {
-            const NetworkManager::ConnectionSettings::ConnectionType type = connection->settings()->connectionType();
-            if (UiUtils::isConnectionTypeSupported(type)) {
-                selectedConnection = connection;
-                qDebug() << "Selecting first connection:" << connection->uuid();
+        for (const ConnectionEntry &connection : connectionList) {
+            if (UiUtils::isConnectionTypeSupported(connection.second->connectionType())) {
+                selectedConnection = NetworkManager::findConnection(connection.first);
+                qDebug() << "Selecting first connection:" << connection.second->uuid();
                 break;
             }
         }
@@ -436,6 +457,64 @@ void KCMNetworkmanagement::onRequestExportConnection(const QString &connectionPa
     }
 }
 
+void KCMNetworkmanagement::onRequestExportAllConnections()
+{
+    const QString url = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + QDir::separator() + QStringLiteral("vpn-connections.tar.gz");
+    const QString filename = QFileDialog::getSaveFileName(this, i18n("Export All VPN Connections"), url, i18n("Archives (*.tar.gz *.zip)"));
+    if (filename.isEmpty()) {
+        return;
+    }
+
+    VpnExportArchive archive(filename);
+    if (!archive.open()) {
+        KMessageBox::error(this, i18n("Failed to create %1: %2", filename, archive.errorString()));
+        return;
+    }
+
+    // One plugin instance per VPN type, creating them is expensive
+    QHash<QString, VpnUiPlugin*> plugins;
+    int failed = 0;
+    for (const NetworkManager::Connection::Ptr &connection : NetworkManager::listConnections()) {
+        NetworkManager::ConnectionSettings::Ptr connSettings = connection->settings();
+        if (connSettings->connectionType() != NetworkManager::ConnectionSettings::Vpn) {
+            continue;
+        }
+
+        NetworkManager::VpnSetting::Ptr vpnSetting = connSettings->setting(NetworkManager::Setting::Vpn).dynamicCast<NetworkManager::VpnSetting>();
+        const QString serviceType = vpnSetting->serviceType();
+
+        if (!plugins.contains(serviceType)) {
+            QString error;
+            VpnUiPlugin *vpnPlugin = KServiceTypeTrader::createInstanceFromQuery<VpnUiPlugin>(QStringLiteral("PlasmaNetworkManagement/VpnUiPlugin"),
+                                                                                              QStringLiteral("[X-NetworkManager-Services]=='%1'").arg(serviceType),
+                                                                                              this, QVariantList(), &error);
+            if (!vpnPlugin) {
+                qCWarning(PLASMA_NM) << "Error getting VpnUiPlugin for export:" << error;
+            }
+            plugins.insert(serviceType, vpnPlugin);
+        }
+
+        VpnUiPlugin *vpnPlugin = plugins.value(serviceType);
+        if (!vpnPlugin || vpnPlugin->suggestedFileName(connSettings).isEmpty()) {
+            continue;
+        }
+
+        qCDebug(PLASMA_NM) << "Exporting VPN connection" << connection->name() << "type:" << serviceType;
+
+        if (!vpnPlugin->exportConnectionSettingsToArchive(connSettings, &archive)) {
+            qCWarning(PLASMA_NM) << "Failed to export VPN connection" << connection->name() << vpnPlugin->lastErrorMessage();
+            ++failed;
+        }
+    }
+    qDeleteAll(plugins);
+
+    if (!archive.close()) {
+        KMessageBox::error(this, i18n("Failed to write %1: %2", filename, archive.errorString()));
+    } else if (failed) {
+        KMessageBox::sorry(this, i18np("One VPN connection could not be exported.", "%1 VPN connections could not be exported.", failed));
+    }
+}
+
 void KCMNetworkmanagement::onRequestToChangeConnection( const QString &connectionName, const QString &connectionPath)
 {
     NetworkManager::Connection::Ptr connection = NetworkManager::findConnection(m_currentConnectionPath);
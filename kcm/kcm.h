@@ -46,6 +46,7 @@ private Q_SLOTS:
     void onSelectedConnectionChanged(const QString &connectionPath);
     void onRequestCreateConnection(int connectionType, const QString &vpnType, const QString &specificType, bool shared);
     void onRequestExportConnection(const QString &connectionPath);
+    void onRequestExportAllConnections();
     void onRequestToChangeConnection(const QString &connectionName, const QString &connectionPath);
 
 private:
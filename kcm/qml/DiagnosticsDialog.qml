@@ -0,0 +1,155 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+import QtQuick 2.5
+import QtQuick.Dialogs 1.2
+import QtQuick.Controls 2.5 as QQC2
+import org.kde.kirigami 2.5 as Kirigami
+
+Dialog {
+    id: diagnosticsDialog
+    title: i18nc("@title:window", "Diagnostics")
+
+    property var metrics: []
+
+    Connections {
+        target: handler
+        onActivationMetricsReceived: diagnosticsDialog.metrics = metrics
+    }
+
+    contentItem: Item {
+        implicitHeight: 300
+        implicitWidth: 500
+
+        Rectangle {
+            id: background
+            anchors.fill: parent
+            focus: true
+            color: baseColor
+        }
+
+        Kirigami.Heading {
+            id: activationLabel
+            anchors {
+                left: parent.left
+                right: parent.right
+                top: parent.top
+                margins: units.smallSpacing
+            }
+            level: 2
+            text: i18n("Activation times")
+        }
+
+        QQC2.ScrollView {
+            anchors {
+                bottom: buttonRow.top
+                left: parent.left
+                right: parent.right
+                top: activationLabel.bottom
+                margins: units.smallSpacing
+            }
+
+            ListView {
+                id: metricsView
+                clip: true
+                model: diagnosticsDialog.metrics
+
+                delegate: Kirigami.FormLayout {
+                    id: typeLayout
+                    // The phases below have their own modelData
+                    property var typeMetrics: modelData
+                    width: metricsView.width
+
+                    Kirigami.Heading {
+                        Kirigami.FormData.isSection: true
+                        level: 3
+                        text: modelData["title"]
+                    }
+
+                    QQC2.Label {
+                        Kirigami.FormData.label: i18n("Activations:")
+                        text: i18n("%1 succeeded, %2 failed", modelData["activation.count"] || 0, modelData["failed"] || 0)
+                    }
+
+                    Repeater {
+                        model: [
+                            { phase: "activation", label: i18n("Total:") },
+                            { phase: "prepare", label: i18n("Preparing:") },
+                            { phase: "config", label: i18n("Configuring:") },
+                            { phase: "needAuth", label: i18n("Waiting for authentication:") },
+                            { phase: "secrets", label: i18n("Providing secrets:") },
+                            { phase: "ipConfig", label: i18n("Configuring IP:") }
+                        ]
+
+                        QQC2.Label {
+                            visible: (modelData.phase + ".count") in typeLayout.typeMetrics
+                            Kirigami.FormData.label: modelData.label
+                            text: visible ? i18n("median %1 ms, 90% %2 ms, 99% %3 ms, max %4 ms",
+                                                 typeLayout.typeMetrics[modelData.phase + ".p50"],
+                                                 typeLayout.typeMetrics[modelData.phase + ".p90"],
+                                                 typeLayout.typeMetrics[modelData.phase + ".p99"],
+                                                 typeLayout.typeMetrics[modelData.phase + ".max"]) : ""
+                        }
+                    }
+                }
+            }
+        }
+
+        QQC2.Label {
+            anchors.centerIn: parent
+            visible: !diagnosticsDialog.metrics.length
+            text: i18n("No connection was activated yet")
+        }
+
+        Row {
+            id: buttonRow
+            anchors {
+                bottom: parent.bottom
+                right: parent.right
+                margins: units.smallSpacing
+            }
+            spacing: units.smallSpacing
+
+            QQC2.Button {
+                id: refreshButton
+                text: i18n("Refresh")
+
+                onClicked: {
+                    handler.requestActivationMetrics()
+                }
+            }
+
+            QQC2.Button {
+                id: closeButton
+                text: i18n("Close")
+
+                onClicked: {
+                    diagnosticsDialog.close()
+                }
+            }
+        }
+    }
+
+    onVisibleChanged: {
+        if (visible) {
+            handler.requestActivationMetrics()
+        }
+    }
+}
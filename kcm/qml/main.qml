@@ -34,6 +34,7 @@ Item {
     signal selectedConnectionChanged(string connection)
     signal requestCreateConnection(int type, string vpnType, string specificType, bool shared)
     signal requestExportConnection(string connection)
+    signal requestExportAllConnections()
     signal requestToChangeConnection(string name, string path)
 
     Kirigami.Theme.colorSet: Kirigami.Theme.Window
@@ -188,6 +189,19 @@ Item {
                 root.requestExportConnection(connectionView.currentConnectionPath)
             }
         }
+
+        QQC2.ToolButton {
+            id: exportAllConnectionsButton
+
+            icon.name: "archive-insert"
+
+            QQC2.ToolTip.text: i18n("Export all VPN connections")
+            QQC2.ToolTip.visible: hovered
+
+            onClicked: {
+                root.requestExportAllConnections()
+            }
+        }
     }
 
     Row {
@@ -212,6 +226,19 @@ Item {
                 configurationDialog.open()
             }
         }
+
+        QQC2.ToolButton {
+            id: diagnosticsButton
+
+            icon.name: "view-statistics"
+
+            QQC2.ToolTip.text: i18n("Diagnostics")
+            QQC2.ToolTip.visible: hovered
+
+            onClicked: {
+                diagnosticsDialog.open()
+            }
+        }
     }
 
     MessageDialog {
@@ -246,6 +273,10 @@ Item {
         id: configurationDialog
     }
 
+    DiagnosticsDialog {
+        id: diagnosticsDialog
+    }
+
     function deselectConnections() {
         connectionView.currentConnectionPath = ""
     }
@@ -0,0 +1,255 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "debug.h"
+#include "activationmetrics.h"
+
+#include <NetworkManagerQt/Connection>
+#include <NetworkManagerQt/Manager>
+
+ActivationMetrics::ActivationMetrics(QObject *parent)
+    : QObject(parent)
+{
+    for (const NetworkManager::ActiveConnection::Ptr &ac : NetworkManager::activeConnections()) {
+        addActiveConnection(ac);
+    }
+
+    connect(NetworkManager::notifier(), &NetworkManager::Notifier::activeConnectionAdded, this, &ActivationMetrics::activeConnectionAdded);
+}
+
+ActivationMetrics::~ActivationMetrics() = default;
+
+NMVariantMapMap ActivationMetrics::metrics() const
+{
+    NMVariantMapMap result;
+
+    for (auto type = m_histograms.constBegin(); type != m_histograms.constEnd(); ++type) {
+        QVariantMap map;
+        for (auto phase = type->constBegin(); phase != type->constEnd(); ++phase) {
+            const LatencyHistogram &histogram = phase.value();
+            map.insert(phase.key() + QLatin1String(".p50"), histogram.percentile(50));
+            map.insert(phase.key() + QLatin1String(".p90"), histogram.percentile(90));
+            map.insert(phase.key() + QLatin1String(".p99"), histogram.percentile(99));
+            map.insert(phase.key() + QLatin1String(".max"), histogram.max());
+            map.insert(phase.key() + QLatin1String(".mean"), histogram.mean());
+            map.insert(phase.key() + QLatin1String(".count"), histogram.count());
+        }
+        result.insert(type.key(), map);
+    }
+
+    for (auto it = m_failed.constBegin(); it != m_failed.constEnd(); ++it) {
+        result[it.key()].insert(QStringLiteral("failed"), it.value());
+    }
+
+    return result;
+}
+
+void ActivationMetrics::reset()
+{
+    m_histograms.clear();
+    m_failed.clear();
+}
+
+void ActivationMetrics::addSecretsWait(const QString &connectionPath, qint64 msecs)
+{
+    for (Activation &activation : m_activations) {
+        if (activation.connectionPath == connectionPath) {
+            activation.phases[QStringLiteral("secrets")] += msecs;
+            activation.transitions << QStringLiteral("%1 ms: secrets after %2 ms").arg(activation.clock.elapsed()).arg(msecs);
+            return;
+        }
+    }
+}
+
+void ActivationMetrics::activeConnectionAdded(const QString &path)
+{
+    NetworkManager::ActiveConnection::Ptr ac = NetworkManager::findActiveConnection(path);
+    if (ac && ac->isValid()) {
+        addActiveConnection(ac);
+    }
+}
+
+void ActivationMetrics::addActiveConnection(const NetworkManager::ActiveConnection::Ptr &ac)
+{
+    // Only activations seen from their start tell how long they took
+    if (ac->state() != NetworkManager::ActiveConnection::Unknown &&
+        ac->state() != NetworkManager::ActiveConnection::Activating) {
+        return;
+    }
+
+    Activation activation;
+    activation.type = NetworkManager::ConnectionSettings::typeAsString(ac->type());
+    if (ac->connection()) {
+        activation.connectionPath = ac->connection()->path();
+    }
+    activation.clock.start();
+
+    if (ac->vpn()) {
+        NetworkManager::VpnConnection::Ptr vpnConnection = ac.objectCast<NetworkManager::VpnConnection>();
+        connect(vpnConnection.data(), &NetworkManager::VpnConnection::stateChanged, this, &ActivationMetrics::vpnConnectionStateChanged);
+    } else {
+        connect(ac.data(), &NetworkManager::ActiveConnection::stateChanged, this, &ActivationMetrics::activeConnectionStateChanged);
+        if (!ac->devices().isEmpty()) {
+            NetworkManager::Device::Ptr device = NetworkManager::findNetworkInterface(ac->devices().first());
+            if (device) {
+                activation.devicePath = device->uni();
+                // Devices outlive activations, one connection serves all of them
+                connect(device.data(), &NetworkManager::Device::stateChanged, this, &ActivationMetrics::deviceStateChanged, Qt::UniqueConnection);
+            }
+        }
+    }
+
+    m_activations.insert(ac->path(), activation);
+}
+
+void ActivationMetrics::activeConnectionStateChanged(NetworkManager::ActiveConnection::State state)
+{
+    NetworkManager::ActiveConnection *ac = qobject_cast<NetworkManager::ActiveConnection*>(sender());
+    if (!ac) {
+        return;
+    }
+
+    if (state == NetworkManager::ActiveConnection::Activated) {
+        finish(ac->path(), true);
+    } else if (state == NetworkManager::ActiveConnection::Deactivating ||
+               state == NetworkManager::ActiveConnection::Deactivated) {
+        finish(ac->path(), false);
+    }
+}
+
+void ActivationMetrics::vpnConnectionStateChanged(NetworkManager::VpnConnection::State state, NetworkManager::VpnConnection::StateChangeReason reason)
+{
+    Q_UNUSED(reason);
+
+    NetworkManager::VpnConnection *vpn = qobject_cast<NetworkManager::VpnConnection*>(sender());
+    if (!vpn) {
+        return;
+    }
+
+    const QString description = QStringLiteral("vpn state %1").arg(state);
+    switch (state) {
+    case NetworkManager::VpnConnection::Prepare:
+        transition(vpn->path(), QStringLiteral("prepare"), description);
+        break;
+    case NetworkManager::VpnConnection::NeedAuth:
+        transition(vpn->path(), QStringLiteral("needAuth"), description);
+        break;
+    case NetworkManager::VpnConnection::Connecting:
+        transition(vpn->path(), QStringLiteral("config"), description);
+        break;
+    case NetworkManager::VpnConnection::GettingIpConfig:
+        transition(vpn->path(), QStringLiteral("ipConfig"), description);
+        break;
+    case NetworkManager::VpnConnection::Activated:
+        finish(vpn->path(), true);
+        break;
+    case NetworkManager::VpnConnection::Failed:
+    case NetworkManager::VpnConnection::Disconnected:
+        finish(vpn->path(), false);
+        break;
+    default:
+        transition(vpn->path(), QString(), description);
+        break;
+    }
+}
+
+void ActivationMetrics::deviceStateChanged(NetworkManager::Device::State newstate, NetworkManager::Device::State oldstate, NetworkManager::Device::StateChangeReason reason)
+{
+    Q_UNUSED(oldstate);
+
+    NetworkManager::Device *device = qobject_cast<NetworkManager::Device*>(sender());
+    if (!device) {
+        return;
+    }
+
+    QString path;
+    for (auto it = m_activations.constBegin(); it != m_activations.constEnd(); ++it) {
+        if (it->devicePath == device->uni()) {
+            path = it.key();
+            break;
+        }
+    }
+    if (path.isEmpty()) {
+        return;
+    }
+
+    const QString description = QStringLiteral("device state %1, reason %2").arg(newstate).arg(reason);
+    switch (newstate) {
+    case NetworkManager::Device::Preparing:
+        transition(path, QStringLiteral("prepare"), description);
+        break;
+    case NetworkManager::Device::ConfiguringHardware:
+        transition(path, QStringLiteral("config"), description);
+        break;
+    case NetworkManager::Device::NeedAuth:
+        transition(path, QStringLiteral("needAuth"), description);
+        break;
+    case NetworkManager::Device::ConfiguringIp:
+    case NetworkManager::Device::CheckingIp:
+        transition(path, QStringLiteral("ipConfig"), description);
+        break;
+    default:
+        // The end of the activation is told by the active connection
+        transition(path, QString(), description);
+        break;
+    }
+}
+
+void ActivationMetrics::transition(const QString &path, const QString &phase, const QString &description)
+{
+    auto it = m_activations.find(path);
+    if (it == m_activations.end()) {
+        return;
+    }
+
+    const qint64 now = it->clock.elapsed();
+    if (!it->phase.isEmpty()) {
+        it->phases[it->phase] += now - it->phaseStart;
+    }
+    it->phase = phase;
+    it->phaseStart = now;
+    it->transitions << QStringLiteral("%1 ms: %2").arg(now).arg(description);
+}
+
+void ActivationMetrics::finish(const QString &path, bool activated)
+{
+    auto it = m_activations.find(path);
+    if (it == m_activations.end()) {
+        return;
+    }
+
+    transition(path, QString(), activated ? QStringLiteral("activated") : QStringLiteral("failed"));
+
+    const Activation activation = it.value();
+    m_activations.erase(it);
+    qCDebug(PLASMA_NM) << "Activation of" << path << (activated ? "finished:" : "failed:") << activation.transitions;
+
+    if (!activated) {
+        m_failed[activation.type]++;
+        return;
+    }
+
+    QHash<QString, LatencyHistogram> &histograms = m_histograms[activation.type];
+    histograms[QStringLiteral("activation")].record(activation.clock.elapsed());
+    for (auto phase = activation.phases.constBegin(); phase != activation.phases.constEnd(); ++phase) {
+        histograms[phase.key()].record(phase.value());
+    }
+}
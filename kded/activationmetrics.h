@@ -0,0 +1,92 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef PLASMA_NM_ACTIVATION_METRICS_H
+#define PLASMA_NM_ACTIVATION_METRICS_H
+
+#include "latencyhistogram.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+
+#include <NetworkManagerQt/ActiveConnection>
+#include <NetworkManagerQt/Device>
+#include <NetworkManagerQt/GenericTypes>
+#include <NetworkManagerQt/VpnConnection>
+
+/**
+ * Timestamps the state transitions of every activation and keeps latency
+ * histograms per connection type: the whole activation and the time spent
+ * preparing, configuring the device or the VPN, waiting for authentication,
+ * configuring IP and waiting for the secret agent.
+ */
+class ActivationMetrics : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ActivationMetrics(QObject *parent = nullptr);
+    ~ActivationMetrics() override;
+
+    /**
+     * Per connection type, "<phase>.p50", "<phase>.p90", "<phase>.p99", "<phase>.max",
+     * "<phase>.mean" and "<phase>.count" of every phase seen, and the number of
+     * activations that "failed"
+     */
+    NMVariantMapMap metrics() const;
+    void reset();
+
+public Q_SLOTS:
+    /**
+     * Time the secret agent took to answer a request for the connection at @p connectionPath
+     */
+    void addSecretsWait(const QString &connectionPath, qint64 msecs);
+
+private Q_SLOTS:
+    void activeConnectionAdded(const QString &path);
+    void activeConnectionStateChanged(NetworkManager::ActiveConnection::State state);
+    void vpnConnectionStateChanged(NetworkManager::VpnConnection::State state, NetworkManager::VpnConnection::StateChangeReason reason);
+    void deviceStateChanged(NetworkManager::Device::State newstate, NetworkManager::Device::State oldstate, NetworkManager::Device::StateChangeReason reason);
+
+private:
+    struct Activation {
+        QString type;
+        QString connectionPath;
+        QString devicePath;
+        QElapsedTimer clock;
+        QString phase;
+        qint64 phaseStart = 0;
+        QHash<QString, qint64> phases;
+        QStringList transitions;
+    };
+
+    void addActiveConnection(const NetworkManager::ActiveConnection::Ptr &ac);
+    void transition(const QString &path, const QString &phase, const QString &description);
+    void finish(const QString &path, bool activated);
+
+    // Keyed by the path of the active connection
+    QHash<QString, Activation> m_activations;
+    // Connection type, then phase
+    QHash<QString, QHash<QString, LatencyHistogram> > m_histograms;
+    QHash<QString, quint64> m_failed;
+};
+
+#endif // PLASMA_NM_ACTIVATION_METRICS_H
@@ -0,0 +1,124 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "latencyhistogram.h"
+
+#include <QtMath>
+
+// Values below 2^NM_LATENCY_EXACT_BITS are exact, the rest split each power of two in half as many buckets
+#define NM_LATENCY_EXACT_BITS 6
+#define NM_LATENCY_SUB_BITS (NM_LATENCY_EXACT_BITS - 1)
+#define NM_LATENCY_MAX 3600000
+
+LatencyHistogram::LatencyHistogram()
+    : m_counts(bucket(NM_LATENCY_MAX) + 1)
+{
+}
+
+int LatencyHistogram::bucket(qint64 msecs)
+{
+    if (msecs < (1 << NM_LATENCY_EXACT_BITS)) {
+        return int(msecs);
+    }
+
+    int exponent = NM_LATENCY_EXACT_BITS;
+    while ((msecs >> (exponent + 1)) != 0) {
+        ++exponent;
+    }
+    // Top bits below the leading one select the bucket within its power of two
+    const int sub = int(msecs >> (exponent - NM_LATENCY_SUB_BITS)) - (1 << NM_LATENCY_SUB_BITS);
+    return (1 << NM_LATENCY_EXACT_BITS) + (exponent - NM_LATENCY_EXACT_BITS) * (1 << NM_LATENCY_SUB_BITS) + sub;
+}
+
+qint64 LatencyHistogram::highestEquivalent(int bucket)
+{
+    if (bucket < (1 << NM_LATENCY_EXACT_BITS)) {
+        return bucket;
+    }
+
+    const int index = bucket - (1 << NM_LATENCY_EXACT_BITS);
+    const int exponent = NM_LATENCY_EXACT_BITS + (index >> NM_LATENCY_SUB_BITS);
+    const int sub = index & ((1 << NM_LATENCY_SUB_BITS) - 1);
+    const qint64 width = qint64(1) << (exponent - NM_LATENCY_SUB_BITS);
+    return (qint64((1 << NM_LATENCY_SUB_BITS) + sub) * width) + width - 1;
+}
+
+void LatencyHistogram::record(qint64 msecs)
+{
+    msecs = qBound<qint64>(0, msecs, NM_LATENCY_MAX);
+
+    m_counts[bucket(msecs)]++;
+    if (!m_count || msecs < m_min) {
+        m_min = msecs;
+    }
+    if (!m_count || msecs > m_max) {
+        m_max = msecs;
+    }
+    m_sum += msecs;
+    ++m_count;
+}
+
+void LatencyHistogram::reset()
+{
+    m_counts.fill(0);
+    m_count = 0;
+    m_min = 0;
+    m_max = 0;
+    m_sum = 0;
+}
+
+quint64 LatencyHistogram::count() const
+{
+    return m_count;
+}
+
+qint64 LatencyHistogram::min() const
+{
+    return m_min;
+}
+
+qint64 LatencyHistogram::max() const
+{
+    return m_max;
+}
+
+double LatencyHistogram::mean() const
+{
+    return m_count ? m_sum / m_count : 0;
+}
+
+qint64 LatencyHistogram::percentile(double percentile) const
+{
+    if (!m_count) {
+        return 0;
+    }
+
+    const quint64 rank = qMax<quint64>(1, quint64(qCeil(qBound(0.0, percentile, 100.0) / 100.0 * m_count)));
+    quint64 seen = 0;
+    for (int i = 0; i < m_counts.size(); ++i) {
+        seen += m_counts.at(i);
+        if (seen >= rank) {
+            // The end of the bucket may lie beyond anything recorded
+            return qMin(highestEquivalent(i), m_max);
+        }
+    }
+    return m_max;
+}
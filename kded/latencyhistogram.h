@@ -0,0 +1,63 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef PLASMA_NM_LATENCY_HISTOGRAM_H
+#define PLASMA_NM_LATENCY_HISTOGRAM_H
+
+#include <QVector>
+
+/**
+ * Histogram of latencies in milliseconds with buckets of constant relative
+ * width, like HdrHistogram: values below 64 ms are kept exactly, larger ones
+ * in 32 buckets per power of two, so percentiles are within 3% of the real
+ * value. Values above an hour are counted as an hour.
+ */
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(qint64 msecs);
+    void reset();
+
+    quint64 count() const;
+    qint64 min() const;
+    qint64 max() const;
+    double mean() const;
+
+    /**
+     * Smallest value that @p percentile percent of the recorded values don't
+     * exceed, rounded up to the end of its bucket, 0 when nothing was recorded
+     */
+    qint64 percentile(double percentile) const;
+
+private:
+    static int bucket(qint64 msecs);
+    static qint64 highestEquivalent(int bucket);
+
+    QVector<quint64> m_counts;
+    quint64 m_count = 0;
+    qint64 m_min = 0;
+    qint64 m_max = 0;
+    double m_sum = 0;
+};
+
+#endif // PLASMA_NM_LATENCY_HISTOGRAM_H
@@ -24,6 +24,7 @@
 #include "debug.h"
 #include "notification.h"
 
+#include <configuration.h>
 #include <uiutils.h>
 
 #include <NetworkManagerQt/Manager>
@@ -38,6 +39,11 @@
 Notification::Notification(QObject *parent) :
     QObject(parent)
 {
+    m_throttle = new NotificationThrottle(this);
+    m_throttle->setBurstLimit(Configuration::notificationBurstLimit());
+    m_throttle->setWindow(Configuration::notificationWindowMs());
+    connect(m_throttle, &NotificationThrottle::notify, this, &Notification::sendNotification);
+
     // devices
     for (const NetworkManager::Device::Ptr &device : NetworkManager::networkInterfaces()) {
         addDevice(device);
@@ -76,10 +82,14 @@ void Notification::stateChanged(NetworkManager::Device::State newstate, NetworkM
     Q_UNUSED(oldstate)
 
     NetworkManager::Device *device = qobject_cast<NetworkManager::Device*>(sender());
-    if (newstate == NetworkManager::Device::Activated && m_notifications.contains(device->uni())) {
-        KNotification *notify = m_notifications.value(device->uni());
-        notify->deleteLater();
-        m_notifications.remove(device->uni());
+    if (newstate == NetworkManager::Device::Activated) {
+        // A failure collapsed into a later notification is resolved as well
+        m_throttle->discard(device->uni());
+        if (m_notifications.contains(device->uni())) {
+            KNotification *notify = m_notifications.value(device->uni());
+            notify->deleteLater();
+            m_notifications.remove(device->uni());
+        }
         return;
     } else if (newstate != NetworkManager::Device::Failed) {
         return;
@@ -326,23 +336,7 @@ void Notification::stateChanged(NetworkManager::Device::State newstate, NetworkM
         return;
     }
 
-    if (m_notifications.contains(device->uni())) {
-        KNotification *notify = m_notifications.value(device->uni());
-        notify->setText(text);
-        notify->update();
-    } else {
-        KNotification *notify = new KNotification(QStringLiteral("DeviceFailed"), KNotification::CloseOnTimeout, this);
-        connect(notify, &KNotification::closed, this, &Notification::notificationClosed);
-        notify->setProperty("uni", device->uni());
-        notify->setComponentName(QStringLiteral("networkmanagement"));
-        notify->setIconName(QStringLiteral("dialog-warning"));
-        notify->setTitle(identifier);
-        notify->setText(text);
-        notify->sendEvent();
-        if (notify->id() != -1) {
-                m_notifications[device->uni()] = notify;
-        }
-    }
+    m_throttle->post(device->uni(), {QStringLiteral("DeviceFailed"), identifier, text, QStringLiteral("dialog-warning")});
 }
 
 void Notification::addActiveConnection(const QString &path)
@@ -375,7 +369,8 @@ void Notification::onActiveConnectionStateChanged(NetworkManager::ActiveConnecti
 
     QString eventId, text, iconName;
     const QString acName = ac->id();
-    const QString connectionId = ac->path();
+    // Every activation creates a new active connection, rate limit the connection itself
+    const QString connectionId = ac->uuid();
 
     if (state == NetworkManager::ActiveConnection::Activated) {
         auto foundConnection = std::find_if(m_activeConnectionsBeforeSleep.constBegin(),
@@ -429,25 +424,15 @@ void Notification::onActiveConnectionStateChanged(NetworkManager::ActiveConnecti
         return;
     }
 
-    KNotification *notify = new KNotification(eventId, KNotification::CloseOnTimeout, this);
-    connect(notify, &KNotification::closed, this, &Notification::notificationClosed);
-    notify->setProperty("uni", connectionId);
-    notify->setComponentName(QStringLiteral("networkmanagement"));
-    if (!iconName.isEmpty()) {
-        notify->setIconName(iconName);
-    } else {
+    if (iconName.isEmpty()) {
         if (state == NetworkManager::ActiveConnection::Activated) {
-            notify->setIconName(QStringLiteral("dialog-information"));
+            iconName = QStringLiteral("dialog-information");
         } else {
-            notify->setIconName(QStringLiteral("dialog-warning"));
+            iconName = QStringLiteral("dialog-warning");
         }
     }
-    notify->setTitle(acName);
-    notify->setText(text);
-    notify->sendEvent();
-    if (notify->id() != -1) {
-        m_notifications[connectionId] = notify;
-    }
+
+    m_throttle->post(connectionId, {eventId, acName, text, iconName});
 }
 
 void Notification::onVpnConnectionStateChanged(NetworkManager::VpnConnection::State state, NetworkManager::VpnConnection::StateChangeReason reason)
@@ -456,7 +441,7 @@ void Notification::onVpnConnectionStateChanged(NetworkManager::VpnConnection::St
 
     QString eventId, text;
     const QString vpnName = vpn->connection()->name();
-    const QString connectionId = vpn->path();
+    const QString connectionId = vpn->uuid();
 
     if (state == NetworkManager::VpnConnection::Activated) {
         eventId = QStringLiteral("ConnectionActivated");
@@ -509,30 +494,53 @@ void Notification::onVpnConnectionStateChanged(NetworkManager::VpnConnection::St
         break;
     }
 
-    KNotification *notify = new KNotification(eventId, KNotification::CloseOnTimeout, this);
-    connect(notify, &KNotification::closed, this, &Notification::notificationClosed);
-    notify->setProperty("uni", connectionId);
-    notify->setComponentName("networkmanagement");
-    if (state == NetworkManager::VpnConnection::Activated) {
-        notify->setIconName(QStringLiteral("dialog-information"));
-    } else {
-        notify->setIconName(QStringLiteral("dialog-warning"));
-    }
-    notify->setTitle(vpnName);
-    notify->setText(text);
-    notify->sendEvent();
-    if (notify->id() != -1) {
-        m_notifications[connectionId] = notify;
-    }
+    const QString iconName = state == NetworkManager::VpnConnection::Activated ? QStringLiteral("dialog-information") : QStringLiteral("dialog-warning");
+    m_throttle->post(connectionId, {eventId, vpnName, text, iconName});
 }
 
 void Notification::notificationClosed()
 {
     KNotification *notify = qobject_cast<KNotification*>(sender());
-    m_notifications.remove(notify->property("uni").toString());
+    // A newer notification may have taken the place of this one
+    const QString uni = notify->property("uni").toString();
+    if (m_notifications.value(uni) == notify) {
+        m_notifications.remove(uni);
+    }
     notify->deleteLater();
 }
 
+void Notification::sendNotification(const QString &source, const NotificationThrottle::Event &event, int collapsed)
+{
+    QString text = event.text;
+    if (collapsed > 0) {
+        qCDebug(PLASMA_NM) << "Collapsed" << collapsed << "notifications of" << source;
+        text = i18ncp("@info:status Notification replacing several state changes of the same device or connection",
+                      "%2\n(1 more change)", "%2\n(%1 more changes)", collapsed, event.text);
+    }
+
+    // Update the notification still shown for the source instead of adding another popup
+    KNotification *notify = m_notifications.value(source);
+    if (notify && notify->eventId() == event.eventId) {
+        notify->setTitle(event.title);
+        notify->setText(text);
+        notify->setIconName(event.iconName);
+        notify->update();
+        return;
+    }
+
+    notify = new KNotification(event.eventId, KNotification::CloseOnTimeout, this);
+    connect(notify, &KNotification::closed, this, &Notification::notificationClosed);
+    notify->setProperty("uni", source);
+    notify->setComponentName(QStringLiteral("networkmanagement"));
+    notify->setIconName(event.iconName);
+    notify->setTitle(event.title);
+    notify->setText(text);
+    notify->sendEvent();
+    if (notify->id() != -1) {
+        m_notifications[source] = notify;
+    }
+}
+
 void Notification::onPrepareForSleep(bool sleep)
 {
     m_preparingForSleep = sleep;
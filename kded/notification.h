@@ -26,6 +26,8 @@
 
 #include <QObject>
 
+#include "notificationthrottle.h"
+
 #include <NetworkManagerQt/Device>
 #include <NetworkManagerQt/VpnConnection>
 
@@ -49,12 +51,15 @@ private Q_SLOTS:
     void onVpnConnectionStateChanged(NetworkManager::VpnConnection::State state, NetworkManager::VpnConnection::StateChangeReason reason);
 
     void notificationClosed();
+    void sendNotification(const QString &source, const NotificationThrottle::Event &event, int collapsed);
 
     void onPrepareForSleep(bool sleep);
     void onCheckActiveConnectionOnResume();
 
 private:
     QHash<QString, KNotification*> m_notifications;
+    // Collapses bursts of state changes of a flapping device or connection
+    NotificationThrottle *m_throttle = nullptr;
 
     bool m_preparingForSleep = false;
     QStringList m_activeConnectionsBeforeSleep;
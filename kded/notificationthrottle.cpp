@@ -0,0 +1,169 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "notificationthrottle.h"
+
+// Defaults when no configuration is given
+#define NM_NOTIFICATION_BURST_LIMIT 3
+#define NM_NOTIFICATION_WINDOW 30000
+
+NotificationThrottle::NotificationThrottle(QObject *parent)
+    : QObject(parent)
+    , m_burstLimit(NM_NOTIFICATION_BURST_LIMIT)
+    , m_window(NM_NOTIFICATION_WINDOW)
+{
+    m_clock.start();
+
+    m_flushTimer.setSingleShot(true);
+    connect(&m_flushTimer, &QTimer::timeout, this, &NotificationThrottle::flush);
+}
+
+NotificationThrottle::~NotificationThrottle()
+{
+}
+
+int NotificationThrottle::burstLimit() const
+{
+    return m_burstLimit;
+}
+
+void NotificationThrottle::setBurstLimit(int limit)
+{
+    m_burstLimit = qMax(1, limit);
+}
+
+int NotificationThrottle::window() const
+{
+    return m_window;
+}
+
+void NotificationThrottle::setWindow(int msecs)
+{
+    m_window = qMax(0, msecs);
+}
+
+void NotificationThrottle::post(const QString &source, const Event &event)
+{
+    const qint64 now = m_clock.elapsed();
+    Source &state = m_sources[source];
+    expire(&state, now);
+    m_posted++;
+
+    // Once events are collapsed the following ones wait for the same notification
+    if (!state.suppressed && state.sent.count() < m_burstLimit) {
+        state.sent << now;
+        m_sent++;
+        Q_EMIT notify(source, event, 0);
+        return;
+    }
+
+    state.pending = event;
+    state.suppressed++;
+    m_suppressed++;
+    scheduleFlush();
+}
+
+void NotificationThrottle::discard(const QString &source)
+{
+    auto it = m_sources.find(source);
+    if (it != m_sources.end() && it->suppressed) {
+        it->suppressed = 0;
+        it->pending = Event();
+    }
+}
+
+quint64 NotificationThrottle::postedCount() const
+{
+    return m_posted;
+}
+
+quint64 NotificationThrottle::sentCount() const
+{
+    return m_sent;
+}
+
+quint64 NotificationThrottle::suppressedCount() const
+{
+    return m_suppressed;
+}
+
+quint64 NotificationThrottle::aggregatedCount() const
+{
+    return m_aggregated;
+}
+
+void NotificationThrottle::flush()
+{
+    const qint64 now = m_clock.elapsed();
+
+    // Collect first, receivers may post new events
+    QVector<QPair<QString, Source> > ready;
+    for (auto it = m_sources.begin(); it != m_sources.end();) {
+        expire(&it.value(), now);
+        if (it->suppressed && it->sent.count() < m_burstLimit) {
+            it->sent << now;
+            ready << qMakePair(it.key(), it.value());
+            it->suppressed = 0;
+            it->pending = Event();
+        }
+
+        if (!it->suppressed && it->sent.isEmpty()) {
+            it = m_sources.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (const QPair<QString, Source> &source : ready) {
+        m_aggregated++;
+        Q_EMIT notify(source.first, source.second.pending, source.second.suppressed - 1);
+    }
+
+    scheduleFlush();
+}
+
+void NotificationThrottle::expire(Source *source, qint64 now) const
+{
+    while (!source->sent.isEmpty() && source->sent.first() + m_window <= now) {
+        source->sent.removeFirst();
+    }
+}
+
+void NotificationThrottle::scheduleFlush()
+{
+    // Wake up when the first collapsed source may send again
+    qint64 next = -1;
+    for (const Source &source : qAsConst(m_sources)) {
+        if (source.suppressed) {
+            const qint64 due = source.sent.count() < m_burstLimit ? 0 : source.sent.first() + m_window;
+            if (next < 0 || due < next) {
+                next = due;
+            }
+        }
+    }
+
+    if (next < 0) {
+        m_flushTimer.stop();
+        return;
+    }
+
+    m_flushTimer.start(int(qMax<qint64>(0, next - m_clock.elapsed())));
+}
@@ -0,0 +1,99 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef PLASMA_NM_NOTIFICATION_THROTTLE_H
+#define PLASMA_NM_NOTIFICATION_THROTTLE_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+/**
+ * Rate limits notifications per source, e.g. a device or a connection. Up to
+ * burstLimit() events of a source within window() are sent right away, further
+ * ones are collapsed and the last of them is sent once the window allows it,
+ * together with the number of events it replaces.
+ */
+class NotificationThrottle : public QObject
+{
+    Q_OBJECT
+public:
+    struct Event {
+        QString eventId;
+        QString title;
+        QString text;
+        QString iconName;
+    };
+
+    explicit NotificationThrottle(QObject *parent = nullptr);
+    ~NotificationThrottle() override;
+
+    int burstLimit() const;
+    void setBurstLimit(int limit);
+
+    int window() const;
+    void setWindow(int msecs);
+
+    void post(const QString &source, const Event &event);
+    // Drops collapsed events of the source, e.g. when its failure was resolved
+    void discard(const QString &source);
+
+    // Events posted, sent right away, collapsed and the notifications sent for collapsed ones
+    quint64 postedCount() const;
+    quint64 sentCount() const;
+    quint64 suppressedCount() const;
+    quint64 aggregatedCount() const;
+
+Q_SIGNALS:
+    /**
+     * @p collapsed is the number of earlier events replaced by this one
+     */
+    void notify(const QString &source, const NotificationThrottle::Event &event, int collapsed);
+
+private Q_SLOTS:
+    void flush();
+
+private:
+    struct Source {
+        // Times events were sent within the window
+        QVector<qint64> sent;
+        Event pending;
+        int suppressed = 0;
+    };
+
+    void expire(Source *source, qint64 now) const;
+    void scheduleFlush();
+
+    int m_burstLimit;
+    int m_window;
+    QElapsedTimer m_clock;
+    QTimer m_flushTimer;
+    QHash<QString, Source> m_sources;
+
+    quint64 m_posted = 0;
+    quint64 m_sent = 0;
+    quint64 m_suppressed = 0;
+    quint64 m_aggregated = 0;
+};
+
+#endif // PLASMA_NM_NOTIFICATION_THROTTLE_H
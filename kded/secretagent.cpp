@@ -22,6 +22,7 @@
 
 #include "passworddialog.h"
 #include "secretagent.h"
+#include "secretsmigration.h"
 
 #include "debug.h"
 
@@ -40,12 +41,11 @@
 #include <QDBusConnection>
 #include <QStringBuilder>
 #include <QDialog>
+#include <QTimer>
 
 #include <KLocalizedString>
 #include <KPluginFactory>
 #include <KWindowSystem>
-#include <KConfig>
-#include <KConfigGroup>
 #include <KWallet>
 
 SecretAgent::SecretAgent(QObject* parent)
@@ -56,8 +56,8 @@ SecretAgent::SecretAgent(QObject* parent)
 {
     connect(NetworkManager::notifier(), &NetworkManager::Notifier::serviceDisappeared, this, &SecretAgent::killDialogs);
 
-    // We have to import secrets previously stored in plaintext files
-    importSecretsFromPlainTextFiles();
+    // We have to import secrets previously stored in plaintext files, once the agent is set up
+    QTimer::singleShot(0, this, &SecretAgent::importSecretsFromPlainTextFiles);
 }
 
 SecretAgent::~SecretAgent()
@@ -91,6 +91,7 @@ NMVariantMapMap SecretAgent::GetSecrets(const NMVariantMapMap &connection, const
     request.hints = hints;
     request.setting_name = setting_name;
     request.message = message();
+    request.clock.start();
     m_calls << request;
 
     processNext();
@@ -152,6 +153,7 @@ void SecretAgent::CancelGetSecrets(const QDBusObjectPath &connection_path, const
             sendError(SecretAgent::AgentCanceled,
                       QLatin1String("Agent canceled the password dialog"),
                       request.message);
+            Q_EMIT secretsRequestFinished(request.connection_path.path(), request.clock.elapsed());
             m_calls.removeAt(i);
             break;
         }
@@ -254,6 +256,7 @@ void SecretAgent::dialogAccepted()
                 }
             }
 
+            Q_EMIT secretsRequestFinished(request.connection_path.path(), request.clock.elapsed());
             m_calls.removeAt(i);
             break;
         }
@@ -273,6 +276,7 @@ void SecretAgent::dialogRejected()
             sendError(SecretAgent::UserCanceled,
                       QLatin1String("User canceled the password dialog"),
                       request.message);
+            Q_EMIT secretsRequestFinished(request.connection_path.path(), request.clock.elapsed());
             m_calls.removeAt(i);
             break;
         }
@@ -327,6 +331,7 @@ void SecretAgent::processNext()
         switch (request.type) {
         case SecretsRequest::GetSecrets:
             if (processGetSecrets(request)) {
+                Q_EMIT secretsRequestFinished(request.connection_path.path(), request.clock.elapsed());
                 m_calls.removeAt(i);
                 continue;
             }
@@ -604,69 +609,8 @@ void SecretAgent::sendSecrets(const NMVariantMapMap &secrets, const QDBusMessage
 
 void SecretAgent::importSecretsFromPlainTextFiles()
 {
-    KConfig config(QLatin1String("plasma-networkmanagement"), KConfig::SimpleConfig);
-
-    // No action is required when the list of secrets is empty
-    if (!config.groupList().isEmpty()) {
-        for (const QString &groupName : config.groupList()) {
-            QString loadedUuid = groupName.split(';').first().remove('{').remove('}');
-            QString loadedSettingType = groupName.split(';').last();
-            NetworkManager::Connection::Ptr connection = NetworkManager::findConnectionByUuid(loadedUuid);
-            if (connection) {
-                NetworkManager::Setting::SecretFlags secretFlags = KWallet::Wallet::isEnabled() ? NetworkManager::Setting::AgentOwned : NetworkManager::Setting::None;
-                QMap<QString, QString> secrets = config.entryMap(groupName);
-                NMVariantMapMap settings = connection->settings()->toMap();
-
-                for (const QString &setting : settings.keys()) {
-                    if (setting == QLatin1String("vpn")) {
-                        NetworkManager::VpnSetting::Ptr vpnSetting = connection->settings()->setting(NetworkManager::Setting::Vpn).staticCast<NetworkManager::VpnSetting>();
-                        if (vpnSetting) {
-                            // Add loaded secrets from the config file
-                            vpnSetting->secretsFromStringMap(secrets);
-
-                            NMStringMap vpnData = vpnSetting->data();
-                            // Reset flags, we can't save secrets to our secret agent when KWallet is not enabled, because
-                            // we dropped support for plaintext files, therefore they need to be stored to NetworkManager
-                            for (const QString &key : vpnData.keys()) {
-                                if (key.endsWith(QLatin1String("-flags"))) {
-                                    vpnData.insert(key, QString::number((int)secretFlags));
-                                }
-                            }
-
-                            vpnSetting->setData(vpnData);
-                            settings.insert(setting, vpnSetting->toMap());
-                            connection->update(settings);
-                        }
-                    } else {
-                        if (setting == loadedSettingType) {
-                            QVariantMap tmpSetting = settings.value(setting);
-                            // Reset flags, we can't save secrets to our secret agent when KWallet is not enabled, because
-                            // we dropped support for plaintext files, therefore they need to be stored to NetworkManager
-                            for (const QString &key : tmpSetting.keys()) {
-                                if (key.endsWith(QLatin1String("-flags"))) {
-                                    tmpSetting.insert(key, (int)secretFlags);
-                                }
-                            }
-
-                            // Add loaded secrets from the config file
-                            QMap<QString, QString>::const_iterator it = secrets.constBegin();
-                            QMap<QString, QString>::const_iterator end = secrets.constEnd();
-                            for (; it != end; ++it) {
-                                tmpSetting.insert(it.key(), it.value());
-                            }
-
-                            // Replace the old setting with the new one
-                            settings.insert(setting, tmpSetting);
-                            // Update the connection which re-saves secrets
-                            connection->update(settings);
-                        }
-                    }
-                }
-            }
-
-            // Remove the group
-            KConfigGroup group(&config, groupName);
-            group.deleteGroup();
-        }
-    }
+    // Runs in the background, requests are served meanwhile
+    SecretsMigration *migration = new SecretsMigration(this);
+    connect(migration, &SecretsMigration::finished, migration, &SecretsMigration::deleteLater);
+    migration->start();
 }
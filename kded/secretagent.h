@@ -25,6 +25,8 @@
 
 #include <NetworkManagerQt/SecretAgent>
 
+#include <QElapsedTimer>
+
 namespace KWallet {
 class Wallet;
 }
@@ -63,6 +65,8 @@ public:
     bool saveSecretsWithoutReply;
     QDBusMessage message;
     PasswordDialog *dialog;
+    // Started when NetworkManager asked for the secrets
+    QElapsedTimer clock;
 };
 
 class Q_DECL_EXPORT SecretAgent : public NetworkManager::SecretAgent
@@ -74,6 +78,10 @@ public:
 
 Q_SIGNALS:
     void secretsError(const QString &connectionPath, const QString &message) const;
+    /**
+     * A GetSecrets call for @p connectionPath was answered or canceled after @p msecs
+     */
+    void secretsRequestFinished(const QString &connectionPath, qint64 msecs) const;
 
 public Q_SLOTS:
     NMVariantMapMap GetSecrets(const NMVariantMapMap&, const QDBusObjectPath&, const QString&, const QStringList&, uint) override;
@@ -87,6 +95,7 @@ private Q_SLOTS:
     void killDialogs();
     void walletOpened(bool success);
     void walletClosed();
+    void importSecretsFromPlainTextFiles();
 
 private:
     void processNext();
@@ -120,9 +129,6 @@ private:
     mutable KWallet::Wallet *m_wallet;
     mutable PasswordDialog *m_dialog;
     QList<SecretsRequest> m_calls;
-
-    void importSecretsFromPlainTextFiles();
-
 };
 
 #endif // PLASMA_NM_SECRET_AGENT_H
@@ -0,0 +1,215 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "secretsmigration.h"
+#include "debug.h"
+
+#include <NetworkManagerQt/ConnectionSettings>
+#include <NetworkManagerQt/Settings>
+#include <NetworkManagerQt/VpnSetting>
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusMetaType>
+#include <QDBusObjectPath>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+
+#include <KConfigGroup>
+#include <KWallet>
+
+// Connections migrated at the same time
+#define NM_SECRETS_MIGRATION_CONCURRENCY 4
+
+SecretsMigration::SecretsMigration(QObject *parent)
+    : QObject(parent)
+    , m_config(QLatin1String("plasma-networkmanagement"), KConfig::SimpleConfig)
+{
+    qDBusRegisterMetaType<NMVariantMapMap>();
+}
+
+SecretsMigration::~SecretsMigration()
+{
+}
+
+void SecretsMigration::start()
+{
+    m_elapsed.start();
+
+    for (const QString &groupName : m_config.groupList()) {
+        const QString uuid = groupName.split(';').first().remove('{').remove('}');
+        m_groups[uuid] << groupName;
+    }
+    m_queue = m_groups.keys();
+
+    // No action is required when the list of secrets is empty
+    if (m_queue.isEmpty()) {
+        Q_EMIT finished();
+        return;
+    }
+
+    qCDebug(PLASMA_NM) << "Migrating plaintext secrets of" << m_queue.count() << "connections";
+    startNext();
+}
+
+int SecretsMigration::processed() const
+{
+    return m_processed;
+}
+
+int SecretsMigration::total() const
+{
+    return m_groups.count();
+}
+
+void SecretsMigration::startNext()
+{
+    while (m_running < NM_SECRETS_MIGRATION_CONCURRENCY && !m_queue.isEmpty()) {
+        const QString uuid = m_queue.takeFirst();
+        m_running++;
+
+        QDBusMessage message = QDBusMessage::createMethodCall(QStringLiteral(NM_DBUS_SERVICE), QStringLiteral(NM_DBUS_PATH_SETTINGS),
+                                                              QStringLiteral(NM_DBUS_INTERFACE_SETTINGS), QStringLiteral("GetConnectionByUuid"));
+        message << uuid;
+        QDBusPendingReply<QDBusObjectPath> reply = QDBusConnection::systemBus().asyncCall(message);
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, uuid] (QDBusPendingCallWatcher *watcher) {
+            QDBusPendingReply<QDBusObjectPath> reply = *watcher;
+            if (reply.isError()) {
+                // The connection doesn't exist anymore, only its secrets are dropped
+                qCDebug(PLASMA_NM) << "No connection for plaintext secrets of" << uuid;
+                connectionFinished(uuid);
+            } else {
+                fetchSettings(uuid, reply.value().path());
+            }
+            watcher->deleteLater();
+        });
+    }
+}
+
+void SecretsMigration::fetchSettings(const QString &uuid, const QString &path)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(QStringLiteral(NM_DBUS_SERVICE), path,
+                                                          QStringLiteral(NM_DBUS_INTERFACE_SETTINGS_CONNECTION), QStringLiteral("GetSettings"));
+    QDBusPendingReply<NMVariantMapMap> reply = QDBusConnection::systemBus().asyncCall(message);
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, uuid, path] (QDBusPendingCallWatcher *watcher) {
+        QDBusPendingReply<NMVariantMapMap> reply = *watcher;
+        if (reply.isError()) {
+            qCWarning(PLASMA_NM) << "Failed to get settings of" << path << ":" << reply.error().message();
+            connectionFinished(uuid);
+        } else {
+            updateConnection(uuid, path, reply.value());
+        }
+        watcher->deleteLater();
+    });
+}
+
+void SecretsMigration::updateConnection(const QString &uuid, const QString &path, const NMVariantMapMap &map)
+{
+    NetworkManager::ConnectionSettings::Ptr connectionSettings(new NetworkManager::ConnectionSettings(map));
+    NMVariantMapMap settings = connectionSettings->toMap();
+    NetworkManager::Setting::SecretFlags secretFlags = KWallet::Wallet::isEnabled() ? NetworkManager::Setting::AgentOwned : NetworkManager::Setting::None;
+
+    // Merge the secrets of all groups, so the connection is updated once
+    for (const QString &groupName : m_groups.value(uuid)) {
+        const QString loadedSettingType = groupName.split(';').last();
+        const QMap<QString, QString> secrets = m_config.entryMap(groupName);
+
+        for (const QString &setting : settings.keys()) {
+            if (setting == QLatin1String("vpn")) {
+                NetworkManager::VpnSetting::Ptr vpnSetting = connectionSettings->setting(NetworkManager::Setting::Vpn).staticCast<NetworkManager::VpnSetting>();
+                if (vpnSetting) {
+                    // Add loaded secrets from the config file
+                    vpnSetting->secretsFromStringMap(secrets);
+
+                    NMStringMap vpnData = vpnSetting->data();
+                    // Reset flags, we can't save secrets to our secret agent when KWallet is not enabled, because
+                    // we dropped support for plaintext files, therefore they need to be stored to NetworkManager
+                    for (const QString &key : vpnData.keys()) {
+                        if (key.endsWith(QLatin1String("-flags"))) {
+                            vpnData.insert(key, QString::number((int)secretFlags));
+                        }
+                    }
+
+                    vpnSetting->setData(vpnData);
+                    settings.insert(setting, vpnSetting->toMap());
+                }
+            } else if (setting == loadedSettingType) {
+                QVariantMap tmpSetting = settings.value(setting);
+                // Reset flags, we can't save secrets to our secret agent when KWallet is not enabled, because
+                // we dropped support for plaintext files, therefore they need to be stored to NetworkManager
+                for (const QString &key : tmpSetting.keys()) {
+                    if (key.endsWith(QLatin1String("-flags"))) {
+                        tmpSetting.insert(key, (int)secretFlags);
+                    }
+                }
+
+                // Add loaded secrets from the config file
+                for (auto it = secrets.constBegin(); it != secrets.constEnd(); ++it) {
+                    tmpSetting.insert(it.key(), it.value());
+                }
+
+                // Replace the old setting with the new one
+                settings.insert(setting, tmpSetting);
+            }
+        }
+    }
+
+    // Update the connection which re-saves secrets
+    QDBusMessage message = QDBusMessage::createMethodCall(QStringLiteral(NM_DBUS_SERVICE), path,
+                                                          QStringLiteral(NM_DBUS_INTERFACE_SETTINGS_CONNECTION), QStringLiteral("Update"));
+    message << QVariant::fromValue(settings);
+    QDBusPendingReply<> reply = QDBusConnection::systemBus().asyncCall(message);
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, uuid, path] (QDBusPendingCallWatcher *watcher) {
+        QDBusPendingReply<> reply = *watcher;
+        if (reply.isError()) {
+            qCWarning(PLASMA_NM) << "Failed to migrate plaintext secrets of" << path << ":" << reply.error().message();
+        } else {
+            m_migrated++;
+        }
+        connectionFinished(uuid);
+        watcher->deleteLater();
+    });
+}
+
+void SecretsMigration::connectionFinished(const QString &uuid)
+{
+    // Remove the groups
+    for (const QString &groupName : m_groups.value(uuid)) {
+        KConfigGroup group(&m_config, groupName);
+        group.deleteGroup();
+    }
+
+    m_running--;
+    m_processed++;
+    Q_EMIT progress(m_processed, total());
+
+    if (m_processed < total()) {
+        startNext();
+        return;
+    }
+
+    m_config.sync();
+    qCDebug(PLASMA_NM) << "Migrated plaintext secrets of" << m_migrated << "of" << total() << "connections in" << m_elapsed.elapsed() << "ms";
+    Q_EMIT finished();
+}
@@ -0,0 +1,71 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef PLASMA_NM_SECRETS_MIGRATION_H
+#define PLASMA_NM_SECRETS_MIGRATION_H
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QObject>
+#include <QStringList>
+
+#include <KConfig>
+
+#include <NetworkManagerQt/GenericTypes>
+
+/**
+ * Moves secrets from the plaintext files of old versions into NetworkManager.
+ * All secrets of a connection are merged into one Update call and at most a few
+ * connections are migrated at the same time, without blocking the caller.
+ */
+class SecretsMigration : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SecretsMigration(QObject *parent = nullptr);
+    ~SecretsMigration() override;
+
+    void start();
+
+    int processed() const;
+    int total() const;
+
+Q_SIGNALS:
+    void progress(int processed, int total);
+    void finished();
+
+private:
+    void startNext();
+    void fetchSettings(const QString &uuid, const QString &path);
+    void updateConnection(const QString &uuid, const QString &path, const NMVariantMapMap &map);
+    void connectionFinished(const QString &uuid);
+
+    KConfig m_config;
+    // Groups of the legacy file by connection UUID
+    QMap<QString, QStringList> m_groups;
+    QStringList m_queue;
+    int m_running = 0;
+    int m_processed = 0;
+    int m_migrated = 0;
+    QElapsedTimer m_elapsed;
+};
+
+#endif // PLASMA_NM_SECRETS_MIGRATION_H
@@ -25,10 +25,13 @@
 
 #include <KPluginFactory>
 
+#include "activationmetrics.h"
 #include "secretagent.h"
 #include "notification.h"
 #include "monitor.h"
 #include "portalmonitor.h"
+#include "models/networkmodel.h"
+#include "models/networkmodelpublisher.h"
 
 #include <QDBusMetaType>
 #include <QDBusServiceWatcher>
@@ -45,6 +48,9 @@ class NetworkManagementServicePrivate
     Notification *notification = nullptr;
     Monitor *monitor = nullptr;
     PortalMonitor *portalMonitor = nullptr;
+    NetworkModel *networkModel = nullptr;
+    NetworkModelPublisher *networkModelPublisher = nullptr;
+    ActivationMetrics *activationMetrics = nullptr;
 };
 
 NetworkManagementService::NetworkManagementService(QObject * parent, const QVariantList&)
@@ -56,6 +62,8 @@ NetworkManagementService::NetworkManagementService(QObject * parent, const QVari
 
     d->agent = new SecretAgent(this);
     connect(d->agent, &SecretAgent::secretsError, this, &NetworkManagementService::secretsError);
+
+    qDBusRegisterMetaType<NMVariantMapMap>();
 }
 
 NetworkManagementService::~NetworkManagementService()
@@ -78,6 +86,44 @@ void NetworkManagementService::init()
     if (!d->portalMonitor) {
         d->portalMonitor = new PortalMonitor(this);
     }
+
+    if (!d->activationMetrics) {
+        d->activationMetrics = new ActivationMetrics(this);
+        connect(d->agent, &SecretAgent::secretsRequestFinished, d->activationMetrics, &ActivationMetrics::addSecretsWait);
+    }
+}
+
+QByteArray NetworkManagementService::networkModelSnapshot()
+{
+    Q_D(NetworkManagementService);
+
+    // Created for the first client, the model must not be a replica of itself
+    if (!d->networkModel) {
+        d->networkModel = new NetworkModel(NetworkModel::LocalSource, this);
+        d->networkModelPublisher = new NetworkModelPublisher(d->networkModel, this);
+        connect(d->networkModelPublisher, &NetworkModelPublisher::deltaReady, this, &NetworkManagementService::networkModelChanged);
+    }
+
+    return d->networkModelPublisher->snapshot();
+}
+
+NMVariantMapMap NetworkManagementService::activationMetrics()
+{
+    Q_D(NetworkManagementService);
+
+    if (!d->activationMetrics) {
+        return NMVariantMapMap();
+    }
+    return d->activationMetrics->metrics();
+}
+
+void NetworkManagementService::resetActivationMetrics()
+{
+    Q_D(NetworkManagementService);
+
+    if (d->activationMetrics) {
+        d->activationMetrics->reset();
+    }
 }
 
 void NetworkManagementService::slotRegistered(const QDBusObjectPath &path)
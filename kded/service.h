@@ -29,6 +29,8 @@
 
 #include <QVariant>
 
+#include <NetworkManagerQt/GenericTypes>
+
 class NetworkManagementServicePrivate;
 
 class Q_DECL_EXPORT NetworkManagementService : public KDEDModule
@@ -42,11 +44,22 @@ public:
 
 public Q_SLOTS:
     Q_SCRIPTABLE void init();
+    /**
+     * Rows of the network model shared by the applets and the KCM, later changes
+     * are sent with networkModelChanged()
+     */
+    Q_SCRIPTABLE QByteArray networkModelSnapshot();
+    /**
+     * Latency percentiles of the activations per connection type, see ActivationMetrics
+     */
+    Q_SCRIPTABLE NMVariantMapMap activationMetrics();
+    Q_SCRIPTABLE void resetActivationMetrics();
 
 Q_SIGNALS:
     Q_SCRIPTABLE void registered();
     Q_SCRIPTABLE
     void secretsError(const QString &connectionPath, const QString &message);
+    Q_SCRIPTABLE void networkModelChanged(const QByteArray &delta);
 
 private Q_SLOTS:
     void slotRegistered(const QDBusObjectPath &path);
@@ -0,0 +1,174 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "bluezadaptercache.h"
+#include "debug.h"
+
+#include <QDBusMetaType>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusVariant>
+
+#define BLUEZ_ADAPTER_IFACE "org.bluez.Adapter1"
+#define DBUS_OBJECT_MANAGER_IFACE "org.freedesktop.DBus.ObjectManager"
+#define DBUS_PROPERTIES_IFACE "org.freedesktop.DBus.Properties"
+
+typedef QMap<QDBusObjectPath, NMVariantMapMap> ManagedObjects;
+
+BluezAdapterCache::BluezAdapterCache(const QDBusConnection &connection, const QString &service, QObject *parent)
+    : QObject(parent)
+    , m_connection(connection)
+    , m_service(service)
+    , m_serviceWatcher(service, connection, QDBusServiceWatcher::WatchForRegistration | QDBusServiceWatcher::WatchForUnregistration)
+{
+    qDBusRegisterMetaType<NMVariantMapMap>();
+    qDBusRegisterMetaType<ManagedObjects>();
+
+    connect(&m_serviceWatcher, &QDBusServiceWatcher::serviceRegistered, this, &BluezAdapterCache::load);
+    connect(&m_serviceWatcher, &QDBusServiceWatcher::serviceUnregistered, this, &BluezAdapterCache::unload);
+
+    // Subscribed before loading, so no change gets lost in between
+    m_connection.connect(m_service, QStringLiteral("/"), QStringLiteral(DBUS_OBJECT_MANAGER_IFACE), QStringLiteral("InterfacesAdded"),
+                         this, SLOT(interfacesAdded(QDBusObjectPath,NMVariantMapMap)));
+    m_connection.connect(m_service, QStringLiteral("/"), QStringLiteral(DBUS_OBJECT_MANAGER_IFACE), QStringLiteral("InterfacesRemoved"),
+                         this, SLOT(interfacesRemoved(QDBusObjectPath,QStringList)));
+    // Only changes of adapters, not the frequent ones of devices
+    m_connection.connect(m_service, QString(), QStringLiteral(DBUS_PROPERTIES_IFACE), QStringLiteral("PropertiesChanged"),
+                         QStringList{QStringLiteral(BLUEZ_ADAPTER_IFACE)}, QString(),
+                         this, SLOT(propertiesChanged(QString,QVariantMap,QStringList,QDBusMessage)));
+
+    load();
+}
+
+BluezAdapterCache::~BluezAdapterCache()
+{
+}
+
+bool BluezAdapterCache::isLoaded() const
+{
+    return m_loaded;
+}
+
+QStringList BluezAdapterCache::adapters() const
+{
+    return m_adapters.keys();
+}
+
+bool BluezAdapterCache::isPowered(const QString &adapter) const
+{
+    return m_adapters.value(adapter);
+}
+
+void BluezAdapterCache::setPowered(const QStringList &adapters, bool powered)
+{
+    if (adapters.isEmpty()) {
+        Q_EMIT poweredSet();
+        return;
+    }
+
+    for (const QString &adapter : adapters) {
+        QDBusMessage message = QDBusMessage::createMethodCall(m_service, adapter, QStringLiteral(DBUS_PROPERTIES_IFACE), QStringLiteral("Set"));
+        message << QStringLiteral(BLUEZ_ADAPTER_IFACE) << QStringLiteral("Powered") << QVariant::fromValue(QDBusVariant(powered));
+        QDBusPendingReply<> reply = m_connection.asyncCall(message);
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
+        m_pendingCalls++;
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, adapter, powered] (QDBusPendingCallWatcher *watcher) {
+            QDBusPendingReply<> reply = *watcher;
+            if (reply.isError()) {
+                qCWarning(PLASMA_NM) << "Failed to set power of bluetooth adapter" << adapter << ":" << reply.error().message();
+            } else if (m_adapters.contains(adapter)) {
+                updatePowered(adapter, powered);
+            }
+
+            if (--m_pendingCalls == 0) {
+                Q_EMIT poweredSet();
+            }
+            watcher->deleteLater();
+        });
+    }
+}
+
+void BluezAdapterCache::load()
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(m_service, QStringLiteral("/"), QStringLiteral(DBUS_OBJECT_MANAGER_IFACE),
+                                                          QStringLiteral("GetManagedObjects"));
+    QDBusPendingReply<ManagedObjects> reply = m_connection.asyncCall(message);
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this] (QDBusPendingCallWatcher *watcher) {
+        QDBusPendingReply<ManagedObjects> reply = *watcher;
+        if (reply.isValid()) {
+            const ManagedObjects objects = reply.value();
+            for (auto it = objects.constBegin(); it != objects.constEnd(); ++it) {
+                if (it->contains(QStringLiteral(BLUEZ_ADAPTER_IFACE))) {
+                    m_adapters.insert(it.key().path(), it->value(QStringLiteral(BLUEZ_ADAPTER_IFACE)).value(QStringLiteral("Powered")).toBool());
+                }
+            }
+            m_loaded = true;
+            Q_EMIT adaptersChanged();
+            Q_EMIT loaded();
+        } else {
+            qCDebug(PLASMA_NM) << "Failed to get bluetooth adapters:" << reply.error().message();
+        }
+        watcher->deleteLater();
+    });
+}
+
+void BluezAdapterCache::unload()
+{
+    m_loaded = false;
+    if (!m_adapters.isEmpty()) {
+        m_adapters.clear();
+        Q_EMIT adaptersChanged();
+    }
+}
+
+void BluezAdapterCache::interfacesAdded(const QDBusObjectPath &path, const NMVariantMapMap &interfaces)
+{
+    if (interfaces.contains(QStringLiteral(BLUEZ_ADAPTER_IFACE))) {
+        m_adapters.insert(path.path(), interfaces.value(QStringLiteral(BLUEZ_ADAPTER_IFACE)).value(QStringLiteral("Powered")).toBool());
+        Q_EMIT adaptersChanged();
+    }
+}
+
+void BluezAdapterCache::interfacesRemoved(const QDBusObjectPath &path, const QStringList &interfaces)
+{
+    if (interfaces.contains(QStringLiteral(BLUEZ_ADAPTER_IFACE)) && m_adapters.remove(path.path())) {
+        Q_EMIT adaptersChanged();
+    }
+}
+
+void BluezAdapterCache::propertiesChanged(const QString &interface, const QVariantMap &changed, const QStringList &invalidated,
+                                          const QDBusMessage &message)
+{
+    Q_UNUSED(invalidated);
+
+    if (interface == QLatin1String(BLUEZ_ADAPTER_IFACE) && m_adapters.contains(message.path()) && changed.contains(QStringLiteral("Powered"))) {
+        updatePowered(message.path(), changed.value(QStringLiteral("Powered")).toBool());
+    }
+}
+
+void BluezAdapterCache::updatePowered(const QString &adapter, bool powered)
+{
+    if (m_adapters.value(adapter) != powered) {
+        m_adapters.insert(adapter, powered);
+        Q_EMIT poweredChanged(adapter, powered);
+    }
+}
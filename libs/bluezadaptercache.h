@@ -0,0 +1,85 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef PLASMA_NM_BLUEZ_ADAPTER_CACHE_H
+#define PLASMA_NM_BLUEZ_ADAPTER_CACHE_H
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusObjectPath>
+#include <QDBusServiceWatcher>
+#include <QMap>
+#include <QStringList>
+
+#include <NetworkManagerQt/GenericTypes>
+
+/**
+ * Bluetooth adapters of bluez and whether they are powered, loaded with one
+ * GetManagedObjects call and kept up to date from the signals of bluez, so
+ * toggling them doesn't need to query anything first.
+ */
+class Q_DECL_EXPORT BluezAdapterCache : public QObject
+{
+    Q_OBJECT
+public:
+    BluezAdapterCache(const QDBusConnection &connection, const QString &service, QObject *parent = nullptr);
+    ~BluezAdapterCache() override;
+
+    bool isLoaded() const;
+
+    /**
+     * Paths of the adapters, sorted
+     */
+    QStringList adapters() const;
+    bool isPowered(const QString &adapter) const;
+
+    /**
+     * Sets Powered of all @p adapters, the calls are sent at once without
+     * waiting for each other. poweredSet() is emitted once all of them are answered.
+     */
+    void setPowered(const QStringList &adapters, bool powered);
+
+Q_SIGNALS:
+    void loaded();
+    void adaptersChanged();
+    void poweredChanged(const QString &adapter, bool powered);
+    void poweredSet();
+
+private Q_SLOTS:
+    void load();
+    void unload();
+    void interfacesAdded(const QDBusObjectPath &path, const NMVariantMapMap &interfaces);
+    void interfacesRemoved(const QDBusObjectPath &path, const QStringList &interfaces);
+    void propertiesChanged(const QString &interface, const QVariantMap &changed, const QStringList &invalidated, const QDBusMessage &message);
+
+private:
+    void updatePowered(const QString &adapter, bool powered);
+
+    QDBusConnection m_connection;
+    QString m_service;
+    QDBusServiceWatcher m_serviceWatcher;
+    // Powered state by adapter path
+    QMap<QString, bool> m_adapters;
+    bool m_loaded = false;
+    int m_pendingCalls = 0;
+};
+
+#endif // PLASMA_NM_BLUEZ_ADAPTER_CACHE_H
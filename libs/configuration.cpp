@@ -195,3 +195,26 @@ bool Configuration::showPasswordDialog()
     return true;
 }
 
+int Configuration::notificationBurstLimit()
+{
+    KSharedConfigPtr config = KSharedConfig::openConfig(QLatin1String("plasma-nm"));
+    KConfigGroup grp(config, QLatin1String("Notifications"));
+
+    if (grp.isValid()) {
+        return grp.readEntry(QLatin1String("BurstLimit"), 3);
+    }
+
+    return 3;
+}
+
+int Configuration::notificationWindowMs()
+{
+    KSharedConfigPtr config = KSharedConfig::openConfig(QLatin1String("plasma-nm"));
+    KConfigGroup grp(config, QLatin1String("Notifications"));
+
+    if (grp.isValid()) {
+        return grp.readEntry(QLatin1String("WindowMs"), 30000);
+    }
+
+    return 30000;
+}
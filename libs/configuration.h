@@ -57,6 +57,10 @@ public:
     static void setHotspotConnectionPath(const QString &path);
 
     static bool showPasswordDialog();
+
+    // Notifications per device or connection within the window, later ones are collapsed
+    static int notificationBurstLimit();
+    static int notificationWindowMs();
 };
 
 #endif // PLAMA_NM_CONFIGURATION_H
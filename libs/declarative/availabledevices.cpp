@@ -19,6 +19,9 @@
 */
 
 #include "availabledevices.h"
+#include "networkmanagerloader.h"
+
+#include <QVector>
 
 #include <NetworkManagerQt/Manager>
 
@@ -29,14 +32,31 @@ AvailableDevices::AvailableDevices(QObject* parent)
     , m_modemDeviceAvailable(false)
     , m_bluetoothDeviceAvailable(false)
 {
-    for (const NetworkManager::Device::Ptr &device : NetworkManager::networkInterfaces()) {
-        if (device->type() == NetworkManager::Device::Modem) {
+    // Only the device types are needed, read them from the startup snapshot if possible
+    QVector<NetworkManager::Device::Type> types;
+    NetworkManagerLoader *loader = NetworkManagerLoader::self();
+    if (loader->isLoaded()) {
+        for (const QString &path : loader->objects(QStringLiteral(NM_DBUS_INTERFACE_DEVICE))) {
+            const QVariantMap properties = loader->properties(path, QStringLiteral(NM_DBUS_INTERFACE_DEVICE));
+            // Placeholders of devices which don't exist yet aren't listed as network interfaces
+            if (properties.value(QStringLiteral("Real"), true).toBool()) {
+                types << static_cast<NetworkManager::Device::Type>(properties.value(QStringLiteral("DeviceType")).toUInt());
+            }
+        }
+    } else {
+        for (const NetworkManager::Device::Ptr &device : NetworkManager::networkInterfaces()) {
+            types << device->type();
+        }
+    }
+
+    for (NetworkManager::Device::Type type : types) {
+        if (type == NetworkManager::Device::Modem) {
             m_modemDeviceAvailable = true;
-        } else if (device->type() == NetworkManager::Device::Wifi) {
+        } else if (type == NetworkManager::Device::Wifi) {
             m_wirelessDeviceAvailable = true;
-        } else if (device->type() == NetworkManager::Device::Ethernet) {
+        } else if (type == NetworkManager::Device::Ethernet) {
             m_wiredDeviceAvailable = true;
-        } else if (device->type() == NetworkManager::Device::Bluetooth) {
+        } else if (type == NetworkManager::Device::Bluetooth) {
             m_bluetoothDeviceAvailable = true;
         }
     }
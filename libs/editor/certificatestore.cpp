@@ -0,0 +1,87 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "certificatestore.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <KLocalizedString>
+
+CertificateStore::CertificateStore(const QString &directory)
+    : m_directory(directory)
+{
+    if (!m_directory.endsWith(QLatin1Char('/'))) {
+        m_directory += QLatin1Char('/');
+    }
+}
+
+QString CertificateStore::directory() const
+{
+    return m_directory;
+}
+
+QString CertificateStore::store(const QByteArray &contents, const QString &suffix)
+{
+    QString fileName = QString::fromLatin1(QCryptographicHash::hash(contents, QCryptographicHash::Sha256).toHex());
+    if (!suffix.isEmpty()) {
+        fileName += QLatin1Char('.') + suffix;
+    }
+
+    const QString absoluteFilePath = m_directory + fileName;
+    if (m_storedFiles.contains(fileName)) {
+        return absoluteFilePath;
+    }
+
+    // Stored by an earlier import, a file of another size has been damaged and is replaced
+    const QFileInfo info(absoluteFilePath);
+    if (!info.exists() || info.size() != contents.size()) {
+        QDir().mkpath(m_directory);
+
+        QSaveFile file(absoluteFilePath);
+        if (!file.open(QIODevice::WriteOnly) || file.write(contents) != contents.size() || !file.commit()) {
+            m_errorString = i18n("Error saving file %1: %2", absoluteFilePath, file.errorString());
+            return QString();
+        }
+    }
+
+    m_storedFiles.insert(fileName);
+    return absoluteFilePath;
+}
+
+QString CertificateStore::storeFile(const QString &sourceFilePath)
+{
+    QFile sourceFile(sourceFilePath);
+    if (!sourceFile.open(QIODevice::ReadOnly)) {
+        m_errorString = i18n("Error reading file %1: %2", sourceFilePath, sourceFile.errorString());
+        return QString();
+    }
+
+    return store(sourceFile.readAll(), QFileInfo(sourceFilePath).suffix());
+}
+
+QString CertificateStore::errorString() const
+{
+    return m_errorString;
+}
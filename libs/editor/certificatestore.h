@@ -0,0 +1,63 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef PLASMA_NM_CERTIFICATE_STORE_H
+#define PLASMA_NM_CERTIFICATE_STORE_H
+
+#include <QByteArray>
+#include <QSet>
+#include <QString>
+
+/**
+ * Directory imported certificates and keys are stored in. Each file is named
+ * after the SHA-256 of its content, so material shared by many connections,
+ * like the CA of a VPN provider, is written to the disk only once and all the
+ * connections refer to the same file.
+ */
+class Q_DECL_EXPORT CertificateStore
+{
+public:
+    explicit CertificateStore(const QString &directory);
+
+    QString directory() const;
+
+    /**
+     * Store @p contents unless a file with the same content is stored already
+     * and return the absolute path of the file. The @p suffix, without the dot,
+     * is appended to the file name. Returns an empty string on failure, see
+     * errorString().
+     */
+    QString store(const QByteArray &contents, const QString &suffix);
+    /**
+     * Store the content of the local file @p sourceFilePath, see store().
+     */
+    QString storeFile(const QString &sourceFilePath);
+
+    QString errorString() const;
+
+private:
+    QString m_directory;
+    QString m_errorString;
+    // Names of the files known to be stored, no need to look at the disk for them
+    QSet<QString> m_storedFiles;
+};
+
+#endif // PLASMA_NM_CERTIFICATE_STORE_H
@@ -0,0 +1,48 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "listvalidationcache.h"
+
+void ListValidationCache::clear()
+{
+    m_text.clear();
+    m_items.clear();
+    m_invalidCount = 0;
+    m_intermediateCount = 0;
+}
+
+QValidator::State ListValidationCache::lastState() const
+{
+    if (m_items.isEmpty()) {
+        return QValidator::Acceptable;
+    }
+
+    return m_items.last().state;
+}
+
+void ListValidationCache::count(QValidator::State state, int difference)
+{
+    if (state == QValidator::Invalid) {
+        m_invalidCount += difference;
+    } else if (state == QValidator::Intermediate) {
+        m_intermediateCount += difference;
+    }
+}
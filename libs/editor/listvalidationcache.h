@@ -0,0 +1,145 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LISTVALIDATIONCACHE_H
+#define LISTVALIDATIONCACHE_H
+
+#include <QValidator>
+#include <QVector>
+
+#include <algorithm>
+
+/**
+ * Validation results of the comma separated items of the text a list validator
+ * has seen last. On the next validation the text is compared with the previous
+ * one and only the items touched by the edit, including the items next to it,
+ * are validated again.
+ */
+class Q_DECL_EXPORT ListValidationCache
+{
+public:
+    struct Item {
+        int start;
+        // Position of the comma following the item or the end of the text
+        int end;
+        QValidator::State state;
+    };
+
+    /** Bring the items up to date with the text. The @p validateItem function is
+     *  called as validateItem(text, start, end) for items which have changed. It
+     *  returns the state of text[start, end) and may rewrite the item, in which
+     *  case it updates @p end.
+     */
+    template<typename ValidateItem>
+    void update(QString &text, ValidateItem validateItem);
+
+    void clear();
+
+    int invalidCount() const { return m_invalidCount; }
+    int intermediateCount() const { return m_intermediateCount; }
+    QValidator::State lastState() const;
+
+private:
+    void count(QValidator::State state, int difference);
+
+    QString m_text;
+    QVector<Item> m_items;
+    int m_invalidCount = 0;
+    int m_intermediateCount = 0;
+};
+
+template<typename ValidateItem>
+void ListValidationCache::update(QString &text, ValidateItem validateItem)
+{
+    const int oldLength = m_text.size();
+    const int newLength = text.size();
+    int first = 0;
+    int last = -1;
+    int from = 0;
+    int to = newLength;
+
+    if (!m_items.isEmpty()) {
+        // Find the edited range, comparing is much cheaper than validating
+        const QChar *oldData = m_text.constData();
+        const QChar *newData = text.constData();
+        const int shorter = qMin(oldLength, newLength);
+        int prefix = 0;
+        while (prefix < shorter && oldData[prefix] == newData[prefix]) {
+            ++prefix;
+        }
+        if (prefix == oldLength && prefix == newLength) {
+            return;
+        }
+        int suffix = 0;
+        while (suffix < shorter - prefix && oldData[oldLength - suffix - 1] == newData[newLength - suffix - 1]) {
+            ++suffix;
+        }
+        const int editEnd = oldLength - suffix;
+
+        // Items touching the edited range, the commas around it included
+        first = std::lower_bound(m_items.constBegin(), m_items.constEnd(), prefix, [] (const Item &item, int position) {
+            return item.end < position;
+        }) - m_items.constBegin();
+        last = std::upper_bound(m_items.constBegin(), m_items.constEnd(), editEnd, [] (int position, const Item &item) {
+            return position < item.start;
+        }) - m_items.constBegin() - 1;
+
+        from = m_items.at(first).start;
+        to = m_items.at(last).end + newLength - oldLength;
+    }
+
+    QVector<Item> items;
+    for (int start = from;;) {
+        int end = start;
+        while (end < to && text.at(end) != QLatin1Char(',')) {
+            ++end;
+        }
+
+        const int length = text.size();
+        const QValidator::State state = validateItem(text, start, end);
+        // The item might have been rewritten
+        to += text.size() - length;
+
+        items.append({start, end, state});
+        count(state, 1);
+
+        if (end >= to) {
+            break;
+        }
+        start = end + 1;
+    }
+
+    for (int i = first; i <= last; ++i) {
+        count(m_items.at(i).state, -1);
+    }
+
+    const int shift = text.size() - oldLength;
+    for (int i = last + 1; i < m_items.size(); ++i) {
+        m_items[i].start += shift;
+        m_items[i].end += shift;
+    }
+
+    m_items.remove(first, last - first + 1);
+    m_items.insert(first, items.size(), Item());
+    std::copy(items.constBegin(), items.constEnd(), m_items.begin() + first);
+    m_text = text;
+}
+
+#endif // LISTVALIDATIONCACHE_H
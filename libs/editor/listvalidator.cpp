@@ -21,8 +21,6 @@
 
 #include "listvalidator.h"
 
-#include <QStringList>
-
 ListValidator::ListValidator(QObject *parent)
     : QValidator(parent)
     , inner(nullptr)
@@ -38,32 +36,44 @@ QValidator::State ListValidator::validate(QString &text, int &pos) const
     Q_ASSERT(inner);
     Q_UNUSED(pos);
 
-    QStringList strings = text.split(QLatin1Char(','));
-    int unusedPos;
-    QValidator::State state = Acceptable;
-    for (QStringList::iterator i = strings.begin(); i != strings.end(); ++i) {
-        QString string = i->trimmed();
-        const int position = i->indexOf(string);
-        const int size = string.size();
-        const QValidator::State current = inner->validate(string, unusedPos);
-        i->replace(position, size, string);
-        if (current == Invalid) {
-            state = Invalid;
-            break;
+    // Items are handed to the inner validator as raw data of the text, they
+    // are only copied when the inner validator changes them
+    QString string;
+    m_cache.update(text, [this, &string] (QString &list, int start, int &end) {
+        int first = start;
+        int last = end;
+        while (first < last && list.at(first).isSpace()) {
+            ++first;
+        }
+        while (last > first && list.at(last - 1).isSpace()) {
+            --last;
         }
-        if (current == Intermediate) {
-            if (state == Intermediate) {
-                state = Invalid;
-                break;
-            }
-            state = Intermediate;
+        if (first == last) {
+            first = last = start;
         }
+
+        int unusedPos;
+        const QChar *item = list.constData() + first;
+        const int size = last - first;
+        string.setRawData(item, size);
+        const QValidator::State state = inner->validate(string, unusedPos);
+        if (string.constData() != item || string.size() != size) {
+            list.replace(first, size, string);
+            end += string.size() - size;
+        }
+        return state;
+    });
+
+    if (m_cache.invalidCount() > 0 || m_cache.intermediateCount() > 1) {
+        return Invalid;
+    } else if (m_cache.intermediateCount() == 1) {
+        return Intermediate;
     }
-    text = strings.join(QLatin1Char(','));
-    return state;
+    return Acceptable;
 }
 
 void ListValidator::setInnerValidator(QValidator *validator)
 {
     inner = validator;
+    m_cache.clear();
 }
@@ -24,6 +24,8 @@
 
 #include <QValidator>
 
+#include "listvalidationcache.h"
+
 /**
  * This class validates each string item with a validator.
  * String items are separated by comma.
@@ -41,6 +43,8 @@ public:
 
 private:
     QValidator *inner;
+    // Results of the items validated last time, only edited items are validated again
+    mutable ListValidationCache m_cache;
 };
 
 #endif // PLASMA_NM_LIST_VALIDATOR_H
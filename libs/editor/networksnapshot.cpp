@@ -0,0 +1,270 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "networksnapshot.h"
+
+#include <QCoreApplication>
+
+#include <NetworkManagerQt/BluetoothDevice>
+#include <NetworkManagerQt/BondDevice>
+#include <NetworkManagerQt/BridgeDevice>
+#include <NetworkManagerQt/InfinibandDevice>
+#include <NetworkManagerQt/Manager>
+#include <NetworkManagerQt/OlpcMeshDevice>
+#include <NetworkManagerQt/VlanDevice>
+#include <NetworkManagerQt/WiredDevice>
+#include <NetworkManagerQt/WirelessDevice>
+
+// Scan results and device changes tend to arrive in bursts, rebuild only once per burst
+#define NETWORK_SNAPSHOT_UPDATE_DELAY 250
+
+static NetworkSnapshot *s_networkSnapshot = nullptr;
+
+NetworkSnapshot *NetworkSnapshot::self()
+{
+    if (!s_networkSnapshot) {
+        s_networkSnapshot = new NetworkSnapshot(QCoreApplication::instance());
+    }
+
+    return s_networkSnapshot;
+}
+
+NetworkSnapshot::NetworkSnapshot(QObject *parent)
+    : QObject(parent)
+{
+    m_networksTimer.setSingleShot(true);
+    m_networksTimer.setInterval(NETWORK_SNAPSHOT_UPDATE_DELAY);
+    connect(&m_networksTimer, &QTimer::timeout, this, &NetworkSnapshot::updateNetworks);
+
+    m_devicesTimer.setSingleShot(true);
+    m_devicesTimer.setInterval(NETWORK_SNAPSHOT_UPDATE_DELAY);
+    connect(&m_devicesTimer, &QTimer::timeout, this, &NetworkSnapshot::updateDevices);
+
+    connect(NetworkManager::notifier(), &NetworkManager::Notifier::deviceAdded, this, &NetworkSnapshot::deviceAdded);
+    connect(NetworkManager::notifier(), &NetworkManager::Notifier::deviceRemoved, this, &NetworkSnapshot::scheduleNetworksUpdate);
+    connect(NetworkManager::notifier(), &NetworkManager::Notifier::deviceRemoved, this, &NetworkSnapshot::scheduleDevicesUpdate);
+
+    for (const NetworkManager::Device::Ptr &device : NetworkManager::networkInterfaces()) {
+        watchDevice(device);
+    }
+
+    updateNetworks();
+    updateDevices();
+}
+
+QVector<NetworkSnapshot::Network> NetworkSnapshot::networks() const
+{
+    return m_networks;
+}
+
+QVector<NetworkSnapshot::AccessPoint> NetworkSnapshot::accessPoints(const QString &ssid) const
+{
+    const int index = m_networkIndex.value(ssid, -1);
+    if (index < 0) {
+        return {};
+    }
+
+    return m_networks.at(index).accessPoints;
+}
+
+QVector<NetworkSnapshot::Device> NetworkSnapshot::devices(NetworkManager::Device::Type type) const
+{
+    QVector<Device> result;
+
+    for (const Device &device : m_devices) {
+        if (device.type == type) {
+            result << device;
+        }
+    }
+
+    return result;
+}
+
+void NetworkSnapshot::deviceAdded(const QString &uni)
+{
+    NetworkManager::Device::Ptr device = NetworkManager::findNetworkInterface(uni);
+    if (device) {
+        watchDevice(device);
+    }
+
+    scheduleNetworksUpdate();
+    scheduleDevicesUpdate();
+}
+
+void NetworkSnapshot::scheduleNetworksUpdate()
+{
+    if (!m_networksTimer.isActive()) {
+        m_networksTimer.start();
+    }
+}
+
+void NetworkSnapshot::scheduleDevicesUpdate()
+{
+    if (!m_devicesTimer.isActive()) {
+        m_devicesTimer.start();
+    }
+}
+
+void NetworkSnapshot::watchDevice(const NetworkManager::Device::Ptr &device)
+{
+    // Interface name shown in HwAddrComboBox depends on the device state
+    connect(device.data(), &NetworkManager::Device::stateChanged, this, &NetworkSnapshot::scheduleDevicesUpdate, Qt::UniqueConnection);
+
+    if (device->type() == NetworkManager::Device::Wifi) {
+        NetworkManager::WirelessDevice::Ptr wifiDevice = device.objectCast<NetworkManager::WirelessDevice>();
+        connect(wifiDevice.data(), &NetworkManager::WirelessDevice::networkAppeared, this, &NetworkSnapshot::scheduleNetworksUpdate, Qt::UniqueConnection);
+        connect(wifiDevice.data(), &NetworkManager::WirelessDevice::networkDisappeared, this, &NetworkSnapshot::scheduleNetworksUpdate, Qt::UniqueConnection);
+        connect(wifiDevice.data(), &NetworkManager::WirelessDevice::accessPointAppeared, this, &NetworkSnapshot::scheduleNetworksUpdate, Qt::UniqueConnection);
+        connect(wifiDevice.data(), &NetworkManager::WirelessDevice::accessPointDisappeared, this, &NetworkSnapshot::scheduleNetworksUpdate, Qt::UniqueConnection);
+        connect(wifiDevice.data(), &NetworkManager::WirelessDevice::lastScanChanged, this, &NetworkSnapshot::scheduleNetworksUpdate, Qt::UniqueConnection);
+    }
+}
+
+void NetworkSnapshot::updateNetworks()
+{
+    QVector<Network> networks;
+    QHash<QString, int> networkIndex;
+    // Per network index of access points, keyed by their BSSID
+    QVector<QHash<QString, int>> accessPointIndex;
+
+    for (const NetworkManager::Device::Ptr &device : NetworkManager::networkInterfaces()) {
+        if (device->type() != NetworkManager::Device::Wifi) {
+            continue;
+        }
+
+        NetworkManager::WirelessDevice::Ptr wifiDevice = device.objectCast<NetworkManager::WirelessDevice>();
+        const NetworkManager::WirelessDevice::Capabilities wirelessCapabilities = wifiDevice->wirelessCapabilities();
+        const bool adhoc = wifiDevice->mode() == NetworkManager::WirelessDevice::Adhoc;
+
+        for (const NetworkManager::WirelessNetwork::Ptr &wifiNetwork : wifiDevice->networks()) {
+            NetworkManager::AccessPoint::Ptr referenceAp = wifiNetwork->referenceAccessPoint();
+            if (!referenceAp) {
+                continue;
+            }
+
+            const QString ssid = wifiNetwork->ssid();
+            const int signalStrength = wifiNetwork->signalStrength();
+
+            int index = networkIndex.value(ssid, -1);
+            if (index < 0) {
+                index = networks.count();
+                networkIndex.insert(ssid, index);
+                networks.append(Network());
+                accessPointIndex.append(QHash<QString, int>());
+                networks[index].ssid = ssid;
+                networks[index].signalStrength = -1;
+            }
+
+            Network &network = networks[index];
+
+            // Keep properties of the strongest occurrence of the network
+            if (signalStrength > network.signalStrength) {
+                network.signalStrength = signalStrength;
+                network.bestBssid = referenceAp->hardwareAddress();
+                network.frequency = referenceAp->frequency();
+                network.securityType = NetworkManager::findBestWirelessSecurity(wirelessCapabilities, true, adhoc,
+                                                                                referenceAp->capabilities(), referenceAp->wpaFlags(), referenceAp->rsnFlags());
+            }
+
+            QHash<QString, int> &apIndex = accessPointIndex[index];
+            for (const NetworkManager::AccessPoint::Ptr &ap : wifiNetwork->accessPoints()) {
+                AccessPoint accessPoint;
+                accessPoint.bssid = ap->hardwareAddress();
+                accessPoint.signalStrength = ap->signalStrength();
+                accessPoint.frequency = ap->frequency();
+
+                const int existing = apIndex.value(accessPoint.bssid, -1);
+                if (existing < 0) {
+                    apIndex.insert(accessPoint.bssid, network.accessPoints.count());
+                    network.accessPoints.append(accessPoint);
+                } else if (accessPoint.signalStrength > network.accessPoints.at(existing).signalStrength) {
+                    network.accessPoints[existing] = accessPoint;
+                }
+            }
+        }
+    }
+
+    for (Network &network : networks) {
+        std::sort(network.accessPoints.begin(), network.accessPoints.end(), [] (const AccessPoint &one, const AccessPoint &two) {
+            return one.signalStrength > two.signalStrength;
+        });
+    }
+    std::sort(networks.begin(), networks.end(), [] (const Network &one, const Network &two) {
+        return one.signalStrength > two.signalStrength;
+    });
+
+    m_networkIndex.clear();
+    for (int i = 0; i < networks.count(); ++i) {
+        m_networkIndex.insert(networks.at(i).ssid, i);
+    }
+    m_networks = networks;
+
+    Q_EMIT networksChanged();
+}
+
+void NetworkSnapshot::updateDevices()
+{
+    QVector<Device> devices;
+
+    for (const NetworkManager::Device::Ptr &device : NetworkManager::networkInterfaces()) {
+        Device entry;
+        entry.hwAddress = hwAddressFromDevice(device);
+        if (entry.hwAddress.isEmpty()) {
+            continue;
+        }
+
+        entry.type = device->type();
+        if (device->state() == NetworkManager::Device::Activated) {
+            entry.name = device->ipInterfaceName();
+        } else {
+            entry.name = device->interfaceName();
+        }
+        devices << entry;
+    }
+
+    m_devices = devices;
+
+    Q_EMIT devicesChanged();
+}
+
+QString NetworkSnapshot::hwAddressFromDevice(const NetworkManager::Device::Ptr &device)
+{
+    const NetworkManager::Device::Type type = device->type();
+
+    if (type == NetworkManager::Device::Ethernet) {
+        return device->as<NetworkManager::WiredDevice>()->permanentHardwareAddress();
+    } else if (type == NetworkManager::Device::Wifi) {
+        return device->as<NetworkManager::WirelessDevice>()->permanentHardwareAddress();
+    } else if (type == NetworkManager::Device::Bluetooth) {
+        return device->as<NetworkManager::BluetoothDevice>()->hardwareAddress();
+    } else if (type == NetworkManager::Device::OlpcMesh) {
+        return device->as<NetworkManager::OlpcMeshDevice>()->hardwareAddress();
+    } else if (type == NetworkManager::Device::InfiniBand) {
+        return device->as<NetworkManager::InfinibandDevice>()->hwAddress();
+    } else if (type == NetworkManager::Device::Bond) {
+        return device->as<NetworkManager::BondDevice>()->hwAddress();
+    } else if (type == NetworkManager::Device::Bridge) {
+        return device->as<NetworkManager::BridgeDevice>()->hwAddress();
+    } else if (type == NetworkManager::Device::Vlan) {
+        return device->as<NetworkManager::VlanDevice>()->hwAddress();
+    }
+
+    return QString();
+}
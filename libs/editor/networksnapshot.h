@@ -0,0 +1,107 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PLASMA_NM_NETWORK_SNAPSHOT_H
+#define PLASMA_NM_NETWORK_SNAPSHOT_H
+
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+#include <NetworkManagerQt/Device>
+#include <NetworkManagerQt/Utils>
+
+/**
+ * Shared, signal-maintained view of the visible wireless networks and of the
+ * hardware addresses of all network devices.
+ *
+ * SsidComboBox, BssidComboBox and HwAddrComboBox used to walk every device,
+ * network and access point on their own. They now read this snapshot, which
+ * is rebuilt once per burst of NetworkManager changes and shared by all editors.
+ */
+class Q_DECL_EXPORT NetworkSnapshot : public QObject
+{
+    Q_OBJECT
+public:
+    struct AccessPoint {
+        QString bssid;
+        int signalStrength = 0;
+        uint frequency = 0;
+    };
+
+    struct Network {
+        QString ssid;
+        QString bestBssid;
+        int signalStrength = 0;
+        uint frequency = 0;
+        NetworkManager::WirelessSecurityType securityType = NetworkManager::UnknownSecurity;
+        // Sorted by signal strength, strongest first
+        QVector<AccessPoint> accessPoints;
+    };
+
+    struct Device {
+        NetworkManager::Device::Type type = NetworkManager::Device::UnknownType;
+        QString hwAddress;
+        QString name;
+    };
+
+    static NetworkSnapshot *self();
+
+    /**
+     * Visible networks, one per SSID and sorted by signal strength, strongest first
+     */
+    QVector<Network> networks() const;
+
+    /**
+     * Access points of the given network, merged from all wireless devices
+     */
+    QVector<AccessPoint> accessPoints(const QString &ssid) const;
+
+    /**
+     * Devices of the given type which have a hardware address
+     */
+    QVector<Device> devices(NetworkManager::Device::Type type) const;
+
+Q_SIGNALS:
+    void networksChanged();
+    void devicesChanged();
+
+private Q_SLOTS:
+    void deviceAdded(const QString &uni);
+    void scheduleNetworksUpdate();
+    void scheduleDevicesUpdate();
+    void updateNetworks();
+    void updateDevices();
+
+private:
+    explicit NetworkSnapshot(QObject *parent = nullptr);
+
+    void watchDevice(const NetworkManager::Device::Ptr &device);
+    static QString hwAddressFromDevice(const NetworkManager::Device::Ptr &device);
+
+    QVector<Network> m_networks;
+    QHash<QString, int> m_networkIndex;
+    QVector<Device> m_devices;
+    QTimer m_networksTimer;
+    QTimer m_devicesTimer;
+};
+
+#endif // PLASMA_NM_NETWORK_SNAPSHOT_H
@@ -30,6 +30,7 @@
 #include <QFileInfo>
 #include <QPointer>
 #include <QStandardItemModel>
+#include <QTextStream>
 
 #include <NetworkManagerQt/Utils>
 #include <NetworkManagerQt/WireguardSetting>
@@ -59,6 +60,9 @@
 #define PNM_WG_CONF_TAG_PRE_DOWN             "PreDown"
 #define PNM_WG_CONF_TAG_POST_DOWN            "PostDown"
 
+// Size of "[Peer]\nPublicKey=<44 characters>\nAllowedIPs=::/0\n", the smallest valid peer section
+#define PNM_WG_CONF_MIN_PEER_SECTION_SIZE    78
+
 #define PNM_WG_KEY_PEERS             "peers"
 #define PNM_WG_KEY_MTU               "mtu"
 #define PNM_WG_KEY_PEER_ROUTES       "peer-routes"
@@ -401,18 +405,13 @@ NMVariantMapMap WireGuardInterfaceWidget::importConnectionSettings(const QString
     }
 
     const QString connectionName = QFileInfo(fileName).completeBaseName();
-    NMStringMap dataMap;
     NMVariantMapList peers;
-    QVariantMap ipv4Data;
     QVariantMap *currentPeer = nullptr;
-    WireGuardKeyValidator keyValidator;
+    SimpleIpListValidator allowedIpsValidator(SimpleIpListValidator::WithCidr, SimpleIpListValidator::Both);
     NetworkManager::Ipv4Setting ipv4Setting;
     NetworkManager::Ipv6Setting ipv6Setting;
     NetworkManager::WireGuardSetting wgSetting;
 
-    QString proxyType;
-    QString proxyUser;
-    QString proxyPasswd;
     bool havePrivateKey = false;
     bool haveIpv4Setting = false;
     bool haveIpv6Setting = false;
@@ -421,7 +420,10 @@ NMVariantMapMap WireGuardInterfaceWidget::importConnectionSettings(const QString
     // first [Peer] section below
     bool havePublicKey = true;
     bool haveAllowedIps = true;
-    int pos = 0;
+
+    // Mesh configurations can have thousands of peers, no section can be
+    // smaller than a [Peer] header with a public key and an allowed IP
+    peers.reserve(int(impFile.size() / PNM_WG_CONF_MIN_PEER_SECTION_SIZE));
 
     QTextStream in(&impFile);
     enum {IDLE, INTERFACE_SECTION, PEER_SECTION} currentState = IDLE;
@@ -429,25 +431,23 @@ NMVariantMapMap WireGuardInterfaceWidget::importConnectionSettings(const QString
     ipv4Setting.setMethod(NetworkManager::Ipv4Setting::Disabled);
     ipv6Setting.setMethod(NetworkManager::Ipv6Setting::Ignored);
 
-    while (!in.atEnd()) {
-        QStringList keyValue;
-        QString line = in.readLine();
-
+    QString line;
+    while (in.readLineInto(&line)) {
         // Remove comments starting with '#'
-        if (int index = line.indexOf('#') > 0)
-            line.truncate(index);
+        const int commentIndex = line.indexOf(QLatin1Char('#'));
+        if (commentIndex >= 0)
+            line.truncate(commentIndex);
+
+        const QStringRef trimmedLine = line.midRef(0).trimmed();
 
         // Ignore blank lines
-        if (line.isEmpty())
+        if (trimmedLine.isEmpty())
             continue;
 
-        keyValue.clear();
-        keyValue << line.split('=');
-
-        if (keyValue[0] == PNM_WG_CONF_TAG_INTERFACE) {
+        if (trimmedLine == QLatin1String(PNM_WG_CONF_TAG_INTERFACE)) {
             currentState = INTERFACE_SECTION;
             continue;
-        } else if (keyValue[0] == PNM_WG_CONF_TAG_PEER) {
+        } else if (trimmedLine == QLatin1String(PNM_WG_CONF_TAG_PEER)) {
             // Check to make sure the previous PEER section has
             // all the required elements. If not it's an error
             // so just return the empty result.
@@ -457,36 +457,36 @@ NMVariantMapMap WireGuardInterfaceWidget::importConnectionSettings(const QString
                 havePublicKey = false;
                 haveAllowedIps = false;
                 currentState = PEER_SECTION;
-                peers.append(*(new QVariantMap));
-                currentPeer = &peers[peers.size() - 1];
+                peers.append(QVariantMap());
+                currentPeer = &peers.last();
                 continue;
             }
         }
 
         // If we didn't get an '=' sign in the line, it's probably an error but
         // we're going to treat it as a comment and ignore it
-        if (keyValue.length() < 2)
+        const int separator = line.indexOf(QLatin1Char('='));
+        if (separator < 0)
             continue;
 
-        QString key = keyValue[0].trimmed();
+        // WireGuard keys end in '=', the value is everything after the first one
+        const QStringRef key = line.leftRef(separator).trimmed();
+        const QString value = line.mid(separator + 1).trimmed();
 
         // If we are in the [Interface] section look for the possible tags
         if (currentState == INTERFACE_SECTION) {
             // Address
-            if (key == PNM_WG_CONF_TAG_ADDRESS) {
-                QStringList valueList = keyValue[1].split(',');
-                if (valueList.isEmpty())
-                    return result;
-
-                for (const QString &address : valueList) {
-                    const QPair<QHostAddress, int> addressIn = QHostAddress::parseSubnet(address.trimmed());
-                    NetworkManager::IpAddress *addr = new NetworkManager::IpAddress;
-                    addr->setIp(addressIn.first);
-                    addr->setPrefixLength(addressIn.second);
+            if (key == QLatin1String(PNM_WG_CONF_TAG_ADDRESS)) {
+                const QVector<QStringRef> valueList = value.splitRef(QLatin1Char(','));
+                for (const QStringRef &address : valueList) {
+                    const QPair<QHostAddress, int> addressIn = QHostAddress::parseSubnet(address.trimmed().toString());
+                    NetworkManager::IpAddress addr;
+                    addr.setIp(addressIn.first);
+                    addr.setPrefixLength(addressIn.second);
                     if (addressIn.first.protocol() == QAbstractSocket::NetworkLayerProtocol::IPv4Protocol) {
-                        ipv4AddressList.append(*addr);
+                        ipv4AddressList.append(addr);
                     } else if (addressIn.first.protocol() == QAbstractSocket::NetworkLayerProtocol::IPv6Protocol) {
-                        ipv6AddressList.append(*addr);
+                        ipv6AddressList.append(addr);
                     } else { // Error condition
                         return result;
                     }
@@ -504,36 +504,27 @@ NMVariantMapMap WireGuardInterfaceWidget::importConnectionSettings(const QString
             }
 
             // Listen Port
-            else if (key == PNM_WG_CONF_TAG_LISTEN_PORT) {
-                uint val = keyValue[1].toUInt();
+            else if (key == QLatin1String(PNM_WG_CONF_TAG_LISTEN_PORT)) {
+                uint val = value.toUInt();
                 if (val <= 65535)
                     wgSetting.setListenPort(val);
-            } else if (key == PNM_WG_CONF_TAG_PRIVATE_KEY) {
-                QString val = keyValue[1].trimmed();
-                // WireGuard keys present a slight problem because they
-                // must end in '=' which is removed during the 'split' above
-                // so if there are 3 parts and the 3 is empty, there must
-                // have been an '=' so add it back on
-                if (keyValue.size() == 3 && keyValue[2].isEmpty())
-                    val += "=";
-                if (QValidator::Acceptable == keyValidator.validate(val, pos)) {
-                    wgSetting.setPrivateKey(val);
+            } else if (key == QLatin1String(PNM_WG_CONF_TAG_PRIVATE_KEY)) {
+                if (WireGuardKeyValidator::isValidKey(value)) {
+                    wgSetting.setPrivateKey(value);
                     havePrivateKey = true;
                 }
-            } else if (key == PNM_WG_CONF_TAG_DNS) {
-                QStringList addressList = keyValue[1].split(',');
+            } else if (key == QLatin1String(PNM_WG_CONF_TAG_DNS)) {
+                const QVector<QStringRef> addressList = value.splitRef(QLatin1Char(','));
                 QList<QHostAddress> ipv4DnsList;
                 QList<QHostAddress> ipv6DnsList;
-                if (!addressList.isEmpty()) {
-                    for (const QString &address : addressList) {
-                        const QPair<QHostAddress, int> addressIn = QHostAddress::parseSubnet(address.trimmed());
-                        if (addressIn.first.protocol() == QAbstractSocket::NetworkLayerProtocol::IPv4Protocol) {
-                            ipv4DnsList.append(addressIn.first);
-                        } else if (addressIn.first.protocol() == QAbstractSocket::NetworkLayerProtocol::IPv6Protocol) {
-                            ipv6DnsList.append(addressIn.first);
-                        } else { // Error condition
-                            return result;
-                        }
+                for (const QStringRef &address : addressList) {
+                    const QPair<QHostAddress, int> addressIn = QHostAddress::parseSubnet(address.trimmed().toString());
+                    if (addressIn.first.protocol() == QAbstractSocket::NetworkLayerProtocol::IPv4Protocol) {
+                        ipv4DnsList.append(addressIn.first);
+                    } else if (addressIn.first.protocol() == QAbstractSocket::NetworkLayerProtocol::IPv6Protocol) {
+                        ipv6DnsList.append(addressIn.first);
+                    } else { // Error condition
+                        return result;
                     }
                 }
 
@@ -553,22 +544,22 @@ NMVariantMapMap WireGuardInterfaceWidget::importConnectionSettings(const QString
                     ipv6Setting.setDns(ipv6DnsList);
                     haveIpv6Setting = true;
                 }
-            } else if (key == PNM_WG_CONF_TAG_MTU) {
-                uint val = keyValue[1].toUInt();
+            } else if (key == QLatin1String(PNM_WG_CONF_TAG_MTU)) {
+                uint val = value.toUInt();
                 if (val > 0)
                     wgSetting.setMtu(val);
-            } else if (key == PNM_WG_CONF_TAG_FWMARK) {
+            } else if (key == QLatin1String(PNM_WG_CONF_TAG_FWMARK)) {
                 uint val;
-                if (keyValue[1].trimmed().toLower() == QLatin1String("off"))
+                if (value.toLower() == QLatin1String("off"))
                     val = 0;
                 else
-                    val = keyValue[1].toUInt();
+                    val = value.toUInt();
                 wgSetting.setFwmark(val);
-            } else if (key == PNM_WG_CONF_TAG_TABLE
-                     || key == PNM_WG_CONF_TAG_PRE_UP
-                     || key == PNM_WG_CONF_TAG_POST_UP
-                     || key == PNM_WG_CONF_TAG_PRE_DOWN
-                     || key == PNM_WG_CONF_TAG_POST_DOWN) {
+            } else if (key == QLatin1String(PNM_WG_CONF_TAG_TABLE)
+                     || key == QLatin1String(PNM_WG_CONF_TAG_PRE_UP)
+                     || key == QLatin1String(PNM_WG_CONF_TAG_POST_UP)
+                     || key == QLatin1String(PNM_WG_CONF_TAG_PRE_DOWN)
+                     || key == QLatin1String(PNM_WG_CONF_TAG_POST_DOWN)) {
                 // plasma-nm does not handle these items
             } else {
                 // We got a wrong field in the Interface section so it
@@ -577,51 +568,41 @@ NMVariantMapMap WireGuardInterfaceWidget::importConnectionSettings(const QString
             }
         } else if (currentState == PEER_SECTION) {
             // Public Key
-            if (key == PNM_WG_CONF_TAG_PUBLIC_KEY) {
-                QString val = keyValue[1].trimmed();
-                // WireGuard keys present a slight problem because they
-                // must end in '=' which is removed during the 'split' above
-                // so if there are 3 parts and the 3 is empty, there must
-                // have been an '=' so add it back on
-                if (keyValue.size() == 3 && keyValue[2].isEmpty())
-                    val += "=";
-
-                if (QValidator::Acceptable == keyValidator.validate(val, pos)) {
-                    currentPeer->insert(PNM_WG_PEER_KEY_PUBLIC_KEY, val);
+            if (key == QLatin1String(PNM_WG_CONF_TAG_PUBLIC_KEY)) {
+                if (WireGuardKeyValidator::isValidKey(value)) {
+                    currentPeer->insert(PNM_WG_PEER_KEY_PUBLIC_KEY, value);
                     havePublicKey = true;
                 }
-            } else if (key == PNM_WG_CONF_TAG_ALLOWED_IPS) {
-                SimpleIpListValidator validator(SimpleIpListValidator::WithCidr, SimpleIpListValidator::Both);
-                QString val = keyValue[1].trimmed();
-                if (QValidator::Acceptable == validator.validate(val, pos))
-                {
-                    QStringList valList = val.split(',');
-                    for (QString& str : valList)
-                        str = str.trimmed();
-                    currentPeer->insert(PNM_WG_PEER_KEY_ALLOWED_IPS, valList);
+            } else if (key == QLatin1String(PNM_WG_CONF_TAG_ALLOWED_IPS)) {
+                // Same as validating the whole list, but done while splitting it
+                const QVector<QStringRef> valueList = value.splitRef(QLatin1Char(','));
+                QStringList allowedIps;
+                allowedIps.reserve(valueList.size());
+                for (const QStringRef &address : valueList) {
+                    const QStringRef trimmedAddress = address.trimmed();
+                    if (allowedIpsValidator.validateAddress(trimmedAddress.constData(), trimmedAddress.size()) != QValidator::Acceptable) {
+                        allowedIps.clear();
+                        break;
+                    }
+                    allowedIps << trimmedAddress.toString();
+                }
+                if (!allowedIps.isEmpty()) {
+                    currentPeer->insert(PNM_WG_PEER_KEY_ALLOWED_IPS, allowedIps);
                     haveAllowedIps = true;
                 }
-            } else if (key == PNM_WG_CONF_TAG_ENDPOINT) {
-                if (keyValue[1].length() > 0)
-                    currentPeer->insert(PNM_WG_PEER_KEY_ENDPOINT, keyValue[1].trimmed());
-            } else if (key == PNM_WG_CONF_TAG_PRESHARED_KEY) {
-                QString val = keyValue[1].trimmed();
-                // WireGuard keys present a slight problem because they
-                // must end in '=' which is removed during the 'split' above
-                // so if there are 3 parts and the 3 is empty, there must
-                // have been an '=' so add it back on
-                if (keyValue.size() == 3 && keyValue[2].isEmpty())
-                    val += "=";
-
-                if (QValidator::Acceptable == keyValidator.validate(val, pos)) {
-                    currentPeer->insert(PNM_WG_PEER_KEY_PRESHARED_KEY, val);
+            } else if (key == QLatin1String(PNM_WG_CONF_TAG_ENDPOINT)) {
+                if (!value.isEmpty())
+                    currentPeer->insert(PNM_WG_PEER_KEY_ENDPOINT, value);
+            } else if (key == QLatin1String(PNM_WG_CONF_TAG_PRESHARED_KEY)) {
+                if (WireGuardKeyValidator::isValidKey(value)) {
+                    currentPeer->insert(PNM_WG_PEER_KEY_PRESHARED_KEY, value);
                 }
             }
         } else {
             return result;
         }
     }
-    if (!havePrivateKey || !haveAllowedIps || !havePublicKey || !haveAllowedIps)
+    if (!havePrivateKey || !havePublicKey || !haveAllowedIps)
         return result;
 
     QVariantMap conn;
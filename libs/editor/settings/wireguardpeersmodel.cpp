@@ -0,0 +1,244 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "wireguardpeersmodel.h"
+#include "wireguardpeerwidget.h"
+#include "simpleiplistvalidator.h"
+#include "wireguardkeyvalidator.h"
+
+#include <KColorScheme>
+#include <KLocalizedString>
+
+#define PNM_WG_PEER_KEY_ALLOWED_IPS          "allowed-ips"
+#define PNM_WG_PEER_KEY_ENDPOINT             "endpoint"
+#define PNM_WG_PEER_KEY_PRESHARED_KEY        "preshared-key"
+#define PNM_WG_PEER_KEY_PRESHARED_KEY_FLAGS  "preshared-key-flags"
+#define PNM_WG_PEER_KEY_PUBLIC_KEY           "public-key"
+
+WireGuardPeersModel::WireGuardPeersModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_invalidForeground(KColorScheme(QPalette::Active, KColorScheme::View).foreground(KColorScheme::NegativeText))
+{
+}
+
+int WireGuardPeersModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_peers.size();
+}
+
+int WireGuardPeersModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant WireGuardPeersModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_peers.size()) {
+        return QVariant();
+    }
+
+    const QVariantMap &peer = m_peers.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case PublicKeyColumn:
+            return peer.value(QLatin1String(PNM_WG_PEER_KEY_PUBLIC_KEY));
+        case AllowedIpsColumn:
+            return peer.value(QLatin1String(PNM_WG_PEER_KEY_ALLOWED_IPS)).toStringList().join(QLatin1String(", "));
+        case EndpointColumn:
+            return peer.value(QLatin1String(PNM_WG_PEER_KEY_ENDPOINT));
+        }
+        break;
+    case Qt::ForegroundRole:
+        if (!m_valid.at(index.row())) {
+            return m_invalidForeground;
+        }
+        break;
+    case Qt::ToolTipRole:
+        if (!m_valid.at(index.row())) {
+            return i18n("The settings of this peer are not valid");
+        }
+        break;
+    case ValidRole:
+        return m_valid.at(index.row());
+    default:
+        break;
+    }
+
+    return QVariant();
+}
+
+QVariant WireGuardPeersModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    if (orientation == Qt::Vertical) {
+        return section + 1;
+    }
+
+    switch (section) {
+    case PublicKeyColumn:
+        return i18n("Public key");
+    case AllowedIpsColumn:
+        return i18n("Allowed IPs");
+    case EndpointColumn:
+        return i18n("Endpoint");
+    }
+
+    return QVariant();
+}
+
+NMVariantMapList WireGuardPeersModel::peers() const
+{
+    return m_peers;
+}
+
+void WireGuardPeersModel::setPeers(const NMVariantMapList &peers)
+{
+    beginResetModel();
+    m_peers = peers;
+    m_valid.resize(m_peers.size());
+    m_invalidCount = 0;
+    for (int i = 0; i < m_peers.size(); ++i) {
+        m_valid[i] = isPeerValid(m_peers.at(i));
+        if (!m_valid.at(i)) {
+            ++m_invalidCount;
+        }
+    }
+    endResetModel();
+
+    Q_EMIT validityChanged();
+}
+
+QVariantMap WireGuardPeersModel::peer(int row) const
+{
+    return m_peers.value(row);
+}
+
+void WireGuardPeersModel::setPeer(int row, const QVariantMap &peer)
+{
+    if (row < 0 || row >= m_peers.size()) {
+        return;
+    }
+
+    m_peers[row] = peer;
+    Q_EMIT dataChanged(index(row, 0), index(row, ColumnCount - 1));
+
+    const bool valid = isPeerValid(peer);
+    if (valid != m_valid.at(row)) {
+        m_valid[row] = valid;
+        m_invalidCount += valid ? -1 : 1;
+        Q_EMIT validityChanged();
+    }
+}
+
+void WireGuardPeersModel::appendPeer(const QVariantMap &peer)
+{
+    const bool valid = isPeerValid(peer);
+
+    beginInsertRows(QModelIndex(), m_peers.size(), m_peers.size());
+    m_peers.append(peer);
+    m_valid.append(valid);
+    endInsertRows();
+
+    if (!valid) {
+        ++m_invalidCount;
+        Q_EMIT validityChanged();
+    }
+}
+
+void WireGuardPeersModel::removePeer(int row)
+{
+    if (row < 0 || row >= m_peers.size()) {
+        return;
+    }
+
+    const bool valid = m_valid.at(row);
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_peers.removeAt(row);
+    m_valid.remove(row);
+    endRemoveRows();
+
+    if (!valid) {
+        --m_invalidCount;
+        Q_EMIT validityChanged();
+    }
+}
+
+bool WireGuardPeersModel::isValid(int row) const
+{
+    return m_valid.value(row);
+}
+
+bool WireGuardPeersModel::allValid() const
+{
+    return m_invalidCount == 0;
+}
+
+bool WireGuardPeersModel::isPeerValid(const QVariantMap &peer)
+{
+    // The same checks the peer editor does for each of its fields
+    if (!WireGuardKeyValidator::isValidKey(peer.value(QLatin1String(PNM_WG_PEER_KEY_PUBLIC_KEY)).toString())) {
+        return false;
+    }
+
+    static const SimpleIpListValidator allowedIpsValidator(SimpleIpListValidator::WithCidr, SimpleIpListValidator::Both);
+    const QStringList allowedIps = peer.value(QLatin1String(PNM_WG_PEER_KEY_ALLOWED_IPS)).toStringList();
+    if (allowedIps.isEmpty()) {
+        return false;
+    }
+    for (const QString &address : allowedIps) {
+        if (allowedIpsValidator.validateAddress(address.constData(), address.size()) != QValidator::Acceptable) {
+            return false;
+        }
+    }
+
+    QString address;
+    QString port;
+    splitEndpoint(peer.value(QLatin1String(PNM_WG_PEER_KEY_ENDPOINT)).toString(), &address, &port);
+    if (WireGuardPeerWidget::isEndpointValid(address, port) != WireGuardPeerWidget::BothValid) {
+        return false;
+    }
+
+    // The preshared key is ignored unless it is stored
+    const NetworkManager::Setting::SecretFlags flags(peer.value(QLatin1String(PNM_WG_PEER_KEY_PRESHARED_KEY_FLAGS), int(NetworkManager::Setting::NotRequired)).toUInt());
+    return flags.testFlag(NetworkManager::Setting::NotRequired)
+        || WireGuardKeyValidator::isValidKey(peer.value(QLatin1String(PNM_WG_PEER_KEY_PRESHARED_KEY)).toString());
+}
+
+void WireGuardPeersModel::splitEndpoint(const QString &endpoint, QString *address, QString *port)
+{
+    const int separator = endpoint.lastIndexOf(QLatin1Char(':'));
+    if (endpoint.isEmpty() || separator < 0) {
+        *address = endpoint;
+        port->clear();
+        return;
+    }
+
+    *address = endpoint.left(separator);
+    *port = endpoint.mid(separator + 1);
+    if (address->startsWith(QLatin1Char('[')) && address->endsWith(QLatin1Char(']'))) {
+        *address = address->mid(1, address->length() - 2);
+    }
+}
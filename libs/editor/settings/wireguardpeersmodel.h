@@ -0,0 +1,76 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef PLASMA_NM_WIREGUARD_PEERS_MODEL_H
+#define PLASMA_NM_WIREGUARD_PEERS_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QBrush>
+#include <QVector>
+
+#include <NetworkManagerQt/WireguardSetting>
+
+/**
+ * The peers of a WireGuard connection, one row each. The peers are kept in the
+ * form NetworkManager uses, so the list is returned as it is. Whether a peer is
+ * valid is checked when it is loaded or changed, without any widgets.
+ */
+class Q_DECL_EXPORT WireGuardPeersModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns {PublicKeyColumn = 0, AllowedIpsColumn, EndpointColumn, ColumnCount};
+    enum Roles {ValidRole = Qt::UserRole + 1};
+
+    explicit WireGuardPeersModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+    NMVariantMapList peers() const;
+    void setPeers(const NMVariantMapList &peers);
+
+    QVariantMap peer(int row) const;
+    void setPeer(int row, const QVariantMap &peer);
+    void appendPeer(const QVariantMap &peer);
+    void removePeer(int row);
+
+    bool isValid(int row) const;
+    // Whether all peers are valid
+    bool allValid() const;
+
+    static bool isPeerValid(const QVariantMap &peer);
+    // An endpoint is stored as <ipv4 | [ipv6] | fqdn>:<port>
+    static void splitEndpoint(const QString &endpoint, QString *address, QString *port);
+
+Q_SIGNALS:
+    void validityChanged();
+
+private:
+    NMVariantMapList m_peers;
+    QVector<bool> m_valid;
+    int m_invalidCount = 0;
+    QBrush m_invalidForeground;
+};
+
+#endif // PLASMA_NM_WIREGUARD_PEERS_MODEL_H
@@ -19,6 +19,7 @@
 */
 #include "debug.h"
 #include "wireguardpeerwidget.h"
+#include "wireguardpeersmodel.h"
 #include "wireguardtabwidget.h"
 #include "ui_wireguardpeerwidget.h"
 #include "uiutils.h"
@@ -88,7 +89,6 @@ WireGuardPeerWidget::WireGuardPeerWidget(const QVariantMap &peerData, QWidget *p
     , d(new Private)
 {
     d->ui.setupUi(this);
-    d->peerData = peerData;
 
     d->config = KSharedConfig::openConfig();
     d->warningPalette = KColorScheme::createApplicationPalette(d->config);
@@ -125,12 +125,7 @@ WireGuardPeerWidget::WireGuardPeerWidget(const QVariantMap &peerData, QWidget *p
     d->ui.keepaliveLineEdit->setValidator(portValidator);
 
     KAcceleratorManager::manage(this);
-    updatePeerWidgets();
-
-    // Set the initial backgrounds on all the widgets
-    checkPublicKeyValid();
-    checkAllowedIpsValid();
-    checkEndpointValid();
+    setPeerData(peerData);
 }
 
 WireGuardPeerWidget::~WireGuardPeerWidget()
@@ -143,6 +138,18 @@ QVariantMap WireGuardPeerWidget::setting() const
     return d->peerData;
 }
 
+void WireGuardPeerWidget::setPeerData(const QVariantMap &peerData)
+{
+    d->peerData = peerData;
+    updatePeerWidgets();
+
+    // Set the initial backgrounds on all the widgets
+    checkPublicKeyValid();
+    checkAllowedIpsValid();
+    checkEndpointValid();
+    checkPresharedKeyValid();
+}
+
 void WireGuardPeerWidget::checkPublicKeyValid()
 {
     int pos = 0;
@@ -151,6 +158,7 @@ void WireGuardPeerWidget::checkPublicKeyValid()
     bool valid = QValidator::Acceptable == keyValidator.validate(value, pos);
     setBackground(widget, valid);
     d->peerData[PNM_WG_PEER_KEY_PUBLIC_KEY] = value;
+    Q_EMIT peerDataChanged();
     if (valid != d->publicKeyValid) {
         d->publicKeyValid = valid;
         slotWidgetChanged();
@@ -175,6 +183,7 @@ void WireGuardPeerWidget::checkPresharedKeyValid()
         d->peerData.remove(PNM_WG_PEER_KEY_PRESHARED_KEY);
     else
         d->peerData[PNM_WG_PEER_KEY_PRESHARED_KEY] = value;
+    Q_EMIT peerDataChanged();
     if (valid != d->presharedKeyValid) {
         d->presharedKeyValid = valid;
         slotWidgetChanged();
@@ -198,6 +207,7 @@ void WireGuardPeerWidget::checkAllowedIpsValid()
     }
 
     d->peerData[PNM_WG_PEER_KEY_ALLOWED_IPS] = ipList;
+    Q_EMIT peerDataChanged();
     if (valid != d->allowedIPsValid) {
         d->allowedIPsValid = valid;
         slotWidgetChanged();
@@ -257,6 +267,7 @@ void WireGuardPeerWidget::checkEndpointValid()
         d->peerData.remove(PNM_WG_PEER_KEY_ENDPOINT);
     else
         d->peerData[PNM_WG_PEER_KEY_ENDPOINT] = stringToStore;
+    Q_EMIT peerDataChanged();
 
     if ((valid == WireGuardPeerWidget::BothValid) != d->endpointValid) {
         d->endpointValid = (valid == WireGuardPeerWidget::BothValid);
@@ -281,6 +292,7 @@ void WireGuardPeerWidget::saveKeepAlive()
         d->peerData.remove(PNM_WG_PEER_KEY_PERSISTENT_KEEPALIVE);
     else
         d->peerData[PNM_WG_PEER_KEY_PERSISTENT_KEEPALIVE] = value;
+    Q_EMIT peerDataChanged();
 }
 
 void WireGuardPeerWidget::saveKeyFlags()
@@ -335,13 +347,11 @@ void WireGuardPeerWidget::updatePeerWidgets()
 
     // An endpoint is stored as <ipv4 | [ipv6] | fqdn>:<port>
     if (d->peerData.contains(PNM_WG_PEER_KEY_ENDPOINT)) {
-        QString storedEndpoint = d->peerData[PNM_WG_PEER_KEY_ENDPOINT].toString();
-        QStringList endpointList = storedEndpoint.contains("]:") ?
-            d->peerData[PNM_WG_PEER_KEY_ENDPOINT].toString().split("]:") :
-            d->peerData[PNM_WG_PEER_KEY_ENDPOINT].toString().split(":");
-
-        d->ui.endpointAddressLineEdit->setText(endpointList[0].remove("["));
-        d->ui.endpointPortLineEdit->setText(endpointList[1]);
+        QString address;
+        QString port;
+        WireGuardPeersModel::splitEndpoint(d->peerData[PNM_WG_PEER_KEY_ENDPOINT].toString(), &address, &port);
+        d->ui.endpointAddressLineEdit->setText(address);
+        d->ui.endpointPortLineEdit->setText(port);
     } else {
         d->ui.endpointAddressLineEdit->clear();
         d->ui.endpointPortLineEdit->clear();
@@ -35,12 +35,16 @@ public:
     ~WireGuardPeerWidget() override;
 
     QVariantMap setting() const;
+    // Show another peer in the widget
+    void setPeerData(const QVariantMap &peerData);
     bool isValid();
     enum EndPointValid {BothValid, AddressValid, PortValid, BothInvalid};
     static WireGuardPeerWidget::EndPointValid isEndpointValid(QString&, QString&);
 
 Q_SIGNALS:
     void notifyValid();
+    // Any field of the peer was edited
+    void peerDataChanged();
 
 private:
     void setBackground(QWidget *w, bool result) const;
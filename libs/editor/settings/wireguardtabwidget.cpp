@@ -19,15 +19,11 @@
 */
 #include "debug.h"
 #include "wireguardtabwidget.h"
+#include "wireguardpeersmodel.h"
 #include "wireguardpeerwidget.h"
 #include "ui_wireguardtabwidget.h"
-#include "ui_wireguardpeerwidget.h"
-#include "uiutils.h"
-#include "simpleipv4addressvalidator.h"
-#include "simpleiplistvalidator.h"
-#include "wireguardkeyvalidator.h"
 
-#include <QStandardItemModel>
+#include <QHeaderView>
 
 #include <NetworkManagerQt/Utils>
 #include <NetworkManagerQt/WireguardSetting>
@@ -50,32 +46,20 @@
 #define PNM_WG_PEER_KEY_PRESHARED_KEY_FLAGS  "preshared-key-flags"
 #define PNM_WG_PEER_KEY_PUBLIC_KEY           "public-key"
 
-static WireGuardKeyValidator keyValidator();
-static SimpleIpListValidator allowedIPsValidator(SimpleIpListValidator::WithCidr, SimpleIpListValidator::Both);
-
 class WireGuardTabWidget::Private
 {
 public:
-    Private();
-    ~Private();
-
     Ui_WireGuardTabWidget ui;
-    NetworkManager::WireGuardSetting::Ptr setting;
     KSharedConfigPtr config;
-    NMVariantMapList peers;
-    int currentIndex;
-    bool currentPeerValid;
-    bool otherPeersValid;
+    WireGuardPeersModel model;
+    // The only editor, showing the peer of the current row
+    WireGuardPeerWidget *peerWidget = nullptr;
+    int currentRow = -1;
+    bool loadingPeer = false;
+    // The selection moves through the rows being removed, they must not be loaded
+    bool removingPeer = false;
 };
 
-WireGuardTabWidget::Private::Private(void)
-{
-}
-
-WireGuardTabWidget::Private::~Private()
-{
-}
-
 WireGuardTabWidget::WireGuardTabWidget(const NMVariantMapList &peerData, QWidget *parent, Qt::WindowFlags f)
     : QDialog(parent, f)
     , d(new Private)
@@ -85,6 +69,20 @@ WireGuardTabWidget::WireGuardTabWidget(const NMVariantMapList &peerData, QWidget
     d->config = KSharedConfig::openConfig();
     setWindowTitle(i18nc("@title: window wireguard peers properties",
                          "WireGuard peers properties"));
+
+    // The view only paints the visible rows, there are no widgets per peer
+    d->ui.peersView->setModel(&d->model);
+    d->ui.peersView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    d->ui.peersView->horizontalHeader()->setSectionResizeMode(WireGuardPeersModel::PublicKeyColumn, QHeaderView::Stretch);
+    d->ui.peersView->horizontalHeader()->setSectionResizeMode(WireGuardPeersModel::AllowedIpsColumn, QHeaderView::Stretch);
+
+    d->peerWidget = new WireGuardPeerWidget(QVariantMap(), this, Qt::Widget);
+    d->ui.peerLayout->addWidget(d->peerWidget);
+
+    connect(d->ui.peersView->selectionModel(), &QItemSelectionModel::currentRowChanged, this, &WireGuardTabWidget::slotCurrentRowChanged);
+    // The table shows the edits as they are typed
+    connect(d->peerWidget, &WireGuardPeerWidget::peerDataChanged, this, &WireGuardTabWidget::slotPeerChanged);
+    connect(&d->model, &WireGuardPeersModel::validityChanged, this, &WireGuardTabWidget::slotWidgetChanged);
     connect(d->ui.btnAdd, &QPushButton::clicked, this, &WireGuardTabWidget::slotAddPeer);
     connect(d->ui.btnRemove, &QPushButton::clicked, this, &WireGuardTabWidget::slotRemovePeer);
     connect(d->ui.buttonBox, &QDialogButtonBox::accepted, this, &WireGuardTabWidget::accept);
@@ -93,9 +91,6 @@ WireGuardTabWidget::WireGuardTabWidget(const NMVariantMapList &peerData, QWidget
     KAcceleratorManager::manage(this);
 
     loadConfig(peerData);
-
-    if (peerData.isEmpty())
-        slotAddPeer();
 }
 
 WireGuardTabWidget::~WireGuardTabWidget()
@@ -105,73 +100,93 @@ WireGuardTabWidget::~WireGuardTabWidget()
 
 void WireGuardTabWidget::loadConfig(const NMVariantMapList &peerData)
 {
-    d->peers = peerData;
-    int numIncomingPeers = d->peers.size();
+    d->currentRow = -1;
+    d->model.setPeers(peerData);
 
     // If there weren't any peers in the incoming setting, create
     // the required first element
-    if (d->peers.isEmpty())
-        d->peers.append(*(new QVariantMap()));
-
-    for (int i = 0; i < numIncomingPeers; i++) {
-        slotAddPeerWithData(peerData[i]);
+    if (peerData.isEmpty()) {
+        slotAddPeer();
+    } else {
+        d->ui.peersView->setCurrentIndex(d->model.index(0, 0));
     }
-    d->ui.tabWidget->setCurrentIndex(0);
+    slotWidgetChanged();
 }
 
 NMVariantMapList WireGuardTabWidget::setting() const
 {
-    d->peers.clear();
-    for (int i = 0; i < d->ui.tabWidget->count(); i++)
-        d->peers.append(static_cast<WireGuardPeerWidget*>(d->ui.tabWidget->widget(i))->setting());
-    return d->peers;
+    // The editor only reports changes of the validity, take its last edits
+    if (d->currentRow >= 0) {
+        d->model.setPeer(d->currentRow, d->peerWidget->setting());
+    }
+    return d->model.peers();
 }
 
 void WireGuardTabWidget::slotAddPeer()
 {
-    QVariantMap *newItem = new QVariantMap; 
-    int numPeers = d->ui.tabWidget->count() + 1;
-    WireGuardPeerWidget *newTab = new WireGuardPeerWidget(*newItem);
-    connect(newTab, &WireGuardPeerWidget::notifyValid, this, &WireGuardTabWidget::slotWidgetChanged);
-    d->ui.tabWidget->addTab(newTab, QString("Peer %1").arg(QString::number(numPeers)));
-    d->peers.append(*newItem);
-    d->ui.tabWidget->setCurrentIndex(numPeers - 1);
-    slotWidgetChanged();
+    slotAddPeerWithData(QVariantMap());
 }
 
 void WireGuardTabWidget::slotAddPeerWithData(const QVariantMap &peerData)
 {
-    int numPeers = d->ui.tabWidget->count() + 1;
-    WireGuardPeerWidget *newTab = new WireGuardPeerWidget(peerData);
-    d->ui.tabWidget->addTab(newTab, QString("Peer %1").arg(QString::number(numPeers)));
-    connect(newTab, &WireGuardPeerWidget::notifyValid, this, &WireGuardTabWidget::slotWidgetChanged);
-    d->peers.append(peerData);
-    d->ui.tabWidget->setCurrentIndex(numPeers - 1);
-    slotWidgetChanged();
+    d->model.appendPeer(peerData);
+    d->ui.peersView->setCurrentIndex(d->model.index(d->model.rowCount() - 1, 0));
 }
 
 void WireGuardTabWidget::slotRemovePeer()
 {
-    int numPeers = d->ui.tabWidget->count() - 1;
-    d->ui.tabWidget->removeTab(d->ui.tabWidget->currentIndex());
-    if (numPeers == 0) {
+    const int row = d->currentRow;
+    if (row < 0) {
+        return;
+    }
+
+    // The editor must not write the removed peer to its neighbour
+    d->currentRow = -1;
+    d->removingPeer = true;
+    d->model.removePeer(row);
+    d->removingPeer = false;
+
+    if (d->model.rowCount() == 0) {
         slotAddPeer();
-        numPeers = 1;
+        return;
     }
 
-    // Retitle the tabs to reflect the current numbers
-    for (int i = 0; i < numPeers; i++)
-        d->ui.tabWidget->setTabText(i, QString("Peer %1").arg(QString::number(i + 1)));
+    // The view may already be on the row, then it doesn't tell about it
+    d->ui.peersView->setCurrentIndex(d->model.index(qMin(row, d->model.rowCount() - 1), 0));
+    const QModelIndex current = d->ui.peersView->currentIndex();
+    if (d->currentRow != current.row()) {
+        slotCurrentRowChanged(current);
+    }
 }
 
-void WireGuardTabWidget::slotWidgetChanged()
+void WireGuardTabWidget::slotCurrentRowChanged(const QModelIndex &current)
+{
+    if (d->removingPeer) {
+        return;
+    }
+
+    // Keep the edits of the peer shown so far
+    slotPeerChanged();
+    d->currentRow = current.isValid() ? current.row() : -1;
+
+    // Loading the fields one by one passes through inconsistent states, only the
+    // final one is written back
+    d->loadingPeer = true;
+    d->peerWidget->setPeerData(d->model.peer(d->currentRow));
+    d->loadingPeer = false;
+    d->peerWidget->setEnabled(d->currentRow >= 0);
+    slotPeerChanged();
+}
+
+void WireGuardTabWidget::slotPeerChanged()
 {
-    bool valid = true;
-    for (int i = 0; i < d->ui.tabWidget->count(); i++) {
-        if (!static_cast<WireGuardPeerWidget*>(d->ui.tabWidget->widget(i))->isValid()) {
-            valid = false;
-            break;
-        }
+    if (d->loadingPeer || d->currentRow < 0) {
+        return;
     }
-    d->ui.buttonBox->button(QDialogButtonBox::Ok)->setEnabled(valid);
+    d->model.setPeer(d->currentRow, d->peerWidget->setting());
+}
+
+void WireGuardTabWidget::slotWidgetChanged()
+{
+    d->ui.buttonBox->button(QDialogButtonBox::Ok)->setEnabled(d->model.allValid());
 }
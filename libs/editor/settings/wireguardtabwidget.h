@@ -45,6 +45,8 @@ public:
     void slotRemovePeer();
 
 private:
+    void slotCurrentRowChanged(const QModelIndex &current);
+    void slotPeerChanged();
     void slotWidgetChanged();
 
     class Private;
@@ -0,0 +1,371 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "simpleipaddressparser.h"
+
+namespace
+{
+
+struct Ipv4Tetrads {
+    int values[4];
+    int count = 0;
+    // Whether all tetrads are written the way QString::number() would write them
+    bool normalized = true;
+    // Position of the first character following the tetrads
+    int end = 0;
+};
+
+inline int digitValue(QChar c)
+{
+    const ushort u = c.unicode();
+    if (u >= '0' && u <= '9') {
+        return u - '0';
+    }
+    return -1;
+}
+
+inline int hexDigitValue(QChar c)
+{
+    const ushort u = c.unicode();
+    if (u >= '0' && u <= '9') {
+        return u - '0';
+    } else if (u >= 'a' && u <= 'f') {
+        return u - 'a' + 10;
+    } else if (u >= 'A' && u <= 'F') {
+        return u - 'A' + 10;
+    }
+    return -1;
+}
+
+// Reads the tetrad like QString::toInt() does: surrounding spaces are ignored
+// and anything else than a plain number is read as 0
+int tetradValue(const QChar *data, int length, bool *normalized)
+{
+    int begin = 0;
+    int end = length;
+    while (begin < end && data[begin].isSpace()) {
+        ++begin;
+    }
+    while (end > begin && data[end - 1].isSpace()) {
+        --end;
+    }
+
+    if (begin != 0 || end != length || (length > 1 && data[0] == QLatin1Char('0'))) {
+        *normalized = false;
+    }
+
+    int value = 0;
+    for (int i = begin; i < end; ++i) {
+        const int digit = digitValue(data[i]);
+        if (digit < 0) {
+            *normalized = false;
+            return 0;
+        }
+        value = value * 10 + digit;
+    }
+
+    if (begin == end) {
+        *normalized = false;
+    }
+
+    return value;
+}
+
+// Reads a number of at most maxLength digits, returns -1 if there is anything else
+int numberValue(const QChar *data, int length, int maxLength)
+{
+    if (length > maxLength) {
+        return -1;
+    }
+
+    int value = 0;
+    for (int i = 0; i < length; ++i) {
+        const int digit = digitValue(data[i]);
+        if (digit < 0) {
+            return -1;
+        }
+        value = value * 10 + digit;
+    }
+
+    return value;
+}
+
+QValidator::State parseIpv4(const QChar *data, int length, SimpleIpAddressParser::AddressStyle style, Ipv4Tetrads &tetrads)
+{
+    const bool withSuffix = style != SimpleIpAddressParser::Base;
+    const QChar separator = style == SimpleIpAddressParser::WithCidr ? QLatin1Char('/') : QLatin1Char(':');
+
+    int tetradStart = 0;
+    int suffixStart = -1;
+
+    for (int i = 0; i < length; ++i) {
+        const QChar c = data[i];
+        const bool isSeparator = withSuffix && c == separator;
+
+        if (c == QLatin1Char('.') || isSeparator) {
+            // Empty tetrad, fifth tetrad or CIDR/port following less than four tetrads
+            if (i == tetradStart || (isSeparator ? tetrads.count != 3 : tetrads.count == 3)) {
+                return QValidator::Invalid;
+            }
+
+            const int value = tetradValue(data + tetradStart, i - tetradStart, &tetrads.normalized);
+            if (value > 255) {
+                return QValidator::Invalid;
+            }
+            tetrads.values[tetrads.count++] = value;
+            tetradStart = i + 1;
+
+            if (isSeparator) {
+                suffixStart = i + 1;
+                break;
+            }
+        } else if (digitValue(c) >= 0 || (style == SimpleIpAddressParser::Base && (c == QLatin1Char(' ') || c == QLatin1Char(',')))) {
+            if (i - tetradStart == 3) {
+                return QValidator::Invalid;
+            }
+        } else {
+            return QValidator::Invalid;
+        }
+    }
+
+    if (suffixStart < 0) {
+        tetrads.end = length;
+
+        // The last tetrad has not been started yet, nothing is normalized in that case
+        if (tetradStart == length) {
+            tetrads.normalized = true;
+            return QValidator::Intermediate;
+        }
+
+        const int value = tetradValue(data + tetradStart, length - tetradStart, &tetrads.normalized);
+        if (value > 255) {
+            return QValidator::Invalid;
+        }
+        tetrads.values[tetrads.count++] = value;
+
+        if (tetrads.count < 4 || withSuffix) {
+            return QValidator::Intermediate;
+        }
+        return QValidator::Acceptable;
+    }
+
+    tetrads.end = suffixStart - 1;
+
+    const bool cidr = style == SimpleIpAddressParser::WithCidr;
+    const int suffix = numberValue(data + suffixStart, length - suffixStart, cidr ? 2 : 5);
+    if (suffix < 0) {
+        return QValidator::Invalid;
+    } else if (suffixStart == length) {
+        return QValidator::Intermediate;
+    } else if (suffix > (cidr ? 32 : 65535)) {
+        return QValidator::Invalid;
+    }
+
+    return QValidator::Acceptable;
+}
+
+}
+
+QValidator::State SimpleIpAddressParser::validateIpv4(const QChar *data, int length, AddressStyle style)
+{
+    Ipv4Tetrads tetrads;
+    return parseIpv4(data, length, style, tetrads);
+}
+
+QValidator::State SimpleIpAddressParser::validateIpv4(QString &address, AddressStyle style)
+{
+    Ipv4Tetrads tetrads;
+    const QValidator::State state = parseIpv4(address.constData(), address.length(), style, tetrads);
+
+    if (state != QValidator::Invalid && !tetrads.normalized) {
+        QString normalized;
+        normalized.reserve(address.length());
+        for (int i = 0; i < tetrads.count; ++i) {
+            if (i > 0) {
+                normalized += QLatin1Char('.');
+            }
+            normalized += QString::number(tetrads.values[i]);
+        }
+        normalized += address.midRef(tetrads.end);
+        address = normalized;
+    }
+
+    return state;
+}
+
+QValidator::State SimpleIpAddressParser::validateIpv6(const QChar *data, int length, AddressStyle style)
+{
+    int i = 0;
+    if (style == WithPort) {
+        if (length == 0) {
+            return QValidator::Intermediate;
+        } else if (data[0] != QLatin1Char('[')) {
+            return QValidator::Invalid;
+        }
+        i = 1;
+    }
+
+    const int addressStart = i;
+    int addressEnd = length;
+    bool terminated = false;
+
+    // Parts of the address separated by colons
+    int parts = 1;
+    int partLength = 0;
+    int partValue = 0;
+    bool emptyPresent = false;
+    bool firstEmpty = false;
+    bool secondEmpty = false;
+    bool eighthEmpty = false;
+    bool ninthEmpty = false;
+    // Lowest number of the hextets and colons the CIDR input mask can see in the address
+    int tokens = 0;
+
+    for (;; ++i) {
+        const bool atEnd = i == length;
+        const QChar c = atEnd ? QChar() : data[i];
+
+        if (!atEnd && hexDigitValue(c) >= 0) {
+            // Saturate, anything over 0xFFFF is invalid anyway
+            partValue = qMin(partValue * 16 + hexDigitValue(c), 0x10000);
+            ++partLength;
+            continue;
+        }
+
+        const bool isTerminator = !atEnd && ((style == WithCidr && c == QLatin1Char('/')) ||
+                                             (style == WithPort && c == QLatin1Char(']')));
+        if (!atEnd && !isTerminator && c != QLatin1Char(':')) {
+            return QValidator::Invalid;
+        }
+
+        // The part has ended, only the last one may be empty without counting as "::"
+        const bool lastPart = c != QLatin1Char(':');
+        const int part = parts - 1;
+        if (partLength == 0) {
+            if (!lastPart) {
+                // Only "::" at the beginning can be followed by another empty part
+                if (emptyPresent && part != 1) {
+                    return QValidator::Invalid;
+                }
+                emptyPresent = true;
+            }
+        } else if (partValue > 0xFFFF) {
+            return QValidator::Invalid;
+        }
+
+        if (part == 0) {
+            firstEmpty = partLength == 0;
+        } else if (part == 1) {
+            secondEmpty = partLength == 0;
+        } else if (part == 7) {
+            eighthEmpty = partLength == 0;
+        } else if (part == 8) {
+            ninthEmpty = partLength == 0;
+        }
+        tokens += (partLength + 3) / 4;
+
+        if (lastPart) {
+            if (isTerminator) {
+                terminated = true;
+                addressEnd = i;
+            }
+            break;
+        }
+
+        // There can't be more than 8 colons
+        if (++parts > 9) {
+            return QValidator::Invalid;
+        }
+        ++tokens;
+        partLength = 0;
+        partValue = 0;
+    }
+
+    // One unusual case with 8 colons: 1:2:3:4:5:6:7::
+    if (parts == 9 && (!eighthEmpty || !ninthEmpty)) {
+        return QValidator::Invalid;
+    }
+
+    // Input masks: "([0-9a-fA-F]{1,4}|:){2,15}/[0-9]{1,3}" and "\[([0-9a-fA-F]{1,4}|:)+\]:[0-9]{1,5}"
+    int suffix = 0;
+    bool suffixPresent = false;
+    if (style == WithCidr) {
+        if (tokens > 15 || (terminated && addressEnd - addressStart < 2)) {
+            return QValidator::Invalid;
+        }
+        if (terminated) {
+            suffix = numberValue(data + addressEnd + 1, length - addressEnd - 1, 3);
+            suffixPresent = addressEnd + 1 < length;
+        }
+    } else if (style == WithPort && terminated) {
+        if (addressEnd == addressStart) {
+            return QValidator::Invalid;
+        }
+        if (addressEnd + 1 < length) {
+            if (data[addressEnd + 1] != QLatin1Char(':')) {
+                return QValidator::Invalid;
+            }
+            suffix = numberValue(data + addressEnd + 2, length - addressEnd - 2, 5);
+            suffixPresent = true;
+        }
+    }
+    if (suffix < 0) {
+        return QValidator::Invalid;
+    }
+
+    QValidator::State result = QValidator::Acceptable;
+    if (parts == 2 && firstEmpty && secondEmpty) {
+        // A single colon
+        result = QValidator::Intermediate;
+    } else if (parts > 1 && firstEmpty && !secondEmpty) {
+        // A single colon followed by something (i.e. ":123")
+        result = QValidator::Invalid;
+    } else if (parts < 8 && !emptyPresent) {
+        result = QValidator::Intermediate;
+    } else if (parts == 8 && eighthEmpty) {
+        result = QValidator::Intermediate;
+    }
+
+    if (style == WithCidr) {
+        // A '/' following an incomplete address makes the whole thing Invalid
+        if (terminated && result == QValidator::Intermediate) {
+            return QValidator::Invalid;
+        }
+        if (!terminated || addressEnd + 1 == length) {
+            return QValidator::Intermediate;
+        }
+        if (suffix > 128) {
+            return QValidator::Invalid;
+        }
+    } else if (style == WithPort) {
+        // A ']' following an incomplete address makes the whole thing Invalid
+        if (terminated && result == QValidator::Intermediate) {
+            return QValidator::Invalid;
+        }
+        if (!suffixPresent || addressEnd + 2 == length) {
+            return QValidator::Intermediate;
+        }
+        if (suffix > 65535) {
+            return QValidator::Invalid;
+        }
+    }
+
+    return result;
+}
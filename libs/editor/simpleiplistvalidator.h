@@ -22,8 +22,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define SIMPLEIPLISTVALIDATOR_H
 
 #include <QValidator>
-#include "simpleipv4addressvalidator.h"
-#include "simpleipv6addressvalidator.h"
+
+#include "listvalidationcache.h"
 
 class Q_DECL_EXPORT SimpleIpListValidator : public QValidator
 {
@@ -36,10 +36,14 @@ public:
     ~SimpleIpListValidator() override;
 
     State validate(QString &, int &) const override;
+    // Validate a single address of the list in data[0, length), surrounding spaces are ignored
+    State validateAddress(const QChar *data, int length) const;
 
 private:
-    SimpleIpV6AddressValidator *m_ipv6Validator;
-    SimpleIpV4AddressValidator *m_ipv4Validator;
+    AddressStyle m_addressStyle;
+    AddressType m_addressType;
+    // Results of the addresses validated last time, only edited addresses are validated again
+    mutable ListValidationCache m_cache;
 };
 
 #endif // SIMPLEIPV4ADDRESSVALIDATOR_H
@@ -31,18 +31,12 @@ public:
     explicit SimpleIpV4AddressValidator(AddressStyle style = AddressStyle::Base, QObject *parent = nullptr);
     ~SimpleIpV4AddressValidator() override;
 
-    State validate(QString &, int &) const override;
-
-    /** Check input value with a regular expression describing simple input mask.
+    /** Check the address in a single pass, tetrads of the address are normalized
+     *  (for example 010 -> 10), so the input string may be changed.
      */
-    QValidator::State checkWithInputMask(QString &, int &) const;
-    /** Function split intput string into tetrads and check them for valid values.
-     *  In the tetrads are placed into QList. Input string may be changed.
-     */
-    QValidator::State checkTetradsRanges(QString &, QList<int>&) const;
+    State validate(QString &, int &) const override;
 private:
     AddressStyle m_addressStyle;
-    QRegularExpressionValidator m_validator;
 };
 
 #endif // SIMPLEIPV4ADDRESSVALIDATOR_H
@@ -31,18 +31,11 @@ public:
     explicit SimpleIpV6AddressValidator(AddressStyle style = AddressStyle::Base, QObject *parent = nullptr);
     ~SimpleIpV6AddressValidator() override;
 
-    State validate(QString &, int &) const override;
-
-    /** Check input value with a regular expression describing simple input mask.
+    /** Check the address in a single pass, the input string is never changed.
      */
-    QValidator::State checkWithInputMask(QString &, int &) const;
-    /** Function split intput string into tetrads and check them for valid values.
-     *  In the tetrads are placed into QList. Input string may be changed.
-     */
-    QValidator::State checkTetradsRanges(QString &) const;
+    State validate(QString &, int &) const override;
 private:
     AddressStyle m_addressStyle;
-    QRegularExpressionValidator m_validator;
 };
 
 #endif // SIMPLEIPV6ADDRESSVALIDATOR_H
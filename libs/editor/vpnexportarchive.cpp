@@ -0,0 +1,142 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "vpnexportarchive.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+
+#include <KLocalizedString>
+#include <KTar>
+#include <KZip>
+
+// Directory of the archive the shared files go to
+#define SHARED_FILES_DIRECTORY "certificates"
+
+VpnExportArchive::VpnExportArchive(const QString &fileName)
+{
+    if (fileName.endsWith(QLatin1String(".zip"), Qt::CaseInsensitive)) {
+        m_archive.reset(new KZip(fileName));
+    } else {
+        m_archive.reset(new KTar(fileName));
+    }
+}
+
+VpnExportArchive::~VpnExportArchive()
+{
+    if (m_archive->isOpen()) {
+        m_archive->close();
+    }
+}
+
+bool VpnExportArchive::open()
+{
+    if (!m_archive->open(QIODevice::WriteOnly)) {
+        m_errorString = m_archive->errorString();
+        return false;
+    }
+    return true;
+}
+
+bool VpnExportArchive::close()
+{
+    if (!m_archive->close()) {
+        m_errorString = m_archive->errorString();
+        return false;
+    }
+    return true;
+}
+
+QString VpnExportArchive::errorString() const
+{
+    return m_errorString;
+}
+
+QString VpnExportArchive::reserveFileName(const QString &fileName)
+{
+    QString name = fileName;
+    const QFileInfo info(fileName);
+    const QString suffix = info.completeSuffix();
+    const QString baseName = suffix.isEmpty() ? fileName : fileName.left(fileName.length() - suffix.length() - 1);
+    for (int i = 2; m_fileNames.contains(name); ++i) {
+        name = suffix.isEmpty() ? QStringLiteral("%1-%2").arg(baseName).arg(i) : QStringLiteral("%1-%2.%3").arg(baseName).arg(i).arg(suffix);
+    }
+    m_fileNames.insert(name);
+    return name;
+}
+
+bool VpnExportArchive::writeFile(const QString &name, const QByteArray &data)
+{
+    // The exported files can contain secrets
+    if (!m_archive->writeFile(name, data, 0100600)) {
+        m_errorString = m_archive->errorString();
+        if (m_errorString.isEmpty()) {
+            m_errorString = i18n("Could not write %1 to the archive", name);
+        }
+        return false;
+    }
+    return true;
+}
+
+QByteArray VpnExportArchive::fileContents(const QString &path)
+{
+    QHash<QString, QByteArray>::const_iterator it = m_fileContents.constFind(path);
+    if (it != m_fileContents.constEnd()) {
+        return it.value();
+    }
+
+    QByteArray contents;
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly)) {
+        contents = file.readAll();
+    }
+    m_fileContents.insert(path, contents);
+    return contents;
+}
+
+QString VpnExportArchive::addSharedFile(const QString &path)
+{
+    const QByteArray contents = fileContents(path);
+    if (contents.isEmpty()) {
+        return QString();
+    }
+
+    const QByteArray hash = QCryptographicHash::hash(contents, QCryptographicHash::Sha256);
+    QHash<QByteArray, QString>::const_iterator it = m_sharedFiles.constFind(hash);
+    if (it != m_sharedFiles.constEnd()) {
+        return it.value();
+    }
+
+    // Named after the content, the same file referred to by many connections is stored once
+    const QString suffix = QFileInfo(path).suffix();
+    QString name = QLatin1String(SHARED_FILES_DIRECTORY "/") + QString::fromLatin1(hash.toHex().left(16));
+    if (!suffix.isEmpty()) {
+        name += QLatin1Char('.') + suffix;
+    }
+    name = reserveFileName(name);
+    if (!writeFile(name, contents)) {
+        return QString();
+    }
+
+    m_sharedFiles.insert(hash, name);
+    return name;
+}
@@ -0,0 +1,78 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef PLASMA_NM_VPN_EXPORT_ARCHIVE_H
+#define PLASMA_NM_VPN_EXPORT_ARCHIVE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QScopedPointer>
+#include <QSet>
+#include <QString>
+
+class KArchive;
+
+/**
+ * Archive many VPN connections are exported into, see
+ * VpnUiPlugin::exportConnectionSettingsToArchive(). Each exported file is
+ * written to the archive right away. Files the connections refer to, like
+ * certificates, are read only once and stored only once per distinct content.
+ */
+class Q_DECL_EXPORT VpnExportArchive
+{
+public:
+    // A zip archive for *.zip, otherwise a tar archive compressed according to the file name
+    explicit VpnExportArchive(const QString &fileName);
+    ~VpnExportArchive();
+
+    bool open();
+    bool close();
+    QString errorString() const;
+
+    /**
+     * Reserve a file name in the archive based on @p fileName, which is made
+     * unique by adding a number if needed.
+     */
+    QString reserveFileName(const QString &fileName);
+    bool writeFile(const QString &name, const QByteArray &data);
+
+    /**
+     * Contents of the local file @p path, empty if it can't be read.
+     */
+    QByteArray fileContents(const QString &path);
+    /**
+     * Add the local file @p path to the archive unless a file with the same
+     * content has been added already, and return its path in the archive.
+     * Returns an empty string if the file can't be read.
+     */
+    QString addSharedFile(const QString &path);
+
+private:
+    QScopedPointer<KArchive> m_archive;
+    QString m_errorString;
+    QSet<QString> m_fileNames;
+    // Contents of the local files read so far
+    QHash<QString, QByteArray> m_fileContents;
+    // Archive paths of the shared files by the SHA-256 of their content
+    QHash<QByteArray, QString> m_sharedFiles;
+};
+
+#endif // PLASMA_NM_VPN_EXPORT_ARCHIVE_H
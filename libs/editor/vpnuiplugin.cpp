@@ -33,6 +33,15 @@ VpnUiPlugin::~VpnUiPlugin()
 {
 }
 
+bool VpnUiPlugin::exportConnectionSettingsToArchive(const NetworkManager::ConnectionSettings::Ptr &connection, VpnExportArchive *archive)
+{
+    Q_UNUSED(connection)
+    Q_UNUSED(archive)
+
+    mError = NotImplemented;
+    return false;
+}
+
 QMessageBox::StandardButtons VpnUiPlugin::suggestedAuthDialogButtons() const
 {
     return QMessageBox::Ok | QMessageBox::Cancel;
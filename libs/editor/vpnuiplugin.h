@@ -32,6 +32,8 @@
 
 #include "settingwidget.h"
 
+class VpnExportArchive;
+
 /**
  * Plugin for UI elements for VPN configuration
  */
@@ -65,6 +67,13 @@ public:
      */
     virtual NMVariantMapMap importConnectionSettings(const QString &fileName) = 0;
     virtual bool exportConnectionSettings(const NetworkManager::ConnectionSettings::Ptr &connection, const QString &fileName) = 0;
+    /**
+     * Export the connection into @p archive, used to export many connections at once.
+     * Files the configuration refers to should be inlined or added with
+     * VpnExportArchive::addSharedFile(). The default implementation sets
+     * VpnUiPlugin::NotImplemented and returns false.
+     */
+    virtual bool exportConnectionSettingsToArchive(const NetworkManager::ConnectionSettings::Ptr &connection, VpnExportArchive *archive);
 
     virtual QMessageBox::StandardButtons suggestedAuthDialogButtons() const;
     ErrorType lastError() const;
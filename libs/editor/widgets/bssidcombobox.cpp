@@ -21,16 +21,12 @@
 
 #include "bssidcombobox.h"
 
-#include <NetworkManagerQt/Manager>
+#include <QAbstractItemView>
+
 #include <NetworkManagerQt/Utils>
-#include <NetworkManagerQt/WirelessDevice>
 
 #include <KLocalizedString>
 
-bool signalCompare(const NetworkManager::AccessPoint::Ptr & one, const NetworkManager::AccessPoint::Ptr & two) {
-    return one->signalStrength() > two->signalStrength();
-}
-
 BssidComboBox::BssidComboBox(QWidget *parent) :
     QComboBox(parent), m_dirty(false)
 {
@@ -39,6 +35,7 @@ BssidComboBox::BssidComboBox(QWidget *parent) :
 
     connect(this, &BssidComboBox::editTextChanged, this, &BssidComboBox::slotEditTextChanged);
     connect(this, QOverload<int>::of(&BssidComboBox::activated), this, &BssidComboBox::slotCurrentIndexChanged);
+    connect(NetworkSnapshot::self(), &NetworkSnapshot::networksChanged, this, &BssidComboBox::slotNetworksChanged);
 }
 
 QString BssidComboBox::bssid() const
@@ -63,6 +60,24 @@ bool BssidComboBox::isValid() const
     return NetworkManager::macAddressIsValid(bssid());
 }
 
+void BssidComboBox::hidePopup()
+{
+    QComboBox::hidePopup();
+
+    if (m_networksChanged) {
+        slotNetworksChanged();
+    }
+}
+
+void BssidComboBox::focusOutEvent(QFocusEvent *event)
+{
+    QComboBox::focusOutEvent(event);
+
+    if (m_networksChanged) {
+        slotNetworksChanged();
+    }
+}
+
 void BssidComboBox::slotEditTextChanged(const QString &)
 {
     m_dirty = true;
@@ -76,58 +91,52 @@ void BssidComboBox::slotCurrentIndexChanged(int)
     Q_EMIT bssidChanged();
 }
 
+void BssidComboBox::slotNetworksChanged()
+{
+    if (m_ssid.isEmpty()) {
+        return;
+    }
+
+    // Don't pull the items from under the user, wait until they are done with the combo
+    if (hasFocus() || view()->isVisible()) {
+        m_networksChanged = true;
+        return;
+    }
+    m_networksChanged = false;
+
+    // Refresh the list with new scan results, but keep what the user has typed or selected
+    const bool dirty = m_dirty;
+    const QString currentBssid = bssid();
+    QSignalBlocker blocker(this);
+    fillCombo(currentBssid);
+    m_dirty = dirty;
+}
+
 void BssidComboBox::init(const QString & bssid, const QString &ssid)
 {
     m_initialBssid = bssid;
+    m_ssid = ssid;
 
     // qCDebug(PLASMA_NM) << "Initial ssid:" << m_initialBssid;
 
-    QList<NetworkManager::AccessPoint::Ptr> aps;
-
-    for (const NetworkManager::Device::Ptr &device : NetworkManager::networkInterfaces()) {
-        if (device->type() == NetworkManager::Device::Wifi) {
-            NetworkManager::WirelessDevice::Ptr wifiDevice = device.objectCast<NetworkManager::WirelessDevice>();
-            NetworkManager::WirelessNetwork::Ptr wifiNetwork = wifiDevice->findNetwork(ssid);
-
-            if (!wifiNetwork) {
-                continue;
-            }
-
-            for (const NetworkManager::AccessPoint::Ptr &newAp : wifiNetwork->accessPoints()) {
-                bool found = false;;
-                for (const NetworkManager::AccessPoint::Ptr &existingAp : aps) {
-                    if (newAp->hardwareAddress() == existingAp->hardwareAddress()) {
-                        if (newAp->signalStrength() > existingAp->signalStrength()) {
-                            aps.removeOne(existingAp);
-                            break;
-                        } else {
-                            found = true;
-                            break;
-                        }
-                    }
-                }
-
-                if (!found) {
-                    aps << newAp;
-                }
-            }
-        }
-    }
+    fillCombo(m_initialBssid);
+}
 
-    std::sort(aps.begin(), aps.end(), signalCompare);
-    addBssidsToCombo(aps);
+void BssidComboBox::fillCombo(const QString &bssid)
+{
+    addBssidsToCombo(NetworkSnapshot::self()->accessPoints(m_ssid));
 
-    const int index = findData(m_initialBssid);
+    const int index = findData(bssid);
     if (index == -1) {
-        insertItem(0, m_initialBssid, m_initialBssid);
+        insertItem(0, bssid, bssid);
         setCurrentIndex(0);
     } else {
         setCurrentIndex(index);
     }
-    setEditText(m_initialBssid);
+    setEditText(bssid);
 }
 
-void BssidComboBox::addBssidsToCombo(const QList<NetworkManager::AccessPoint::Ptr> & aps)
+void BssidComboBox::addBssidsToCombo(const QVector<NetworkSnapshot::AccessPoint> & aps)
 {
     clear();
 
@@ -136,12 +145,8 @@ void BssidComboBox::addBssidsToCombo(const QList<NetworkManager::AccessPoint::Pt
         return;
     }
 
-    for (const NetworkManager::AccessPoint::Ptr &ap : aps) {
-        if (!ap) {
-            continue;
-        }
-
-        const QString text = i18n("%1 (%2%)\nFrequency: %3 Mhz\nChannel: %4", ap->hardwareAddress(), ap->signalStrength(), ap->frequency(), QString::number(NetworkManager::findChannel(ap->frequency())));
-        addItem(text, QVariant::fromValue(ap->hardwareAddress()));
+    for (const NetworkSnapshot::AccessPoint &ap : aps) {
+        const QString text = i18n("%1 (%2%)\nFrequency: %3 Mhz\nChannel: %4", ap.bssid, ap.signalStrength, ap.frequency, QString::number(NetworkManager::findChannel(ap.frequency)));
+        addItem(text, QVariant::fromValue(ap.bssid));
     }
 }
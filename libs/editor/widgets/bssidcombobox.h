@@ -24,8 +24,7 @@
 
 #include <QComboBox>
 
-#include <NetworkManagerQt/Device>
-#include <NetworkManagerQt/AccessPoint>
+#include "networksnapshot.h"
 
 class Q_DECL_EXPORT BssidComboBox : public QComboBox
 {
@@ -36,21 +35,30 @@ public:
     QString bssid() const;
     bool isValid() const;
 
+    void hidePopup() override;
+
 Q_SIGNALS:
     void bssidChanged();
 
 public Q_SLOTS:
     void init(const QString & bssid, const QString &ssid);
 
+protected:
+    void focusOutEvent(QFocusEvent *event) override;
+
 private Q_SLOTS:
     void slotEditTextChanged(const QString &);
     void slotCurrentIndexChanged(int);
+    void slotNetworksChanged();
 
 private:
-    void addBssidsToCombo(const QList<NetworkManager::AccessPoint::Ptr> & aps);
+    void addBssidsToCombo(const QVector<NetworkSnapshot::AccessPoint> & aps);
+    void fillCombo(const QString &bssid);
 
     QString m_initialBssid;
+    QString m_ssid;
     bool m_dirty;
+    bool m_networksChanged = false;
 };
 
 #endif // PLASMA_NM_BSSIDCOMBOBOX_H
@@ -20,25 +20,19 @@
 
 #include "hwaddrcombobox.h"
 
-#include <NetworkManagerQt/Manager>
-#include <NetworkManagerQt/WiredDevice>
-#include <NetworkManagerQt/WirelessDevice>
-#include <NetworkManagerQt/BluetoothDevice>
-#include <NetworkManagerQt/OlpcMeshDevice>
-#include <NetworkManagerQt/InfinibandDevice>
-#include <NetworkManagerQt/BondDevice>
-#include <NetworkManagerQt/BridgeDevice>
-#include <NetworkManagerQt/VlanDevice>
+#include <QAbstractItemView>
+
 #include <NetworkManagerQt/Utils>
 
 HwAddrComboBox::HwAddrComboBox(QWidget *parent) :
-    QComboBox(parent), m_dirty(false)
+    QComboBox(parent), m_deviceType(NetworkManager::Device::UnknownType), m_dirty(false)
 {
     setEditable(true);
     setInsertPolicy(QComboBox::NoInsert);
 
     connect(this, &HwAddrComboBox::editTextChanged, this, &HwAddrComboBox::slotEditTextChanged);
     connect(this, QOverload<int>::of(&HwAddrComboBox::currentIndexChanged), this, &HwAddrComboBox::slotCurrentIndexChanged);
+    connect(NetworkSnapshot::self(), &NetworkSnapshot::devicesChanged, this, &HwAddrComboBox::slotDevicesChanged);
 }
 
 bool HwAddrComboBox::isValid() const
@@ -63,6 +57,24 @@ QString HwAddrComboBox::hwAddress() const
     return result;
 }
 
+void HwAddrComboBox::hidePopup()
+{
+    QComboBox::hidePopup();
+
+    if (m_devicesChanged) {
+        slotDevicesChanged();
+    }
+}
+
+void HwAddrComboBox::focusOutEvent(QFocusEvent *event)
+{
+    QComboBox::focusOutEvent(event);
+
+    if (m_devicesChanged) {
+        slotDevicesChanged();
+    }
+}
+
 void HwAddrComboBox::slotEditTextChanged(const QString &)
 {
     m_dirty = true;
@@ -75,34 +87,59 @@ void HwAddrComboBox::slotCurrentIndexChanged(int)
     Q_EMIT hwAddressChanged();
 }
 
+void HwAddrComboBox::slotDevicesChanged()
+{
+    if (m_deviceType == NetworkManager::Device::UnknownType) {
+        return;
+    }
+
+    // Don't pull the items from under the user, wait until they are done with the combo
+    if (hasFocus() || view()->isVisible()) {
+        m_devicesChanged = true;
+        return;
+    }
+    m_devicesChanged = false;
+
+    // Refresh the list when devices come and go, but keep what the user has typed or selected
+    const bool dirty = m_dirty;
+    const QString currentAddress = hwAddress();
+    QSignalBlocker blocker(this);
+    fillCombo(currentAddress);
+    if (dirty) {
+        setEditText(currentAddress);
+    }
+    m_dirty = dirty;
+}
+
 void HwAddrComboBox::init(const NetworkManager::Device::Type &deviceType, const QString &address)
 {
     m_initialAddress = address;
+    m_deviceType = deviceType;
 
     // qCDebug(PLASMA_NM) << "Initial address:" << m_initialAddress;
 
+    fillCombo(m_initialAddress);
+}
+
+void HwAddrComboBox::fillCombo(const QString &address)
+{
+    clear();
+
     QString deviceName;
-    for (const NetworkManager::Device::Ptr &device : NetworkManager::networkInterfaces()) {
-        const NetworkManager::Device::Type type = device->type();
-        if (type == deviceType) {
-            if (address == hwAddressFromDevice(device).toString()) {
-                if (device->state() == NetworkManager::Device::Activated) {
-                    deviceName = device->ipInterfaceName();
-                } else {
-                    deviceName = device->interfaceName();
-                }
-            }
-            addAddressToCombo(device);
+    for (const NetworkSnapshot::Device &device : NetworkSnapshot::self()->devices(m_deviceType)) {
+        if (address == device.hwAddress) {
+            deviceName = device.name;
         }
+        addAddressToCombo(device);
     }
 
-    const int index = findData(m_initialAddress);
+    const int index = findData(address);
     if (index == -1) {
-        if (!m_initialAddress.isEmpty()) {
-            const QString text = QStringLiteral("%1 (%2)").arg(deviceName).arg(m_initialAddress);
-            insertItem(0, text, m_initialAddress);
+        if (!address.isEmpty()) {
+            const QString text = QStringLiteral("%1 (%2)").arg(deviceName).arg(address);
+            insertItem(0, text, address);
         } else {
-            insertItem(0, m_initialAddress, m_initialAddress);
+            insertItem(0, address, address);
         }
         setCurrentIndex(0);
     } else {
@@ -110,52 +147,11 @@ void HwAddrComboBox::init(const NetworkManager::Device::Type &deviceType, const
     }
 }
 
-void HwAddrComboBox::addAddressToCombo(const NetworkManager::Device::Ptr &device)
+void HwAddrComboBox::addAddressToCombo(const NetworkSnapshot::Device &device)
 {
-    const QVariant data = hwAddressFromDevice(device);
-    // qCDebug(PLASMA_NM) << "Data:" << data;
-
-    QString name;
-    if (device->state() == NetworkManager::Device::Activated)
-        name = device->ipInterfaceName();
-    else
-        name = device->interfaceName();
-
-    // qCDebug(PLASMA_NM) << "Name:" << name;
-
-    if (!data.isNull()) {
-        if (name == data.toString()) {
-            addItem(data.toString(), data);
-        }
-        else {
-            addItem(QStringLiteral("%1 (%2)").arg(name).arg(data.toString()), data);
-        }
-    }
-}
-
-
-QVariant HwAddrComboBox::hwAddressFromDevice(const NetworkManager::Device::Ptr& device)
-{
-    const NetworkManager::Device::Type type = device->type();
-
-    QVariant data;
-    if (type == NetworkManager::Device::Ethernet) {
-        data = device->as<NetworkManager::WiredDevice>()->permanentHardwareAddress();
-    } else if (type == NetworkManager::Device::Wifi) {
-        data = device->as<NetworkManager::WirelessDevice>()->permanentHardwareAddress();
-    } else if (type == NetworkManager::Device::Bluetooth) {
-        data = device->as<NetworkManager::BluetoothDevice>()->hardwareAddress();
-    } else if (type == NetworkManager::Device::OlpcMesh) {
-        data = device->as<NetworkManager::OlpcMeshDevice>()->hardwareAddress();
-    } else if (type == NetworkManager::Device::InfiniBand) {
-        data = device->as<NetworkManager::InfinibandDevice>()->hwAddress();
-    } else if (type == NetworkManager::Device::Bond) {
-        data = device->as<NetworkManager::BondDevice>()->hwAddress();
-    } else if (type == NetworkManager::Device::Bridge) {
-        data = device->as<NetworkManager::BridgeDevice>()->hwAddress();
-    } else if (type == NetworkManager::Device::Vlan) {
-        data = device->as<NetworkManager::VlanDevice>()->hwAddress();
+    if (device.name == device.hwAddress) {
+        addItem(device.hwAddress, device.hwAddress);
+    } else {
+        addItem(QStringLiteral("%1 (%2)").arg(device.name).arg(device.hwAddress), device.hwAddress);
     }
-
-    return data;
 }
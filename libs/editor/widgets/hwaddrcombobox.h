@@ -23,7 +23,7 @@
 
 #include <QComboBox>
 
-#include <NetworkManagerQt/Device>
+#include "networksnapshot.h"
 
 class Q_DECL_EXPORT HwAddrComboBox : public QComboBox
 {
@@ -36,18 +36,26 @@ public:
     bool isValid() const;
     QString hwAddress() const;
 
+    void hidePopup() override;
+
 Q_SIGNALS:
     void hwAddressChanged();
 
+protected:
+    void focusOutEvent(QFocusEvent *event) override;
+
 private Q_SLOTS:
     void slotEditTextChanged(const QString &);
     void slotCurrentIndexChanged(int);
+    void slotDevicesChanged();
 
 private:
-    void addAddressToCombo(const NetworkManager::Device::Ptr &device);
-    QVariant hwAddressFromDevice(const NetworkManager::Device::Ptr &device);
+    void addAddressToCombo(const NetworkSnapshot::Device &device);
+    void fillCombo(const QString &address);
     QString m_initialAddress;
+    NetworkManager::Device::Type m_deviceType;
     bool m_dirty;
+    bool m_devicesChanged = false;
 };
 
 #endif // PLASMA_NM_HWADDRCOMBOBOX_H
@@ -22,16 +22,10 @@
 #include "ssidcombobox.h"
 #include "uiutils.h"
 
-#include <NetworkManagerQt/Manager>
-#include <NetworkManagerQt/WirelessDevice>
+#include <QAbstractItemView>
 
 #include <KLocalizedString>
 
-bool signalCompare(const NetworkManager::WirelessNetwork::Ptr & one, const NetworkManager::WirelessNetwork::Ptr & two)
-{
-    return one->signalStrength() > two->signalStrength();
-}
-
 SsidComboBox::SsidComboBox(QWidget *parent) :
     KComboBox(parent)
 {
@@ -40,6 +34,7 @@ SsidComboBox::SsidComboBox(QWidget *parent) :
 
     connect(this, &SsidComboBox::editTextChanged, this, &SsidComboBox::slotEditTextChanged);
     connect(this, QOverload<int>::of(&SsidComboBox::activated), this, &SsidComboBox::slotCurrentIndexChanged);
+    connect(NetworkSnapshot::self(), &NetworkSnapshot::networksChanged, this, &SsidComboBox::slotNetworksChanged);
 }
 
 QString SsidComboBox::ssid() const
@@ -51,6 +46,24 @@ QString SsidComboBox::ssid() const
     }
 }
 
+void SsidComboBox::hidePopup()
+{
+    KComboBox::hidePopup();
+
+    if (m_networksChanged) {
+        slotNetworksChanged();
+    }
+}
+
+void SsidComboBox::focusOutEvent(QFocusEvent *event)
+{
+    KComboBox::focusOutEvent(event);
+
+    if (m_networksChanged) {
+        slotNetworksChanged();
+    }
+}
+
 void SsidComboBox::slotEditTextChanged(const QString &text)
 {
     if (!text.contains(QLatin1String("Security:")) && !text.contains(QLatin1String("Frequency:"))) {
@@ -63,86 +76,65 @@ void SsidComboBox::slotCurrentIndexChanged(int)
     setEditText(itemData(currentIndex()).toString());
 }
 
+void SsidComboBox::slotNetworksChanged()
+{
+    // Refresh the list with new scan results, but keep what the user has typed or selected
+    if (m_initialSsid.isNull()) {
+        return;
+    }
+
+    // Don't pull the items from under the user, wait until they are done with the combo
+    if (hasFocus() || view()->isVisible()) {
+        m_networksChanged = true;
+        return;
+    }
+    m_networksChanged = false;
+
+    const QString currentSsid = ssid();
+    QSignalBlocker blocker(this);
+    fillCombo(currentSsid);
+}
+
 void SsidComboBox::init(const QString &ssid)
 {
     m_initialSsid = ssid;
 
     // qCDebug(PLASMA_NM) << "Initial ssid:" << m_initialSsid;
 
-    QList<NetworkManager::WirelessNetwork::Ptr> networks;
-
-    for (const NetworkManager::Device::Ptr &device : NetworkManager::networkInterfaces()) {
-        if (device->type() == NetworkManager::Device::Wifi) {
-            NetworkManager::WirelessDevice::Ptr wifiDevice = device.objectCast<NetworkManager::WirelessDevice>();
-
-            for (const NetworkManager::WirelessNetwork::Ptr &newNetwork : wifiDevice->networks()) {
-                bool found = false;
-                for (const NetworkManager::WirelessNetwork::Ptr &existingNetwork : networks) {
-                    if (newNetwork->ssid() == existingNetwork->ssid()) {
-                        if (newNetwork->signalStrength() > existingNetwork->signalStrength()) {
-                            networks.removeOne(existingNetwork);
-                            break;
-                        } else {
-                            found = true;
-                            break;
-                        }
-                    }
-                }
-                if (!found) {
-                    networks << newNetwork;
-                }
-            }
-        }
-    }
+    fillCombo(m_initialSsid);
+}
 
-    std::sort(networks.begin(), networks.end(), signalCompare);
-    addSsidsToCombo(networks);
+void SsidComboBox::fillCombo(const QString &ssid)
+{
+    clear();
+    addSsidsToCombo(NetworkSnapshot::self()->networks());
 
-    int index = findData(m_initialSsid);
+    int index = findData(ssid);
     if (index == -1) {
-        insertItem(0, m_initialSsid, m_initialSsid);
+        insertItem(0, ssid, ssid);
         setCurrentIndex(0);
     } else {
         setCurrentIndex(index);
     }
-    setEditText(m_initialSsid);
+    setEditText(ssid);
 }
 
-void SsidComboBox::addSsidsToCombo(const QList<NetworkManager::WirelessNetwork::Ptr> &networks)
+void SsidComboBox::addSsidsToCombo(const QVector<NetworkSnapshot::Network> &networks)
 {
-    QList<NetworkManager::WirelessDevice::Ptr> wifiDevices;
-
-    for (const NetworkManager::Device::Ptr &dev : NetworkManager::networkInterfaces()) {
-        if (dev->type() == NetworkManager::Device::Wifi) {
-            wifiDevices << dev.objectCast<NetworkManager::WirelessDevice>();
-        }
-    }
-
     bool empty = true;
 
-    for (const NetworkManager::WirelessNetwork::Ptr &network : networks) {
-        NetworkManager::AccessPoint::Ptr accessPoint = network->referenceAccessPoint();
-
-        if (!accessPoint) {
-            continue;
+    for (const NetworkSnapshot::Network &network : networks) {
+        if (!empty) {
+            insertSeparator(count());
         }
-
-        for (const NetworkManager::WirelessDevice::Ptr &wifiDev : wifiDevices) {
-            if (wifiDev->findNetwork(network->ssid()) == network) {
-                if (!empty) {
-                    insertSeparator(count());
-                }
-                empty = false;
-
-                NetworkManager::WirelessSecurityType security = NetworkManager::findBestWirelessSecurity(wifiDev->wirelessCapabilities(), true, (wifiDev->mode() == NetworkManager::WirelessDevice::Adhoc), accessPoint->capabilities(), accessPoint->wpaFlags(), accessPoint->rsnFlags());
-                if (security != NetworkManager::UnknownSecurity && security != NetworkManager::NoneSecurity) {
-                    const QString text = i18n("%1 (%2%)\nSecurity: %3\nFrequency: %4 Mhz", accessPoint->ssid(), network->signalStrength(), UiUtils::labelFromWirelessSecurity(security), accessPoint->frequency());
-                    addItem(QIcon::fromTheme("object-locked"), text, accessPoint->ssid());
-                } else {
-                    const QString text = i18n("%1 (%2%)\nSecurity: Insecure\nFrequency: %3 Mhz", accessPoint->ssid(), network->signalStrength(), accessPoint->frequency());
-                    addItem(QIcon::fromTheme("object-unlocked"), text, accessPoint->ssid());
-                }
-            }
+        empty = false;
+
+        if (network.securityType != NetworkManager::UnknownSecurity && network.securityType != NetworkManager::NoneSecurity) {
+            const QString text = i18n("%1 (%2%)\nSecurity: %3\nFrequency: %4 Mhz", network.ssid, network.signalStrength, UiUtils::labelFromWirelessSecurity(network.securityType), network.frequency);
+            addItem(QIcon::fromTheme("object-locked"), text, network.ssid);
+        } else {
+            const QString text = i18n("%1 (%2%)\nSecurity: Insecure\nFrequency: %3 Mhz", network.ssid, network.signalStrength, network.frequency);
+            addItem(QIcon::fromTheme("object-unlocked"), text, network.ssid);
         }
     }
 }
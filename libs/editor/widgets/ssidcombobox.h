@@ -24,7 +24,7 @@
 
 #include <KComboBox>
 
-#include <NetworkManagerQt/WirelessNetwork>
+#include "networksnapshot.h"
 
 class Q_DECL_EXPORT SsidComboBox : public KComboBox
 {
@@ -36,16 +36,24 @@ public:
 
     QString ssid() const;
 
+    void hidePopup() override;
+
 Q_SIGNALS:
     void ssidChanged();
 
+protected:
+    void focusOutEvent(QFocusEvent *event) override;
+
 private Q_SLOTS:
     void slotEditTextChanged(const QString &text);
     void slotCurrentIndexChanged(int);
+    void slotNetworksChanged();
 
 private:
-    void addSsidsToCombo(const QList<NetworkManager::WirelessNetwork::Ptr> &networks);
+    void addSsidsToCombo(const QVector<NetworkSnapshot::Network> &networks);
+    void fillCombo(const QString &ssid);
     QString m_initialSsid;
+    bool m_networksChanged = false;
 };
 
 #endif // PLASMA_NM_SSIDCOMBOBOX_H
@@ -20,15 +20,63 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "wireguardkeyvalidator.h"
 
+// A WireGuard key is Base64 encoded and in human readable form consists
+// of 43 Alpha-numeric or  '+' or '/' with a 44th character of an equal sign.
+// The 43rd character is limited such that the converted character zeroes in
+// the 2 LSB.
+#define WIREGUARD_KEY_LENGTH 44
+
+namespace
+{
+
+enum CharClass {
+    Base64 = 0x1,
+    // Base64 characters allowed as the 43rd character
+    LastBase64 = 0x2,
+    Padding = 0x4
+};
+
+const uchar *charClasses()
+{
+    static const struct Table {
+        Table()
+        {
+            for (int c = 0; c < 128; ++c) {
+                if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '+' || c == '/') {
+                    classes[c] = Base64;
+                }
+            }
+            for (const char *c = "AEIMQUYcgkosw048"; *c; ++c) {
+                classes[uchar(*c)] |= LastBase64;
+            }
+            classes[uchar('=')] = Padding;
+        }
+        uchar classes[128] = {};
+    } table;
+    return table.classes;
+}
+
+inline uint charClass(QChar c)
+{
+    const ushort u = c.unicode();
+    return u < 128 ? charClasses()[u] : 0;
+}
+
+inline uint requiredClass(int position)
+{
+    if (position < WIREGUARD_KEY_LENGTH - 2) {
+        return Base64;
+    } else if (position == WIREGUARD_KEY_LENGTH - 2) {
+        return LastBase64;
+    }
+    return Padding;
+}
+
+}
+
 WireGuardKeyValidator::WireGuardKeyValidator(QObject *parent)
     : QValidator(parent)
 {
-    m_validator = new QRegularExpressionValidator(this);
-    // A WireGuard key is Base64 encoded and in human readable form consists
-    // of 43 Alpha-numeric or  '+' or '/' with a 44th character of an equal sign.
-    // The 43rd character is limited such that the converted character zeroes in
-    // the 2 LSB.
-    m_validator->setRegularExpression(QRegularExpression(QLatin1String("[0-9a-zA-Z\\+/]{42,42}[AEIMQUYcgkosw048]=")));
 }
 
 WireGuardKeyValidator::~WireGuardKeyValidator()
@@ -37,5 +85,37 @@ WireGuardKeyValidator::~WireGuardKeyValidator()
 
 QValidator::State WireGuardKeyValidator::validate(QString &address, int &pos) const
 {
-    return m_validator->validate(address, pos);
+    Q_UNUSED(pos)
+
+    // Same results as the regular expression "[0-9a-zA-Z\\+/]{42,42}[AEIMQUYcgkosw048]="
+    // used to, partially typed keys are Intermediate
+    const int length = address.length();
+    if (length > WIREGUARD_KEY_LENGTH) {
+        return QValidator::Invalid;
+    }
+
+    const QChar *data = address.constData();
+    for (int i = 0; i < length; ++i) {
+        if (!(charClass(data[i]) & requiredClass(i))) {
+            return QValidator::Invalid;
+        }
+    }
+
+    return length == WIREGUARD_KEY_LENGTH ? QValidator::Acceptable : QValidator::Intermediate;
+}
+
+bool WireGuardKeyValidator::isValidKey(const QString &key)
+{
+    if (key.length() != WIREGUARD_KEY_LENGTH) {
+        return false;
+    }
+
+    // No early return, a private key mustn't leak through the time the check takes
+    const QChar *data = key.constData();
+    uint invalid = 0;
+    for (int i = 0; i < WIREGUARD_KEY_LENGTH; ++i) {
+        invalid |= requiredClass(i) & ~charClass(data[i]);
+    }
+
+    return !invalid;
 }
@@ -31,8 +31,11 @@ public:
 
     QValidator::State validate(QString &, int &) const override;
 
-private:
-    QRegularExpressionValidator *m_validator;
+    /**
+     * Whether @p key is a complete WireGuard key. All the characters of the key
+     * are looked at, the check takes the same time for any key of the right length.
+     */
+    static bool isValidKey(const QString &key);
 };
 
 #endif // SIMPLEIPV4ADDRESSVALIDATOR_H
@@ -19,8 +19,10 @@
 */
 
 #include "handler.h"
+#include "bluezadaptercache.h"
 #include "connectioneditordialog.h"
 #include "configuration.h"
+#include "hotspotchannelscorer.h"
 #include "uiutils.h"
 #include "debug.h"
 
@@ -47,7 +49,6 @@
 #endif
 
 #include <QDBusError>
-#include <QDBusMetaType>
 #include <QDBusPendingReply>
 #include <QIcon>
 
@@ -71,7 +72,9 @@ Handler::Handler(QObject *parent)
     : QObject(parent)
     , m_tmpWirelessEnabled(NetworkManager::isWirelessEnabled())
     , m_tmpWwanEnabled(NetworkManager::isWwanEnabled())
+    , m_bluezAdapters(new BluezAdapterCache(QDBusConnection::systemBus(), QStringLiteral("org.bluez"), this))
 {
+    connect(m_bluezAdapters, &BluezAdapterCache::loaded, this, &Handler::bluetoothAdaptersLoaded);
     initKdedModule();
     QDBusConnection::sessionBus().connect(QStringLiteral(AGENT_SERVICE),
                                             QStringLiteral(AGENT_PATH),
@@ -247,6 +250,7 @@ void Handler::addAndActivateConnection(const QString& device, const QString& spe
     }
 
     if (!ap) {
+        qCWarning(PLASMA_NM) << "Failed to add connection: access point" << specificObject << "not found";
         return;
     }
 
@@ -398,59 +402,41 @@ void Handler::enableAirplaneMode(bool enable)
 
 void Handler::enableBluetooth(bool enable)
 {
-    qDBusRegisterMetaType< QMap<QDBusObjectPath, NMVariantMapMap > >();
+    if (!m_bluezAdapters->isLoaded()) {
+        m_bluetoothPending = true;
+        m_bluetoothEnabled = enable;
+        return;
+    }
 
-    QDBusMessage message = QDBusMessage::createMethodCall("org.bluez", "/", "org.freedesktop.DBus.ObjectManager", "GetManagedObjects");
-    QDBusPendingReply<QMap<QDBusObjectPath, NMVariantMapMap> > reply = QDBusConnection::systemBus().asyncCall(message);
-    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
-    connect(watcher, &QDBusPendingCallWatcher::finished,
-        [this, enable] (QDBusPendingCallWatcher *watcher) {
-            QDBusPendingReply<QMap<QDBusObjectPath, NMVariantMapMap> > reply = *watcher;
-            if (reply.isValid()) {
-                for (const QDBusObjectPath &path : reply.value().keys()) {
-                    const QString objPath = path.path();
-                    qCDebug(PLASMA_NM) << "inspecting path" << objPath;
-                    const QStringList interfaces = reply.value().value(path).keys();
-                    qCDebug(PLASMA_NM) << "interfaces:" << interfaces;
-                    if (interfaces.contains("org.bluez.Adapter1")) {
-                        // We need to check previous state first
-                        if (!enable) {
-                            QDBusMessage message = QDBusMessage::createMethodCall("org.bluez", objPath, "org.freedesktop.DBus.Properties", "Get");
-                            QList<QVariant> arguments;
-                            arguments << QLatin1String("org.bluez.Adapter1");
-                            arguments << QLatin1String("Powered");
-                            message.setArguments(arguments);
-                            QDBusPendingReply<QVariant> getReply = QDBusConnection::systemBus().asyncCall(message);
-                            QDBusPendingCallWatcher *getWatcher = new QDBusPendingCallWatcher(getReply, this);
-                                connect(getWatcher, &QDBusPendingCallWatcher::finished,
-                                    [this, objPath] (QDBusPendingCallWatcher *watcher) {
-                                        QDBusPendingReply<QVariant> reply = *watcher;
-                                        if (reply.isValid()) {
-                                            m_bluetoothAdapters.insert(objPath, reply.value().toBool());
-                                            QDBusMessage message = QDBusMessage::createMethodCall("org.bluez", objPath, "org.freedesktop.DBus.Properties", "Set");
-                                            QList<QVariant> arguments;
-                                            arguments << QLatin1String("org.bluez.Adapter1");
-                                            arguments << QLatin1String("Powered");
-                                            arguments << QVariant::fromValue(QDBusVariant(QVariant(false)));
-                                            message.setArguments(arguments);
-                                            QDBusConnection::systemBus().asyncCall(message);
-                                        }
-                                        watcher->deleteLater();
-                                    });
-                        } else if (enable && m_bluetoothAdapters.value(objPath)) {
-                            QDBusMessage message = QDBusMessage::createMethodCall("org.bluez", objPath, "org.freedesktop.DBus.Properties", "Set");
-                            QList<QVariant> arguments;
-                            arguments << QLatin1String("org.bluez.Adapter1");
-                            arguments << QLatin1String("Powered");
-                            arguments << QVariant::fromValue(QDBusVariant(QVariant(enable)));
-                            message.setArguments(arguments);
-                            QDBusConnection::systemBus().asyncCall(message);
-                        }
-                    }
-                }
+    // The state of the adapters is cached, all of them are switched at once
+    QStringList adapters;
+    if (!enable) {
+        m_bluetoothAdapters.clear();
+        for (const QString &adapter : m_bluezAdapters->adapters()) {
+            const bool powered = m_bluezAdapters->isPowered(adapter);
+            m_bluetoothAdapters.insert(adapter, powered);
+            if (powered) {
+                adapters << adapter;
             }
-            watcher->deleteLater();
-        });
+        }
+    } else {
+        for (const QString &adapter : m_bluezAdapters->adapters()) {
+            if (m_bluetoothAdapters.value(adapter)) {
+                adapters << adapter;
+            }
+        }
+    }
+
+    qCDebug(PLASMA_NM) << "Switching bluetooth adapters" << adapters << (enable ? "on" : "off");
+    m_bluezAdapters->setPowered(adapters, enable);
+}
+
+void Handler::bluetoothAdaptersLoaded()
+{
+    if (m_bluetoothPending) {
+        m_bluetoothPending = false;
+        enableBluetooth(m_bluetoothEnabled);
+    }
 }
 
 void Handler::enableNetworking(bool enable)
@@ -548,6 +534,11 @@ void Handler::requestScan(const QString &interface)
 }
 
 void Handler::createHotspot()
+{
+    addHotspot(true);
+}
+
+void Handler::addHotspot(bool pinChannel)
 {
     bool foundInactive = false;
     bool useApMode = false;
@@ -593,6 +584,24 @@ void Handler::createHotspot()
     wifiSetting->setInitialized(true);
     wifiSetting->setMode(useApMode ? NetworkManager::WirelessSetting::Ap :NetworkManager::WirelessSetting::Adhoc);
 
+    // Use the least congested channel of the networks around, 5 GHz only works in AP mode
+    HotspotChannelScorer channelScorer;
+    for (const NetworkManager::WirelessNetwork::Ptr &network : wifiDev->networks()) {
+        for (const NetworkManager::AccessPoint::Ptr &ap : network->accessPoints()) {
+            channelScorer.addAccessPoint(ap->frequency(), ap->signalStrength());
+        }
+    }
+    const bool use5GHz = useApMode && wifiDev->wirelessCapabilities().testFlag(NetworkManager::WirelessDevice::Freq5Ghz);
+    const HotspotChannelScorer::Channel channel = channelScorer.bestChannel(use5GHz);
+    // Not every channel the card can use is allowed for an access point (e.g. no-IR channels
+    // of the regulatory domain), so a pinned channel falls back to NetworkManager's choice
+    m_hotspotPinnedChannel = pinChannel && channel.band != NetworkManager::WirelessSetting::Automatic;
+    if (m_hotspotPinnedChannel) {
+        qCDebug(PLASMA_NM) << "Creating hotspot on channel" << channel.channel << "with congestion" << channel.congestion;
+        wifiSetting->setBand(channel.band);
+        wifiSetting->setChannel(channel.channel);
+    }
+
     if (!Configuration::hotspotPassword().isEmpty()) {
         NetworkManager::WirelessSecuritySetting::Ptr wifiSecurity = connectionSettings->setting(NetworkManager::Setting::WirelessSecurity).dynamicCast<NetworkManager::WirelessSecuritySetting>();
         wifiSecurity->setInitialized(true);
@@ -627,7 +636,10 @@ void Handler::createHotspot()
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
     watcher->setProperty("action", Handler::CreateHotspot);
     watcher->setProperty("connection", Configuration::hotspotName());
-    connect(watcher, &QDBusPendingCallWatcher::finished, this, &Handler::replyFinished);
+    // Failures of a pinned channel are retried without notification in hotspotCreated
+    if (!m_hotspotPinnedChannel) {
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, &Handler::replyFinished);
+    }
     connect(watcher, &QDBusPendingCallWatcher::finished, this, QOverload<QDBusPendingCallWatcher *>::of(&Handler::hotspotCreated));
 }
 
@@ -645,6 +657,7 @@ void Handler::stopHotspot()
         return;
     }
 
+    m_hotspotPinnedChannel = false;
     NetworkManager::deactivateConnection(activeConnectionPath);
     Configuration::setHotspotConnectionPath(QString());
 
@@ -745,6 +758,38 @@ void Handler::initKdedModule()
     QDBusConnection::sessionBus().send(initMsg);
 }
 
+void Handler::requestActivationMetrics()
+{
+    QDBusMessage msg = QDBusMessage::createMethodCall(QStringLiteral(AGENT_SERVICE),
+                                                      QStringLiteral(AGENT_PATH),
+                                                      QStringLiteral(AGENT_IFACE),
+                                                      QStringLiteral("activationMetrics"));
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(msg), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this] (QDBusPendingCallWatcher *watcher) {
+        QDBusPendingReply<NMVariantMapMap> reply = *watcher;
+        QVariantList metrics;
+        if (reply.isError()) {
+            qCWarning(PLASMA_NM) << "Failed to get the activation metrics:" << reply.error().message();
+        } else {
+            const NMVariantMapMap map = reply.value();
+            for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+                QVariantMap entry = it.value();
+                QString title;
+                const QString icon = UiUtils::iconAndTitleForConnectionSettingsType(NetworkManager::ConnectionSettings::typeFromString(it.key()), title);
+                entry.insert(QStringLiteral("type"), it.key());
+                entry.insert(QStringLiteral("title"), title);
+                entry.insert(QStringLiteral("icon"), icon);
+                metrics << entry;
+            }
+            std::sort(metrics.begin(), metrics.end(), [] (const QVariant &left, const QVariant &right) {
+                return left.toMap().value(QStringLiteral("title")).toString().localeAwareCompare(right.toMap().value(QStringLiteral("title")).toString()) < 0;
+            });
+        }
+        emit activationMetricsReceived(metrics);
+        watcher->deleteLater();
+    });
+}
+
 void Handler::secretAgentError(const QString &connectionPath, const QString &message)
 {
     // If the password was wrong, forget it
@@ -844,7 +889,13 @@ void Handler::hotspotCreated(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<QDBusObjectPath, QDBusObjectPath, QVariantMap> reply = *watcher;
 
-    if (!reply.isError() && reply.isValid()) {
+    // replyFinished isn't connected for a pinned channel
+    watcher->deleteLater();
+
+    if (reply.isError() && m_hotspotPinnedChannel) {
+        qCWarning(PLASMA_NM) << "Failed to create hotspot on the chosen channel, retrying on any channel:" << reply.error().message();
+        addHotspot(false);
+    } else if (!reply.isError() && reply.isValid()) {
         const QString activeConnectionPath = reply.argumentAt(1).value<QDBusObjectPath>().path();
 
         if (activeConnectionPath.isEmpty()) {
@@ -859,10 +910,18 @@ void Handler::hotspotCreated(QDBusPendingCallWatcher *watcher)
             return;
         }
 
-        connect(hotspot.data(), &NetworkManager::ActiveConnection::stateChanged, [=] (NetworkManager::ActiveConnection::State state) {
-            if (state > NetworkManager::ActiveConnection::Activated) {
+        connect(hotspot.data(), &NetworkManager::ActiveConnection::stateChanged, this, [=] (NetworkManager::ActiveConnection::State state) {
+            if (state == NetworkManager::ActiveConnection::Activated) {
+                m_hotspotPinnedChannel = false;
+            } else if (state > NetworkManager::ActiveConnection::Activated) {
                 Configuration::setHotspotConnectionPath(QString());
                 Q_EMIT hotspotDisabled();
+
+                // The activation on the chosen channel failed, let NetworkManager pick one once
+                if (m_hotspotPinnedChannel) {
+                    qCWarning(PLASMA_NM) << "Failed to activate hotspot on the chosen channel, retrying on any channel";
+                    addHotspot(false);
+                }
             }
         });
 
@@ -32,6 +32,7 @@
 #include <ModemManagerQt/GenericTypes>
 #endif
 
+class BluezAdapterCache;
 
 class Q_DECL_EXPORT Handler : public QObject
 {
@@ -123,6 +124,10 @@ public Q_SLOTS:
 
     void createHotspot();
     void stopHotspot();
+    /**
+     * Asks the kded module for the activation latencies, answered with activationMetricsReceived()
+     */
+    void requestActivationMetrics();
 
 private Q_SLOTS:
     void initKdedModule();
@@ -130,6 +135,7 @@ private Q_SLOTS:
     void replyFinished(QDBusPendingCallWatcher *watcher);
     void hotspotCreated(QDBusPendingCallWatcher *watcher);
     void primaryConnectionTypeChanged(NetworkManager::ConnectionSettings::ConnectionType type);
+    void bluetoothAdaptersLoaded();
 #if WITH_MODEMMANAGER_SUPPORT
     void unlockRequiredChanged(MMModemLock modemLock);
 #endif
@@ -139,6 +145,11 @@ Q_SIGNALS:
     void hotspotCreated();
     void hotspotDisabled();
     void hotspotSupportedChanged(bool hotspotSupported);
+    /**
+     * @metrics - one map per connection type with its "type", "title" and "icon"
+     * besides the metrics of the kded module, sorted by title
+     */
+    void activationMetricsReceived(const QVariantList &metrics);
 private:
     bool m_hotspotSupported;
     bool m_tmpWirelessEnabled;
@@ -149,9 +160,17 @@ private:
     QString m_tmpConnectionUuid;
     QString m_tmpDevicePath;
     QString m_tmpSpecificPath;
+    // Adapters powered before airplane mode was enabled
     QMap<QString, bool> m_bluetoothAdapters;
+    BluezAdapterCache *m_bluezAdapters;
+    // Toggle requested before the adapters were known
+    bool m_bluetoothPending = false;
+    bool m_bluetoothEnabled = false;
     QMap<QString, QTimer*> m_wirelessScanRetryTimer;
+    // The hotspot was pinned to a channel and hasn't been activated yet
+    bool m_hotspotPinnedChannel = false;
 
+    void addHotspot(bool pinChannel);
     void enableBluetooth(bool enable);
     void scanRequestFailed(const QString &interface);
     bool checkRequestScanRateLimit(const NetworkManager::WirelessDevice::Ptr &wifiDevice);
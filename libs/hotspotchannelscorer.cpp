@@ -0,0 +1,119 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "hotspotchannelscorer.h"
+
+#include <algorithm>
+
+// Channels which don't overlap each other in 2.4 GHz
+static const int s_bgChannels[] = {1, 6, 11};
+// 5 GHz channels without radar detection, which access points may use everywhere
+static const int s_aChannels[] = {36, 40, 44, 48};
+
+// Added to the congestion of 5 GHz channels, which clients and the regulatory domain
+// support less often than 2.4 GHz, so they're only used when clearly less congested
+#define NM_HOTSPOT_A_PENALTY 0.5
+// Weight of the weakest access point, so networks at the edge of range still count
+#define NM_HOTSPOT_MIN_WEIGHT 0.1
+
+void HotspotChannelScorer::addAccessPoint(uint frequency, int signalStrength)
+{
+    AccessPoint accessPoint;
+    if (frequency >= 2412 && frequency <= 2472) {
+        accessPoint.band = NetworkManager::WirelessSetting::Bg;
+        accessPoint.channel = (frequency - 2407) / 5;
+    } else if (frequency == 2484) {
+        accessPoint.band = NetworkManager::WirelessSetting::Bg;
+        accessPoint.channel = 14;
+    } else if (frequency >= 5000 && frequency < 5900) {
+        accessPoint.band = NetworkManager::WirelessSetting::A;
+        accessPoint.channel = (frequency - 5000) / 5;
+    } else {
+        return;
+    }
+
+    const qreal strength = qBound(0, signalStrength, 100) / 100.0;
+    accessPoint.weight = NM_HOTSPOT_MIN_WEIGHT + (1 - NM_HOTSPOT_MIN_WEIGHT) * strength * strength;
+    m_accessPoints << accessPoint;
+}
+
+void HotspotChannelScorer::clear()
+{
+    m_accessPoints.clear();
+}
+
+qreal HotspotChannelScorer::congestion(NetworkManager::WirelessSetting::FrequencyBand band, int channel) const
+{
+    qreal congestion = 0;
+    for (const AccessPoint &accessPoint : m_accessPoints) {
+        if (accessPoint.band != band) {
+            continue;
+        }
+
+        const int distance = qAbs(accessPoint.channel - channel);
+        if (band == NetworkManager::WirelessSetting::Bg) {
+            // 2.4 GHz channels are 5 MHz apart, 20 MHz wide channels overlap up to 4 channels away
+            if (distance < 5) {
+                congestion += accessPoint.weight * (5 - distance) / 5.0;
+            }
+        } else if (distance <= 4) {
+            // 5 GHz channels don't overlap at 20 MHz, only neighbours bonded into wider channels
+            congestion += accessPoint.weight * (distance ? 0.5 : 1);
+        }
+    }
+    return congestion;
+}
+
+QVector<HotspotChannelScorer::Channel> HotspotChannelScorer::rankedChannels(bool use5GHz) const
+{
+    QVector<Channel> channels;
+    for (int channel : s_bgChannels) {
+        Channel candidate;
+        candidate.band = NetworkManager::WirelessSetting::Bg;
+        candidate.channel = channel;
+        candidate.congestion = congestion(candidate.band, channel);
+        channels << candidate;
+    }
+    if (use5GHz) {
+        for (int channel : s_aChannels) {
+            Channel candidate;
+            candidate.band = NetworkManager::WirelessSetting::A;
+            candidate.channel = channel;
+            candidate.congestion = congestion(candidate.band, channel);
+            channels << candidate;
+        }
+    }
+
+    auto score = [] (const Channel &channel) {
+        return channel.congestion + (channel.band == NetworkManager::WirelessSetting::A ? NM_HOTSPOT_A_PENALTY : 0);
+    };
+    // Stable, so ties keep the lower channel
+    std::stable_sort(channels.begin(), channels.end(), [score] (const Channel &left, const Channel &right) {
+        return score(left) < score(right);
+    });
+    return channels;
+}
+
+HotspotChannelScorer::Channel HotspotChannelScorer::bestChannel(bool use5GHz) const
+{
+    const QVector<Channel> channels = rankedChannels(use5GHz);
+    return channels.isEmpty() ? Channel() : channels.first();
+}
@@ -0,0 +1,76 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef PLASMA_NM_HOTSPOT_CHANNEL_SCORER_H
+#define PLASMA_NM_HOTSPOT_CHANNEL_SCORER_H
+
+#include <QVector>
+
+#include <NetworkManagerQt/WirelessSetting>
+
+/**
+ * Picks the channel for a hotspot with the least congestion. Every access point
+ * seen in the scans adds to the congestion of the channels it overlaps, weighted
+ * by its signal strength, so a channel shared with weak networks far away is
+ * preferred to one next to a strong network.
+ */
+class Q_DECL_EXPORT HotspotChannelScorer
+{
+public:
+    struct Channel {
+        NetworkManager::WirelessSetting::FrequencyBand band = NetworkManager::WirelessSetting::Automatic;
+        int channel = 0;
+        qreal congestion = 0;
+    };
+
+    /**
+     * @p frequency in MHz, @p signalStrength in percent
+     */
+    void addAccessPoint(uint frequency, int signalStrength);
+    void clear();
+
+    /**
+     * Congestion of a 20 MHz channel, 0 when no access point overlaps it
+     */
+    qreal congestion(NetworkManager::WirelessSetting::FrequencyBand band, int channel) const;
+
+    /**
+     * Candidates of the bands, sorted by score. 5 GHz channels get a penalty, so they
+     * only win when they're clearly less congested than the best 2.4 GHz channel.
+     */
+    QVector<Channel> rankedChannels(bool use5GHz) const;
+
+    /**
+     * The best channel, with band Automatic when there's no candidate
+     */
+    Channel bestChannel(bool use5GHz) const;
+
+private:
+    struct AccessPoint {
+        NetworkManager::WirelessSetting::FrequencyBand band;
+        int channel;
+        qreal weight;
+    };
+
+    QVector<AccessPoint> m_accessPoints;
+};
+
+#endif // PLASMA_NM_HOTSPOT_CHANNEL_SCORER_H
@@ -34,8 +34,19 @@ AppletProxyModel::~AppletProxyModel()
 {
 }
 
+void AppletProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    m_networkModel = qobject_cast<NetworkModel*>(sourceModel);
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
+
 bool AppletProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
 {
+    // Unavailable connections, usually most of the rows, are rejected without evaluating their roles
+    if (m_networkModel && !(m_networkModel->partitions(source_row) & NetworkModel::AvailablePartition)) {
+        return false;
+    }
+
     const QModelIndex index = sourceModel()->index(source_row, 0, source_parent);
 
     // slaves are filtered-out when not searching for a connection (makes the state of search results clear)
@@ -25,6 +25,8 @@
 
 #include "networkmodelitem.h"
 
+class NetworkModel;
+
 class Q_DECL_EXPORT AppletProxyModel : public QSortFilterProxyModel
 {
 Q_OBJECT
@@ -33,9 +35,14 @@ public:
     explicit AppletProxyModel(QObject *parent = nullptr);
     ~AppletProxyModel() override;
 
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
 protected:
     bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override;
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    NetworkModel *m_networkModel = nullptr;
 };
 
 
@@ -19,8 +19,11 @@
 */
 
 #include "editorproxymodel.h"
+#include "networkmodel.h"
 #include "uiutils.h"
 
+#include <QIdentityProxyModel>
+
 EditorProxyModel::EditorProxyModel(QObject *parent)
     : QSortFilterProxyModel(parent)
 {
@@ -34,8 +37,26 @@ EditorProxyModel::~EditorProxyModel()
 {
 }
 
+void EditorProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    QAbstractItemModel *model = sourceModel;
+    while (QIdentityProxyModel *identityModel = qobject_cast<QIdentityProxyModel*>(model)) {
+        model = identityModel->sourceModel();
+    }
+    m_networkModel = qobject_cast<NetworkModel*>(model);
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
+
 bool EditorProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
 {
+    // Access points without a connection, often most of the rows, are rejected without evaluating their roles
+    if (m_networkModel) {
+        const NetworkModel::Partitions partitions = m_networkModel->partitions(source_row);
+        if (partitions & (NetworkModel::AccessPointPartition | NetworkModel::SlavePartition)) {
+            return false;
+        }
+    }
+
     const QModelIndex index = sourceModel()->index(source_row, 0, source_parent);
 
     // slaves are always filtered-out
@@ -25,6 +25,8 @@
 
 #include <QSortFilterProxyModel>
 
+class NetworkModel;
+
 class Q_DECL_EXPORT EditorProxyModel : public QSortFilterProxyModel
 {
 Q_OBJECT
@@ -33,9 +35,15 @@ public:
     explicit EditorProxyModel(QObject *parent = nullptr);
     ~EditorProxyModel() override;
 
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
 protected:
     bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override;
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    // The network model, also behind identity proxies which keep its rows
+    NetworkModel *m_networkModel = nullptr;
 };
 
 
@@ -46,8 +46,26 @@ bool MobileProxyModel::showSavedMode() const{
     return m_showSavedMode;
 }
 
+void MobileProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    m_networkModel = qobject_cast<NetworkModel*>(sourceModel);
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
+
 bool MobileProxyModel::filterAcceptsRow(int source_row, const QModelIndex& source_parent) const
 {
+    // Only wireless connections which are not slaves are shown, saved ones or available ones
+    // depending on the mode, reject the rest without evaluating their roles
+    if (m_networkModel) {
+        const NetworkModel::Partitions partitions = m_networkModel->partitions(source_row);
+        if (!(partitions & NetworkModel::WirelessPartition) || (partitions & NetworkModel::SlavePartition)) {
+            return false;
+        }
+        if (showSavedMode() != partitions.testFlag(NetworkModel::UnavailablePartition)) {
+            return false;
+        }
+    }
+
     const QModelIndex index = sourceModel()->index(source_row, 0, source_parent);
 
     // slaves are always filtered-out
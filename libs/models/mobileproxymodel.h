@@ -25,6 +25,8 @@
 
 #include <QSortFilterProxyModel>
 
+class NetworkModel;
+
 class Q_DECL_EXPORT MobileProxyModel : public QSortFilterProxyModel
 {
 Q_OBJECT
@@ -35,6 +37,7 @@ public:
     virtual ~MobileProxyModel();
     void setShowSavedMode(bool mode);
     bool showSavedMode() const;
+    void setSourceModel(QAbstractItemModel *sourceModel) Q_DECL_OVERRIDE;
 signals:
     void showSavedModeChanged(bool mode);
 
@@ -43,6 +46,7 @@ protected:
     bool lessThan(const QModelIndex& left, const QModelIndex& right) const Q_DECL_OVERRIDE;
 private:
     bool m_showSavedMode;
+    NetworkModel *m_networkModel = nullptr;
 };
 
 #endif // PLASMA_NM_MOBILE_PROXY_MODEL_H
@@ -21,6 +21,13 @@
 #include "networkitemslist.h"
 #include "networkmodelitem.h"
 
+// Filters on object paths and SSIDs, which items keep in the string pool of NetworkModelItem
+static bool isPathFilter(NetworkItemsList::FilterType type)
+{
+    return type == NetworkItemsList::ActiveConnection || type == NetworkItemsList::Connection
+        || type == NetworkItemsList::Device || type == NetworkItemsList::Ssid;
+}
+
 NetworkItemsList::NetworkItemsList(QObject *parent)
     : QObject(parent)
 {
@@ -33,20 +40,25 @@ NetworkItemsList::~NetworkItemsList()
 
 bool NetworkItemsList::contains(const NetworkItemsList::FilterType type, const QString &parameter) const
 {
+    quint32 id = 0;
+    if (isPathFilter(type) && !NetworkModelItem::findStringId(parameter, &id)) {
+        return false;
+    }
+
     for (NetworkModelItem *item : m_items) {
         switch (type) {
             case NetworkItemsList::ActiveConnection:
-                if (item->activeConnectionPath() == parameter) {
+                if (item->activeConnectionPathId() == id) {
                     return true;
                 }
                 break;
             case NetworkItemsList::Connection:
-                if (item->connectionPath() == parameter) {
+                if (item->connectionPathId() == id) {
                     return true;
                 }
                 break;
             case NetworkItemsList::Device:
-                if (item->devicePath() == parameter) {
+                if (item->devicePathId() == id) {
                     return true;
                 }
                 break;
@@ -56,7 +68,7 @@ bool NetworkItemsList::contains(const NetworkItemsList::FilterType type, const Q
                 }
                 break;
             case NetworkItemsList::Ssid:
-                if (item->ssid() == parameter) {
+                if (item->ssidId() == id) {
                     return true;
                 }
                 break;
@@ -108,26 +120,32 @@ QList< NetworkModelItem*> NetworkItemsList::returnItems(const NetworkItemsList::
 {
     QList<NetworkModelItem*> result;
 
+    quint32 id = 0;
+    if (isPathFilter(type) && !NetworkModelItem::findStringId(parameter, &id)) {
+        return result;
+    }
+
+    // The device is only used to narrow down connections and SSIDs
+    quint32 deviceId = 0;
+    const bool filterDevice = !additionalParameter.isEmpty() && (type == NetworkItemsList::Connection || type == NetworkItemsList::Ssid);
+    if (filterDevice && !NetworkModelItem::findStringId(additionalParameter, &deviceId)) {
+        return result;
+    }
+
     for (NetworkModelItem *item : m_items) {
         switch (type) {
             case NetworkItemsList::ActiveConnection:
-                if (item->activeConnectionPath() == parameter) {
+                if (item->activeConnectionPathId() == id) {
                     result << item;
                 }
                 break;
             case NetworkItemsList::Connection:
-                if (item->connectionPath() == parameter) {
-                    if (additionalParameter.isEmpty()) {
-                        result << item;
-                    } else {
-                        if (item->devicePath() == additionalParameter) {
-                            result << item;
-                        }
-                    }
+                if (item->connectionPathId() == id && (!filterDevice || item->devicePathId() == deviceId)) {
+                    result << item;
                 }
                 break;
             case NetworkItemsList::Device:
-                if (item->devicePath() == parameter) {
+                if (item->devicePathId() == id) {
                     result << item;
                 }
                 break;
@@ -137,14 +155,8 @@ QList< NetworkModelItem*> NetworkItemsList::returnItems(const NetworkItemsList::
                 }
                 break;
             case NetworkItemsList::Ssid:
-                if (item->ssid() == parameter) {
-                    if (additionalParameter.isEmpty()) {
-                        result << item;
-                    } else {
-                        if (item->devicePath() == additionalParameter) {
-                            result << item;
-                        }
-                    }
+                if (item->ssidId() == id && (!filterDevice || item->devicePathId() == deviceId)) {
+                    result << item;
                 }
                 break;
             case NetworkItemsList::Uuid:
@@ -22,6 +22,8 @@
 #include "networkmodelitem.h"
 #include "configuration.h"
 #include "debug.h"
+#include "networkmanagerloader.h"
+#include "networkmodelpublisher.h"
 #include "uiutils.h"
 
 #if WITH_MODEMMANAGER_SUPPORT
@@ -31,22 +33,93 @@
 #include <NetworkManagerQt/Settings>
 #include <NetworkManagerQt/Utils>
 
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDataStream>
+#include <QStandardPaths>
+
+#include <KConfig>
+#include <KConfigGroup>
+
+// Delay between a change of visible wireless networks and writing them into the scan cache
+#define NM_SCAN_CACHE_SAVE_DELAY 5000
+// Cached networks not confirmed by a scan within this time are dropped
+#define NM_SCAN_CACHE_STALE_TIMEOUT 30000
+
+// The kded module publishing its model, see NetworkManagementService
+#define KDED_SERVICE "org.kde.kded5"
+#define KDED_PATH "/modules/networkmanagement"
+#define KDED_IFACE "org.kde.plasmanetworkmanagement"
+
 NetworkModel::NetworkModel(QObject *parent)
+    : NetworkModel(AutomaticSource, parent)
+{
+}
+
+NetworkModel::NetworkModel(Source source, QObject *parent)
     : QAbstractListModel(parent)
 {
     QLoggingCategory::setFilterRules(QStringLiteral("plasma-nm.debug = false"));
 
-    initialize();
+    m_scanCacheTimer.setSingleShot(true);
+    m_scanCacheTimer.setInterval(NM_SCAN_CACHE_SAVE_DELAY);
+    connect(&m_scanCacheTimer, &QTimer::timeout, this, &NetworkModel::saveScanCache);
+
+    m_lastUsedTimer.setSingleShot(true);
+    connect(&m_lastUsedTimer, &QTimer::timeout, this, &NetworkModel::updateLastUsed);
+
+    // Connected before any proxy model so partitions are up to date when proxies filter
+    connect(this, &NetworkModel::rowsInserted, this, &NetworkModel::rowsInsertedIntoList);
+    connect(this, &NetworkModel::rowsRemoved, this, &NetworkModel::rowsRemovedFromList);
+    connect(this, &NetworkModel::dataChanged, this, &NetworkModel::rowsDataChanged);
+    connect(this, &NetworkModel::modelReset, this, &NetworkModel::rowsReset);
+
+    if (source == LocalSource) {
+        initialize();
+        return;
+    }
+
+    m_replica = true;
+    if (source == ReplicaSource) {
+        return;
+    }
+
+    // Every applet and the KCM share the model of the kded module instead of fetching
+    // everything from NetworkManager on their own
+    QDBusConnectionInterface *bus = QDBusConnection::sessionBus().interface();
+    if (!bus || !bus->isServiceRegistered(QStringLiteral(KDED_SERVICE))) {
+        switchToLocal();
+        return;
+    }
+
+    m_kdedWatcher = new QDBusServiceWatcher(QStringLiteral(KDED_SERVICE), QDBusConnection::sessionBus(),
+                                            QDBusServiceWatcher::WatchForUnregistration, this);
+    connect(m_kdedWatcher, &QDBusServiceWatcher::serviceUnregistered, this, &NetworkModel::switchToLocal);
+    QDBusConnection::sessionBus().connect(QStringLiteral(KDED_SERVICE), QStringLiteral(KDED_PATH), QStringLiteral(KDED_IFACE),
+                                          QStringLiteral("networkModelChanged"), this, SLOT(replicaDeltaReceived(QByteArray)));
+    requestReplicaSnapshot();
 }
 
 NetworkModel::~NetworkModel()
 {
+    if (m_scanCacheTimer.isActive()) {
+        saveScanCache();
+    }
 }
 
 QVariant NetworkModel::data(const QModelIndex &index, int role) const
 {
     const int row = index.row();
 
+    if (m_replica) {
+        if (row >= 0 && row < m_replicaRows.count() && role >= ConnectionDetailsRole && role <= TxBytesRole) {
+            return m_replicaRows.at(row).at(role - ConnectionDetailsRole);
+        }
+        return QVariant();
+    }
+
     if (row >= 0 && row < m_list.count()) {
         NetworkModelItem *item = m_list.itemAt(row);
 
@@ -68,7 +141,14 @@ QVariant NetworkModel::data(const QModelIndex &index, int role) const
             case DuplicateRole:
                 return item->duplicate();
             case ItemUniqueNameRole:
-                if (m_list.returnItems(NetworkItemsList::Name, item->name()).count() > 1) {
+                if (!m_nameCountsValid) {
+                    m_nameCounts.clear();
+                    for (const NetworkModelItem *listItem : m_list.items()) {
+                        ++m_nameCounts[listItem->name()];
+                    }
+                    m_nameCountsValid = true;
+                }
+                if (m_nameCounts.value(item->name()) > 1) {
                     return item->originalName();
                 } else {
                     return item->name();
@@ -76,9 +156,9 @@ QVariant NetworkModel::data(const QModelIndex &index, int role) const
             case ItemTypeRole:
                 return item->itemType();
             case LastUsedRole:
-                return UiUtils::formatLastUsedDateRelative(item->timestamp());
+                return item->lastUsed();
             case LastUsedDateOnlyRole:
-                return UiUtils::formatDateRelative(item->timestamp());
+                return item->lastUsedDateOnly();
             case NameRole:
                 return item->name();
             case SectionRole:
@@ -91,6 +171,8 @@ QVariant NetworkModel::data(const QModelIndex &index, int role) const
                 return item->ssid();
             case SpecificPathRole:
                 return item->specificPath();
+            case StaleRole:
+                return item->stale();
             case SecurityTypeRole:
                 return item->securityType();
             case SecurityTypeStringRole:
@@ -122,7 +204,10 @@ QVariant NetworkModel::data(const QModelIndex &index, int role) const
 int NetworkModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
-    return parent.isValid() ? 0 : m_list.count();
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_replica ? m_replicaRows.count() : m_list.count();
 }
 
 QHash<int, QByteArray> NetworkModel::roleNames() const
@@ -146,6 +231,7 @@ QHash<int, QByteArray> NetworkModel::roleNames() const
     roles[SlaveRole] = "Slave";
     roles[SsidRole] = "Ssid";
     roles[SpecificPathRole] = "SpecificPath";
+    roles[StaleRole] = "Stale";
     roles[SecurityTypeRole] = "SecurityType";
     roles[SecurityTypeStringRole] = "SecurityTypeString";
     roles[TimeStampRole] = "TimeStamp";
@@ -160,11 +246,318 @@ QHash<int, QByteArray> NetworkModel::roleNames() const
     return roles;
 }
 
+NetworkModel::Partitions NetworkModel::partitions(int row) const
+{
+    if (row >= 0 && row < m_partitions.count()) {
+        return m_partitions.at(row);
+    }
+
+    return Partitions();
+}
+
+NetworkModel::Partitions NetworkModel::partitionsForRow(int row) const
+{
+    NetworkModelItem::ItemType itemType;
+    bool slave;
+    NetworkManager::ConnectionSettings::ConnectionType type;
+    if (m_replica) {
+        const QVector<QVariant> &values = m_replicaRows.at(row);
+        itemType = (NetworkModelItem::ItemType) values.at(ItemTypeRole - ConnectionDetailsRole).toUInt();
+        slave = values.at(SlaveRole - ConnectionDetailsRole).toBool();
+        type = (NetworkManager::ConnectionSettings::ConnectionType) values.at(TypeRole - ConnectionDetailsRole).toUInt();
+    } else {
+        const NetworkModelItem *item = m_list.itemAt(row);
+        itemType = item->itemType();
+        slave = item->slave();
+        type = item->type();
+    }
+
+    Partitions partitions;
+    if (itemType == NetworkModelItem::UnavailableConnection) {
+        partitions |= UnavailablePartition;
+    } else {
+        partitions |= AvailablePartition;
+        if (itemType == NetworkModelItem::AvailableAccessPoint) {
+            partitions |= AccessPointPartition;
+        }
+    }
+
+    if (slave) {
+        partitions |= SlavePartition;
+    }
+
+    if (type == NetworkManager::ConnectionSettings::Wireless) {
+        partitions |= WirelessPartition;
+    }
+
+    return partitions;
+}
+
+void NetworkModel::rowsDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles)
+{
+    if (roles.isEmpty() || roles.contains(NameRole)) {
+        m_nameCountsValid = false;
+    }
+
+    if (!roles.isEmpty() && !roles.contains(ItemTypeRole) && !roles.contains(SlaveRole) && !roles.contains(TypeRole)) {
+        return;
+    }
+
+    for (int row = topLeft.row(); row <= bottomRight.row() && row < m_partitions.count(); ++row) {
+        m_partitions[row] = partitionsForRow(row);
+    }
+}
+
+void NetworkModel::rowsInsertedIntoList(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+
+    m_nameCountsValid = false;
+    m_partitions.insert(first, last - first + 1, Partitions());
+    for (int row = first; row <= last; ++row) {
+        m_partitions[row] = partitionsForRow(row);
+    }
+}
+
+void NetworkModel::rowsRemovedFromList(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+
+    m_nameCountsValid = false;
+    m_partitions.remove(first, last - first + 1);
+}
+
+void NetworkModel::rowsReset()
+{
+    m_nameCountsValid = false;
+    m_partitions.resize(rowCount(QModelIndex()));
+    for (int row = 0; row < m_partitions.count(); ++row) {
+        m_partitions[row] = partitionsForRow(row);
+    }
+}
+
+bool NetworkModel::applySnapshot(const QByteArray &snapshot)
+{
+    QDataStream stream(snapshot);
+    stream.setVersion(QDataStream::Qt_5_12);
+
+    quint32 version;
+    qint32 roleCount;
+    quint64 serial;
+    qint32 count;
+    stream >> version >> roleCount >> serial >> count;
+    if (stream.status() != QDataStream::Ok || version != NM_MODEL_STREAM_VERSION || roleCount != RoleCount || count < 0) {
+        qCWarning(PLASMA_NM) << "Failed to read network model snapshot";
+        return false;
+    }
+
+    QVector<QVector<QVariant> > rows(count);
+    for (QVector<QVariant> &values : rows) {
+        stream >> values;
+        if (values.count() != RoleCount) {
+            qCWarning(PLASMA_NM) << "Failed to read network model snapshot";
+            return false;
+        }
+    }
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(PLASMA_NM) << "Failed to read network model snapshot";
+        return false;
+    }
+
+    beginResetModel();
+    m_replicaRows = rows;
+    m_replicaSerial = serial;
+    endResetModel();
+
+    return true;
+}
+
+bool NetworkModel::applyDelta(const QByteArray &delta)
+{
+    QDataStream stream(delta);
+    stream.setVersion(QDataStream::Qt_5_12);
+
+    quint32 version;
+    qint32 roleCount;
+    quint64 serial;
+    qint32 count;
+    stream >> version >> roleCount >> serial >> count;
+    if (stream.status() != QDataStream::Ok || version != NM_MODEL_STREAM_VERSION || roleCount != RoleCount) {
+        qCWarning(PLASMA_NM) << "Failed to read network model delta";
+        return false;
+    }
+
+    // Already part of the snapshot
+    if (serial <= m_replicaSerial) {
+        return true;
+    }
+
+    if (serial != m_replicaSerial + 1) {
+        qCDebug(PLASMA_NM) << "Missed network model deltas" << m_replicaSerial + 1 << "to" << serial - 1;
+        return false;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        quint8 operation;
+        qint32 first;
+        qint32 rows;
+        stream >> operation >> first;
+
+        switch (operation) {
+            case NetworkModelPublisher::InsertRows: {
+                stream >> rows;
+                if (first < 0 || first > m_replicaRows.count() || rows <= 0) {
+                    return false;
+                }
+                QVector<QVector<QVariant> > inserted(rows);
+                for (QVector<QVariant> &values : inserted) {
+                    stream >> values;
+                    if (values.count() != RoleCount) {
+                        return false;
+                    }
+                }
+                beginInsertRows(QModelIndex(), first, first + rows - 1);
+                for (int row = 0; row < rows; ++row) {
+                    m_replicaRows.insert(first + row, inserted.at(row));
+                }
+                endInsertRows();
+                break;
+            }
+            case NetworkModelPublisher::RemoveRows:
+                stream >> rows;
+                if (first < 0 || rows <= 0 || first + rows > m_replicaRows.count()) {
+                    return false;
+                }
+                beginRemoveRows(QModelIndex(), first, first + rows - 1);
+                m_replicaRows.remove(first, rows);
+                endRemoveRows();
+                break;
+            case NetworkModelPublisher::ChangeData: {
+                QVector<qint32> columns;
+                QVector<QVariant> values;
+                stream >> columns >> values;
+                if (first < 0 || first >= m_replicaRows.count() || columns.count() != values.count()) {
+                    return false;
+                }
+                QVector<int> roles;
+                QVector<QVariant> &row = m_replicaRows[first];
+                for (int column = 0; column < columns.count(); ++column) {
+                    if (columns.at(column) < 0 || columns.at(column) >= RoleCount) {
+                        return false;
+                    }
+                    row[columns.at(column)] = values.at(column);
+                    roles << ConnectionDetailsRole + columns.at(column);
+                }
+                const QModelIndex index = createIndex(first, 0);
+                Q_EMIT dataChanged(index, index, roles);
+                break;
+            }
+            case NetworkModelPublisher::ResetRows: {
+                // The count of rows takes the place of the first row
+                if (first < 0) {
+                    return false;
+                }
+                QVector<QVector<QVariant> > reset(first);
+                for (QVector<QVariant> &values : reset) {
+                    stream >> values;
+                    if (values.count() != RoleCount) {
+                        return false;
+                    }
+                }
+                beginResetModel();
+                m_replicaRows = reset;
+                endResetModel();
+                break;
+            }
+            default:
+                return false;
+        }
+
+        if (stream.status() != QDataStream::Ok) {
+            qCWarning(PLASMA_NM) << "Failed to read network model delta";
+            return false;
+        }
+    }
+
+    m_replicaSerial = serial;
+    return true;
+}
+
+void NetworkModel::requestReplicaSnapshot()
+{
+    m_replicaSnapshotPending = true;
+
+    QDBusMessage message = QDBusMessage::createMethodCall(QStringLiteral(KDED_SERVICE), QStringLiteral(KDED_PATH), QStringLiteral(KDED_IFACE),
+                                                          QStringLiteral("networkModelSnapshot"));
+    QDBusPendingReply<QByteArray> reply = QDBusConnection::sessionBus().asyncCall(message);
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this] (QDBusPendingCallWatcher *watcher) {
+        QDBusPendingReply<QByteArray> reply = *watcher;
+        if (m_replica && m_kdedWatcher) {
+            m_replicaSnapshotPending = false;
+            if (reply.isError()) {
+                qCDebug(PLASMA_NM) << "Network model of the kded module unavailable:" << reply.error().message();
+                switchToLocal();
+            } else if (!applySnapshot(reply.value())) {
+                switchToLocal();
+            }
+        }
+        watcher->deleteLater();
+    });
+}
+
+void NetworkModel::replicaDeltaReceived(const QByteArray &delta)
+{
+    // Deltas up to the snapshot are part of it, later ones are sent after its reply
+    if (!m_replica || m_replicaSnapshotPending) {
+        return;
+    }
+
+    if (!applyDelta(delta)) {
+        requestReplicaSnapshot();
+    }
+}
+
+void NetworkModel::switchToLocal()
+{
+    if (!m_replica) {
+        return;
+    }
+
+    if (m_kdedWatcher) {
+        QDBusConnection::sessionBus().disconnect(QStringLiteral(KDED_SERVICE), QStringLiteral(KDED_PATH), QStringLiteral(KDED_IFACE),
+                                                 QStringLiteral("networkModelChanged"), this, SLOT(replicaDeltaReceived(QByteArray)));
+        m_kdedWatcher->deleteLater();
+        m_kdedWatcher = nullptr;
+    }
+
+    beginResetModel();
+    m_replica = false;
+    m_replicaSnapshotPending = false;
+    m_replicaSerial = 0;
+    m_replicaRows.clear();
+    endResetModel();
+
+    initialize();
+}
+
 void NetworkModel::initialize()
 {
-    // Initialize existing connections
-    for (const NetworkManager::Connection::Ptr &connection : NetworkManager::listConnections()) {
-        addConnection(connection);
+    updateHotspotConnectionPath();
+
+    // Initialize existing connections, from the startup snapshot unless it couldn't be loaded
+    NetworkManagerLoader *loader = NetworkManagerLoader::self();
+    if (loader->isLoaded()) {
+        for (const QString &path : loader->objects(QStringLiteral(NM_DBUS_INTERFACE_SETTINGS_CONNECTION))) {
+            const NMVariantMapMap settings = loader->settings(path);
+            if (!settings.isEmpty()) {
+                addConnection(path, NetworkManager::ConnectionSettings::Ptr(new NetworkManager::ConnectionSettings(settings)));
+            }
+        }
+    } else {
+        for (const NetworkManager::Connection::Ptr &connection : NetworkManager::listConnections()) {
+            addConnection(connection->path(), connection->settings());
+        }
     }
 
     // Initialize existing devices
@@ -180,6 +573,9 @@ void NetworkModel::initialize()
         addActiveConnection(active);
     }
 
+    // Show networks from the last session until the first scan finishes
+    loadScanCache();
+
     initializeSignals();
 }
 
@@ -192,6 +588,9 @@ void NetworkModel::initializeSignals()
     connect(NetworkManager::notifier(), &NetworkManager::Notifier::deviceAdded, this, &NetworkModel::deviceAdded, Qt::UniqueConnection);
     connect(NetworkManager::notifier(), &NetworkManager::Notifier::deviceRemoved, this, &NetworkModel::deviceRemoved, Qt::UniqueConnection);
     connect(NetworkManager::notifier(), &NetworkManager::Notifier::statusChanged, this, &NetworkModel::statusChanged, Qt::UniqueConnection);
+    // One match rule for the updates of all connections, so connection objects don't need to be created to watch them
+    QDBusConnection::systemBus().connect(QStringLiteral(NM_DBUS_SERVICE), QString(), QStringLiteral(NM_DBUS_INTERFACE_SETTINGS_CONNECTION),
+                                         QStringLiteral("Updated"), this, SLOT(connectionUpdated(QDBusMessage)));
 }
 
 void NetworkModel::initializeSignals(const NetworkManager::ActiveConnection::Ptr &activeConnection)
@@ -206,11 +605,6 @@ void NetworkModel::initializeSignals(const NetworkManager::ActiveConnection::Ptr
     }
 }
 
-void NetworkModel::initializeSignals(const NetworkManager::Connection::Ptr &connection)
-{
-    connect(connection.data(), &NetworkManager::Connection::updated, this, &NetworkModel::connectionUpdated, Qt::UniqueConnection);
-}
-
 void NetworkModel::initializeSignals(const NetworkManager::Device::Ptr &device)
 {
     connect(device.data(), &NetworkManager::Device::availableConnectionAppeared, this, &NetworkModel::availableConnectionAppeared, Qt::UniqueConnection);
@@ -238,7 +632,7 @@ void NetworkModel::initializeSignals(const NetworkManager::Device::Ptr &device)
         NetworkManager::WirelessDevice::Ptr wifiDev = device.objectCast<NetworkManager::WirelessDevice>();
         connect(wifiDev.data(), &NetworkManager::WirelessDevice::networkAppeared, this, &NetworkModel::wirelessNetworkAppeared, Qt::UniqueConnection);
         connect(wifiDev.data(), &NetworkManager::WirelessDevice::networkDisappeared, this, &NetworkModel::wirelessNetworkDisappeared, Qt::UniqueConnection);
-
+        connect(wifiDev.data(), &NetworkManager::WirelessDevice::lastScanChanged, this, &NetworkModel::wirelessDeviceScanFinished, Qt::UniqueConnection);
     }
 
 #if WITH_MODEMMANAGER_SUPPORT
@@ -264,6 +658,86 @@ void NetworkModel::initializeSignals(const NetworkManager::WirelessNetwork::Ptr
     connect(network.data(), &NetworkManager::WirelessNetwork::referenceAccessPointChanged, this, &NetworkModel::wirelessNetworkReferenceApChanged, Qt::UniqueConnection);
 }
 
+void NetworkModel::loadScanCache()
+{
+    QHash<QString, NetworkManager::WirelessDevice::Ptr> wifiDevices;
+    for (const NetworkManager::Device::Ptr &device : NetworkManager::networkInterfaces()) {
+        if (device->type() == NetworkManager::Device::Wifi && device->managed()) {
+            wifiDevices.insert(device->interfaceName(), device.objectCast<NetworkManager::WirelessDevice>());
+        }
+    }
+
+    if (wifiDevices.isEmpty()) {
+        return;
+    }
+
+    bool staleItemsAdded = false;
+    KConfig config(QStringLiteral("plasma-nm-networks"), KConfig::SimpleConfig, QStandardPaths::GenericCacheLocation);
+    for (const QString &group : config.groupList()) {
+        KConfigGroup grp(&config, group);
+        const QString ssid = grp.readEntry(QLatin1String("Ssid"), QString());
+        NetworkManager::WirelessDevice::Ptr device = wifiDevices.value(grp.readEntry(QLatin1String("Device"), QString()));
+
+        if (ssid.isEmpty() || !device || device->state() == NetworkManager::Device::Unavailable) {
+            continue;
+        }
+
+        // NetworkManager already knows this network
+        if (!m_list.returnItems(NetworkItemsList::Ssid, ssid, device->uni()).isEmpty()) {
+            continue;
+        }
+
+        const int signal = grp.readEntry(QLatin1String("Signal"), 0);
+        const QString deviceName = device->ipInterfaceName().isEmpty() ? device->interfaceName() : device->ipInterfaceName();
+
+        // Prefer to show an existing connection for this network as available
+        NetworkModelItem *connectionItem = nullptr;
+        for (NetworkModelItem *item : m_list.returnItems(NetworkItemsList::Ssid, ssid)) {
+            if (!item->connectionPath().isEmpty() && item->devicePath().isEmpty() && !item->duplicate() &&
+                item->mode() == NetworkManager::WirelessSetting::Infrastructure) {
+                connectionItem = item;
+                break;
+            }
+        }
+
+        if (connectionItem) {
+            connectionItem->setStale(true);
+            connectionItem->setDeviceName(deviceName);
+            connectionItem->setDevicePath(device->uni());
+            connectionItem->setDeviceState(device->state());
+            connectionItem->setSignal(signal);
+            updateItem(connectionItem);
+        } else {
+            NetworkModelItem *item = new NetworkModelItem();
+            item->setStale(true);
+            item->setDeviceName(deviceName);
+            item->setDevicePath(device->uni());
+            item->setMode(NetworkManager::WirelessSetting::Infrastructure);
+            item->setName(ssid);
+            item->setSignal(signal);
+            item->setSsid(ssid);
+            item->setType(NetworkManager::ConnectionSettings::Wireless);
+            item->setSecurityType((NetworkManager::WirelessSecurityType) grp.readEntry(QLatin1String("SecurityType"), (int) NetworkManager::UnknownSecurity));
+            item->invalidateDetails();
+
+            const int index = m_list.count();
+            beginInsertRows(QModelIndex(), index, index);
+            m_list.insertItem(item);
+            endInsertRows();
+        }
+
+        staleItemsAdded = true;
+        qCDebug(PLASMA_NM) << "Cached wireless network " << ssid << " restored";
+    }
+
+    if (staleItemsAdded) {
+        // In case the device doesn't scan at all, e.g. when the wireless is disabled
+        QTimer::singleShot(NM_SCAN_CACHE_STALE_TIMEOUT, this, [this] () {
+            dropStaleItems();
+        });
+    }
+}
+
 void NetworkModel::addActiveConnection(const NetworkManager::ActiveConnection::Ptr &activeConnection)
 {
     initializeSignals(activeConnection);
@@ -279,7 +753,7 @@ void NetworkModel::addActiveConnection(const NetworkManager::ActiveConnection::P
     // Check whether we have a base connection
     if (!m_list.contains(NetworkItemsList::Uuid, connection->uuid())) {
         // Active connection appeared before a base connection, so we have to add its base connection first
-        addConnection(connection);
+        addConnection(connection->path(), connection->settings());
     }
 
     for (NetworkModelItem *item : m_list.returnItems(NetworkItemsList::NetworkItemsList::Uuid, connection->uuid())) {
@@ -324,10 +798,12 @@ void NetworkModel::addAvailableConnection(const QString &connection, const Netwo
 
     for (NetworkModelItem *item : m_list.returnItems(NetworkItemsList::Connection, connection)) {
         // The item is already associated with another device
-        if (!device || !item->devicePath().isEmpty()) {
+        if (!device || (!item->devicePath().isEmpty() && !item->stale())) {
             continue;
         }
 
+        item->setStale(false);
+
         if (device->ipInterfaceName().isEmpty()) {
             item->setDeviceName(device->interfaceName());
         } else {
@@ -358,8 +834,8 @@ void NetworkModel::addAvailableConnection(const QString &connection, const Netwo
                     if (row >= 0) {
                         beginRemoveRows(QModelIndex(), row, row);
                         m_list.removeItem(secondItem);
-                        secondItem->deleteLater();
                         endRemoveRows();
+                        delete secondItem;
                     }
                     break;
                 }
@@ -379,16 +855,14 @@ void NetworkModel::addAvailableConnection(const QString &connection, const Netwo
     }
 }
 
-void NetworkModel::addConnection(const NetworkManager::Connection::Ptr &connection)
+void NetworkModel::addConnection(const QString &connection, const NetworkManager::ConnectionSettings::Ptr &settings)
 {
     // Can't add a connection without name or uuid
-    if (connection->name().isEmpty() || connection->uuid().isEmpty()) {
+    if (!settings || settings->id().isEmpty() || settings->uuid().isEmpty()) {
         return;
     }
 
-    initializeSignals(connection);
-
-    NetworkManager::ConnectionSettings::Ptr settings = connection->settings();
+    updateWirelessProfile(connection, settings);
     NetworkManager::VpnSetting::Ptr vpnSetting;
     NetworkManager::WirelessSetting::Ptr wirelessSetting;
 
@@ -399,12 +873,12 @@ void NetworkModel::addConnection(const NetworkManager::Connection::Ptr &connecti
     }
 
     // Check whether the connection is already in the model to avoid duplicates, but this shouldn't happen
-    if (m_list.contains(NetworkItemsList::Connection, connection->path())) {
+    if (m_list.contains(NetworkItemsList::Connection, connection)) {
         return;
     }
 
     NetworkModelItem *item = new NetworkModelItem();
-    item->setConnectionPath(connection->path());
+    item->setConnectionPath(connection);
     item->setName(settings->id());
     item->setTimestamp(settings->timestamp());
     item->setType(settings->connectionType());
@@ -425,6 +899,7 @@ void NetworkModel::addConnection(const NetworkManager::Connection::Ptr &connecti
     beginInsertRows(QModelIndex(), index, index);
     m_list.insertItem(item);
     endInsertRows();
+    scheduleLastUsedUpdate(item);
     qCDebug(PLASMA_NM) << "New connection " << item->name() << " added";
 }
 
@@ -448,9 +923,13 @@ void NetworkModel::addWirelessNetwork(const NetworkManager::WirelessNetwork::Ptr
 {
     initializeSignals(network);
 
+    if (!m_scanCacheTimer.isActive()) {
+        m_scanCacheTimer.start();
+    }
+
     // Avoid duplicating entries in the model
-    if (!Configuration::hotspotConnectionPath().isEmpty()) {
-        NetworkManager::ActiveConnection::Ptr activeConnection = NetworkManager::findActiveConnection(Configuration::hotspotConnectionPath());
+    if (!m_hotspotConnectionPath.isEmpty()) {
+        NetworkManager::ActiveConnection::Ptr activeConnection = NetworkManager::findActiveConnection(m_hotspotConnectionPath);
 
         // If we are trying to add an AP which is the one created by our hotspot, then we can skip this and don't add it twice
         if (activeConnection && activeConnection->specificObject() == network->referenceAccessPoint()->uni()) {
@@ -464,21 +943,19 @@ void NetworkModel::addWirelessNetwork(const NetworkManager::WirelessNetwork::Ptr
     // attempt to merge with an AP, based on its SSID, but it doesn't find any, because we have AP with empty SSID. After this we get another
     // AccessPoint appeared signal, this time we know SSID, but we don't attempt any merging, because it's usually the other way around, thus
     // we need to attempt to merge it here with a connection we guess it's related to this new AP
-    for (NetworkModelItem *item : m_list.returnItems(NetworkItemsList::Type, NetworkManager::ConnectionSettings::Wireless)) {
-        if (item->itemType() != NetworkModelItem::AvailableConnection)
+    const QString apHw = network->referenceAccessPoint()->hardwareAddress();
+    for (const QString &connectionPath : m_wirelessProfilePaths.values(network->ssid())) {
+        const WirelessProfile profile = m_wirelessProfiles.value(connectionPath);
+        if ((!profile.bssid.isEmpty() && profile.bssid != apHw) ||
+            (!profile.restrictedHw.isEmpty() && profile.restrictedHw != device->hardwareAddress())) {
             continue;
+        }
 
-        NetworkManager::ConnectionSettings::Ptr connectionSettings = NetworkManager::findConnection(item->connectionPath())->settings();
-        if (connectionSettings && connectionSettings->connectionType() == NetworkManager::ConnectionSettings::Wireless) {
-            NetworkManager::WirelessSetting::Ptr wirelessSetting = connectionSettings->setting(NetworkManager::Setting::Wireless).dynamicCast<NetworkManager::WirelessSetting>();
-            if (QString::fromUtf8(wirelessSetting->ssid()) == network->ssid()) {
-                const QString bssid =  NetworkManager::macAddressAsString(wirelessSetting->bssid());
-                const QString restrictedHw = NetworkManager::macAddressAsString(wirelessSetting->macAddress());
-                if ((bssid.isEmpty() || bssid == network->referenceAccessPoint()->hardwareAddress()) &&
-                    (restrictedHw.isEmpty() || restrictedHw == device->hardwareAddress())) {
-                    updateFromWirelessNetwork(item, network, device);
-                    return;
-                }
+        for (NetworkModelItem *item : m_list.returnItems(NetworkItemsList::Connection, connectionPath)) {
+            if (item->itemType() == NetworkModelItem::AvailableConnection) {
+                item->setStale(false);
+                updateFromWirelessNetwork(item, network, device);
+                return;
             }
         }
     }
@@ -498,6 +975,20 @@ void NetworkModel::addWirelessNetwork(const NetworkManager::WirelessNetwork::Ptr
         }
     }
 
+    // Confirm the network restored from the scan cache in place, so the item doesn't jump around in the list
+    for (NetworkModelItem *item : m_list.returnItems(NetworkItemsList::Ssid, network->ssid(), device->uni())) {
+        if (item->stale() && item->itemType() == NetworkModelItem::AvailableAccessPoint) {
+            item->setStale(false);
+            item->setMode(mode);
+            item->setSignal(network->signalStrength());
+            item->setSpecificPath(network->referenceAccessPoint()->uni());
+            item->setSecurityType(securityType);
+            updateItem(item);
+            qCDebug(PLASMA_NM) << "Cached wireless network " << item->name() << " confirmed";
+            return;
+        }
+    }
+
     NetworkModelItem *item = new NetworkModelItem();
     if (device->ipInterfaceName().isEmpty()) {
         item->setDeviceName(device->interfaceName());
@@ -531,7 +1022,7 @@ void NetworkModel::checkAndCreateDuplicate(const QString &connection, const QStr
             originalItem = item;
         }
 
-        if (!item->duplicate() && item->itemType() == NetworkModelItem::AvailableConnection && (item->devicePath() != deviceUni && !item->devicePath().isEmpty())) {
+        if (!item->duplicate() && !item->stale() && item->itemType() == NetworkModelItem::AvailableConnection && (item->devicePath() != deviceUni && !item->devicePath().isEmpty())) {
             createDuplicate = true;
         }
     }
@@ -544,14 +1035,36 @@ void NetworkModel::checkAndCreateDuplicate(const QString &connection, const QStr
         beginInsertRows(QModelIndex(), index, index);
         m_list.insertItem(duplicatedItem);
         endInsertRows();
+        scheduleLastUsedUpdate(duplicatedItem);
     }
 }
 
-void NetworkModel::onItemUpdated()
+void NetworkModel::dropStaleItems(const QString &deviceUni)
 {
-    NetworkModelItem *item = static_cast<NetworkModelItem*>(sender());
-    if (item) {
-        updateItem(item);
+    for (NetworkModelItem *item : m_list.items()) {
+        if (!item->stale() || (!deviceUni.isEmpty() && item->devicePath() != deviceUni)) {
+            continue;
+        }
+
+        // Cached network hasn't been found by the scan, remove it or leave only its connection
+        if (item->connectionPath().isEmpty()) {
+            const int row = m_list.indexOf(item);
+            if (row >= 0) {
+                qCDebug(PLASMA_NM) << "Cached wireless network " << item->name() << " removed";
+                beginRemoveRows(QModelIndex(), row, row);
+                m_list.removeItem(item);
+                endRemoveRows();
+                delete item;
+            }
+        } else {
+            item->setStale(false);
+            item->setDeviceName(QString());
+            item->setDevicePath(QString());
+            item->setDeviceState(NetworkManager::Device::UnknownState);
+            item->setSignal(0);
+            updateItem(item);
+            qCDebug(PLASMA_NM) << "Item " << item->name() << ": cached wireless network removed";
+        }
     }
 }
 
@@ -564,6 +1077,65 @@ void NetworkModel::setDeviceStatisticsRefreshRateMs(const QString &devicePath, u
     }
 }
 
+void NetworkModel::saveScanCache()
+{
+    KConfig config(QStringLiteral("plasma-nm-networks"), KConfig::SimpleConfig, QStandardPaths::GenericCacheLocation);
+    for (const QString &group : config.groupList()) {
+        config.deleteGroup(group);
+    }
+
+    int index = 0;
+    for (NetworkModelItem *item : m_list.returnItems(NetworkItemsList::Type, NetworkManager::ConnectionSettings::Wireless)) {
+        if (item->devicePath().isEmpty() || item->ssid().isEmpty() || item->duplicate() ||
+            item->mode() != NetworkManager::WirelessSetting::Infrastructure) {
+            continue;
+        }
+
+        NetworkManager::Device::Ptr device = NetworkManager::findNetworkInterface(item->devicePath());
+        if (!device) {
+            continue;
+        }
+
+        KConfigGroup grp(&config, QStringLiteral("Network %1").arg(index++));
+        grp.writeEntry(QLatin1String("Ssid"), item->ssid());
+        grp.writeEntry(QLatin1String("SecurityType"), (int) item->securityType());
+        grp.writeEntry(QLatin1String("Signal"), item->signal());
+        grp.writeEntry(QLatin1String("Device"), device->interfaceName());
+    }
+
+    config.sync();
+}
+
+void NetworkModel::updateHotspotConnectionPath()
+{
+    m_hotspotConnectionPath = Configuration::hotspotConnectionPath();
+}
+
+void NetworkModel::updateWirelessProfile(const QString &connectionPath, const NetworkManager::ConnectionSettings::Ptr &settings)
+{
+    auto it = m_wirelessProfiles.find(connectionPath);
+    if (it != m_wirelessProfiles.end()) {
+        m_wirelessProfilePaths.remove(it->ssid, connectionPath);
+        m_wirelessProfiles.erase(it);
+    }
+
+    if (!settings || settings->connectionType() != NetworkManager::ConnectionSettings::Wireless) {
+        return;
+    }
+
+    NetworkManager::WirelessSetting::Ptr wirelessSetting = settings->setting(NetworkManager::Setting::Wireless).dynamicCast<NetworkManager::WirelessSetting>();
+    if (!wirelessSetting) {
+        return;
+    }
+
+    WirelessProfile profile;
+    profile.ssid = QString::fromUtf8(wirelessSetting->ssid());
+    profile.bssid = NetworkManager::macAddressAsString(wirelessSetting->bssid());
+    profile.restrictedHw = NetworkManager::macAddressAsString(wirelessSetting->macAddress());
+    m_wirelessProfilePaths.insert(profile.ssid, connectionPath);
+    m_wirelessProfiles.insert(connectionPath, profile);
+}
+
 void NetworkModel::updateItem(NetworkModelItem*item)
 {
     const int row = m_list.indexOf(item);
@@ -572,10 +1144,69 @@ void NetworkModel::updateItem(NetworkModelItem*item)
         item->invalidateDetails();
         QModelIndex index = createIndex(row, 0);
         Q_EMIT dataChanged(index, index, item->changedRoles());
+        if (item->hasChangedRole(LastUsedRole)) {
+            scheduleLastUsedUpdate(item);
+        }
         item->clearChangedRoles();
     }
 }
 
+void NetworkModel::scheduleLastUsedUpdate(NetworkModelItem *item)
+{
+    const QDateTime change = item->lastUsedChange();
+    if (!change.isValid()) {
+        return;
+    }
+
+    const int interval = static_cast<int>(qMax<qint64>(0, QDateTime::currentDateTime().msecsTo(change)));
+    if (!m_lastUsedTimer.isActive() || interval < m_lastUsedTimer.remainingTime()) {
+        m_lastUsedTimer.start(interval);
+    }
+}
+
+void NetworkModel::updateLastUsed()
+{
+    const QDateTime now = QDateTime::currentDateTime();
+    const QVector<int> roles = { LastUsedRole, LastUsedDateOnlyRole };
+    QDateTime nextChange;
+    int firstChangedRow = -1;
+    int lastChangedRow = -1;
+
+    // Only texts which actually changed are announced, neighbouring rows in one dataChanged()
+    for (int row = 0; row < m_list.count(); ++row) {
+        NetworkModelItem *item = m_list.itemAt(row);
+        QDateTime change = item->lastUsedChange();
+        if (!change.isValid()) {
+            continue;
+        }
+
+        if (change <= now) {
+            if (item->refreshLastUsed()) {
+                if (firstChangedRow < 0) {
+                    firstChangedRow = row;
+                } else if (lastChangedRow != row - 1) {
+                    Q_EMIT dataChanged(createIndex(firstChangedRow, 0), createIndex(lastChangedRow, 0), roles);
+                    firstChangedRow = row;
+                }
+                lastChangedRow = row;
+            }
+            change = item->lastUsedChange();
+        }
+
+        if (change.isValid() && (!nextChange.isValid() || change < nextChange)) {
+            nextChange = change;
+        }
+    }
+
+    if (firstChangedRow >= 0) {
+        Q_EMIT dataChanged(createIndex(firstChangedRow, 0), createIndex(lastChangedRow, 0), roles);
+    }
+
+    if (nextChange.isValid()) {
+        m_lastUsedTimer.start(static_cast<int>(qMax<qint64>(0, now.msecsTo(nextChange))));
+    }
+}
+
 void NetworkModel::accessPointSignalStrengthChanged(int signal)
 {
     NetworkManager::AccessPoint *apPtr = qobject_cast<NetworkManager::AccessPoint*>(sender());
@@ -594,6 +1225,8 @@ void NetworkModel::accessPointSignalStrengthChanged(int signal)
 
 void NetworkModel::activeConnectionAdded(const QString &activeConnection)
 {
+    updateHotspotConnectionPath();
+
     NetworkManager::ActiveConnection::Ptr activeCon = NetworkManager::findActiveConnection(activeConnection);
 
     if (activeCon) {
@@ -603,6 +1236,8 @@ void NetworkModel::activeConnectionAdded(const QString &activeConnection)
 
 void NetworkModel::activeConnectionRemoved(const QString &activeConnection)
 {
+    updateHotspotConnectionPath();
+
     for (NetworkModelItem *item : m_list.returnItems(NetworkItemsList::ActiveConnection, activeConnection)) {
         item->setActiveConnectionPath(QString());
         item->setConnectionState(NetworkManager::ActiveConnection::Deactivated);
@@ -620,6 +1255,9 @@ void NetworkModel::activeConnectionStateChanged(NetworkManager::ActiveConnection
         return;
     }
 
+    // The handler stores the path of a new hotspot only once its activation started
+    updateHotspotConnectionPath();
+
     for (NetworkModelItem *item : m_list.returnItems(NetworkItemsList::ActiveConnection, activePtr->path())) {
         item->setConnectionState(state);
         updateItem(item);
@@ -715,8 +1353,8 @@ void NetworkModel::availableConnectionDisappeared(const QString &connection)
                     qCDebug(PLASMA_NM) << "Duplicate item " << item->name() << " removed completely";
                     beginRemoveRows(QModelIndex(), row, row);
                     m_list.removeItem(item);
-                    item->deleteLater();
                     endRemoveRows();
+                    delete item;
                 }
             } else {
                 updateItem(item);
@@ -730,12 +1368,14 @@ void NetworkModel::connectionAdded(const QString &connection)
 {
     NetworkManager::Connection::Ptr newConnection = NetworkManager::findConnection(connection);
     if (newConnection) {
-        addConnection(newConnection);
+        addConnection(connection, newConnection->settings());
     }
 }
 
 void NetworkModel::connectionRemoved(const QString &connection)
 {
+    updateWirelessProfile(connection, NetworkManager::ConnectionSettings::Ptr());
+
     bool remove = false;
     for (NetworkModelItem *item : m_list.returnItems(NetworkItemsList::Connection, connection)) {
         // When the item type is wireless, we can remove only the connection and leave it as an available access point
@@ -773,24 +1413,40 @@ void NetworkModel::connectionRemoved(const QString &connection)
                 qCDebug(PLASMA_NM) << "Item " << item->name() << " removed completely";
                 beginRemoveRows(QModelIndex(), row, row);
                 m_list.removeItem(item);
-                item->deleteLater();
                 endRemoveRows();
+                delete item;
             }
         }
         remove = false;
     }
 }
 
-void NetworkModel::connectionUpdated()
+void NetworkModel::connectionUpdated(const QDBusMessage &message)
 {
-    NetworkManager::Connection *connectionPtr = qobject_cast<NetworkManager::Connection*>(sender());
-    if (!connectionPtr) {
+    const QString connection = message.path();
+    if (!m_list.contains(NetworkItemsList::Connection, connection)) {
         return;
     }
 
-    NetworkManager::ConnectionSettings::Ptr settings = connectionPtr->settings();
-    for (NetworkModelItem *item : m_list.returnItems(NetworkItemsList::Connection, connectionPtr->path())) {
-        item->setConnectionPath(connectionPtr->path());
+    QDBusMessage call = QDBusMessage::createMethodCall(QStringLiteral(NM_DBUS_SERVICE), connection,
+                                                       QStringLiteral(NM_DBUS_INTERFACE_SETTINGS_CONNECTION), QStringLiteral("GetSettings"));
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(QDBusConnection::systemBus().asyncCall(call), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, connection] (QDBusPendingCallWatcher *watcher) {
+        QDBusPendingReply<NMVariantMapMap> reply = *watcher;
+        // The connection may have been removed while waiting for its settings
+        if (reply.isValid() && m_list.contains(NetworkItemsList::Connection, connection)) {
+            updateConnection(connection, NetworkManager::ConnectionSettings::Ptr(new NetworkManager::ConnectionSettings(reply.value())));
+        }
+        watcher->deleteLater();
+    });
+}
+
+void NetworkModel::updateConnection(const QString &connection, const NetworkManager::ConnectionSettings::Ptr &settings)
+{
+    updateWirelessProfile(connection, settings);
+
+    for (NetworkModelItem *item : m_list.returnItems(NetworkItemsList::Connection, connection)) {
+        item->setConnectionPath(connection);
         item->setName(settings->id());
         item->setTimestamp(settings->timestamp());
         item->setType(settings->connectionType());
@@ -976,13 +1632,20 @@ void NetworkModel::ipInterfaceChanged()
 
 void NetworkModel::statusChanged(NetworkManager::Status status)
 {
-    Q_UNUSED(status);
-
     qCDebug(PLASMA_NM) << "NetworkManager state changed to " << status;
-    // This has probably effect only for VPN connections
+    // Items keep the status, new ones take it from NetworkManager
+    for (NetworkModelItem *item : m_list.items()) {
+        item->setNetworkManagerStatus(status);
+    }
+
+    // This has probably effect only for VPN connections, their item type and with it
+    // their partitions change as well
     for (NetworkModelItem *item : m_list.returnItems(NetworkItemsList::Type, NetworkManager::ConnectionSettings::Vpn)) {
         updateItem(item);
     }
+    for (NetworkModelItem *item : m_list.returnItems(NetworkItemsList::Type, NetworkManager::ConnectionSettings::WireGuard)) {
+        updateItem(item);
+    }
 }
 
 void NetworkModel::wirelessNetworkAppeared(const QString &ssid)
@@ -1002,6 +1665,10 @@ void NetworkModel::wirelessNetworkDisappeared(const QString &ssid)
         return;
     }
 
+    if (!m_scanCacheTimer.isActive()) {
+        m_scanCacheTimer.start();
+    }
+
     for (NetworkModelItem *item : m_list.returnItems(NetworkItemsList::Ssid, ssid, device->uni())) {
         // Remove the entire item, because it's only AP or it's a duplicated available connection
         if (item->itemType() == NetworkModelItem::AvailableAccessPoint || item->duplicate()) {
@@ -1010,8 +1677,8 @@ void NetworkModel::wirelessNetworkDisappeared(const QString &ssid)
                 qCDebug(PLASMA_NM) << "Wireless network " << item->name() << " removed completely";
                 beginRemoveRows(QModelIndex(), row, row);
                 m_list.removeItem(item);
-                item->deleteLater();
                 endRemoveRows();
+                delete item;
             }
         // Remove only AP and device from the item and leave it as an unavailable connection
         } else {
@@ -1027,6 +1694,20 @@ void NetworkModel::wirelessNetworkDisappeared(const QString &ssid)
     }
 }
 
+void NetworkModel::wirelessDeviceScanFinished()
+{
+    NetworkManager::Device *device = qobject_cast<NetworkManager::Device*>(sender());
+    if (!device) {
+        return;
+    }
+
+    const QString deviceUni = device->uni();
+    // Networks found by the scan are reported right after the scan time is updated
+    QTimer::singleShot(0, this, [this, deviceUni] () {
+        dropStaleItems(deviceUni);
+    });
+}
+
 void NetworkModel::wirelessNetworkReferenceApChanged(const QString &accessPoint)
 {
     NetworkManager::WirelessNetwork *networkPtr = qobject_cast<NetworkManager::WirelessNetwork*>(sender());
@@ -1093,23 +1774,20 @@ void NetworkModel::updateFromWirelessNetwork(NetworkModelItem *item, const Netwo
     }
 
     // Check whether the connection is associated with some concrete AP
-    NetworkManager::Connection::Ptr connection = NetworkManager::findConnection(item->connectionPath());
-    if (connection) {
-        NetworkManager::WirelessSetting::Ptr wirelessSetting = connection->settings()->setting(NetworkManager::Setting::Wireless).staticCast<NetworkManager::WirelessSetting>();
-        if (wirelessSetting) {
-            if (!wirelessSetting->bssid().isEmpty()) {
-                for (const NetworkManager::AccessPoint::Ptr ap : network->accessPoints()) {
-                    if (ap->hardwareAddress() == NetworkManager::macAddressAsString(wirelessSetting->bssid())) {
-                        item->setSignal(ap->signalStrength());
-                        item->setSpecificPath(ap->uni());
-                        // We need to watch this AP for signal changes
-                        connect(ap.data(), &NetworkManager::AccessPoint::signalStrengthChanged, this, &NetworkModel::accessPointSignalStrengthChanged, Qt::UniqueConnection);
-                    }
+    auto profile = m_wirelessProfiles.constFind(item->connectionPath());
+    if (profile != m_wirelessProfiles.constEnd()) {
+        if (!profile->bssid.isEmpty()) {
+            for (const NetworkManager::AccessPoint::Ptr ap : network->accessPoints()) {
+                if (ap->hardwareAddress() == profile->bssid) {
+                    item->setSignal(ap->signalStrength());
+                    item->setSpecificPath(ap->uni());
+                    // We need to watch this AP for signal changes
+                    connect(ap.data(), &NetworkManager::AccessPoint::signalStrengthChanged, this, &NetworkModel::accessPointSignalStrengthChanged, Qt::UniqueConnection);
                 }
-            } else {
-                item->setSignal(network->signalStrength());
-                item->setSpecificPath(network->referenceAccessPoint()->uni());
             }
+        } else {
+            item->setSignal(network->signalStrength());
+            item->setSpecificPath(network->referenceAccessPoint()->uni());
         }
     }
     item->setSecurityType(securityType);
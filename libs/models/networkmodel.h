@@ -22,6 +22,9 @@
 #define PLASMA_NM_NETWORK_MODEL_H
 
 #include <QAbstractListModel>
+#include <QDBusMessage>
+#include <QDBusServiceWatcher>
+#include <QTimer>
 
 #include "networkitemslist.h"
 
@@ -38,7 +41,17 @@ class Q_DECL_EXPORT NetworkModel : public QAbstractListModel
 {
 Q_OBJECT
 public:
+    /**
+     * Where the rows of the model come from
+     */
+    enum Source {
+        AutomaticSource,    // Replica of the model of the kded module, local when it isn't running
+        LocalSource,        // Items built from NetworkManager in this process
+        ReplicaSource       // Rows applied with applySnapshot() and applyDelta() only
+    };
+
     explicit NetworkModel(QObject *parent = nullptr);
+    explicit NetworkModel(Source source, QObject *parent = nullptr);
     ~NetworkModel() override;
 
     enum ItemRole {
@@ -62,6 +75,7 @@ public:
         SlaveRole,
         SsidRole,
         SpecificPathRole,
+        StaleRole,
         TimeStampRole,
         TypeRole,
         UniRole,
@@ -73,12 +87,41 @@ public:
     };
     Q_ENUMS(ItemRole)
 
+    // Number of roles published to replicas, ConnectionDetailsRole to TxBytesRole
+    static const int RoleCount = TxBytesRole - ConnectionDetailsRole + 1;
+
+    /**
+     * Classification of rows used by the proxy models, maintained on item changes
+     * so rows which can't be shown are rejected without evaluating their roles
+     */
+    enum Partition {
+        AvailablePartition = 0x01,      // AvailableConnection and AvailableAccessPoint items
+        UnavailablePartition = 0x02,    // UnavailableConnection items
+        AccessPointPartition = 0x04,    // AvailableAccessPoint items
+        SlavePartition = 0x08,
+        WirelessPartition = 0x10
+    };
+    Q_DECLARE_FLAGS(Partitions, Partition)
+
+    Partitions partitions(int row) const;
+
+    /**
+     * Replace the rows of a replica with a snapshot of NetworkModelPublisher,
+     * returns false if it can't be read
+     */
+    bool applySnapshot(const QByteArray &snapshot);
+    /**
+     * Apply a delta of NetworkModelPublisher to a replica. Deltas already contained
+     * in the rows are skipped, returns false if the delta can't be read or
+     * earlier ones are missing and a new snapshot is needed.
+     */
+    bool applyDelta(const QByteArray &delta);
+
     int rowCount(const QModelIndex &parent) const override;
     QVariant data(const QModelIndex &index, int role) const override;
     QHash<int, QByteArray> roleNames() const override;
 
 public Q_SLOTS:
-    void onItemUpdated();
     void setDeviceStatisticsRefreshRateMs(const QString &devicePath, uint refreshRate);
 
 private Q_SLOTS:
@@ -91,7 +134,7 @@ private Q_SLOTS:
     void availableConnectionDisappeared(const QString &connection);
     void connectionAdded(const QString &connection);
     void connectionRemoved(const QString &connection);
-    void connectionUpdated();
+    void connectionUpdated(const QDBusMessage &message);
     void deviceAdded(const QString &device);
     void deviceRemoved(const QString &device);
     void deviceStateChanged(NetworkManager::Device::State state, NetworkManager::Device::State oldState, NetworkManager::Device::StateChangeReason reason);
@@ -107,26 +150,71 @@ private Q_SLOTS:
     void wirelessNetworkDisappeared(const QString &ssid);
     void wirelessNetworkSignalChanged(int signal);
     void wirelessNetworkReferenceApChanged(const QString &accessPoint);
+    void wirelessDeviceScanFinished();
 
     void initialize();
+    void saveScanCache();
+    void updateLastUsed();
+    void rowsDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles);
+    void rowsInsertedIntoList(const QModelIndex &parent, int first, int last);
+    void rowsRemovedFromList(const QModelIndex &parent, int first, int last);
+    void rowsReset();
+    void replicaDeltaReceived(const QByteArray &delta);
+    void switchToLocal();
 private:
+    // Restrictions of a saved wireless connection an access point must match to be merged with it
+    struct WirelessProfile {
+        QString ssid;
+        QString bssid;
+        QString restrictedHw;
+    };
+
     NetworkItemsList m_list;
+    // Rows of a replica, the values of all published roles per row
+    bool m_replica = false;
+    bool m_replicaSnapshotPending = false;
+    quint64 m_replicaSerial = 0;
+    QVector<QVector<QVariant> > m_replicaRows;
+    QDBusServiceWatcher *m_kdedWatcher = nullptr;
+    QTimer m_scanCacheTimer;
+    // Fires when the relative "last used" text of some item changes
+    QTimer m_lastUsedTimer;
+    // Partitions of items, indexed by row
+    QVector<Partitions> m_partitions;
+    // Number of items sharing a name, rebuilt on demand for ItemUniqueNameRole
+    mutable QHash<QString, int> m_nameCounts;
+    mutable bool m_nameCountsValid = false;
+    // Saved wireless connections by connection path and their paths by SSID, so new
+    // networks are merged without fetching the settings of every connection
+    QHash<QString, WirelessProfile> m_wirelessProfiles;
+    QMultiHash<QString, QString> m_wirelessProfilePaths;
+    // Active connection of our hotspot, refreshed when active connections change
+    QString m_hotspotConnectionPath;
 
     void addActiveConnection(const NetworkManager::ActiveConnection::Ptr &activeConnection);
     void addAvailableConnection(const QString &connection, const NetworkManager::Device::Ptr &device);
-    void addConnection(const NetworkManager::Connection::Ptr &connection);
+    void addConnection(const QString &connection, const NetworkManager::ConnectionSettings::Ptr &settings);
     void addDevice(const NetworkManager::Device::Ptr &device);
     void addWirelessNetwork(const NetworkManager::WirelessNetwork::Ptr &network, const NetworkManager::WirelessDevice::Ptr &device);
     void checkAndCreateDuplicate(const QString &connection, const QString &deviceUni);
+    void dropStaleItems(const QString &deviceUni = QString());
     void initializeSignals();
     void initializeSignals(const NetworkManager::ActiveConnection::Ptr &activeConnection);
-    void initializeSignals(const NetworkManager::Connection::Ptr &connection);
     void initializeSignals(const NetworkManager::Device::Ptr &device);
     void initializeSignals(const NetworkManager::WirelessNetwork::Ptr &network);
+    void loadScanCache();
+    Partitions partitionsForRow(int row) const;
+    void requestReplicaSnapshot();
+    void scheduleLastUsedUpdate(NetworkModelItem *item);
+    void updateConnection(const QString &connection, const NetworkManager::ConnectionSettings::Ptr &settings);
+    void updateHotspotConnectionPath();
     void updateItem(NetworkModelItem *item);
+    void updateWirelessProfile(const QString &connectionPath, const NetworkManager::ConnectionSettings::Ptr &settings);
     void updateFromWirelessNetwork(NetworkModelItem *item, const NetworkManager::WirelessNetwork::Ptr &network, const NetworkManager::WirelessDevice::Ptr &device);
 
     NetworkManager::WirelessSecurityType alternativeWirelessSecurity(const NetworkManager::WirelessSecurityType type);
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(NetworkModel::Partitions)
+
 #endif // PLASMA_NM_NETWORK_MODEL_H
@@ -37,6 +37,10 @@
 #include <NetworkManagerQt/WirelessDevice>
 #include <NetworkManagerQt/WirelessSetting>
 
+#include <QHash>
+#include <QVector>
+#include <QtAlgorithms>
+
 #include <KLocalizedString>
 
 #if WITH_MODEMMANAGER_SUPPORT
@@ -47,80 +51,231 @@
 #include <ModemManagerQt/modemcdma.h>
 #endif
 
-NetworkModelItem::NetworkModelItem(QObject *parent)
-    : QObject(parent)
+namespace
+{
+
+/**
+ * Strings shared by the items, with the number of items referring to each of them.
+ * Only used from the thread of the models.
+ */
+class NetworkItemStringPool
+{
+public:
+    NetworkItemStringPool()
+    {
+        // Id 0 is the empty string
+        m_entries.append(Entry());
+    }
+
+    quint32 acquire(const QString &string)
+    {
+        if (string.isEmpty()) {
+            return 0;
+        }
+
+        auto it = m_ids.constFind(string);
+        if (it != m_ids.constEnd()) {
+            m_entries[*it].refs++;
+            return *it;
+        }
+
+        quint32 id;
+        if (m_freeIds.isEmpty()) {
+            id = m_entries.size();
+            m_entries.append(Entry());
+        } else {
+            id = m_freeIds.takeLast();
+        }
+        m_entries[id].string = string;
+        m_entries[id].refs = 1;
+        m_ids.insert(string, id);
+        return id;
+    }
+
+    void release(quint32 id)
+    {
+        if (id == 0) {
+            return;
+        }
+
+        Entry &entry = m_entries[id];
+        if (--entry.refs == 0) {
+            m_ids.remove(entry.string);
+            entry.string.clear();
+            m_freeIds.append(id);
+        }
+    }
+
+    bool find(const QString &string, quint32 *id) const
+    {
+        if (string.isEmpty()) {
+            *id = 0;
+            return true;
+        }
+
+        auto it = m_ids.constFind(string);
+        if (it == m_ids.constEnd()) {
+            return false;
+        }
+        *id = *it;
+        return true;
+    }
+
+    QString string(quint32 id) const
+    {
+        return m_entries.at(id).string;
+    }
+
+private:
+    struct Entry {
+        QString string;
+        int refs = 0;
+    };
+
+    QVector<Entry> m_entries;
+    QHash<QString, quint32> m_ids;
+    QVector<quint32> m_freeIds;
+};
+
+Q_GLOBAL_STATIC(NetworkItemStringPool, s_strings)
+
+// Points @p id to @p string, returns whether it changed
+bool assignString(quint32 *id, const QString &string)
+{
+    if (s_strings->string(*id) == string) {
+        return false;
+    }
+
+    const quint32 newId = s_strings->acquire(string);
+    s_strings->release(*id);
+    *id = newId;
+    return true;
+}
+
+bool isConnected(NetworkManager::Status status)
+{
+    return status == NetworkManager::Connected ||
+           status == NetworkManager::ConnectedLinkLocal ||
+           status == NetworkManager::ConnectedSiteOnly;
+}
+
+}
+
+Q_STATIC_ASSERT(NetworkModel::TxBytesRole - NetworkModel::ConnectionDetailsRole < 32);
+
+NetworkModelItem::NetworkModelItem()
+    : m_activeConnectionPath(0)
+    , m_connectionPath(0)
+    , m_devicePath(0)
+    , m_deviceName(0)
+    , m_specificPath(0)
+    , m_ssid(0)
+    , m_vpnType(0)
+    , m_changedRoles(0)
+    , m_rxBytes(0)
+    , m_txBytes(0)
     , m_connectionState(NetworkManager::ActiveConnection::Deactivated)
     , m_deviceState(NetworkManager::Device::UnknownState)
-    , m_detailsValid(false)
-    , m_duplicate(false)
     , m_mode(NetworkManager::WirelessSetting::Infrastructure)
     , m_securityType(NetworkManager::NoneSecurity)
-    , m_signal(0)
-    , m_slave(false)
     , m_type(NetworkManager::ConnectionSettings::Unknown)
     , m_vpnState(NetworkManager::VpnConnection::Unknown)
-    , m_rxBytes(0)
-    , m_txBytes(0)
+    , m_signal(0)
+    , m_detailsValid(false)
+    , m_duplicate(false)
+    , m_slave(false)
+    , m_stale(false)
+    , m_lastUsedValid(false)
+    , m_networkManagerConnected(isConnected(NetworkManager::status()))
 {
 }
 
-NetworkModelItem::NetworkModelItem(const NetworkModelItem *item, QObject *parent)
-    : QObject(parent)
-    , m_connectionPath(item->connectionPath())
-    , m_connectionState(NetworkManager::ActiveConnection::Deactivated)
-    , m_detailsValid(false)
-    , m_duplicate(true)
-    , m_mode(item->mode())
+NetworkModelItem::NetworkModelItem(const NetworkModelItem *item)
+    : m_activeConnectionPath(0)
+    , m_connectionPath(s_strings->acquire(item->connectionPath()))
+    , m_devicePath(0)
+    , m_deviceName(0)
+    , m_specificPath(0)
+    , m_ssid(s_strings->acquire(item->ssid()))
+    , m_vpnType(0)
+    , m_changedRoles(0)
     , m_name(item->name())
-    , m_securityType(item->securityType())
-    , m_slave(item->slave())
-    , m_ssid(item->ssid())
-    , m_timestamp(item->timestamp())
-    , m_type(item->type())
     , m_uuid(item->uuid())
-    , m_vpnState(NetworkManager::VpnConnection::Unknown)
+    , m_timestamp(item->timestamp())
     , m_rxBytes(0)
     , m_txBytes(0)
+    , m_connectionState(NetworkManager::ActiveConnection::Deactivated)
+    , m_deviceState(NetworkManager::Device::UnknownState)
+    , m_mode(item->m_mode)
+    , m_securityType(item->m_securityType)
+    , m_type(item->m_type)
+    , m_vpnState(NetworkManager::VpnConnection::Unknown)
+    , m_signal(0)
+    , m_detailsValid(false)
+    , m_duplicate(true)
+    , m_slave(item->slave())
+    , m_stale(false)
+    , m_lastUsedValid(false)
+    , m_networkManagerConnected(item->m_networkManagerConnected)
 {
 }
 
 NetworkModelItem::~NetworkModelItem()
 {
+    // Items of a model destroyed at exit may outlive the pool
+    if (s_strings.isDestroyed()) {
+        return;
+    }
+
+    s_strings->release(m_activeConnectionPath);
+    s_strings->release(m_connectionPath);
+    s_strings->release(m_devicePath);
+    s_strings->release(m_deviceName);
+    s_strings->release(m_specificPath);
+    s_strings->release(m_ssid);
+    s_strings->release(m_vpnType);
+}
+
+bool NetworkModelItem::findStringId(const QString &string, quint32 *id)
+{
+    return s_strings->find(string, id);
 }
 
 QString NetworkModelItem::activeConnectionPath() const
 {
-    return m_activeConnectionPath;
+    return s_strings->string(m_activeConnectionPath);
 }
 
 void NetworkModelItem::setActiveConnectionPath(const QString &path)
 {
-    m_activeConnectionPath = path;
+    assignString(&m_activeConnectionPath, path);
 }
 
 QString NetworkModelItem::connectionPath() const
 {
-    return m_connectionPath;
+    return s_strings->string(m_connectionPath);
 }
 
 void NetworkModelItem::setConnectionPath(const QString &path)
 {
-    if (m_connectionPath != path) {
-        m_connectionPath = path;
-        m_changedRoles << NetworkModel::ConnectionPathRole << NetworkModel::UniRole;
+    if (assignString(&m_connectionPath, path)) {
+        markChanged(NetworkModel::ConnectionPathRole);
+        markChanged(NetworkModel::ItemTypeRole);
+        markChanged(NetworkModel::UniRole);
     }
 }
 
 NetworkManager::ActiveConnection::State NetworkModelItem::connectionState() const
 {
-    return m_connectionState;
+    return static_cast<NetworkManager::ActiveConnection::State>(m_connectionState);
 }
 
 void NetworkModelItem::setConnectionState(NetworkManager::ActiveConnection::State state)
 {
     if (m_connectionState != state) {
         m_connectionState = state;
-        m_changedRoles << NetworkModel::ConnectionStateRole << NetworkModel::SectionRole;
+        markChanged(NetworkModel::ConnectionStateRole);
+        markChanged(NetworkModel::SectionRole);
         refreshIcon();
     }
 }
@@ -135,40 +290,40 @@ QStringList NetworkModelItem::details() const
 
 QString NetworkModelItem::devicePath() const
 {
-    return m_devicePath;
+    return s_strings->string(m_devicePath);
 }
 
 QString NetworkModelItem::deviceName() const
 {
-    return m_deviceName;
+    return s_strings->string(m_deviceName);
 }
 
 void NetworkModelItem::setDeviceName(const QString &name)
 {
-    if (m_deviceName != name) {
-        m_deviceName = name;
-        m_changedRoles << NetworkModel::DeviceName;
+    if (assignString(&m_deviceName, name)) {
+        markChanged(NetworkModel::DeviceName);
     }
 }
 
 void NetworkModelItem::setDevicePath(const QString &path)
 {
-    if (m_devicePath != path) {
-        m_devicePath = path;
-        m_changedRoles << NetworkModel::DevicePathRole << NetworkModel::ItemTypeRole << NetworkModel::UniRole;
+    if (assignString(&m_devicePath, path)) {
+        markChanged(NetworkModel::DevicePathRole);
+        markChanged(NetworkModel::ItemTypeRole);
+        markChanged(NetworkModel::UniRole);
     }
 }
 
 QString NetworkModelItem::deviceState() const
 {
-    return UiUtils::connectionStateToString(m_deviceState);
+    return UiUtils::connectionStateToString(static_cast<NetworkManager::Device::State>(m_deviceState));
 }
 
 void NetworkModelItem::setDeviceState(const NetworkManager::Device::State state)
 {
     if (m_deviceState != state) {
         m_deviceState = state;
-        m_changedRoles << NetworkModel::DeviceStateRole;
+        markChanged(NetworkModel::DeviceStateRole);
     }
 }
 
@@ -181,7 +336,7 @@ void NetworkModelItem::setIcon(const QString& icon)
 {
     if (icon != m_icon) {
         m_icon = icon;
-        m_changedRoles << NetworkModel::ConnectionIconRole;
+        markChanged(NetworkModel::ConnectionIconRole);
     }
 }
 
@@ -274,15 +429,13 @@ QString NetworkModelItem::computeIcon() const
 
 NetworkModelItem::ItemType NetworkModelItem::itemType() const
 {
-    if (!m_devicePath.isEmpty() ||
+    if (m_devicePath != 0 ||
         m_type == NetworkManager::ConnectionSettings::Bond ||
         m_type == NetworkManager::ConnectionSettings::Bridge ||
         m_type == NetworkManager::ConnectionSettings::Vlan ||
         m_type == NetworkManager::ConnectionSettings::Team ||
-        ((NetworkManager::status() == NetworkManager::Connected ||
-          NetworkManager::status() == NetworkManager::ConnectedLinkLocal ||
-          NetworkManager::status() == NetworkManager::ConnectedSiteOnly) && (m_type == NetworkManager::ConnectionSettings::Vpn || m_type == NetworkManager::ConnectionSettings::WireGuard))) {
-        if (m_connectionPath.isEmpty() && m_type == NetworkManager::ConnectionSettings::Wireless) {
+        (m_networkManagerConnected && (m_type == NetworkManager::ConnectionSettings::Vpn || m_type == NetworkManager::ConnectionSettings::WireGuard))) {
+        if (m_connectionPath == 0 && m_type == NetworkManager::ConnectionSettings::Wireless) {
             return NetworkModelItem::AvailableAccessPoint;
         } else {
             return NetworkModelItem::AvailableConnection;
@@ -293,7 +446,7 @@ NetworkModelItem::ItemType NetworkModelItem::itemType() const
 
 NetworkManager::WirelessSetting::NetworkMode NetworkModelItem::mode() const
 {
-    return m_mode;
+    return static_cast<NetworkManager::WirelessSetting::NetworkMode>(m_mode);
 }
 
 void NetworkModelItem::setMode(const NetworkManager::WirelessSetting::NetworkMode mode)
@@ -313,16 +466,17 @@ void NetworkModelItem::setName(const QString &name)
 {
     if (m_name != name) {
         m_name = name;
-        m_changedRoles << NetworkModel::ItemUniqueNameRole << NetworkModel::NameRole;
+        markChanged(NetworkModel::ItemUniqueNameRole);
+        markChanged(NetworkModel::NameRole);
     }
 }
 
 QString NetworkModelItem::originalName() const
 {
-    if (m_deviceName.isEmpty()) {
+    if (m_deviceName == 0) {
         return m_name;
     }
-    return m_name % QLatin1String(" (") % m_deviceName % ')';
+    return m_name % QLatin1String(" (") % s_strings->string(m_deviceName) % ')';
 }
 
 QString NetworkModelItem::sectionType() const
@@ -336,14 +490,15 @@ QString NetworkModelItem::sectionType() const
 
 NetworkManager::WirelessSecurityType NetworkModelItem::securityType() const
 {
-    return m_securityType;
+    return static_cast<NetworkManager::WirelessSecurityType>(m_securityType);
 }
 
 void NetworkModelItem::setSecurityType(NetworkManager::WirelessSecurityType type)
 {
     if (m_securityType != type) {
         m_securityType = type;
-        m_changedRoles << NetworkModel::SecurityTypeStringRole << NetworkModel::SecurityTypeRole;
+        markChanged(NetworkModel::SecurityTypeStringRole);
+        markChanged(NetworkModel::SecurityTypeRole);
         refreshIcon();
     }
 }
@@ -355,9 +510,11 @@ int NetworkModelItem::signal() const
 
 void NetworkModelItem::setSignal(int signal)
 {
-    if (m_signal != signal) {
-        m_signal = signal;
-        m_changedRoles << NetworkModel::SignalRole;
+    // Signal strengths are percentages
+    const quint8 strength = qBound(0, signal, 100);
+    if (m_signal != strength) {
+        m_signal = strength;
+        markChanged(NetworkModel::SignalRole);
         refreshIcon();
     }
 }
@@ -371,39 +528,66 @@ void NetworkModelItem::setSlave(bool slave)
 {
     if (m_slave != slave) {
         m_slave = slave;
-        m_changedRoles << NetworkModel::SlaveRole;
+        markChanged(NetworkModel::SlaveRole);
     }
 }
 
 QString NetworkModelItem::specificPath() const
 {
-    return m_specificPath;
+    return s_strings->string(m_specificPath);
 }
 
 void NetworkModelItem::setSpecificPath(const QString &path)
 {
-    if (m_specificPath != path) {
-        m_specificPath = path;
-        m_changedRoles << NetworkModel::SpecificPathRole;
+    if (assignString(&m_specificPath, path)) {
+        markChanged(NetworkModel::SpecificPathRole);
     }
 }
 
 QString NetworkModelItem::ssid() const
 {
-    return m_ssid;
+    return s_strings->string(m_ssid);
 }
 
 void NetworkModelItem::setSsid(const QString &ssid)
 {
-    if (m_ssid != ssid) {
-        m_ssid = ssid;
-        m_changedRoles << NetworkModel::SsidRole << NetworkModel::UniRole;
+    if (assignString(&m_ssid, ssid)) {
+        markChanged(NetworkModel::SsidRole);
+        markChanged(NetworkModel::UniRole);
+    }
+}
+
+bool NetworkModelItem::stale() const
+{
+    return m_stale;
+}
+
+void NetworkModelItem::setStale(bool stale)
+{
+    if (m_stale != stale) {
+        m_stale = stale;
+        markChanged(NetworkModel::StaleRole);
+    }
+}
+
+void NetworkModelItem::setNetworkManagerStatus(NetworkManager::Status status)
+{
+    const bool connected = isConnected(status);
+    if (connected == m_networkManagerConnected) {
+        return;
+    }
+
+    const ItemType previousType = itemType();
+    m_networkManagerConnected = connected;
+    if (itemType() != previousType) {
+        markChanged(NetworkModel::ItemTypeRole);
+        invalidateDetails();
     }
 }
 
 NetworkManager::ConnectionSettings::ConnectionType NetworkModelItem::type() const
 {
-    return m_type;
+    return static_cast<NetworkManager::ConnectionSettings::ConnectionType>(m_type);
 }
 
 QDateTime NetworkModelItem::timestamp() const
@@ -415,15 +599,59 @@ void NetworkModelItem::setTimestamp(const QDateTime &date)
 {
     if (m_timestamp != date) {
         m_timestamp = date;
-        m_changedRoles << NetworkModel::TimeStampRole;
+        m_lastUsedValid = false;
+        markChanged(NetworkModel::TimeStampRole);
+        markChanged(NetworkModel::LastUsedRole);
+        markChanged(NetworkModel::LastUsedDateOnlyRole);
     }
 }
 
+QString NetworkModelItem::lastUsed() const
+{
+    if (!m_lastUsedValid) {
+        updateLastUsed();
+    }
+    return m_lastUsed;
+}
+
+QString NetworkModelItem::lastUsedDateOnly() const
+{
+    if (!m_lastUsedValid) {
+        updateLastUsed();
+    }
+    return m_lastUsedDateOnly;
+}
+
+QDateTime NetworkModelItem::lastUsedChange() const
+{
+    if (!m_lastUsedValid) {
+        updateLastUsed();
+    }
+    return m_lastUsedChange;
+}
+
+bool NetworkModelItem::refreshLastUsed()
+{
+    if (!m_lastUsedValid) {
+        // Nothing has been shown yet
+        updateLastUsed();
+        return false;
+    }
+
+    const QString lastUsed = m_lastUsed;
+    const QString lastUsedDateOnly = m_lastUsedDateOnly;
+    updateLastUsed();
+
+    return lastUsed != m_lastUsed || lastUsedDateOnly != m_lastUsedDateOnly;
+}
+
 void NetworkModelItem::setType(NetworkManager::ConnectionSettings::ConnectionType type)
 {
     if (m_type != type) {
         m_type = type;
-        m_changedRoles << NetworkModel::TypeRole << NetworkModel::ItemTypeRole << NetworkModel::UniRole;
+        markChanged(NetworkModel::TypeRole);
+        markChanged(NetworkModel::ItemTypeRole);
+        markChanged(NetworkModel::UniRole);
 
         refreshIcon();
     }
@@ -432,9 +660,9 @@ void NetworkModelItem::setType(NetworkManager::ConnectionSettings::ConnectionTyp
 QString NetworkModelItem::uni() const
 {
     if (m_type == NetworkManager::ConnectionSettings::Wireless && m_uuid.isEmpty()) {
-        return m_ssid + '%' + m_devicePath;
+        return s_strings->string(m_ssid) + '%' + s_strings->string(m_devicePath);
     } else {
-        return m_connectionPath + '%' + m_devicePath;
+        return s_strings->string(m_connectionPath) + '%' + s_strings->string(m_devicePath);
     }
 }
 
@@ -447,33 +675,32 @@ void NetworkModelItem::setUuid(const QString &uuid)
 {
     if (m_uuid != uuid) {
         m_uuid = uuid;
-        m_changedRoles << NetworkModel::UuidRole;
+        markChanged(NetworkModel::UuidRole);
     }
 }
 
 QString NetworkModelItem::vpnState() const
 {
-    return UiUtils::vpnConnectionStateToString(m_vpnState);
+    return UiUtils::vpnConnectionStateToString(static_cast<NetworkManager::VpnConnection::State>(m_vpnState));
 }
 
 void NetworkModelItem::setVpnState(NetworkManager::VpnConnection::State state)
 {
     if (m_vpnState != state) {
         m_vpnState = state;
-        m_changedRoles << NetworkModel::VpnState;
+        markChanged(NetworkModel::VpnState);
     }
 }
 
 QString NetworkModelItem::vpnType() const
 {
-    return m_vpnType;
+    return s_strings->string(m_vpnType);
 }
 
 void NetworkModelItem::setVpnType(const QString &type)
 {
-    if (m_vpnType != type) {
-        m_vpnType = type;
-        m_changedRoles << NetworkModel::VpnType;
+    if (assignString(&m_vpnType, type)) {
+        markChanged(NetworkModel::VpnType);
     }
 }
 
@@ -486,7 +713,7 @@ void NetworkModelItem::setRxBytes(qulonglong bytes)
 {
     if (m_rxBytes != bytes) {
         m_rxBytes = bytes;
-        m_changedRoles << NetworkModel::RxBytesRole;
+        markChanged(NetworkModel::RxBytesRole);
     }
 }
 
@@ -499,7 +726,7 @@ void NetworkModelItem::setTxBytes(qulonglong bytes)
 {
     if (m_txBytes != bytes) {
         m_txBytes = bytes;
-        m_changedRoles << NetworkModel::TxBytesRole;
+        markChanged(NetworkModel::TxBytesRole);
     }
 }
 
@@ -518,10 +745,37 @@ bool NetworkModelItem::operator==(const NetworkModelItem *item) const
     return false;
 }
 
+QVector<int> NetworkModelItem::changedRoles() const
+{
+    QVector<int> roles;
+    for (quint32 bits = m_changedRoles; bits; bits &= bits - 1) {
+        roles << NetworkModel::ConnectionDetailsRole + qCountTrailingZeroBits(bits);
+    }
+    return roles;
+}
+
+bool NetworkModelItem::hasChangedRole(int role) const
+{
+    return m_changedRoles & (1u << (role - NetworkModel::ConnectionDetailsRole));
+}
+
+void NetworkModelItem::markChanged(int role)
+{
+    m_changedRoles |= 1u << (role - NetworkModel::ConnectionDetailsRole);
+}
+
 void NetworkModelItem::invalidateDetails()
 {
     m_detailsValid = false;
-    m_changedRoles << NetworkModel::ConnectionDetailsRole;
+    markChanged(NetworkModel::ConnectionDetailsRole);
+}
+
+void NetworkModelItem::updateLastUsed() const
+{
+    m_lastUsedValid = true;
+    m_lastUsed = UiUtils::formatLastUsedDateRelative(m_timestamp);
+    m_lastUsedDateOnly = UiUtils::formatDateRelative(m_timestamp);
+    m_lastUsedChange = UiUtils::nextDateRelativeChange(m_timestamp);
 }
 
 void NetworkModelItem::updateDetails() const
@@ -533,7 +787,7 @@ void NetworkModelItem::updateDetails() const
         return;
     }
 
-    NetworkManager::Device::Ptr device = NetworkManager::findNetworkInterface(m_devicePath);
+    NetworkManager::Device::Ptr device = NetworkManager::findNetworkInterface(devicePath());
 
     // Get IPv[46]Address and related nameservers + IPv4 default gateway
     if (device && device->ipV4Config().isValid() && m_connectionState == NetworkManager::ActiveConnection::Activated) {
@@ -581,11 +835,11 @@ void NetworkModelItem::updateDetails() const
         }
     } else if (m_type == NetworkManager::ConnectionSettings::Wireless) {
         NetworkManager::WirelessDevice::Ptr wirelessDevice = device.objectCast<NetworkManager::WirelessDevice>();
-        m_details << i18n("Access point (SSID)") << m_ssid;
+        m_details << i18n("Access point (SSID)") << ssid();
         if (m_mode == NetworkManager::WirelessSetting::Infrastructure) {
-            m_details << i18n("Signal strength") << QStringLiteral("%1%").arg(m_signal);
+            m_details << i18n("Signal strength") << QStringLiteral("%1%").arg(signal());
         }
-        m_details << i18n("Security type") << UiUtils::labelFromWirelessSecurity(m_securityType);
+        m_details << i18n("Security type") << UiUtils::labelFromWirelessSecurity(securityType());
         if (wirelessDevice) {
             if (m_connectionState == NetworkManager::ActiveConnection::Activated) {
                 m_details << i18n("Connection speed") << UiUtils::connectionSpeed(wirelessDevice->bitRate());
@@ -618,10 +872,10 @@ void NetworkModelItem::updateDetails() const
         }
 #endif
     } else if (m_type == NetworkManager::ConnectionSettings::Vpn) {
-        m_details << i18n("VPN plugin") << m_vpnType;
+        m_details << i18n("VPN plugin") << vpnType();
 
         if (m_connectionState == NetworkManager::ActiveConnection::Activated) {
-            NetworkManager::ActiveConnection::Ptr active = NetworkManager::findActiveConnection(m_activeConnectionPath);
+            NetworkManager::ActiveConnection::Ptr active = NetworkManager::findActiveConnection(activeConnectionPath());
             NetworkManager::VpnConnection::Ptr vpnConnection;
 
             if (active) {
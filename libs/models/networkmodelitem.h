@@ -25,25 +25,40 @@
 #include <NetworkManagerQt/Connection>
 #include <NetworkManagerQt/ConnectionSettings>
 #include <NetworkManagerQt/Device>
+#include <NetworkManagerQt/Manager>
 #include <NetworkManagerQt/Utils>
 
 #include "networkmodel.h"
 
-class Q_DECL_EXPORT NetworkModelItem : public QObject
+/**
+ * Item of the NetworkModel. Items are plain objects, the model owns them and
+ * tracks their changes through changedRoles(). Object paths, SSIDs and device
+ * names shared by many items are kept once in a pool and items refer to them
+ * by id.
+ */
+class Q_DECL_EXPORT NetworkModelItem
 {
-Q_OBJECT
 public:
 
     enum ItemType { UnavailableConnection, AvailableConnection, AvailableAccessPoint };
 
-    explicit NetworkModelItem(QObject *parent = nullptr);
-    explicit NetworkModelItem(const NetworkModelItem *item, QObject *parent = nullptr);
-    ~NetworkModelItem() override;
+    NetworkModelItem();
+    // Duplicate of @p item for another device
+    explicit NetworkModelItem(const NetworkModelItem *item);
+    ~NetworkModelItem();
+
+    /**
+     * Id of @p string in the pool, or 0 for an empty string. Returns false when
+     * no item holds the string, so no item can match it.
+     */
+    static bool findStringId(const QString &string, quint32 *id);
 
     QString activeConnectionPath() const;
+    quint32 activeConnectionPathId() const { return m_activeConnectionPath; }
     void setActiveConnectionPath(const QString &path);
 
     QString connectionPath() const;
+    quint32 connectionPathId() const { return m_connectionPath; }
     void setConnectionPath(const QString &path);
 
     NetworkManager::ActiveConnection::State connectionState() const;
@@ -55,6 +70,7 @@ public:
     void setDeviceName(const QString &name);
 
     QString devicePath() const;
+    quint32 devicePathId() const { return m_devicePath; }
     void setDevicePath(const QString &path);
 
     QString deviceState() const;
@@ -90,11 +106,26 @@ public:
     void setSpecificPath(const QString &path);
 
     QString ssid() const;
+    quint32 ssidId() const { return m_ssid; }
     void setSsid(const QString &ssid);
 
+    // Item restored from the scan cache which hasn't been confirmed by a scan yet
+    bool stale() const;
+    void setStale(bool stale);
+
+    // VPN connections are only available while NetworkManager is connected
+    void setNetworkManagerStatus(NetworkManager::Status status);
+
     QDateTime timestamp() const;
     void setTimestamp(const QDateTime &date);
 
+    // Relative texts of the timestamp, formatted once and kept until lastUsedChange()
+    QString lastUsed() const;
+    QString lastUsedDateOnly() const;
+    QDateTime lastUsedChange() const;
+    // Formats the texts again, returns true if they differ from the previously shown ones
+    bool refreshLastUsed();
+
     NetworkManager::ConnectionSettings::ConnectionType type() const;
     void setType(NetworkManager::ConnectionSettings::ConnectionType type);
 
@@ -117,42 +148,56 @@ public:
 
     bool operator==(const NetworkModelItem *item) const;
 
-    QVector<int> changedRoles() const { return m_changedRoles; }
-    void clearChangedRoles() { m_changedRoles.clear(); }
+    QVector<int> changedRoles() const;
+    bool hasChangedRole(int role) const;
+    void clearChangedRoles() { m_changedRoles = 0; }
 
-public Q_SLOTS:
     void invalidateDetails();
 
 private:
+    Q_DISABLE_COPY(NetworkModelItem)
+
     QString computeIcon() const;
+    void markChanged(int role);
     void refreshIcon();
     void updateDetails() const;
+    void updateLastUsed() const;
+
+    // Ids in the string pool
+    quint32 m_activeConnectionPath;
+    quint32 m_connectionPath;
+    quint32 m_devicePath;
+    quint32 m_deviceName;
+    quint32 m_specificPath;
+    quint32 m_ssid;
+    quint32 m_vpnType;
+    // One bit per NetworkModel role, starting at ConnectionDetailsRole
+    quint32 m_changedRoles;
 
-    QString m_activeConnectionPath;
-    QString m_connectionPath;
-    NetworkManager::ActiveConnection::State m_connectionState;
-    QString m_devicePath;
-    QString m_deviceName;
-    NetworkManager::Device::State m_deviceState;
-    mutable QStringList m_details;
-    mutable bool m_detailsValid;
-    bool m_duplicate;
-    NetworkManager::WirelessSetting::NetworkMode m_mode;
     QString m_name;
-    NetworkManager::WirelessSecurityType m_securityType;
-    int m_signal;
-    bool m_slave;
-    QString m_specificPath;
-    QString m_ssid;
-    QDateTime m_timestamp;
-    NetworkManager::ConnectionSettings::ConnectionType m_type;
     QString m_uuid;
-    QString m_vpnType;
-    NetworkManager::VpnConnection::State m_vpnState;
+    QString m_icon;
+    QDateTime m_timestamp;
+    mutable QStringList m_details;
+    mutable QString m_lastUsed;
+    mutable QString m_lastUsedDateOnly;
+    mutable QDateTime m_lastUsedChange;
     qulonglong m_rxBytes;
     qulonglong m_txBytes;
-    QString m_icon;
-    QVector<int> m_changedRoles;
+
+    qint8 m_connectionState;
+    qint8 m_deviceState;
+    qint8 m_mode;
+    qint8 m_securityType;
+    qint8 m_type;
+    qint8 m_vpnState;
+    quint8 m_signal;
+    mutable bool m_detailsValid : 1;
+    bool m_duplicate : 1;
+    bool m_slave : 1;
+    bool m_stale : 1;
+    mutable bool m_lastUsedValid : 1;
+    bool m_networkManagerConnected : 1;
 };
 
 #endif // PLASMA_NM_MODEL_NETWORK_MODEL_ITEM_H
@@ -0,0 +1,173 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "networkmodelpublisher.h"
+#include "networkmodel.h"
+
+#include <QDataStream>
+
+// Changes arriving within this time are published in one delta
+#define NM_MODEL_DELTA_DELAY 50
+
+NetworkModelPublisher::NetworkModelPublisher(QAbstractItemModel *model, QObject *parent)
+    : QObject(parent)
+    , m_model(model)
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(NM_MODEL_DELTA_DELAY);
+    connect(&m_flushTimer, &QTimer::timeout, this, &NetworkModelPublisher::flush);
+
+    connect(model, &QAbstractItemModel::rowsInserted, this, &NetworkModelPublisher::rowsInserted);
+    connect(model, &QAbstractItemModel::rowsRemoved, this, &NetworkModelPublisher::rowsRemoved);
+    connect(model, &QAbstractItemModel::dataChanged, this, &NetworkModelPublisher::dataChanged);
+    connect(model, &QAbstractItemModel::modelReset, this, &NetworkModelPublisher::modelReset);
+}
+
+NetworkModelPublisher::~NetworkModelPublisher()
+{
+}
+
+QByteArray NetworkModelPublisher::snapshot()
+{
+    flush();
+
+    QByteArray snapshot;
+    QDataStream stream(&snapshot, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << quint32(NM_MODEL_STREAM_VERSION) << qint32(NetworkModel::RoleCount) << m_serial;
+    stream << qint32(m_model->rowCount());
+    writeRows(stream, 0, m_model->rowCount() - 1);
+    return snapshot;
+}
+
+quint64 NetworkModelPublisher::serial() const
+{
+    return m_serial;
+}
+
+void NetworkModelPublisher::flush()
+{
+    m_flushTimer.stop();
+
+    if (!m_operationCount) {
+        return;
+    }
+
+    QByteArray delta;
+    QDataStream stream(&delta, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << quint32(NM_MODEL_STREAM_VERSION) << qint32(NetworkModel::RoleCount) << ++m_serial;
+    stream << qint32(m_operationCount);
+    delta.append(m_operations);
+
+    m_operations.clear();
+    m_operationCount = 0;
+
+    Q_EMIT deltaReady(delta);
+}
+
+void NetworkModelPublisher::rowsInserted(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+
+    // Values are taken right away, later operations may move the rows
+    QDataStream stream(&m_operations, QIODevice::Append);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << quint8(InsertRows) << qint32(first) << qint32(last - first + 1);
+    writeRows(stream, first, last);
+    m_operationCount++;
+    scheduleFlush();
+}
+
+void NetworkModelPublisher::rowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+
+    QDataStream stream(&m_operations, QIODevice::Append);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << quint8(RemoveRows) << qint32(first) << qint32(last - first + 1);
+    m_operationCount++;
+    scheduleFlush();
+}
+
+void NetworkModelPublisher::dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles)
+{
+    QVector<qint32> columns;
+    for (int role : roles) {
+        if (role >= NetworkModel::ConnectionDetailsRole && role <= NetworkModel::TxBytesRole) {
+            columns << role - NetworkModel::ConnectionDetailsRole;
+        }
+    }
+    if (roles.isEmpty()) {
+        for (int column = 0; column < NetworkModel::RoleCount; ++column) {
+            columns << column;
+        }
+    } else if (columns.isEmpty()) {
+        return;
+    }
+
+    QDataStream stream(&m_operations, QIODevice::Append);
+    stream.setVersion(QDataStream::Qt_5_12);
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        const QModelIndex index = m_model->index(row, 0);
+        QVector<QVariant> values;
+        values.reserve(columns.count());
+        for (qint32 column : columns) {
+            values << m_model->data(index, NetworkModel::ConnectionDetailsRole + column);
+        }
+        stream << quint8(ChangeData) << qint32(row) << columns << values;
+        m_operationCount++;
+    }
+    scheduleFlush();
+}
+
+void NetworkModelPublisher::modelReset()
+{
+    // Earlier operations are superseded by the new rows
+    m_operations.clear();
+
+    QDataStream stream(&m_operations, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << quint8(ResetRows) << qint32(m_model->rowCount());
+    writeRows(stream, 0, m_model->rowCount() - 1);
+    m_operationCount = 1;
+    scheduleFlush();
+}
+
+void NetworkModelPublisher::writeRows(QDataStream &stream, int first, int last) const
+{
+    for (int row = first; row <= last; ++row) {
+        const QModelIndex index = m_model->index(row, 0);
+        QVector<QVariant> values;
+        values.reserve(NetworkModel::RoleCount);
+        for (int role = NetworkModel::ConnectionDetailsRole; role <= NetworkModel::TxBytesRole; ++role) {
+            values << m_model->data(index, role);
+        }
+        stream << values;
+    }
+}
+
+void NetworkModelPublisher::scheduleFlush()
+{
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
@@ -0,0 +1,82 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef PLASMA_NM_NETWORK_MODEL_PUBLISHER_H
+#define PLASMA_NM_NETWORK_MODEL_PUBLISHER_H
+
+#include <QAbstractItemModel>
+#include <QByteArray>
+#include <QTimer>
+
+// Version of the snapshot and delta format shared with NetworkModel replicas
+#define NM_MODEL_STREAM_VERSION 2
+
+/**
+ * Publishes a NetworkModel to replicas in other processes, see
+ * NetworkModel::ReplicaSource. A replica starts from snapshot() and then
+ * applies every delta, each of which carries the changes of one burst of
+ * changes of the model with a serial number one higher than the previous.
+ */
+class Q_DECL_EXPORT NetworkModelPublisher : public QObject
+{
+    Q_OBJECT
+public:
+    enum Operation {
+        InsertRows = 1,
+        RemoveRows,
+        ChangeData,
+        ResetRows
+    };
+
+    explicit NetworkModelPublisher(QAbstractItemModel *model, QObject *parent = nullptr);
+    ~NetworkModelPublisher() override;
+
+    /**
+     * All rows of the model. Pending changes are published first, so the
+     * snapshot has the serial of the last delta.
+     */
+    QByteArray snapshot();
+    quint64 serial() const;
+
+Q_SIGNALS:
+    void deltaReady(const QByteArray &delta);
+
+public Q_SLOTS:
+    void flush();
+
+private Q_SLOTS:
+    void rowsInserted(const QModelIndex &parent, int first, int last);
+    void rowsRemoved(const QModelIndex &parent, int first, int last);
+    void dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles);
+    void modelReset();
+
+private:
+    void writeRows(QDataStream &stream, int first, int last) const;
+    void scheduleFlush();
+
+    QAbstractItemModel *m_model;
+    quint64 m_serial = 0;
+    QByteArray m_operations;
+    int m_operationCount = 0;
+    QTimer m_flushTimer;
+};
+
+#endif // PLASMA_NM_NETWORK_MODEL_PUBLISHER_H
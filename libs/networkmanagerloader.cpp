@@ -0,0 +1,168 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "networkmanagerloader.h"
+#include "debug.h"
+
+#include <QDBusMetaType>
+#include <QDBusObjectPath>
+#include <QDBusPendingReply>
+#include <QPair>
+#include <QTimer>
+#include <QVector>
+
+// Time to wait for each round trip, consumers fall back to loading object by object after it
+#define NM_LOADER_TIMEOUT 1000
+
+typedef QMap<QDBusObjectPath, NMVariantMapMap> ManagedObjects;
+
+Q_GLOBAL_STATIC_WITH_ARGS(NetworkManagerLoader, s_loader, (QDBusConnection::systemBus(), QStringLiteral(NM_DBUS_SERVICE)))
+
+NetworkManagerLoader::NetworkManagerLoader(const QDBusConnection &connection, const QString &service)
+    : m_connection(connection)
+    , m_service(service)
+    , m_timeout(NM_LOADER_TIMEOUT)
+{
+    qDBusRegisterMetaType<NMVariantMapMap>();
+    qDBusRegisterMetaType<ManagedObjects>();
+}
+
+NetworkManagerLoader::~NetworkManagerLoader()
+{
+}
+
+NetworkManagerLoader *NetworkManagerLoader::self()
+{
+    // Consumers created in the same pass share one attempt
+    if (!s_loader->m_attempted) {
+        s_loader->load();
+        QTimer::singleShot(0, [] () {
+            s_loader->clear();
+        });
+    }
+    return s_loader;
+}
+
+bool NetworkManagerLoader::load()
+{
+    clear();
+    m_attempted = true;
+
+    QDBusMessage message = QDBusMessage::createMethodCall(m_service, QStringLiteral("/org/freedesktop"),
+                                                          QStringLiteral("org.freedesktop.DBus.ObjectManager"), QStringLiteral("GetManagedObjects"));
+    QDBusPendingReply<ManagedObjects> reply = m_connection.asyncCall(message, m_timeout);
+    reply.waitForFinished();
+    m_roundTrips++;
+
+    if (!reply.isValid()) {
+        qCWarning(PLASMA_NM) << "Failed to get NetworkManager objects:" << reply.error().message();
+        return false;
+    }
+
+    const ManagedObjects objects = reply.value();
+    for (auto it = objects.constBegin(); it != objects.constEnd(); ++it) {
+        m_objects.insert(it.key().path(), it.value());
+    }
+
+    // All requests are sent before waiting for the first reply, so the settings
+    // of all connections cost a single round trip
+    QVector<QPair<QString, QDBusPendingReply<NMVariantMapMap> > > pendingSettings;
+    for (const QString &path : this->objects(QStringLiteral(NM_DBUS_INTERFACE_SETTINGS_CONNECTION))) {
+        QDBusMessage message = QDBusMessage::createMethodCall(m_service, path, QStringLiteral(NM_DBUS_INTERFACE_SETTINGS_CONNECTION), QStringLiteral("GetSettings"));
+        pendingSettings << qMakePair(path, QDBusPendingReply<NMVariantMapMap>(m_connection.asyncCall(message, m_timeout)));
+    }
+
+    bool timedOut = false;
+    for (auto &pending : pendingSettings) {
+        pending.second.waitForFinished();
+        if (pending.second.isValid()) {
+            m_settings.insert(pending.first, pending.second.value());
+        } else {
+            const QDBusError error = pending.second.error();
+            timedOut = timedOut || error.type() == QDBusError::NoReply || error.type() == QDBusError::Timeout;
+            qCWarning(PLASMA_NM) << "Failed to get settings of" << pending.first << ":" << error.message();
+        }
+    }
+    if (!pendingSettings.isEmpty()) {
+        m_roundTrips++;
+    }
+
+    // A partial snapshot would miss connections, the consumers load them one by one instead
+    if (timedOut) {
+        m_objects.clear();
+        m_settings.clear();
+        return false;
+    }
+
+    m_loaded = true;
+    return true;
+}
+
+void NetworkManagerLoader::clear()
+{
+    m_objects.clear();
+    m_settings.clear();
+    m_loaded = false;
+    m_attempted = false;
+    m_roundTrips = 0;
+}
+
+int NetworkManagerLoader::timeout() const
+{
+    return m_timeout;
+}
+
+void NetworkManagerLoader::setTimeout(int msecs)
+{
+    m_timeout = msecs;
+}
+
+bool NetworkManagerLoader::isLoaded() const
+{
+    return m_loaded;
+}
+
+int NetworkManagerLoader::roundTrips() const
+{
+    return m_roundTrips;
+}
+
+QStringList NetworkManagerLoader::objects(const QString &interface) const
+{
+    QStringList result;
+    for (auto it = m_objects.constBegin(); it != m_objects.constEnd(); ++it) {
+        if (it.value().contains(interface)) {
+            result << it.key();
+        }
+    }
+    result.sort();
+    return result;
+}
+
+QVariantMap NetworkManagerLoader::properties(const QString &path, const QString &interface) const
+{
+    return m_objects.value(path).value(interface);
+}
+
+NMVariantMapMap NetworkManagerLoader::settings(const QString &path) const
+{
+    return m_settings.value(path);
+}
@@ -0,0 +1,93 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef PLASMA_NM_NETWORKMANAGER_LOADER_H
+#define PLASMA_NM_NETWORKMANAGER_LOADER_H
+
+#include <QDBusConnection>
+#include <QHash>
+#include <QStringList>
+
+#include <NetworkManagerQt/Manager>
+
+/**
+ * Fetches all NetworkManager objects with their properties in a single
+ * GetManagedObjects call, and the settings of all connections in one batch
+ * of GetSettings calls sent together.
+ *
+ * Consumers created at startup read this snapshot instead of enumerating
+ * devices and connections object by object. The shared snapshot of self()
+ * is dropped when control returns to the event loop, later consumers load
+ * a new one.
+ */
+class Q_DECL_EXPORT NetworkManagerLoader
+{
+public:
+    NetworkManagerLoader(const QDBusConnection &connection, const QString &service);
+    ~NetworkManagerLoader();
+
+    /**
+     * Snapshot of NetworkManager on the system bus, check isLoaded() before using it
+     */
+    static NetworkManagerLoader *self();
+
+    /**
+     * Blocks until NetworkManager replies, at most timeout() for each round trip.
+     * Returns false when it doesn't reply in time, then nothing is loaded.
+     */
+    bool load();
+    void clear();
+    bool isLoaded() const;
+
+    /**
+     * Time in ms to wait for the replies of a round trip
+     */
+    int timeout() const;
+    void setTimeout(int msecs);
+
+    /**
+     * Number of times load() waited for replies
+     */
+    int roundTrips() const;
+
+    /**
+     * Paths of the objects implementing @p interface, sorted
+     */
+    QStringList objects(const QString &interface) const;
+    QVariantMap properties(const QString &path, const QString &interface) const;
+
+    /**
+     * Settings of the connection at @p path, empty if they couldn't be loaded
+     */
+    NMVariantMapMap settings(const QString &path) const;
+
+private:
+    QDBusConnection m_connection;
+    QString m_service;
+    int m_timeout;
+    QHash<QString, NMVariantMapMap> m_objects;
+    QHash<QString, NMVariantMapMap> m_settings;
+    bool m_loaded = false;
+    bool m_attempted = false;
+    int m_roundTrips = 0;
+};
+
+#endif // PLASMA_NM_NETWORKMANAGER_LOADER_H
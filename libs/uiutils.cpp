@@ -47,13 +47,62 @@
 #endif
 
 // Qt
+#include <QHash>
 #include <QSizeF>
 #include <QHostAddress>
 
 #include <QString>
 
+#include <climits>
+
 using namespace NetworkManager;
 
+namespace
+{
+// Key of the label used for values missing in a label table
+const int FallbackLabel = INT_MIN;
+
+// Bumped by UiUtils::clearLabelCache(), which makes all label tables to be rebuilt
+int s_labelsGeneration = 0;
+
+struct LabelTable
+{
+    int generation = -1;
+    QHash<int, QString> labels;
+};
+
+/*
+ * Translated labels are requested by the models for every row and role, so they are
+ * translated only once and then shared, until the language changes.
+ */
+template<typename Builder>
+const QHash<int, QString> &labelTable(LabelTable &table, Builder build)
+{
+    if (table.generation != s_labelsGeneration) {
+        table.labels.clear();
+        build(table.labels);
+        table.generation = s_labelsGeneration;
+    }
+
+    return table.labels;
+}
+
+QString label(const QHash<int, QString> &labels, int key)
+{
+    auto it = labels.constFind(key);
+    if (it != labels.constEnd()) {
+        return it.value();
+    }
+
+    return labels.value(FallbackLabel);
+}
+}
+
+void UiUtils::clearLabelCache()
+{
+    ++s_labelsGeneration;
+}
+
 UiUtils::SortedConnectionType UiUtils::connectionTypeToSortedType(NetworkManager::ConnectionSettings::ConnectionType type)
 {
     switch (type) {
@@ -145,121 +194,87 @@ bool UiUtils::isConnectionTypeVirtual(NetworkManager::ConnectionSettings::Connec
 
 QString UiUtils::interfaceTypeLabel(const NetworkManager::Device::Type type, const NetworkManager::Device::Ptr iface)
 {
-    QString deviceText;
-    switch (type) {
-    case NetworkManager::Device::Wifi:
-        deviceText = i18nc("title of the interface widget in nm's popup", "Wi-Fi");
-        break;
-    case NetworkManager::Device::Bluetooth:
-        deviceText = i18nc("title of the interface widget in nm's popup", "Bluetooth");
-        break;
-    case NetworkManager::Device::InfiniBand:
-        deviceText = i18nc("title of the interface widget in nm's popup", "Infiniband");
-        break;
-    case NetworkManager::Device::Adsl:
-        deviceText = i18nc("title of the interface widget in nm's popup", "ADSL");
-        break;
-    case NetworkManager::Device::Bond:
-        deviceText = i18nc("title of the interface widget in nm's popup", "Virtual (bond)");
-        break;
-    case NetworkManager::Device::Bridge:
-        deviceText = i18nc("title of the interface widget in nm's popup", "Virtual (bridge)");
-        break;
-    case NetworkManager::Device::Vlan:
-        deviceText = i18nc("title of the interface widget in nm's popup", "Virtual (vlan)");
-        break;
-    case NetworkManager::Device::Team:
-        deviceText = i18nc("title of the interface widget in nm's popup", "Virtual (team)");
-        break;
-    case NetworkManager::Device::Modem: {
-        const NetworkManager::ModemDevice::Ptr nmModemIface = iface.objectCast<NetworkManager::ModemDevice>();
-        if (nmModemIface) {
-            switch(modemSubType(nmModemIface->currentCapabilities())) {
-            case NetworkManager::ModemDevice::Pots:
-                deviceText = i18nc("title of the interface widget in nm's popup", "Serial Modem");
-                break;
-            case NetworkManager::ModemDevice::GsmUmts:
-            case NetworkManager::ModemDevice::CdmaEvdo:
-            case NetworkManager::ModemDevice::Lte:
-                deviceText = i18nc("title of the interface widget in nm's popup", "Mobile Broadband");
-                break;
-            case NetworkManager::ModemDevice::NoCapability:
-                qCWarning(PLASMA_NM) << "Unhandled modem sub type: NetworkManager::ModemDevice::NoCapability";
-                break;
-            }
-        }
+    static LabelTable deviceTable;
+    const QHash<int, QString> &deviceLabels = labelTable(deviceTable, [] (QHash<int, QString> &entries) {
+        entries.insert(NetworkManager::Device::Wifi, i18nc("title of the interface widget in nm's popup", "Wi-Fi"));
+        entries.insert(NetworkManager::Device::Bluetooth, i18nc("title of the interface widget in nm's popup", "Bluetooth"));
+        entries.insert(NetworkManager::Device::InfiniBand, i18nc("title of the interface widget in nm's popup", "Infiniband"));
+        entries.insert(NetworkManager::Device::Adsl, i18nc("title of the interface widget in nm's popup", "ADSL"));
+        entries.insert(NetworkManager::Device::Bond, i18nc("title of the interface widget in nm's popup", "Virtual (bond)"));
+        entries.insert(NetworkManager::Device::Bridge, i18nc("title of the interface widget in nm's popup", "Virtual (bridge)"));
+        entries.insert(NetworkManager::Device::Vlan, i18nc("title of the interface widget in nm's popup", "Virtual (vlan)"));
+        entries.insert(NetworkManager::Device::Team, i18nc("title of the interface widget in nm's popup", "Virtual (team)"));
+        entries.insert(FallbackLabel, i18nc("title of the interface widget in nm's popup", "Wired Ethernet"));
+    });
+
+    if (type != NetworkManager::Device::Modem) {
+        return label(deviceLabels, type);
     }
-        break;
-    case NetworkManager::Device::Ethernet:
-    default:
-        deviceText = i18nc("title of the interface widget in nm's popup", "Wired Ethernet");
-        break;
+
+    static LabelTable modemTable;
+    const QHash<int, QString> &modemLabels = labelTable(modemTable, [] (QHash<int, QString> &entries) {
+        const QString mobileBroadband = i18nc("title of the interface widget in nm's popup", "Mobile Broadband");
+        entries.insert(NetworkManager::ModemDevice::Pots, i18nc("title of the interface widget in nm's popup", "Serial Modem"));
+        entries.insert(NetworkManager::ModemDevice::GsmUmts, mobileBroadband);
+        entries.insert(NetworkManager::ModemDevice::CdmaEvdo, mobileBroadband);
+        entries.insert(NetworkManager::ModemDevice::Lte, mobileBroadband);
+    });
+
+    const NetworkManager::ModemDevice::Ptr nmModemIface = iface.objectCast<NetworkManager::ModemDevice>();
+    if (!nmModemIface) {
+        return QString();
+    }
+
+    const NetworkManager::ModemDevice::Capability subType = modemSubType(nmModemIface->currentCapabilities());
+    if (subType == NetworkManager::ModemDevice::NoCapability) {
+        qCWarning(PLASMA_NM) << "Unhandled modem sub type: NetworkManager::ModemDevice::NoCapability";
     }
-    return deviceText;
+
+    return modemLabels.value(subType);
 }
 
 QString UiUtils::iconAndTitleForConnectionSettingsType(NetworkManager::ConnectionSettings::ConnectionType type, QString &title)
 {
-    QString text;
-    QString icon = QStringLiteral("network-wired");
+    static LabelTable table;
+    const QHash<int, QString> &titles = labelTable(table, [] (QHash<int, QString> &entries) {
+        const QString mobileBroadband = i18n("Mobile broadband");
+        entries.insert(ConnectionSettings::Adsl, i18n("ADSL"));
+        entries.insert(ConnectionSettings::Pppoe, i18n("DSL"));
+        entries.insert(ConnectionSettings::Bluetooth, i18n("Bluetooth"));
+        entries.insert(ConnectionSettings::Bond, i18n("Bond"));
+        entries.insert(ConnectionSettings::Bridge, i18n("Bridge"));
+        entries.insert(ConnectionSettings::Gsm, mobileBroadband);
+        entries.insert(ConnectionSettings::Cdma, mobileBroadband);
+        entries.insert(ConnectionSettings::Infiniband, i18n("Infiniband"));
+        entries.insert(ConnectionSettings::OLPCMesh, i18n("Olpc mesh"));
+        entries.insert(ConnectionSettings::Vlan, i18n("VLAN"));
+        entries.insert(ConnectionSettings::Vpn, i18n("VPN"));
+        entries.insert(ConnectionSettings::Wired, i18n("Wired Ethernet"));
+        entries.insert(ConnectionSettings::Wireless, i18n("Wi-Fi"));
+        entries.insert(ConnectionSettings::Team, i18n("Team"));
+        entries.insert(ConnectionSettings::WireGuard, i18n("WireGuard VPN"));
+        entries.insert(FallbackLabel, i18n("Unknown connection type"));
+    });
+
+    title = label(titles, type);
+
     switch (type) {
     case ConnectionSettings::Adsl:
-        text = i18n("ADSL");
-        icon = QStringLiteral("network-modem");
-        break;
     case ConnectionSettings::Pppoe:
-        text = i18n("DSL");
-        icon = QStringLiteral("network-modem");
-        break;
+        return QStringLiteral("network-modem");
     case ConnectionSettings::Bluetooth:
-        text = i18n("Bluetooth");
-        icon = QStringLiteral("network-bluetooth");
-        break;
-    case ConnectionSettings::Bond:
-        text = i18n("Bond");
-        break;
-    case ConnectionSettings::Bridge:
-        text = i18n("Bridge");
-        break;
+        return QStringLiteral("network-bluetooth");
     case ConnectionSettings::Gsm:
     case ConnectionSettings::Cdma:
-        text = i18n("Mobile broadband");
-        icon = QStringLiteral("smartphone");
-        break;
-    case ConnectionSettings::Infiniband:
-        text = i18n("Infiniband");
-        break;
-    case ConnectionSettings::OLPCMesh:
-        text = i18n("Olpc mesh");
-        break;
-    case ConnectionSettings::Vlan:
-        text = i18n("VLAN");
-        break;
+        return QStringLiteral("smartphone");
     case ConnectionSettings::Vpn:
-        text = i18n("VPN");
-        icon = QStringLiteral("network-vpn");
-        break;
-    case ConnectionSettings::Wired:
-        text = i18n("Wired Ethernet");
-        icon = QStringLiteral("network-wired");
-        break;
-    case ConnectionSettings::Wireless:
-        text = i18n("Wi-Fi");
-        icon = QStringLiteral("network-wireless");
-        break;
-    case ConnectionSettings::Team:
-        text = i18n("Team");
-        break;
     case ConnectionSettings::WireGuard:
-        text = i18n("WireGuard VPN");
-        icon = QStringLiteral("network-vpn");
-        break;
+        return QStringLiteral("network-vpn");
+    case ConnectionSettings::Wireless:
+        return QStringLiteral("network-wireless");
     default:
-        text = i18n("Unknown connection type");
-        break;
+        return QStringLiteral("network-wired");
     }
-    title = text;
-    return icon;
 }
 
 QString UiUtils::prettyInterfaceName(NetworkManager::Device::Type type, const QString &interfaceName)
@@ -295,88 +310,47 @@ QString UiUtils::prettyInterfaceName(NetworkManager::Device::Type type, const QS
 
 QString UiUtils::connectionStateToString(NetworkManager::Device::State state, const QString &connectionName)
 {
-    QString stateString;
-    switch (state) {
-        case NetworkManager::Device::UnknownState:
-            stateString = i18nc("description of unknown network interface state", "Unknown");
-            break;
-        case NetworkManager::Device::Unmanaged:
-            stateString = i18nc("description of unmanaged network interface state", "Unmanaged");
-            break;
-        case NetworkManager::Device::Unavailable:
-            stateString = i18nc("description of unavailable network interface state", "Unavailable");
-            break;
-        case NetworkManager::Device::Disconnected:
-            stateString = i18nc("description of unconnected network interface state", "Not connected");
-            break;
-        case NetworkManager::Device::Preparing:
-            stateString = i18nc("description of preparing to connect network interface state", "Preparing to connect");
-            break;
-        case NetworkManager::Device::ConfiguringHardware:
-            stateString = i18nc("description of configuring hardware network interface state", "Configuring interface");
-            break;
-        case NetworkManager::Device::NeedAuth:
-            stateString = i18nc("description of waiting for authentication network interface state", "Waiting for authorization");
-            break;
-        case NetworkManager::Device::ConfiguringIp:
-            stateString = i18nc("network interface doing dhcp request in most cases", "Setting network address");
-            break;
-        case NetworkManager::Device::CheckingIp:
-            stateString = i18nc("is other action required to fully connect? captive portals, etc.", "Checking further connectivity");
-            break;
-        case NetworkManager::Device::WaitingForSecondaries:
-            stateString = i18nc("a secondary connection (e.g. VPN) has to be activated first to continue", "Waiting for a secondary connection");
-            break;
-        case NetworkManager::Device::Activated:
-            if (connectionName.isEmpty()) {
-                stateString = i18nc("network interface connected state label", "Connected");
-            } else {
-                stateString = i18nc("network interface connected state label", "Connected to %1", connectionName);
-            }
-            break;
-        case NetworkManager::Device::Deactivating:
-            stateString = i18nc("network interface disconnecting state label", "Deactivating connection");
-            break;
-        case NetworkManager::Device::Failed:
-            stateString = i18nc("network interface connection failed state label", "Connection Failed");
-            break;
-        default:
-            stateString = i18nc("interface state", "Error: Invalid state");
+    if (state == NetworkManager::Device::Activated && !connectionName.isEmpty()) {
+        return i18nc("network interface connected state label", "Connected to %1", connectionName);
     }
-    return stateString;
+
+    static LabelTable table;
+    const QHash<int, QString> &labels = labelTable(table, [] (QHash<int, QString> &entries) {
+        entries.insert(NetworkManager::Device::UnknownState, i18nc("description of unknown network interface state", "Unknown"));
+        entries.insert(NetworkManager::Device::Unmanaged, i18nc("description of unmanaged network interface state", "Unmanaged"));
+        entries.insert(NetworkManager::Device::Unavailable, i18nc("description of unavailable network interface state", "Unavailable"));
+        entries.insert(NetworkManager::Device::Disconnected, i18nc("description of unconnected network interface state", "Not connected"));
+        entries.insert(NetworkManager::Device::Preparing, i18nc("description of preparing to connect network interface state", "Preparing to connect"));
+        entries.insert(NetworkManager::Device::ConfiguringHardware, i18nc("description of configuring hardware network interface state", "Configuring interface"));
+        entries.insert(NetworkManager::Device::NeedAuth, i18nc("description of waiting for authentication network interface state", "Waiting for authorization"));
+        entries.insert(NetworkManager::Device::ConfiguringIp, i18nc("network interface doing dhcp request in most cases", "Setting network address"));
+        entries.insert(NetworkManager::Device::CheckingIp, i18nc("is other action required to fully connect? captive portals, etc.", "Checking further connectivity"));
+        entries.insert(NetworkManager::Device::WaitingForSecondaries, i18nc("a secondary connection (e.g. VPN) has to be activated first to continue", "Waiting for a secondary connection"));
+        entries.insert(NetworkManager::Device::Activated, i18nc("network interface connected state label", "Connected"));
+        entries.insert(NetworkManager::Device::Deactivating, i18nc("network interface disconnecting state label", "Deactivating connection"));
+        entries.insert(NetworkManager::Device::Failed, i18nc("network interface connection failed state label", "Connection Failed"));
+        entries.insert(FallbackLabel, i18nc("interface state", "Error: Invalid state"));
+    });
+
+    return label(labels, state);
 }
 
 QString UiUtils::vpnConnectionStateToString(VpnConnection::State state)
 {
-    QString stateString;
-    switch (state) {
-        case VpnConnection::Unknown:
-            stateString = i18nc("The state of the VPN connection is unknown", "Unknown");
-            break;
-        case VpnConnection::Prepare:
-            stateString = i18nc("The VPN connection is preparing to connect", "Preparing to connect");
-            break;
-        case VpnConnection::NeedAuth:
-            stateString = i18nc("The VPN connection needs authorization credentials", "Needs authorization");
-            break;
-        case VpnConnection::Connecting:
-            stateString = i18nc("The VPN connection is being established", "Connecting");
-            break;
-        case VpnConnection::GettingIpConfig:
-            stateString = i18nc("The VPN connection is getting an IP address", "Setting network address");
-            break;
-        case VpnConnection::Activated:
-            stateString = i18nc("The VPN connection is active", "Activated");
-            break;
-        case VpnConnection::Failed:
-            stateString = i18nc("The VPN connection failed", "Failed");
-            break;
-        case VpnConnection::Disconnected:
-            stateString = i18nc("The VPN connection is disconnected", "Failed");
-            break;
-        default:
-            stateString = i18nc("interface state", "Error: Invalid state");    }
-    return stateString;
+    static LabelTable table;
+    const QHash<int, QString> &labels = labelTable(table, [] (QHash<int, QString> &entries) {
+        entries.insert(VpnConnection::Unknown, i18nc("The state of the VPN connection is unknown", "Unknown"));
+        entries.insert(VpnConnection::Prepare, i18nc("The VPN connection is preparing to connect", "Preparing to connect"));
+        entries.insert(VpnConnection::NeedAuth, i18nc("The VPN connection needs authorization credentials", "Needs authorization"));
+        entries.insert(VpnConnection::Connecting, i18nc("The VPN connection is being established", "Connecting"));
+        entries.insert(VpnConnection::GettingIpConfig, i18nc("The VPN connection is getting an IP address", "Setting network address"));
+        entries.insert(VpnConnection::Activated, i18nc("The VPN connection is active", "Activated"));
+        entries.insert(VpnConnection::Failed, i18nc("The VPN connection failed", "Failed"));
+        entries.insert(VpnConnection::Disconnected, i18nc("The VPN connection is disconnected", "Failed"));
+        entries.insert(FallbackLabel, i18nc("interface state", "Error: Invalid state"));
+    });
+
+    return label(labels, state);
 }
 
 QString UiUtils::operationModeToString(NetworkManager::WirelessDevice::OperationMode mode)
@@ -492,43 +466,55 @@ QString UiUtils::convertAllowedModeToString(ModemManager::Modem::ModemModes mode
 
 QString UiUtils::convertAccessTechnologyToString(ModemManager::Modem::AccessTechnologies tech)
 {
-    if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_LTE)) {
-        return i18nc("Cellular access technology","LTE");
-    } else if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_EVDOB)) {
-        return i18nc("Cellular access technology","CDMA2000 EVDO revision B");
-    } else if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_EVDOA)) {
-        return i18nc("Cellular access technology","CDMA2000 EVDO revision A");
-    } else if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_EVDO0)) {
-        return i18nc("Cellular access technology","CDMA2000 EVDO revision 0");
-    } else if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_1XRTT)) {
-        return i18nc("Cellular access technology","CDMA2000 1xRTT");
-    } else if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_HSPA_PLUS)) {
-        return i18nc("Cellular access technology","HSPA+");
-    } else if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_HSPA)) {
-        return i18nc("Cellular access technology","HSPA");
-    } else if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_HSUPA)) {
-        return i18nc("Cellular access technology","HSUPA");
-    } else if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_HSDPA)) {
-        return i18nc("Cellular access technology","HSDPA");
-    } else if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_UMTS)) {
-        return i18nc("Cellular access technology","UMTS");
-    } else if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_EDGE)) {
-        return i18nc("Cellular access technology","EDGE");
-    } else if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_GPRS)) {
-        return i18nc("Cellular access technology","GPRS");
-    } else if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_GSM_COMPACT)) {
-        return i18nc("Cellular access technology","Compact GSM");
-    } else if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_GSM)) {
-        return i18nc("Cellular access technology","GSM");
-    } else if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_POTS)) {
-        return i18nc("Analog wireline modem","Analog");
-    } else if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN)) {
-        return i18nc("Unknown cellular access technology","Unknown");
-    } else if (tech.testFlag(MM_MODEM_ACCESS_TECHNOLOGY_ANY)) {
-        return i18nc("Any cellular access technology","Any");
+    // Ordered from the most to the least preferred technology
+    static const MMModemAccessTechnology technologies[] = {
+        MM_MODEM_ACCESS_TECHNOLOGY_LTE,
+        MM_MODEM_ACCESS_TECHNOLOGY_EVDOB,
+        MM_MODEM_ACCESS_TECHNOLOGY_EVDOA,
+        MM_MODEM_ACCESS_TECHNOLOGY_EVDO0,
+        MM_MODEM_ACCESS_TECHNOLOGY_1XRTT,
+        MM_MODEM_ACCESS_TECHNOLOGY_HSPA_PLUS,
+        MM_MODEM_ACCESS_TECHNOLOGY_HSPA,
+        MM_MODEM_ACCESS_TECHNOLOGY_HSUPA,
+        MM_MODEM_ACCESS_TECHNOLOGY_HSDPA,
+        MM_MODEM_ACCESS_TECHNOLOGY_UMTS,
+        MM_MODEM_ACCESS_TECHNOLOGY_EDGE,
+        MM_MODEM_ACCESS_TECHNOLOGY_GPRS,
+        MM_MODEM_ACCESS_TECHNOLOGY_GSM_COMPACT,
+        MM_MODEM_ACCESS_TECHNOLOGY_GSM,
+        MM_MODEM_ACCESS_TECHNOLOGY_POTS,
+        MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN,
+        MM_MODEM_ACCESS_TECHNOLOGY_ANY
+    };
+
+    static LabelTable table;
+    const QHash<int, QString> &labels = labelTable(table, [] (QHash<int, QString> &entries) {
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_LTE, i18nc("Cellular access technology","LTE"));
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_EVDOB, i18nc("Cellular access technology","CDMA2000 EVDO revision B"));
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_EVDOA, i18nc("Cellular access technology","CDMA2000 EVDO revision A"));
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_EVDO0, i18nc("Cellular access technology","CDMA2000 EVDO revision 0"));
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_1XRTT, i18nc("Cellular access technology","CDMA2000 1xRTT"));
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_HSPA_PLUS, i18nc("Cellular access technology","HSPA+"));
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_HSPA, i18nc("Cellular access technology","HSPA"));
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_HSUPA, i18nc("Cellular access technology","HSUPA"));
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_HSDPA, i18nc("Cellular access technology","HSDPA"));
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_UMTS, i18nc("Cellular access technology","UMTS"));
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_EDGE, i18nc("Cellular access technology","EDGE"));
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_GPRS, i18nc("Cellular access technology","GPRS"));
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_GSM_COMPACT, i18nc("Cellular access technology","Compact GSM"));
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_GSM, i18nc("Cellular access technology","GSM"));
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_POTS, i18nc("Analog wireline modem","Analog"));
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN, i18nc("Unknown cellular access technology","Unknown"));
+        entries.insert(MM_MODEM_ACCESS_TECHNOLOGY_ANY, i18nc("Any cellular access technology","Any"));
+    });
+
+    for (const MMModemAccessTechnology technology : technologies) {
+        if (tech.testFlag(technology)) {
+            return labels.value(technology);
+        }
     }
 
-    return i18nc("Unknown cellular access technology","Unknown");
+    return labels.value(MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN);
 }
 
 QString UiUtils::convertLockReasonToString(MMModemLock reason)
@@ -589,40 +575,21 @@ NetworkManager::ModemDevice::Capability UiUtils::modemSubType(NetworkManager::Mo
 
 QString UiUtils::labelFromWirelessSecurity(NetworkManager::WirelessSecurityType type)
 {
-    QString tip;
-    switch (type) {
-        case NetworkManager::NoneSecurity:
-            tip = i18nc("@label no security", "Insecure");
-            break;
-        case NetworkManager::StaticWep:
-            tip = i18nc("@label WEP security", "WEP");
-            break;
-        case NetworkManager::Leap:
-            tip = i18nc("@label LEAP security", "LEAP");
-            break;
-        case NetworkManager::DynamicWep:
-            tip = i18nc("@label Dynamic WEP security", "Dynamic WEP");
-            break;
-        case NetworkManager::WpaPsk:
-            tip = i18nc("@label WPA-PSK security", "WPA-PSK");
-            break;
-        case NetworkManager::WpaEap:
-            tip = i18nc("@label WPA-EAP security", "WPA-EAP");
-            break;
-        case NetworkManager::Wpa2Psk:
-            tip = i18nc("@label WPA2-PSK security", "WPA2-PSK");
-            break;
-        case NetworkManager::Wpa2Eap:
-            tip = i18nc("@label WPA2-EAP security", "WPA2-EAP");
-            break;
-        case NetworkManager::SAE:
-            tip = i18nc("@label WPA3-SAE security", "WPA3-SAE");
-            break;
-        default:
-            tip = i18nc("@label unknown security", "Unknown security type");
-            break;
-    }
-    return tip;
+    static LabelTable table;
+    const QHash<int, QString> &labels = labelTable(table, [] (QHash<int, QString> &entries) {
+        entries.insert(NetworkManager::NoneSecurity, i18nc("@label no security", "Insecure"));
+        entries.insert(NetworkManager::StaticWep, i18nc("@label WEP security", "WEP"));
+        entries.insert(NetworkManager::Leap, i18nc("@label LEAP security", "LEAP"));
+        entries.insert(NetworkManager::DynamicWep, i18nc("@label Dynamic WEP security", "Dynamic WEP"));
+        entries.insert(NetworkManager::WpaPsk, i18nc("@label WPA-PSK security", "WPA-PSK"));
+        entries.insert(NetworkManager::WpaEap, i18nc("@label WPA-EAP security", "WPA-EAP"));
+        entries.insert(NetworkManager::Wpa2Psk, i18nc("@label WPA2-PSK security", "WPA2-PSK"));
+        entries.insert(NetworkManager::Wpa2Eap, i18nc("@label WPA2-EAP security", "WPA2-EAP"));
+        entries.insert(NetworkManager::SAE, i18nc("@label WPA3-SAE security", "WPA3-SAE"));
+        entries.insert(FallbackLabel, i18nc("@label unknown security", "Unknown security type"));
+    });
+
+    return label(labels, type);
 }
 
 QString UiUtils::formatDateRelative(const QDateTime & lastUsed)
@@ -692,3 +659,33 @@ QString UiUtils::formatLastUsedDateRelative(const QDateTime & lastUsed)
     }
     return lastUsedText;
 }
+
+QDateTime UiUtils::nextDateRelativeChange(const QDateTime & lastUsed)
+{
+    if (!lastUsed.isValid()) {
+        return QDateTime();
+    }
+
+    const QDateTime now = QDateTime::currentDateTime();
+    const qint64 daysAgo = lastUsed.daysTo(now);
+
+    // Older dates are formatted as a plain date
+    if (daysAgo > 1) {
+        return QDateTime();
+    }
+
+    const QDateTime tomorrow(now.date().addDays(1), QTime(0, 0));
+    if (daysAgo == 1) {
+        return tomorrow;
+    }
+
+    const qint64 secondsAgo = lastUsed.secsTo(now);
+    QDateTime nextChange;
+    if (secondsAgo < (60 * 60)) {
+        nextChange = lastUsed.addSecs((secondsAgo / 60 + 1) * 60);
+    } else {
+        nextChange = lastUsed.addSecs((secondsAgo / (60 * 60) + 1) * (60 * 60));
+    }
+
+    return qMin(nextChange, tomorrow);
+}
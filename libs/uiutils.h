@@ -102,6 +102,12 @@ public:
 
     static QString iconAndTitleForConnectionSettingsType(NetworkManager::ConnectionSettings::ConnectionType type,
                                                          QString &title);
+
+    /**
+     * Drops the translated labels shared between the calls above. KLocalizedString doesn't
+     * notify about language changes, so this needs to be called after KLocalizedString::setLanguages().
+     */
+    static void clearLabelCache();
     /**
      * @return a human-readable description of operation mode.
      * @param mode the operation mode
@@ -136,5 +142,12 @@ public:
 
     static QString formatDateRelative(const QDateTime & lastUsed);
     static QString formatLastUsedDateRelative(const QDateTime & lastUsed);
+
+    /**
+     * @return time when the text formatted by formatDateRelative() and formatLastUsedDateRelative()
+     * changes, e.g. when "Today" becomes "Yesterday", or an invalid date if it stays the same
+     * @param lastUsed the formatted date
+     */
+    static QDateTime nextDateRelativeChange(const QDateTime & lastUsed);
 };
 #endif // UIUTILS_H
@@ -33,6 +33,8 @@ Kirigami.SwipeListItem {
                                                     (SecurityType == PlasmaNM.Enums.StaticWep ||
                                                      SecurityType == PlasmaNM.Enums.WpaPsk ||
                                                      SecurityType == PlasmaNM.Enums.Wpa2Psk)
+    // Network restored from the scan cache, its access point is only known after a scan
+    property bool staleAccessPoint: Stale && !Uuid
 
     RowLayout {
         anchors.leftMargin: Kirigami.Units.largeSpacing * 5
@@ -96,7 +98,7 @@ Kirigami.SwipeListItem {
     actions: [
         Kirigami.Action {
             iconName: "network-connect"
-            visible: ConnectionState != PlasmaNM.Enums.Activated && Signal > 0
+            visible: ConnectionState != PlasmaNM.Enums.Activated && Signal > 0 && !staleAccessPoint
             onTriggered: changeState()
         },
         Kirigami.Action {
@@ -123,7 +125,7 @@ Kirigami.SwipeListItem {
     }
 
     function changeState() {
-        if (Signal === 0)
+        if (Signal === 0 || staleAccessPoint)
             return
         if (Uuid || !predictableWirelessPassword || connectionPasswordField.visible) {
             if (ConnectionState == PlasmaNM.Enums.Deactivated) {
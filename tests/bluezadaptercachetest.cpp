@@ -0,0 +1,303 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bluezadaptercache.h"
+
+#include <QDBusMetaType>
+#include <QDBusReply>
+#include <QDBusVirtualObject>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QSignalSpy>
+#include <QTest>
+#include <QThread>
+#include <QTimer>
+
+#define FAKE_BLUEZ_SERVICE "org.kde.plasmanm.FakeBluez"
+#define FAKE_BLUEZ_ADAPTERS 4
+// Delay of each reply, so the cost of a round trip shows in the latency
+#define FAKE_BLUEZ_LATENCY 5
+
+typedef QMap<QDBusObjectPath, NMVariantMapMap> ManagedObjects;
+
+/**
+ * Minimal bluez with a few adapters, answering and announcing changes of their power
+ */
+class FakeBluez : public QDBusVirtualObject
+{
+    Q_OBJECT
+public:
+    FakeBluez()
+    {
+        for (int i = 0; i < FAKE_BLUEZ_ADAPTERS; ++i) {
+            // Every other adapter is switched off
+            m_powered.insert(adapterPath(i), i % 2 == 0);
+        }
+    }
+
+    QString introspect(const QString &path) const override
+    {
+        Q_UNUSED(path);
+        return QString();
+    }
+
+    bool handleMessage(const QDBusMessage &message, const QDBusConnection &connection) override
+    {
+        QList<QDBusMessage> messages;
+        if (message.member() == QLatin1String("GetManagedObjects")) {
+            messages << message.createReply(QVariant::fromValue(managedObjects()));
+        } else if (message.member() == QLatin1String("Get")) {
+            QMutexLocker locker(&m_mutex);
+            messages << message.createReply(QVariant::fromValue(QDBusVariant(m_powered.value(message.path()))));
+        } else if (message.member() == QLatin1String("Set")) {
+            const bool powered = message.arguments().at(2).value<QDBusVariant>().variant().toBool();
+            {
+                QMutexLocker locker(&m_mutex);
+                m_powered.insert(message.path(), powered);
+            }
+            messages << message.createReply();
+            QDBusMessage changed = QDBusMessage::createSignal(message.path(), QStringLiteral("org.freedesktop.DBus.Properties"),
+                                                              QStringLiteral("PropertiesChanged"));
+            changed << QStringLiteral("org.bluez.Adapter1") << QVariantMap{{QStringLiteral("Powered"), powered}} << QStringList();
+            messages << changed;
+        } else {
+            return false;
+        }
+
+        {
+            QMutexLocker locker(&m_mutex);
+            m_calls[message.member()]++;
+        }
+
+        QTimer::singleShot(FAKE_BLUEZ_LATENCY, this, [connection, messages] () {
+            for (const QDBusMessage &message : messages) {
+                connection.send(message);
+            }
+        });
+        return true;
+    }
+
+    void addAdapter(const QDBusConnection &connection, const QString &path)
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_powered.insert(path, true);
+        }
+        QDBusMessage added = QDBusMessage::createSignal(QStringLiteral("/"), QStringLiteral("org.freedesktop.DBus.ObjectManager"),
+                                                        QStringLiteral("InterfacesAdded"));
+        NMVariantMapMap interfaces;
+        interfaces.insert(QStringLiteral("org.bluez.Adapter1"), {{QStringLiteral("Powered"), true}});
+        added << QVariant::fromValue(QDBusObjectPath(path)) << QVariant::fromValue(interfaces);
+        connection.send(added);
+    }
+
+    bool isPowered(const QString &path)
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_powered.value(path);
+    }
+
+    int calls(const QString &member)
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_calls.value(member);
+    }
+
+    void resetCalls()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_calls.clear();
+    }
+
+    static QString adapterPath(int index)
+    {
+        return QStringLiteral("/org/bluez/hci%1").arg(index);
+    }
+
+private:
+    ManagedObjects managedObjects()
+    {
+        QMutexLocker locker(&m_mutex);
+        ManagedObjects objects;
+        for (auto it = m_powered.constBegin(); it != m_powered.constEnd(); ++it) {
+            NMVariantMapMap adapter;
+            adapter.insert(QStringLiteral("org.bluez.Adapter1"), {{QStringLiteral("Powered"), it.value()}});
+            objects.insert(QDBusObjectPath(it.key()), adapter);
+        }
+        return objects;
+    }
+
+    QMutex m_mutex;
+    QMap<QString, bool> m_powered;
+    QHash<QString, int> m_calls;
+};
+
+class BluezAdapterCacheTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void loadTest();
+    void setPoweredTest();
+    void signalsTest();
+    void toggleLatencyBenchmark();
+    void chainedToggleLatencyBenchmark();
+
+private:
+    QThread m_serviceThread;
+    FakeBluez *m_service = nullptr;
+    QString m_serviceName;
+};
+
+void BluezAdapterCacheTest::initTestCase()
+{
+    if (!QDBusConnection::sessionBus().isConnected()) {
+        QSKIP("No session bus to run the fake bluez on");
+    }
+
+    qDBusRegisterMetaType<NMVariantMapMap>();
+    qDBusRegisterMetaType<ManagedObjects>();
+
+    m_service = new FakeBluez();
+    m_service->moveToThread(&m_serviceThread);
+    m_serviceThread.start();
+
+    QDBusConnection connection = QDBusConnection::connectToBus(QDBusConnection::SessionBus, QStringLiteral("fake-bluez"));
+    m_serviceName = QStringLiteral(FAKE_BLUEZ_SERVICE "%1").arg(QCoreApplication::applicationPid());
+    QVERIFY(connection.registerService(m_serviceName));
+    QVERIFY(connection.registerVirtualObject(QStringLiteral("/"), m_service, QDBusConnection::SubPath));
+}
+
+void BluezAdapterCacheTest::cleanupTestCase()
+{
+    QDBusConnection::disconnectFromBus(QStringLiteral("fake-bluez"));
+    m_serviceThread.quit();
+    m_serviceThread.wait();
+    delete m_service;
+}
+
+void BluezAdapterCacheTest::loadTest()
+{
+    m_service->resetCalls();
+
+    BluezAdapterCache cache(QDBusConnection::sessionBus(), m_serviceName);
+    QVERIFY(!cache.isLoaded());
+    QSignalSpy loaded(&cache, &BluezAdapterCache::loaded);
+    QVERIFY(loaded.wait());
+
+    QCOMPARE(cache.adapters().count(), FAKE_BLUEZ_ADAPTERS);
+    QVERIFY(cache.isPowered(FakeBluez::adapterPath(0)));
+    QVERIFY(!cache.isPowered(FakeBluez::adapterPath(1)));
+    QCOMPARE(m_service->calls(QStringLiteral("GetManagedObjects")), 1);
+    QCOMPARE(m_service->calls(QStringLiteral("Get")), 0);
+}
+
+void BluezAdapterCacheTest::setPoweredTest()
+{
+    BluezAdapterCache cache(QDBusConnection::sessionBus(), m_serviceName);
+    QSignalSpy loaded(&cache, &BluezAdapterCache::loaded);
+    QVERIFY(loaded.wait());
+    m_service->resetCalls();
+
+    QSignalSpy poweredSet(&cache, &BluezAdapterCache::poweredSet);
+    cache.setPowered(cache.adapters(), false);
+    QVERIFY(poweredSet.wait());
+    QCOMPARE(poweredSet.count(), 1);
+
+    QCOMPARE(m_service->calls(QStringLiteral("Set")), FAKE_BLUEZ_ADAPTERS);
+    QCOMPARE(m_service->calls(QStringLiteral("Get")), 0);
+    for (const QString &adapter : cache.adapters()) {
+        QVERIFY(!cache.isPowered(adapter));
+        QVERIFY(!m_service->isPowered(adapter));
+    }
+
+    cache.setPowered({FakeBluez::adapterPath(0), FakeBluez::adapterPath(2)}, true);
+    QVERIFY(poweredSet.wait());
+    QVERIFY(cache.isPowered(FakeBluez::adapterPath(0)));
+    QVERIFY(!cache.isPowered(FakeBluez::adapterPath(1)));
+    QVERIFY(cache.isPowered(FakeBluez::adapterPath(2)));
+}
+
+void BluezAdapterCacheTest::signalsTest()
+{
+    BluezAdapterCache cache(QDBusConnection::sessionBus(), m_serviceName);
+    QSignalSpy loaded(&cache, &BluezAdapterCache::loaded);
+    QVERIFY(loaded.wait());
+
+    // Changes made by others reach the cache too
+    BluezAdapterCache other(QDBusConnection::sessionBus(), m_serviceName);
+    QSignalSpy otherLoaded(&other, &BluezAdapterCache::loaded);
+    QVERIFY(otherLoaded.wait());
+    const bool powered = cache.isPowered(FakeBluez::adapterPath(3));
+    QSignalSpy poweredChanged(&cache, &BluezAdapterCache::poweredChanged);
+    other.setPowered({FakeBluez::adapterPath(3)}, !powered);
+    QTRY_COMPARE(poweredChanged.count(), 1);
+    QCOMPARE(poweredChanged.first().at(0).toString(), FakeBluez::adapterPath(3));
+    QCOMPARE(cache.isPowered(FakeBluez::adapterPath(3)), !powered);
+
+    QSignalSpy adaptersChanged(&cache, &BluezAdapterCache::adaptersChanged);
+    m_service->addAdapter(QDBusConnection(QStringLiteral("fake-bluez")), QStringLiteral("/org/bluez/hci9"));
+    QVERIFY(adaptersChanged.wait());
+    QVERIFY(cache.adapters().contains(QStringLiteral("/org/bluez/hci9")));
+    QVERIFY(cache.isPowered(QStringLiteral("/org/bluez/hci9")));
+}
+
+void BluezAdapterCacheTest::toggleLatencyBenchmark()
+{
+    BluezAdapterCache cache(QDBusConnection::sessionBus(), m_serviceName);
+    QSignalSpy loaded(&cache, &BluezAdapterCache::loaded);
+    QVERIFY(loaded.wait());
+
+    // From the request until every adapter is switched
+    bool powered = false;
+    QBENCHMARK {
+        QSignalSpy poweredSet(&cache, &BluezAdapterCache::poweredSet);
+        cache.setPowered(cache.adapters(), powered);
+        QVERIFY(poweredSet.wait());
+        powered = !powered;
+    }
+}
+
+void BluezAdapterCacheTest::chainedToggleLatencyBenchmark()
+{
+    // What airplane mode did before: list the adapters, then read and set each one in turn
+    QDBusConnection connection = QDBusConnection::sessionBus();
+    bool powered = false;
+    QBENCHMARK {
+        QDBusMessage getObjects = QDBusMessage::createMethodCall(m_serviceName, QStringLiteral("/"), QStringLiteral("org.freedesktop.DBus.ObjectManager"),
+                                                                 QStringLiteral("GetManagedObjects"));
+        const ManagedObjects objects = QDBusReply<ManagedObjects>(connection.call(getObjects)).value();
+        for (const QDBusObjectPath &path : objects.keys()) {
+            QDBusMessage get = QDBusMessage::createMethodCall(m_serviceName, path.path(), QStringLiteral("org.freedesktop.DBus.Properties"), QStringLiteral("Get"));
+            get << QStringLiteral("org.bluez.Adapter1") << QStringLiteral("Powered");
+            connection.call(get);
+            QDBusMessage set = QDBusMessage::createMethodCall(m_serviceName, path.path(), QStringLiteral("org.freedesktop.DBus.Properties"), QStringLiteral("Set"));
+            set << QStringLiteral("org.bluez.Adapter1") << QStringLiteral("Powered") << QVariant::fromValue(QDBusVariant(powered));
+            connection.call(set);
+        }
+        powered = !powered;
+    }
+}
+
+QTEST_GUILESS_MAIN(BluezAdapterCacheTest)
+
+#include "bluezadaptercachetest.moc"
@@ -0,0 +1,128 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ciscodecrypt.h"
+
+#include <QProcess>
+#include <QStandardPaths>
+#include <QTest>
+
+// Obfuscated like the Cisco VPN client does, see decryptTest_data()
+#define CISCO_DECRYPT_SECRET "000102030405060708090A0B0C0D0E0F1011121341EA0057AA543208F6808EAD84C5EE0824623B360B4995183D249B87"
+
+class CiscoDecryptTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void decryptTest_data();
+    void decryptTest();
+    void invalidTest_data();
+    void invalidTest();
+    void decryptBenchmark();
+    void processBenchmark();
+};
+
+void CiscoDecryptTest::decryptTest_data()
+{
+    QTest::addColumn<QString>("encrypted");
+    QTest::addColumn<QString>("password");
+
+    // Seed, SHA-1 of the ciphertext and ciphertext, encrypted with openssl des-ede3-cbc
+    QTest::newRow("one block") << QStringLiteral(CISCO_DECRYPT_SECRET)
+                               << QStringLiteral("secret");
+    QTest::newRow("full padding block") << QStringLiteral("E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3D664C9094ADE1D8A596085BF30879C06E0F4D6872637230489B8E18F121F7A0262291746")
+                                        << QStringLiteral("12345678");
+    QTest::newRow("utf-8") << QStringLiteral("0A044E012E6BE85C13D163649EC48CCCDDA80B42B7C3F1A77D3C9900F9C4347B6FECD78AE8E8D7C1EA3C97E26AC01DA54DD3CC6C1A0A533964F08A3B31BDA910F51AB860352956E8")
+                           << QString::fromUtf8("Group p\xc3\xa4ssword with spaces");
+    // The last byte of the seed overflows when deriving the key
+    QTest::newRow("empty") << QStringLiteral("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF7284FB0E78D210E0BB3F4EBD59AB1729B80CABB18CFB4609BFE893FE")
+                           << QString();
+    QTest::newRow("lowercase") << QStringLiteral(CISCO_DECRYPT_SECRET).toLower()
+                               << QStringLiteral("secret");
+    QTest::newRow("whitespace") << QStringLiteral(" " CISCO_DECRYPT_SECRET "\n")
+                                << QStringLiteral("secret");
+}
+
+void CiscoDecryptTest::decryptTest()
+{
+    QFETCH(QString, encrypted);
+    QFETCH(QString, password);
+
+    bool ok = false;
+    QCOMPARE(CiscoDecrypt::decrypt(encrypted, &ok), password);
+    QVERIFY(ok);
+}
+
+void CiscoDecryptTest::invalidTest_data()
+{
+    QTest::addColumn<QString>("encrypted");
+
+    const QString secret = QStringLiteral(CISCO_DECRYPT_SECRET);
+    QTest::newRow("empty") << QString();
+    QTest::newRow("not hex") << QString(secret).replace(60, 1, QLatin1Char('x'));
+    QTest::newRow("odd length") << secret.left(secret.size() - 1);
+    QTest::newRow("no ciphertext") << secret.left(80);
+    QTest::newRow("partial block") << secret.left(secret.size() - 2);
+    // Fails the SHA-1 of the ciphertext
+    QTest::newRow("corrupted") << QString(secret).replace(secret.size() - 1, 1, QLatin1Char('8'));
+    // Matching SHA-1, but the seed gives another key and garbage padding
+    QTest::newRow("wrong seed") << QString(secret).replace(0, 2, QStringLiteral("01"));
+}
+
+void CiscoDecryptTest::invalidTest()
+{
+    QFETCH(QString, encrypted);
+
+    bool ok = true;
+    QVERIFY(CiscoDecrypt::decrypt(encrypted, &ok).isEmpty());
+    QVERIFY(!ok);
+}
+
+void CiscoDecryptTest::decryptBenchmark()
+{
+    const QString encrypted = QStringLiteral(CISCO_DECRYPT_SECRET);
+    QBENCHMARK {
+        CiscoDecrypt::decrypt(encrypted);
+    }
+}
+
+void CiscoDecryptTest::processBenchmark()
+{
+    // What importing a .pcf file did before, for every obfuscated password
+    const QString ciscoDecryptBinary = QStandardPaths::findExecutable(QStringLiteral("cisco-decrypt"));
+    if (ciscoDecryptBinary.isEmpty()) {
+        QSKIP("cisco-decrypt is not installed");
+    }
+
+    QBENCHMARK {
+        QProcess process;
+        process.start(ciscoDecryptBinary, QStringList());
+        process.waitForStarted();
+        process.write(CISCO_DECRYPT_SECRET);
+        process.closeWriteChannel();
+        process.waitForFinished();
+        QCOMPARE(process.readAllStandardOutput().trimmed(), QByteArray("secret"));
+    }
+}
+
+QTEST_GUILESS_MAIN(CiscoDecryptTest)
+
+#include "ciscodecrypttest.moc"
@@ -0,0 +1,175 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "hotspotchannelscorer.h"
+
+#include <QTest>
+
+class HotspotChannelScorerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void emptyScanTest();
+    void overlapTest();
+    void signalWeightTest();
+    void crowdedBgTest();
+    void bandTest();
+    void bestChannel_data();
+    void bestChannel();
+};
+
+typedef QVector<QPair<uint, int> > Scan;
+Q_DECLARE_METATYPE(Scan)
+
+static uint bgFrequency(int channel)
+{
+    return 2407 + 5 * channel;
+}
+
+static uint aFrequency(int channel)
+{
+    return 5000 + 5 * channel;
+}
+
+void HotspotChannelScorerTest::emptyScanTest()
+{
+    HotspotChannelScorer scorer;
+
+    HotspotChannelScorer::Channel channel = scorer.bestChannel(false);
+    QCOMPARE(channel.band, NetworkManager::WirelessSetting::Bg);
+    QCOMPARE(channel.channel, 1);
+    QCOMPARE(channel.congestion, qreal(0));
+
+    // An empty 5 GHz channel doesn't beat an empty 2.4 GHz one
+    channel = scorer.bestChannel(true);
+    QCOMPARE(channel.band, NetworkManager::WirelessSetting::Bg);
+    QCOMPARE(channel.channel, 1);
+    QCOMPARE(scorer.rankedChannels(true).at(3).band, NetworkManager::WirelessSetting::A);
+}
+
+void HotspotChannelScorerTest::overlapTest()
+{
+    HotspotChannelScorer scorer;
+    scorer.addAccessPoint(bgFrequency(3), 100);
+
+    // Full weight on its own channel, less the further away, nothing 5 channels away
+    QCOMPARE(scorer.congestion(NetworkManager::WirelessSetting::Bg, 3), qreal(1));
+    QVERIFY(scorer.congestion(NetworkManager::WirelessSetting::Bg, 1) > scorer.congestion(NetworkManager::WirelessSetting::Bg, 6));
+    QVERIFY(scorer.congestion(NetworkManager::WirelessSetting::Bg, 6) > 0);
+    QCOMPARE(scorer.congestion(NetworkManager::WirelessSetting::Bg, 8), qreal(0));
+    QCOMPARE(scorer.congestion(NetworkManager::WirelessSetting::A, 36), qreal(0));
+
+    QCOMPARE(scorer.bestChannel(false).channel, 11);
+
+    scorer.clear();
+    QCOMPARE(scorer.congestion(NetworkManager::WirelessSetting::Bg, 3), qreal(0));
+}
+
+void HotspotChannelScorerTest::signalWeightTest()
+{
+    HotspotChannelScorer scorer;
+    // Many weak networks on 1 and a single strong one on 6
+    for (int i = 0; i < 3; ++i) {
+        scorer.addAccessPoint(bgFrequency(1), 10);
+    }
+    scorer.addAccessPoint(bgFrequency(6), 95);
+    scorer.addAccessPoint(bgFrequency(11), 90);
+
+    QVERIFY(scorer.congestion(NetworkManager::WirelessSetting::Bg, 1) < scorer.congestion(NetworkManager::WirelessSetting::Bg, 6));
+    QCOMPARE(scorer.bestChannel(false).channel, 1);
+}
+
+void HotspotChannelScorerTest::crowdedBgTest()
+{
+    HotspotChannelScorer scorer;
+    for (int channel = 1; channel <= 13; ++channel) {
+        scorer.addAccessPoint(bgFrequency(channel), 70);
+    }
+    scorer.addAccessPoint(aFrequency(36), 80);
+    scorer.addAccessPoint(aFrequency(40), 60);
+
+    const HotspotChannelScorer::Channel channel = scorer.bestChannel(true);
+    QCOMPARE(channel.band, NetworkManager::WirelessSetting::A);
+    QCOMPARE(channel.channel, 48);
+
+    // Without 5 GHz the edge of the band has the fewest neighbours
+    QCOMPARE(scorer.bestChannel(false).band, NetworkManager::WirelessSetting::Bg);
+    QCOMPARE(scorer.bestChannel(false).channel, 1);
+}
+
+void HotspotChannelScorerTest::bandTest()
+{
+    HotspotChannelScorer scorer;
+    // Outside of both bands
+    scorer.addAccessPoint(58320, 100);
+    scorer.addAccessPoint(0, 100);
+    scorer.addAccessPoint(2484, 100);
+
+    QCOMPARE(scorer.congestion(NetworkManager::WirelessSetting::Bg, 11), qreal(0));
+    QVERIFY(scorer.congestion(NetworkManager::WirelessSetting::Bg, 13) > 0);
+    QCOMPARE(scorer.rankedChannels(false).count(), 3);
+    QCOMPARE(scorer.rankedChannels(true).count(), 7);
+}
+
+void HotspotChannelScorerTest::bestChannel_data()
+{
+    QTest::addColumn<Scan>("accessPoints");
+    QTest::addColumn<bool>("use5GHz");
+    QTest::addColumn<int>("band");
+    QTest::addColumn<int>("channel");
+
+    QTest::newRow("quiet 11") << Scan{{bgFrequency(1), 80}, {bgFrequency(6), 80}} << false << int(NetworkManager::WirelessSetting::Bg) << 11;
+    QTest::newRow("quiet 6") << Scan{{bgFrequency(1), 80}, {bgFrequency(11), 80}} << false << int(NetworkManager::WirelessSetting::Bg) << 6;
+    // 6 overlaps both of them, 1 only the first
+    QTest::newRow("overlapping 3 and 9") << Scan{{bgFrequency(3), 80}, {bgFrequency(9), 80}, {bgFrequency(11), 20}}
+                                         << false << int(NetworkManager::WirelessSetting::Bg) << 1;
+    QTest::newRow("5 GHz busy") << Scan{{aFrequency(36), 100}, {aFrequency(40), 100}, {aFrequency(44), 100}, {aFrequency(48), 100},
+                                        {aFrequency(36), 100}, {aFrequency(40), 100}, {aFrequency(44), 100}, {aFrequency(48), 100}}
+                                << true << int(NetworkManager::WirelessSetting::Bg) << 1;
+    QTest::newRow("5 GHz quiet") << Scan{{aFrequency(36), 100}, {aFrequency(40), 100}}
+                                 << true << int(NetworkManager::WirelessSetting::Bg) << 1;
+    QTest::newRow("2.4 GHz weak") << Scan{{bgFrequency(1), 20}, {bgFrequency(6), 20}, {bgFrequency(11), 20}}
+                                  << true << int(NetworkManager::WirelessSetting::Bg) << 1;
+    QTest::newRow("2.4 GHz busy") << Scan{{bgFrequency(1), 80}, {bgFrequency(6), 80}, {bgFrequency(11), 80},
+                                          {aFrequency(36), 100}, {aFrequency(40), 100}}
+                                  << true << int(NetworkManager::WirelessSetting::A) << 48;
+}
+
+void HotspotChannelScorerTest::bestChannel()
+{
+    QFETCH(Scan, accessPoints);
+    QFETCH(bool, use5GHz);
+    QFETCH(int, band);
+    QFETCH(int, channel);
+
+    HotspotChannelScorer scorer;
+    for (const QPair<uint, int> &accessPoint : accessPoints) {
+        scorer.addAccessPoint(accessPoint.first, accessPoint.second);
+    }
+
+    const HotspotChannelScorer::Channel best = scorer.bestChannel(use5GHz);
+    QCOMPARE(int(best.band), band);
+    QCOMPARE(best.channel, channel);
+}
+
+QTEST_GUILESS_MAIN(HotspotChannelScorerTest)
+
+#include "hotspotchannelscorertest.moc"
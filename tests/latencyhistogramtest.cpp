@@ -0,0 +1,135 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "latencyhistogram.h"
+
+#include <QTest>
+#include <QtMath>
+
+class LatencyHistogramTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void emptyTest();
+    void exactTest();
+    void precisionTest_data();
+    void precisionTest();
+    void clampTest();
+    void resetTest();
+    void recordBenchmark();
+};
+
+void LatencyHistogramTest::emptyTest()
+{
+    LatencyHistogram histogram;
+    QCOMPARE(histogram.count(), quint64(0));
+    QCOMPARE(histogram.min(), qint64(0));
+    QCOMPARE(histogram.max(), qint64(0));
+    QCOMPARE(histogram.mean(), 0.0);
+    QCOMPARE(histogram.percentile(50), qint64(0));
+}
+
+void LatencyHistogramTest::exactTest()
+{
+    // Short latencies have a bucket each
+    LatencyHistogram histogram;
+    for (int i = 1; i <= 50; ++i) {
+        histogram.record(i);
+    }
+
+    QCOMPARE(histogram.count(), quint64(50));
+    QCOMPARE(histogram.min(), qint64(1));
+    QCOMPARE(histogram.max(), qint64(50));
+    QCOMPARE(histogram.mean(), 25.5);
+    QCOMPARE(histogram.percentile(0), qint64(1));
+    QCOMPARE(histogram.percentile(50), qint64(25));
+    QCOMPARE(histogram.percentile(90), qint64(45));
+    QCOMPARE(histogram.percentile(100), qint64(50));
+}
+
+void LatencyHistogramTest::precisionTest_data()
+{
+    QTest::addColumn<double>("percentile");
+
+    QTest::newRow("p50") << 50.0;
+    QTest::newRow("p90") << 90.0;
+    QTest::newRow("p99") << 99.0;
+    QTest::newRow("p99.9") << 99.9;
+}
+
+void LatencyHistogramTest::precisionTest()
+{
+    QFETCH(double, percentile);
+
+    const int count = 100000;
+    LatencyHistogram histogram;
+    for (int i = 1; i <= count; ++i) {
+        histogram.record(i);
+    }
+
+    // Never below the real value and at most one bucket, 1/32 of it, above
+    const qint64 exact = qCeil(percentile / 100 * count);
+    const qint64 value = histogram.percentile(percentile);
+    QVERIFY2(value >= exact, qPrintable(QString::number(value)));
+    QVERIFY2(value <= exact + exact / 32, qPrintable(QString::number(value)));
+}
+
+void LatencyHistogramTest::clampTest()
+{
+    LatencyHistogram histogram;
+    histogram.record(-5);
+    histogram.record(10 * 3600000);
+
+    QCOMPARE(histogram.count(), quint64(2));
+    QCOMPARE(histogram.min(), qint64(0));
+    QCOMPARE(histogram.max(), qint64(3600000));
+    QCOMPARE(histogram.percentile(100), qint64(3600000));
+}
+
+void LatencyHistogramTest::resetTest()
+{
+    LatencyHistogram histogram;
+    histogram.record(1200);
+    histogram.reset();
+
+    QCOMPARE(histogram.count(), quint64(0));
+    QCOMPARE(histogram.max(), qint64(0));
+    QCOMPARE(histogram.percentile(99), qint64(0));
+
+    histogram.record(7);
+    QCOMPARE(histogram.min(), qint64(7));
+    QCOMPARE(histogram.percentile(50), qint64(7));
+}
+
+void LatencyHistogramTest::recordBenchmark()
+{
+    LatencyHistogram histogram;
+    qint64 value = 0;
+    QBENCHMARK {
+        // Spread over all buckets
+        value = (value * 7 + 13) % 3600000;
+        histogram.record(value);
+    }
+}
+
+QTEST_GUILESS_MAIN(LatencyHistogramTest)
+
+#include "latencyhistogramtest.moc"
@@ -0,0 +1,280 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "networkmanagerloader.h"
+
+#include <QDBusMetaType>
+#include <QDBusObjectPath>
+#include <QDBusVirtualObject>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QTest>
+#include <QThread>
+#include <QTimer>
+
+#define FAKE_NM_SERVICE "org.kde.plasmanm.FakeNetworkManager"
+#define FAKE_NM_CONNECTIONS 300
+// Delay of each reply, so the cost of a round trip shows in the benchmarks
+#define FAKE_NM_LATENCY 1
+
+typedef QMap<QDBusObjectPath, NMVariantMapMap> ManagedObjects;
+
+/**
+ * Minimal NetworkManager with a device and some connections, counting the calls it gets
+ */
+class FakeNetworkManager : public QDBusVirtualObject
+{
+    Q_OBJECT
+public:
+    QString introspect(const QString &path) const override
+    {
+        Q_UNUSED(path);
+        return QString();
+    }
+
+    bool handleMessage(const QDBusMessage &message, const QDBusConnection &connection) override
+    {
+        QDBusMessage reply;
+        if (message.member() == QLatin1String("GetManagedObjects")) {
+            reply = message.createReply(QVariant::fromValue(managedObjects()));
+        } else if (message.member() == QLatin1String("GetSettings")) {
+            reply = message.createReply(QVariant::fromValue(settings(message.path())));
+        } else if (message.member() == QLatin1String("GetAll")) {
+            reply = message.createReply(QVariant::fromValue(QVariantMap()));
+        } else {
+            return false;
+        }
+
+        int latency;
+        {
+            QMutexLocker locker(&m_mutex);
+            m_calls[message.member()]++;
+            latency = m_latencies.value(message.member(), FAKE_NM_LATENCY);
+        }
+
+        QTimer::singleShot(latency, this, [connection, reply] () {
+            connection.send(reply);
+        });
+        return true;
+    }
+
+    int calls(const QString &member)
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_calls.value(member);
+    }
+
+    void resetCalls()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_calls.clear();
+    }
+
+    // Delay of the replies to @p member, the default latency when negative
+    void setLatency(const QString &member, int msecs)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (msecs < 0) {
+            m_latencies.remove(member);
+        } else {
+            m_latencies.insert(member, msecs);
+        }
+    }
+
+    static QString connectionPath(int index)
+    {
+        return QStringLiteral("/org/freedesktop/NetworkManager/Settings/%1").arg(index);
+    }
+
+private:
+    ManagedObjects managedObjects() const
+    {
+        ManagedObjects objects;
+
+        NMVariantMapMap device;
+        device.insert(QStringLiteral(NM_DBUS_INTERFACE_DEVICE), {{QStringLiteral("DeviceType"), uint(NetworkManager::Device::Wifi)},
+                                                                 {QStringLiteral("Real"), true}});
+        objects.insert(QDBusObjectPath(QStringLiteral("/org/freedesktop/NetworkManager/Devices/1")), device);
+
+        for (int i = 0; i < FAKE_NM_CONNECTIONS; ++i) {
+            NMVariantMapMap connection;
+            connection.insert(QStringLiteral(NM_DBUS_INTERFACE_SETTINGS_CONNECTION), {{QStringLiteral("Unsaved"), false}});
+            objects.insert(QDBusObjectPath(connectionPath(i)), connection);
+        }
+        return objects;
+    }
+
+    NMVariantMapMap settings(const QString &path) const
+    {
+        NMVariantMapMap settings;
+        settings.insert(QStringLiteral("connection"), {{QStringLiteral("id"), path.section(QLatin1Char('/'), -1)},
+                                                       {QStringLiteral("type"), QStringLiteral("802-3-ethernet")}});
+        return settings;
+    }
+
+    QMutex m_mutex;
+    QHash<QString, int> m_calls;
+    QHash<QString, int> m_latencies;
+};
+
+class NetworkManagerLoaderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void loadTest();
+    void missingServiceTest();
+    void timeoutTest_data();
+    void timeoutTest();
+    void loaderBenchmark();
+    void objectByObjectBenchmark();
+
+private:
+    QThread m_serviceThread;
+    FakeNetworkManager *m_service = nullptr;
+    QString m_serviceName;
+};
+
+void NetworkManagerLoaderTest::initTestCase()
+{
+    if (!QDBusConnection::sessionBus().isConnected()) {
+        QSKIP("No session bus to run the fake NetworkManager on");
+    }
+
+    qDBusRegisterMetaType<NMVariantMapMap>();
+    qDBusRegisterMetaType<ManagedObjects>();
+
+    // The loader blocks while waiting, the service answers from its own thread and connection
+    m_service = new FakeNetworkManager();
+    m_service->moveToThread(&m_serviceThread);
+    m_serviceThread.start();
+
+    QDBusConnection connection = QDBusConnection::connectToBus(QDBusConnection::SessionBus, QStringLiteral("fake-nm"));
+    m_serviceName = QStringLiteral(FAKE_NM_SERVICE "%1").arg(QCoreApplication::applicationPid());
+    QVERIFY(connection.registerService(m_serviceName));
+    QVERIFY(connection.registerVirtualObject(QStringLiteral("/org/freedesktop"), m_service, QDBusConnection::SubPath));
+}
+
+void NetworkManagerLoaderTest::cleanupTestCase()
+{
+    QDBusConnection::disconnectFromBus(QStringLiteral("fake-nm"));
+    m_serviceThread.quit();
+    m_serviceThread.wait();
+    delete m_service;
+}
+
+void NetworkManagerLoaderTest::loadTest()
+{
+    m_service->resetCalls();
+
+    NetworkManagerLoader loader(QDBusConnection::sessionBus(), m_serviceName);
+    QVERIFY(loader.load());
+    QVERIFY(loader.isLoaded());
+
+    // One call for all objects and one batch for all settings
+    QCOMPARE(loader.roundTrips(), 2);
+    QCOMPARE(m_service->calls(QStringLiteral("GetManagedObjects")), 1);
+    QCOMPARE(m_service->calls(QStringLiteral("GetSettings")), FAKE_NM_CONNECTIONS);
+
+    const QStringList devices = loader.objects(QStringLiteral(NM_DBUS_INTERFACE_DEVICE));
+    QCOMPARE(devices, QStringList{QStringLiteral("/org/freedesktop/NetworkManager/Devices/1")});
+    QCOMPARE(loader.properties(devices.first(), QStringLiteral(NM_DBUS_INTERFACE_DEVICE)).value(QStringLiteral("DeviceType")).toUInt(),
+             uint(NetworkManager::Device::Wifi));
+
+    QCOMPARE(loader.objects(QStringLiteral(NM_DBUS_INTERFACE_SETTINGS_CONNECTION)).count(), FAKE_NM_CONNECTIONS);
+    const NMVariantMapMap settings = loader.settings(FakeNetworkManager::connectionPath(7));
+    QCOMPARE(settings.value(QStringLiteral("connection")).value(QStringLiteral("id")).toString(), QStringLiteral("7"));
+    QVERIFY(loader.settings(QStringLiteral("/org/freedesktop/NetworkManager/Settings/none")).isEmpty());
+
+    loader.clear();
+    QVERIFY(!loader.isLoaded());
+    QVERIFY(loader.objects(QStringLiteral(NM_DBUS_INTERFACE_DEVICE)).isEmpty());
+}
+
+void NetworkManagerLoaderTest::missingServiceTest()
+{
+    NetworkManagerLoader loader(QDBusConnection::sessionBus(), QStringLiteral(FAKE_NM_SERVICE ".Missing"));
+    QVERIFY(!loader.load());
+    QVERIFY(!loader.isLoaded());
+    QCOMPARE(loader.roundTrips(), 1);
+}
+
+void NetworkManagerLoaderTest::timeoutTest_data()
+{
+    QTest::addColumn<QString>("member");
+    QTest::addColumn<int>("roundTrips");
+
+    QTest::newRow("objects") << QStringLiteral("GetManagedObjects") << 1;
+    QTest::newRow("settings") << QStringLiteral("GetSettings") << 2;
+}
+
+void NetworkManagerLoaderTest::timeoutTest()
+{
+    QFETCH(QString, member);
+    QFETCH(int, roundTrips);
+
+    m_service->setLatency(member, 2000);
+
+    NetworkManagerLoader loader(QDBusConnection::sessionBus(), m_serviceName);
+    loader.setTimeout(100);
+
+    // Gives up long before the replies arrive, without a partial snapshot
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(!loader.load());
+    QVERIFY(timer.elapsed() < 1000);
+    QVERIFY(!loader.isLoaded());
+    QCOMPARE(loader.roundTrips(), roundTrips);
+    QVERIFY(loader.objects(QStringLiteral(NM_DBUS_INTERFACE_SETTINGS_CONNECTION)).isEmpty());
+    QVERIFY(loader.settings(FakeNetworkManager::connectionPath(7)).isEmpty());
+
+    m_service->setLatency(member, -1);
+}
+
+void NetworkManagerLoaderTest::loaderBenchmark()
+{
+    NetworkManagerLoader loader(QDBusConnection::sessionBus(), m_serviceName);
+    QBENCHMARK {
+        loader.load();
+    }
+}
+
+void NetworkManagerLoaderTest::objectByObjectBenchmark()
+{
+    // What consumers did before: every object fetched on its own, waiting for each reply
+    QDBusConnection connection = QDBusConnection::sessionBus();
+    QBENCHMARK {
+        for (int i = 0; i < FAKE_NM_CONNECTIONS; ++i) {
+            QDBusMessage getAll = QDBusMessage::createMethodCall(m_serviceName, FakeNetworkManager::connectionPath(i),
+                                                                 QStringLiteral("org.freedesktop.DBus.Properties"), QStringLiteral("GetAll"));
+            getAll << QStringLiteral(NM_DBUS_INTERFACE_SETTINGS_CONNECTION);
+            connection.call(getAll);
+            QDBusMessage getSettings = QDBusMessage::createMethodCall(m_serviceName, FakeNetworkManager::connectionPath(i),
+                                                                      QStringLiteral(NM_DBUS_INTERFACE_SETTINGS_CONNECTION), QStringLiteral("GetSettings"));
+            connection.call(getSettings);
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(NetworkManagerLoaderTest)
+
+#include "networkmanagerloadertest.moc"
@@ -0,0 +1,256 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "models/networkmodelitem.h"
+
+#include <QTest>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#define NETWORK_ITEMS_BENCHMARK_SIZE 10000
+
+class NetworkModelItemTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void stringPoolTest();
+    void duplicateTest();
+    void changedRolesTest();
+    void statusTest();
+    void staleTest();
+    void memoryBenchmark();
+};
+
+static QString connectionPath(int index)
+{
+    return QStringLiteral("/org/freedesktop/NetworkManager/Settings/%1").arg(index);
+}
+
+static QString devicePath(int index)
+{
+    return QStringLiteral("/org/freedesktop/NetworkManager/Devices/%1").arg(index);
+}
+
+// Bytes in use on the heap, -1 when the allocator can't tell
+static qint64 heapUsage()
+{
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 33)
+    return mallinfo2().uordblks;
+#else
+    return mallinfo().uordblks;
+#endif
+#else
+    return -1;
+#endif
+}
+
+void NetworkModelItemTest::stringPoolTest()
+{
+    quint32 id;
+    QVERIFY(!NetworkModelItem::findStringId(connectionPath(1), &id));
+    QVERIFY(NetworkModelItem::findStringId(QString(), &id));
+    QCOMPARE(id, 0u);
+
+    NetworkModelItem *first = new NetworkModelItem();
+    NetworkModelItem *second = new NetworkModelItem();
+    first->setConnectionPath(connectionPath(1));
+    first->setDevicePath(devicePath(1));
+    second->setConnectionPath(connectionPath(2));
+    second->setDevicePath(devicePath(1));
+
+    QCOMPARE(first->connectionPath(), connectionPath(1));
+    QCOMPARE(first->devicePathId(), second->devicePathId());
+    QVERIFY(first->connectionPathId() != second->connectionPathId());
+    QVERIFY(NetworkModelItem::findStringId(connectionPath(1), &id));
+    QCOMPARE(id, first->connectionPathId());
+
+    // Strings are dropped with the last item holding them
+    second->setConnectionPath(QString());
+    QCOMPARE(second->connectionPathId(), 0u);
+    QVERIFY(!NetworkModelItem::findStringId(connectionPath(2), &id));
+    delete first;
+    QVERIFY(NetworkModelItem::findStringId(devicePath(1), &id));
+    delete second;
+    QVERIFY(!NetworkModelItem::findStringId(devicePath(1), &id));
+    QVERIFY(!NetworkModelItem::findStringId(connectionPath(1), &id));
+}
+
+void NetworkModelItemTest::duplicateTest()
+{
+    NetworkModelItem item;
+    item.setConnectionPath(connectionPath(1));
+    item.setDevicePath(devicePath(1));
+    item.setName(QStringLiteral("Home"));
+    item.setSsid(QStringLiteral("Home"));
+    item.setType(NetworkManager::ConnectionSettings::Wireless);
+    item.setSecurityType(NetworkManager::Wpa2Psk);
+    item.setSignal(60);
+
+    NetworkModelItem duplicate(&item);
+    QVERIFY(duplicate.duplicate());
+    QCOMPARE(duplicate.connectionPathId(), item.connectionPathId());
+    QCOMPARE(duplicate.ssidId(), item.ssidId());
+    QCOMPARE(duplicate.name(), item.name());
+    QCOMPARE(duplicate.type(), NetworkManager::ConnectionSettings::Wireless);
+    QCOMPARE(duplicate.securityType(), NetworkManager::Wpa2Psk);
+    // The duplicate is for another device
+    QVERIFY(duplicate.devicePath().isEmpty());
+    QCOMPARE(duplicate.signal(), 0);
+}
+
+void NetworkModelItemTest::changedRolesTest()
+{
+    NetworkModelItem item;
+    item.setName(QStringLiteral("Home"));
+    item.setSignal(50);
+    QVERIFY(item.hasChangedRole(NetworkModel::NameRole));
+    QVERIFY(item.hasChangedRole(NetworkModel::SignalRole));
+    QVERIFY(!item.hasChangedRole(NetworkModel::UuidRole));
+
+    const QVector<int> roles = item.changedRoles();
+    QVERIFY(roles.contains(NetworkModel::NameRole));
+    QVERIFY(roles.contains(NetworkModel::ItemUniqueNameRole));
+    QVERIFY(roles.contains(NetworkModel::SignalRole));
+    QVERIFY(!roles.contains(NetworkModel::UuidRole));
+
+    item.clearChangedRoles();
+    QVERIFY(item.changedRoles().isEmpty());
+
+    // Setting the same value doesn't change anything
+    item.setName(QStringLiteral("Home"));
+    item.setSignal(50);
+    QVERIFY(item.changedRoles().isEmpty());
+
+    item.setTxBytes(1);
+    QCOMPARE(item.changedRoles(), QVector<int>{NetworkModel::TxBytesRole});
+
+    // A removed connection turns a saved wireless network back into an access point
+    NetworkModelItem wireless;
+    wireless.setType(NetworkManager::ConnectionSettings::Wireless);
+    wireless.setDevicePath(devicePath(1));
+    wireless.setConnectionPath(connectionPath(1));
+    QCOMPARE(wireless.itemType(), NetworkModelItem::AvailableConnection);
+    wireless.clearChangedRoles();
+    wireless.setConnectionPath(QString());
+    QCOMPARE(wireless.itemType(), NetworkModelItem::AvailableAccessPoint);
+    QVERIFY(wireless.hasChangedRole(NetworkModel::ItemTypeRole));
+}
+
+void NetworkModelItemTest::statusTest()
+{
+    NetworkModelItem vpn;
+    vpn.setType(NetworkManager::ConnectionSettings::Vpn);
+    vpn.setNetworkManagerStatus(NetworkManager::Disconnected);
+    QCOMPARE(vpn.itemType(), NetworkModelItem::UnavailableConnection);
+
+    // The item type follows NetworkManager, and the change is reported with it
+    vpn.clearChangedRoles();
+    vpn.setNetworkManagerStatus(NetworkManager::Connected);
+    QCOMPARE(vpn.itemType(), NetworkModelItem::AvailableConnection);
+    QVERIFY(vpn.hasChangedRole(NetworkModel::ItemTypeRole));
+    QVERIFY(vpn.hasChangedRole(NetworkModel::ConnectionDetailsRole));
+
+    vpn.clearChangedRoles();
+    vpn.setNetworkManagerStatus(NetworkManager::ConnectedSiteOnly);
+    QVERIFY(vpn.changedRoles().isEmpty());
+
+    vpn.setNetworkManagerStatus(NetworkManager::Disconnecting);
+    QCOMPARE(vpn.itemType(), NetworkModelItem::UnavailableConnection);
+    QVERIFY(vpn.hasChangedRole(NetworkModel::ItemTypeRole));
+
+    // Other connections don't depend on it
+    NetworkModelItem wired;
+    wired.setType(NetworkManager::ConnectionSettings::Wired);
+    wired.setNetworkManagerStatus(NetworkManager::Disconnected);
+    wired.clearChangedRoles();
+    wired.setNetworkManagerStatus(NetworkManager::Connected);
+    QCOMPARE(wired.itemType(), NetworkModelItem::UnavailableConnection);
+    QVERIFY(!wired.hasChangedRole(NetworkModel::ItemTypeRole));
+}
+
+void NetworkModelItemTest::staleTest()
+{
+    NetworkModelItem item;
+    QVERIFY(!item.stale());
+
+    // Restored from the scan cache, without an access point to connect to
+    item.setStale(true);
+    item.setSsid(QStringLiteral("Home"));
+    item.setType(NetworkManager::ConnectionSettings::Wireless);
+    item.setDevicePath(devicePath(0));
+    QVERIFY(item.stale());
+    QVERIFY(item.hasChangedRole(NetworkModel::StaleRole));
+    QCOMPARE(item.itemType(), NetworkModelItem::AvailableAccessPoint);
+    QVERIFY(item.specificPath().isEmpty());
+
+    item.clearChangedRoles();
+    item.setStale(true);
+    QVERIFY(!item.hasChangedRole(NetworkModel::StaleRole));
+
+    // Confirmed by a scan
+    item.setStale(false);
+    item.setSpecificPath(QStringLiteral("/org/freedesktop/NetworkManager/AccessPoint/1"));
+    QVERIFY(item.hasChangedRole(NetworkModel::StaleRole));
+    QVERIFY(item.hasChangedRole(NetworkModel::SpecificPathRole));
+
+    // Duplicates aren't restored from the cache
+    item.setStale(true);
+    NetworkModelItem duplicate(&item);
+    QVERIFY(!duplicate.stale());
+}
+
+void NetworkModelItemTest::memoryBenchmark()
+{
+    // Many saved connections over a few devices sharing a set of SSIDs
+    QList<NetworkModelItem*> items;
+    items.reserve(NETWORK_ITEMS_BENCHMARK_SIZE);
+
+    const qint64 before = heapUsage();
+    for (int i = 0; i < NETWORK_ITEMS_BENCHMARK_SIZE; ++i) {
+        NetworkModelItem *item = new NetworkModelItem();
+        item->setConnectionPath(connectionPath(i / 4));
+        item->setDevicePath(devicePath(i % 4));
+        item->setDeviceName(QStringLiteral("wlp%1s0").arg(i % 4));
+        item->setName(QStringLiteral("Network %1").arg(i / 4));
+        item->setSsid(QStringLiteral("Network %1").arg(i % 200));
+        item->setSpecificPath(QStringLiteral("/org/freedesktop/NetworkManager/AccessPoint/%1").arg(i % 500));
+        item->setType(NetworkManager::ConnectionSettings::Wireless);
+        item->setUuid(QStringLiteral("%1-0000-0000-0000-000000000000").arg(i / 4, 8, 10, QLatin1Char('0')));
+        item->setSignal(i % 100);
+        item->clearChangedRoles();
+        items << item;
+    }
+    const qint64 after = heapUsage();
+
+    if (before >= 0) {
+        qDebug() << "Bytes per item:" << (after - before) / NETWORK_ITEMS_BENCHMARK_SIZE;
+        QTest::setBenchmarkResult(after - before, QTest::BytesAllocated);
+    }
+
+    qDeleteAll(items);
+}
+
+QTEST_GUILESS_MAIN(NetworkModelItemTest)
+
+#include "networkmodelitemtest.moc"
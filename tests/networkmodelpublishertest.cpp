@@ -0,0 +1,248 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "models/appletproxymodel.h"
+#include "models/networkmodel.h"
+#include "models/networkmodelitem.h"
+#include "models/networkmodelpublisher.h"
+
+#include <QSignalSpy>
+#include <QStandardItemModel>
+#include <QTest>
+
+class NetworkModelPublisherTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void snapshotTest();
+    void deltaTest();
+    void missedDeltaTest();
+    void resetTest();
+    void partitionsTest();
+    void statusTest();
+    void filterBenchmark();
+
+private:
+    QStandardItem *createItem(const QString &name, NetworkModelItem::ItemType itemType) const;
+    void compareModels() const;
+
+    QStandardItemModel *m_source = nullptr;
+    NetworkModelPublisher *m_publisher = nullptr;
+    NetworkModel *m_replica = nullptr;
+    QList<QByteArray> m_deltas;
+};
+
+QStandardItem *NetworkModelPublisherTest::createItem(const QString &name, NetworkModelItem::ItemType itemType) const
+{
+    QStandardItem *item = new QStandardItem();
+    item->setData(name, NetworkModel::NameRole);
+    item->setData(name, NetworkModel::ItemUniqueNameRole);
+    item->setData(itemType, NetworkModel::ItemTypeRole);
+    item->setData(QStringLiteral("/org/freedesktop/NetworkManager/Settings/%1").arg(name), NetworkModel::ConnectionPathRole);
+    item->setData(false, NetworkModel::SlaveRole);
+    item->setData(NetworkManager::ConnectionSettings::Wired, NetworkModel::TypeRole);
+    item->setData(42, NetworkModel::SignalRole);
+    return item;
+}
+
+void NetworkModelPublisherTest::compareModels() const
+{
+    QCOMPARE(m_replica->rowCount(QModelIndex()), m_source->rowCount());
+    for (int row = 0; row < m_source->rowCount(); ++row) {
+        for (int role = NetworkModel::ConnectionDetailsRole; role <= NetworkModel::TxBytesRole; ++role) {
+            QCOMPARE(m_replica->data(m_replica->index(row), role), m_source->data(m_source->index(row, 0), role));
+        }
+    }
+}
+
+void NetworkModelPublisherTest::init()
+{
+    m_source = new QStandardItemModel(this);
+    m_source->appendRow(createItem(QStringLiteral("first"), NetworkModelItem::AvailableConnection));
+    m_source->appendRow(createItem(QStringLiteral("second"), NetworkModelItem::UnavailableConnection));
+    m_source->appendRow(createItem(QStringLiteral("third"), NetworkModelItem::AvailableConnection));
+
+    m_publisher = new NetworkModelPublisher(m_source, this);
+    connect(m_publisher, &NetworkModelPublisher::deltaReady, this, [this] (const QByteArray &delta) {
+        m_deltas << delta;
+    });
+    m_replica = new NetworkModel(NetworkModel::ReplicaSource, this);
+}
+
+void NetworkModelPublisherTest::cleanup()
+{
+    delete m_replica;
+    delete m_publisher;
+    delete m_source;
+    m_deltas.clear();
+}
+
+void NetworkModelPublisherTest::snapshotTest()
+{
+    QVERIFY(m_replica->applySnapshot(m_publisher->snapshot()));
+    compareModels();
+    QVERIFY(m_deltas.isEmpty());
+
+    QVERIFY(!m_replica->applySnapshot(QByteArray("garbage")));
+    compareModels();
+}
+
+void NetworkModelPublisherTest::deltaTest()
+{
+    QVERIFY(m_replica->applySnapshot(m_publisher->snapshot()));
+
+    m_source->insertRow(1, createItem(QStringLiteral("inserted"), NetworkModelItem::AvailableAccessPoint));
+    m_source->item(0)->setData(80, NetworkModel::SignalRole);
+    m_source->removeRow(2);
+    m_source->item(2)->setData(QStringLiteral("renamed"), NetworkModel::NameRole);
+    // Roles which aren't published don't produce any changes
+    m_source->item(2)->setData(QStringLiteral("ignored"), Qt::DisplayRole);
+
+    // Everything is published together
+    QVERIFY(m_deltas.isEmpty());
+    QTRY_COMPARE(m_deltas.count(), 1);
+
+    QSignalSpy rowsInserted(m_replica, &NetworkModel::rowsInserted);
+    QSignalSpy rowsRemoved(m_replica, &NetworkModel::rowsRemoved);
+    QSignalSpy dataChanged(m_replica, &NetworkModel::dataChanged);
+    QVERIFY(m_replica->applyDelta(m_deltas.first()));
+    QCOMPARE(rowsInserted.count(), 1);
+    QCOMPARE(rowsRemoved.count(), 1);
+    QCOMPARE(dataChanged.count(), 2);
+    QCOMPARE(dataChanged.first().at(2).value<QVector<int> >(), QVector<int>() << NetworkModel::SignalRole);
+    compareModels();
+
+    // Applying it again doesn't change anything
+    QVERIFY(m_replica->applyDelta(m_deltas.first()));
+    compareModels();
+}
+
+void NetworkModelPublisherTest::missedDeltaTest()
+{
+    QVERIFY(m_replica->applySnapshot(m_publisher->snapshot()));
+
+    m_source->removeRow(0);
+    m_publisher->flush();
+    m_source->removeRow(0);
+    m_publisher->flush();
+    QCOMPARE(m_deltas.count(), 2);
+
+    QVERIFY(!m_replica->applyDelta(m_deltas.at(1)));
+    QCOMPARE(m_replica->rowCount(QModelIndex()), 3);
+
+    // A new snapshot contains all deltas so far
+    QVERIFY(m_replica->applySnapshot(m_publisher->snapshot()));
+    QVERIFY(m_replica->applyDelta(m_deltas.at(0)));
+    QVERIFY(m_replica->applyDelta(m_deltas.at(1)));
+    compareModels();
+}
+
+void NetworkModelPublisherTest::resetTest()
+{
+    QVERIFY(m_replica->applySnapshot(m_publisher->snapshot()));
+
+    m_source->item(0)->setData(10, NetworkModel::SignalRole);
+    m_source->clear();
+    m_source->appendRow(createItem(QStringLiteral("new"), NetworkModelItem::AvailableConnection));
+    m_publisher->flush();
+    QCOMPARE(m_deltas.count(), 1);
+
+    QSignalSpy modelReset(m_replica, &NetworkModel::modelReset);
+    QVERIFY(m_replica->applyDelta(m_deltas.first()));
+    QCOMPARE(modelReset.count(), 1);
+    compareModels();
+}
+
+void NetworkModelPublisherTest::partitionsTest()
+{
+    QStandardItem *accessPoint = createItem(QStringLiteral("wireless"), NetworkModelItem::AvailableAccessPoint);
+    accessPoint->setData(NetworkManager::ConnectionSettings::Wireless, NetworkModel::TypeRole);
+    m_source->appendRow(accessPoint);
+    QVERIFY(m_replica->applySnapshot(m_publisher->snapshot()));
+
+    QCOMPARE(m_replica->partitions(0), NetworkModel::Partitions(NetworkModel::AvailablePartition));
+    QCOMPARE(m_replica->partitions(1), NetworkModel::Partitions(NetworkModel::UnavailablePartition));
+    QCOMPARE(m_replica->partitions(3), NetworkModel::AvailablePartition | NetworkModel::AccessPointPartition | NetworkModel::WirelessPartition);
+
+    m_source->item(1)->setData(NetworkModelItem::AvailableConnection, NetworkModel::ItemTypeRole);
+    m_source->item(1)->setData(true, NetworkModel::SlaveRole);
+    m_publisher->flush();
+    QVERIFY(m_replica->applyDelta(m_deltas.first()));
+    QCOMPARE(m_replica->partitions(1), NetworkModel::AvailablePartition | NetworkModel::SlavePartition);
+}
+
+void NetworkModelPublisherTest::statusTest()
+{
+    QStandardItem *vpn = createItem(QStringLiteral("vpn"), NetworkModelItem::UnavailableConnection);
+    vpn->setData(NetworkManager::ConnectionSettings::Vpn, NetworkModel::TypeRole);
+    m_source->appendRow(vpn);
+    QVERIFY(m_replica->applySnapshot(m_publisher->snapshot()));
+
+    AppletProxyModel appletModel;
+    appletModel.setSourceModel(m_replica);
+    QCOMPARE(m_replica->partitions(3), NetworkModel::Partitions(NetworkModel::UnavailablePartition));
+    QCOMPARE(appletModel.rowCount(), 2);
+
+    // What the network model reports for VPN connections once NetworkManager is connected
+    vpn->setData(NetworkModelItem::AvailableConnection, NetworkModel::ItemTypeRole);
+    vpn->setData(QStringList{QStringLiteral("details")}, NetworkModel::ConnectionDetailsRole);
+    m_publisher->flush();
+    QVERIFY(m_replica->applyDelta(m_deltas.first()));
+
+    QCOMPARE(m_replica->partitions(3), NetworkModel::Partitions(NetworkModel::AvailablePartition));
+    QCOMPARE(appletModel.rowCount(), 3);
+}
+
+void NetworkModelPublisherTest::filterBenchmark()
+{
+    // Mostly saved profiles which aren't available, like on a laptop that has been around
+    m_source->clear();
+    for (int i = 0; i < 1200; ++i) {
+        const QString name = QStringLiteral("profile %1").arg(i);
+        m_source->appendRow(createItem(name, i % 6 ? NetworkModelItem::UnavailableConnection : NetworkModelItem::AvailableConnection));
+    }
+    QVERIFY(m_replica->applySnapshot(m_publisher->snapshot()));
+    QCOMPARE(m_replica->rowCount(QModelIndex()), 1200);
+
+    AppletProxyModel appletModel;
+    appletModel.setSourceModel(m_replica);
+    QCOMPARE(appletModel.rowCount(), 200);
+
+    // Typing a search term into the applet, one keystroke at a time
+    const QString search = QStringLiteral("profile 11");
+    QBENCHMARK {
+        for (int length = 1; length <= search.size(); ++length) {
+            appletModel.setFilterRegExp(search.left(length));
+        }
+        appletModel.setFilterRegExp(QString());
+    }
+
+    appletModel.setFilterRegExp(search);
+    // profile 114 and profile 1104 to 1194 in steps of six
+    QCOMPARE(appletModel.rowCount(), 17);
+}
+
+QTEST_GUILESS_MAIN(NetworkModelPublisherTest)
+
+#include "networkmodelpublishertest.moc"
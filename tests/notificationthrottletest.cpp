@@ -0,0 +1,160 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "notificationthrottle.h"
+
+#include <QTest>
+
+// Stands in for the devices and connections of NetworkManager, changing states on demand
+class FakeEventSource : public QObject
+{
+    Q_OBJECT
+public:
+    void flap(const QString &source, int count)
+    {
+        for (int i = 0; i < count; ++i) {
+            Q_EMIT stateChanged(source, i % 2 ? QStringLiteral("ConnectionDeactivated") : QStringLiteral("ConnectionActivated"), i);
+        }
+    }
+
+Q_SIGNALS:
+    void stateChanged(const QString &source, const QString &eventId, int index);
+};
+
+class NotificationThrottleTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void burstTest();
+    void aggregationTest();
+    void sourcesTest();
+    void discardTest();
+    void windowTest();
+
+private:
+    struct Sent {
+        QString source;
+        QString eventId;
+        QString text;
+        int collapsed;
+    };
+
+    FakeEventSource *m_events = nullptr;
+    NotificationThrottle *m_throttle = nullptr;
+    QVector<Sent> m_sent;
+};
+
+void NotificationThrottleTest::init()
+{
+    m_events = new FakeEventSource();
+    m_throttle = new NotificationThrottle();
+    m_throttle->setBurstLimit(2);
+    m_throttle->setWindow(200);
+
+    connect(m_events, &FakeEventSource::stateChanged, m_throttle, [this] (const QString &source, const QString &eventId, int index) {
+        m_throttle->post(source, {eventId, source, QString::number(index), QString()});
+    });
+    connect(m_throttle, &NotificationThrottle::notify, this, [this] (const QString &source, const NotificationThrottle::Event &event, int collapsed) {
+        m_sent << Sent{source, event.eventId, event.text, collapsed};
+    });
+}
+
+void NotificationThrottleTest::cleanup()
+{
+    delete m_throttle;
+    delete m_events;
+    m_sent.clear();
+}
+
+void NotificationThrottleTest::burstTest()
+{
+    m_events->flap(QStringLiteral("eth0"), 2);
+
+    QCOMPARE(m_sent.count(), 2);
+    QCOMPARE(m_sent.at(0).text, QStringLiteral("0"));
+    QCOMPARE(m_sent.at(1).text, QStringLiteral("1"));
+    QCOMPARE(m_sent.at(1).collapsed, 0);
+    QCOMPARE(m_throttle->sentCount(), quint64(2));
+    QCOMPARE(m_throttle->suppressedCount(), quint64(0));
+}
+
+void NotificationThrottleTest::aggregationTest()
+{
+    m_events->flap(QStringLiteral("eth0"), 20);
+
+    QCOMPARE(m_sent.count(), 2);
+    QCOMPARE(m_throttle->postedCount(), quint64(20));
+    QCOMPARE(m_throttle->suppressedCount(), quint64(18));
+
+    // The burst ends in one notification with the last state
+    QTRY_COMPARE(m_sent.count(), 3);
+    QCOMPARE(m_sent.at(2).source, QStringLiteral("eth0"));
+    QCOMPARE(m_sent.at(2).text, QStringLiteral("19"));
+    QCOMPARE(m_sent.at(2).eventId, QStringLiteral("ConnectionDeactivated"));
+    QCOMPARE(m_sent.at(2).collapsed, 17);
+    QCOMPARE(m_throttle->aggregatedCount(), quint64(1));
+
+    QTest::qWait(2 * m_throttle->window());
+    QCOMPARE(m_sent.count(), 3);
+}
+
+void NotificationThrottleTest::sourcesTest()
+{
+    m_events->flap(QStringLiteral("eth0"), 5);
+    m_events->flap(QStringLiteral("wlan0"), 1);
+
+    // Other sources aren't held back
+    QCOMPARE(m_sent.count(), 3);
+    QCOMPARE(m_sent.at(2).source, QStringLiteral("wlan0"));
+
+    QTRY_COMPARE(m_sent.count(), 4);
+    QCOMPARE(m_sent.at(3).source, QStringLiteral("eth0"));
+    QCOMPARE(m_sent.at(3).collapsed, 2);
+}
+
+void NotificationThrottleTest::discardTest()
+{
+    m_events->flap(QStringLiteral("eth0"), 4);
+    QCOMPARE(m_sent.count(), 2);
+
+    m_throttle->discard(QStringLiteral("eth0"));
+    QTest::qWait(2 * m_throttle->window());
+    QCOMPARE(m_sent.count(), 2);
+    QCOMPARE(m_throttle->aggregatedCount(), quint64(0));
+}
+
+void NotificationThrottleTest::windowTest()
+{
+    m_events->flap(QStringLiteral("eth0"), 2);
+    QTest::qWait(m_throttle->window() + 50);
+
+    // Events outside of the window don't count
+    m_events->flap(QStringLiteral("eth0"), 2);
+    QCOMPARE(m_sent.count(), 4);
+    QCOMPARE(m_throttle->suppressedCount(), quint64(0));
+}
+
+QTEST_GUILESS_MAIN(NotificationThrottleTest)
+
+#include "notificationthrottletest.moc"
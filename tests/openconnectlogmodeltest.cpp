@@ -0,0 +1,174 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "openconnectlogmodel.h"
+
+#include <QAbstractItemModelTester>
+#include <QSignalSpy>
+#include <QTest>
+
+class OpenconnectLogModelTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void appendTest();
+    void capacityTest();
+    void levelTest();
+    void lastMessageTest();
+    void modelTest();
+    void reconnectLoopBenchmark();
+};
+
+static QStringList messages(const OpenconnectLogModel &model)
+{
+    QStringList result;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        result << model.index(row).data().toString();
+    }
+    return result;
+}
+
+void OpenconnectLogModelTest::appendTest()
+{
+    OpenconnectLogModel model(10);
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+
+    model.append(QStringLiteral("Connecting"), OpenconnectLogModel::Info);
+    model.append({{QStringLiteral("GET /"), OpenconnectLogModel::Debug},
+                  {QStringLiteral("Login failed"), OpenconnectLogModel::Error},
+                  {QStringLiteral("TLS record"), OpenconnectLogModel::Trace}});
+
+    // Trace messages are hidden at the default level
+    QCOMPARE(messages(model), QStringList({QStringLiteral("Connecting"), QStringLiteral("GET /"), QStringLiteral("Login failed")}));
+    QCOMPARE(model.index(2).data(OpenconnectLogModel::LevelRole).toInt(), int(OpenconnectLogModel::Error));
+
+    // One signal per batch
+    QCOMPARE(inserted.count(), 2);
+    QCOMPARE(inserted.at(1).at(1).toInt(), 1);
+    QCOMPARE(inserted.at(1).at(2).toInt(), 2);
+
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+}
+
+void OpenconnectLogModelTest::capacityTest()
+{
+    OpenconnectLogModel model(3);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+
+    for (int i = 0; i < 5; ++i) {
+        model.append(QString::number(i), OpenconnectLogModel::Info);
+    }
+    QCOMPARE(messages(model), QStringList({QStringLiteral("2"), QStringLiteral("3"), QStringLiteral("4")}));
+    QCOMPARE(removed.count(), 2);
+
+    // A batch larger than the capacity keeps only its last messages
+    QVector<OpenconnectLogModel::Entry> entries;
+    for (int i = 5; i < 12; ++i) {
+        entries.append({QString::number(i), OpenconnectLogModel::Info});
+    }
+    model.append(entries);
+    QCOMPARE(messages(model), QStringList({QStringLiteral("9"), QStringLiteral("10"), QStringLiteral("11")}));
+}
+
+void OpenconnectLogModelTest::levelTest()
+{
+    OpenconnectLogModel model(4);
+    model.append({{QStringLiteral("trace 1"), OpenconnectLogModel::Trace},
+                  {QStringLiteral("error 1"), OpenconnectLogModel::Error},
+                  {QStringLiteral("info 1"), OpenconnectLogModel::Info},
+                  {QStringLiteral("trace 2"), OpenconnectLogModel::Trace}});
+
+    model.setMaximumLevel(OpenconnectLogModel::Error);
+    QCOMPARE(messages(model), QStringList({QStringLiteral("error 1")}));
+    model.setMaximumLevel(OpenconnectLogModel::Trace);
+    QCOMPARE(messages(model).count(), 4);
+
+    // Dropping hidden messages doesn't touch the visible rows
+    model.setMaximumLevel(OpenconnectLogModel::Info);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    model.append(QStringLiteral("info 2"), OpenconnectLogModel::Info);
+    QCOMPARE(removed.count(), 0);
+    QCOMPARE(messages(model), QStringList({QStringLiteral("error 1"), QStringLiteral("info 1"), QStringLiteral("info 2")}));
+
+    model.append(QStringLiteral("debug 1"), OpenconnectLogModel::Debug);
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(messages(model), QStringList({QStringLiteral("info 1"), QStringLiteral("info 2")}));
+
+    model.setMaximumLevel(OpenconnectLogModel::Trace);
+    QCOMPARE(messages(model), QStringList({QStringLiteral("info 1"), QStringLiteral("trace 2"), QStringLiteral("info 2"), QStringLiteral("debug 1")}));
+}
+
+void OpenconnectLogModelTest::lastMessageTest()
+{
+    OpenconnectLogModel model(3);
+    QCOMPARE(model.lastMessage(OpenconnectLogModel::Error), QString());
+
+    model.append({{QStringLiteral("error 1"), OpenconnectLogModel::Error},
+                  {QStringLiteral("info 1"), OpenconnectLogModel::Info},
+                  {QStringLiteral("debug 1"), OpenconnectLogModel::Debug}});
+    QCOMPARE(model.lastMessage(OpenconnectLogModel::Error), QStringLiteral("error 1"));
+    QCOMPARE(model.lastMessage(OpenconnectLogModel::Info), QStringLiteral("info 1"));
+    QCOMPARE(model.lastMessage(OpenconnectLogModel::Trace), QStringLiteral("debug 1"));
+
+    model.append(QStringLiteral("trace 1"), OpenconnectLogModel::Trace);
+    QCOMPARE(model.lastMessage(OpenconnectLogModel::Error), QString());
+}
+
+void OpenconnectLogModelTest::modelTest()
+{
+    OpenconnectLogModel model(50);
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+
+    for (int i = 0; i < 500; ++i) {
+        if (i % 97 == 0) {
+            model.setMaximumLevel(i % 4);
+        }
+        QVector<OpenconnectLogModel::Entry> entries;
+        for (int j = 0; j < i % 7; ++j) {
+            entries.append({QString::number(i * 10 + j), (i + j) % 4});
+        }
+        model.append(entries);
+        QVERIFY(model.rowCount() <= model.capacity());
+    }
+}
+
+void OpenconnectLogModelTest::reconnectLoopBenchmark()
+{
+    // Hours of a reconnect loop logged at the trace level, while the level is switched back and forth
+    OpenconnectLogModel model;
+    QVector<OpenconnectLogModel::Entry> entries;
+    for (int i = 0; i < 200; ++i) {
+        entries.append({QStringLiteral("POST https://vpn.example.com/ attempt %1").arg(i), i % 4});
+    }
+
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i) {
+            model.append(entries);
+            model.setMaximumLevel(i % 4);
+        }
+    }
+    QVERIFY(model.rowCount() <= model.capacity());
+}
+
+QTEST_GUILESS_MAIN(OpenconnectLogModelTest)
+
+#include "openconnectlogmodeltest.moc"
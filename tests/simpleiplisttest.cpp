@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "simpleiplistvalidator.h"
 #include <QTest>
+#include <QStringList>
 
 class SimpleipListTest : public QObject
 {
@@ -35,6 +36,11 @@ private slots:
     void cidrTest_data();
     void portTest();
     void portTest_data();
+    void fuzzTest();
+    void fuzzTest_data();
+    void benchmark();
+    void incrementalTest();
+    void typingBenchmark();
 
 private:
     SimpleIpListValidator m_vb;
@@ -131,6 +137,101 @@ void SimpleipListTest::portTest()
     QCOMPARE(m_vp.validate(address, pos), result);
 }
 
+void SimpleipListTest::fuzzTest_data()
+{
+    QTest::addColumn<int>("style");
+    QTest::addColumn<int>("type");
+    QTest::addColumn<QString>("address");
+    QTest::addColumn<QValidator::State>("result");
+
+    // Checked against the former validator based on the address validators
+    QTest::newRow("cidr both: 10.0.0.0/8, ::/0") << int(SimpleIpListValidator::WithCidr) << int(SimpleIpListValidator::Both) << "10.0.0.0/8, ::/0" << QValidator::Acceptable;
+    QTest::newRow("cidr both: 10.0.0.0/8,,::/0") << int(SimpleIpListValidator::WithCidr) << int(SimpleIpListValidator::Both) << "10.0.0.0/8,,::/0" << QValidator::Invalid;
+    QTest::newRow("cidr both: 10.0.0.0/8, ::/0,") << int(SimpleIpListValidator::WithCidr) << int(SimpleIpListValidator::Both) << "10.0.0.0/8, ::/0," << QValidator::Intermediate;
+    QTest::newRow("cidr ipv4: 10.0.0.0/8, ::/0") << int(SimpleIpListValidator::WithCidr) << int(SimpleIpListValidator::Ipv4) << "10.0.0.0/8, ::/0" << QValidator::Invalid;
+    QTest::newRow("cidr ipv6: 10.0.0.0/8, ::/0") << int(SimpleIpListValidator::WithCidr) << int(SimpleIpListValidator::Ipv6) << "10.0.0.0/8, ::/0" << QValidator::Invalid;
+    QTest::newRow("cidr both: 10.0.0.0/8, fe80::") << int(SimpleIpListValidator::WithCidr) << int(SimpleIpListValidator::Both) << "10.0.0.0/8, fe80::" << QValidator::Intermediate;
+    QTest::newRow("cidr both: 10.0.0.0, fe80::/64") << int(SimpleIpListValidator::WithCidr) << int(SimpleIpListValidator::Both) << "10.0.0.0, fe80::/64" << QValidator::Invalid;
+    QTest::newRow("cidr both:  010.0.0.0/8 , fe80::/64 ") << int(SimpleIpListValidator::WithCidr) << int(SimpleIpListValidator::Both) << " 010.0.0.0/8 , fe80::/64 " << QValidator::Acceptable;
+    QTest::newRow("base both: 1.2.3.4, 1.2.3") << int(SimpleIpListValidator::Base) << int(SimpleIpListValidator::Both) << "1.2.3.4, 1.2.3" << QValidator::Intermediate;
+    QTest::newRow("base both: 1.2.3, 1.2.3.4") << int(SimpleIpListValidator::Base) << int(SimpleIpListValidator::Both) << "1.2.3, 1.2.3.4" << QValidator::Invalid;
+    QTest::newRow("base ipv6: ::1,\t::2") << int(SimpleIpListValidator::Base) << int(SimpleIpListValidator::Ipv6) << "::1,\t::2" << QValidator::Acceptable;
+    QTest::newRow("port both: 1.2.3.4:80, [::1]:80") << int(SimpleIpListValidator::WithPort) << int(SimpleIpListValidator::Both) << "1.2.3.4:80, [::1]:80" << QValidator::Acceptable;
+    QTest::newRow("port both: 1.2.3.4:80, [::1]:") << int(SimpleIpListValidator::WithPort) << int(SimpleIpListValidator::Both) << "1.2.3.4:80, [::1]:" << QValidator::Intermediate;
+    QTest::newRow("port both: [::1]:80,1.2.3.4:65536") << int(SimpleIpListValidator::WithPort) << int(SimpleIpListValidator::Both) << "[::1]:80,1.2.3.4:65536" << QValidator::Invalid;
+}
+
+void SimpleipListTest::fuzzTest()
+{
+    int pos;
+
+    QFETCH(int, style);
+    QFETCH(int, type);
+    QFETCH(QString, address);
+    QFETCH(QValidator::State, result);
+
+    SimpleIpListValidator validator(static_cast<SimpleIpListValidator::AddressStyle>(style), static_cast<SimpleIpListValidator::AddressType>(type));
+    QCOMPARE(validator.validate(address, pos), result);
+}
+
+void SimpleipListTest::benchmark()
+{
+    // WireGuard AllowedIPs with a thousand of entries
+    QStringList addresses;
+    for (int i = 0; i < 500; ++i) {
+        addresses << QStringLiteral("10.%1.%2.0/24").arg(i / 256).arg(i % 256);
+        addresses << QStringLiteral("fd00:%1::/64").arg(i, 0, 16);
+    }
+    const QString list = addresses.join(QStringLiteral(", "));
+    int pos;
+
+    QBENCHMARK {
+        QString input = list;
+        QCOMPARE(m_vc.validate(input, pos), QValidator::Acceptable);
+    }
+}
+
+void SimpleipListTest::incrementalTest()
+{
+    SimpleIpListValidator validator(SimpleIpListValidator::WithCidr, SimpleIpListValidator::Both);
+    int pos = 0;
+
+    // Edits of the same list validated with the previous results cached
+    const QStringList edits = { "10.0.0.0/8, ::/0", "10.0.0.0/8, ::/0,", "10.0.0.0/8, ::/0, fe80::",
+                                "10.0.0.0/8, ::/0, fe80::/64", "10.0.0.0/8 ::/0, fe80::/64", "10.0.0.0/8, ::/0, fe80::/64",
+                                "10.0.0.0/8, ::/0, fe80::/6", "10.0.0.0/, ::/0, fe80::/6", "10.0.0.0/8, ::/0, fe80::/6",
+                                "10.0.0.0/8, fe80::/6", "", "1" };
+    for (const QString &edit : edits) {
+        QString address = edit;
+        QString freshAddress = edit;
+        SimpleIpListValidator freshValidator(SimpleIpListValidator::WithCidr, SimpleIpListValidator::Both);
+        QCOMPARE(validator.validate(address, pos), freshValidator.validate(freshAddress, pos));
+    }
+}
+
+void SimpleipListTest::typingBenchmark()
+{
+    // Typing in the middle of a WireGuard AllowedIPs list with 10k entries
+    QStringList addresses;
+    for (int i = 0; i < 5000; ++i) {
+        addresses << QStringLiteral("10.%1.%2.0/24").arg(i / 256).arg(i % 256);
+        addresses << QStringLiteral("fd00:%1::/64").arg(i, 0, 16);
+    }
+    QString address = addresses.join(QStringLiteral(", "));
+    const int edit = address.indexOf(QLatin1Char(','), address.size() / 2) - 1;
+    const QChar typed = address.at(edit);
+    int pos = edit;
+
+    QCOMPARE(m_vc.validate(address, pos), QValidator::Acceptable);
+    QBENCHMARK {
+        address.remove(edit, 1);
+        m_vc.validate(address, pos);
+        address.insert(edit, typed);
+        m_vc.validate(address, pos);
+    }
+    QCOMPARE(m_vc.validate(address, pos), QValidator::Acceptable);
+}
+
 QTEST_GUILESS_MAIN(SimpleipListTest)
 
 #include "simpleiplisttest.moc"
@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "simpleipv4addressvalidator.h"
 #include <QTest>
+#include <QStringList>
 
 class SimpleIpv4Test : public QObject
 {
@@ -35,6 +36,9 @@ private slots:
     void cidrTest_data();
     void portTest();
     void portTest_data();
+    void fuzzTest();
+    void fuzzTest_data();
+    void benchmark();
 
 private:
     SimpleIpV4AddressValidator m_vb;
@@ -147,6 +151,75 @@ void SimpleIpv4Test::portTest()
     QCOMPARE(m_vp.validate(address, pos), result);
 }
 
+void SimpleIpv4Test::fuzzTest_data()
+{
+    QTest::addColumn<int>("style");
+    QTest::addColumn<QString>("address");
+    QTest::addColumn<QValidator::State>("result");
+    QTest::addColumn<QString>("normalized");
+
+    // Mutations of valid addresses, checked against the former regular expression based validator
+    QTest::newRow("port: 1.2.7.4") << int(SimpleIpV4AddressValidator::WithPort) << "1.2.7.4" << QValidator::Intermediate << "1.2.7.4";
+    QTest::newRow("base: 010.1.1.2") << int(SimpleIpV4AddressValidator::Base) << "010.1.1.2" << QValidator::Acceptable << "10.1.1.2";
+    QTest::newRow("port: 1962.168.1.1:8080") << int(SimpleIpV4AddressValidator::WithPort) << "1962.168.1.1:8080" << QValidator::Invalid << "1962.168.1.1:8080";
+    QTest::newRow("base:  1./2.3,.4") << int(SimpleIpV4AddressValidator::Base) << " 1./2.3,.4" << QValidator::Invalid << " 1./2.3,.4";
+    QTest::newRow("base: 192.1/681.1:8080") << int(SimpleIpV4AddressValidator::Base) << "192.1/681.1:8080" << QValidator::Invalid << "192.1/681.1:8080";
+    QTest::newRow("base: 0 10.,1.1.1") << int(SimpleIpV4AddressValidator::Base) << "0 10.,1.1.1" << QValidator::Invalid << "0 10.,1.1.1";
+    QTest::newRow("port: 10.0.0.3/24") << int(SimpleIpV4AddressValidator::WithPort) << "10.0.0.3/24" << QValidator::Invalid << "10.0.0.3/24";
+    QTest::newRow("cidr: 112.364") << int(SimpleIpV4AddressValidator::WithCidr) << "112.364" << QValidator::Invalid << "112.364";
+    QTest::newRow("port: 01031.1.1") << int(SimpleIpV4AddressValidator::WithPort) << "01031.1.1" << QValidator::Invalid << "01031.1.1";
+    QTest::newRow("cidr: 001.002.2003,.004/08") << int(SimpleIpV4AddressValidator::WithCidr) << "001.002.2003,.004/08" << QValidator::Invalid << "001.002.2003,.004/08";
+    QTest::newRow("cidr: 192.1681.1.1:8080") << int(SimpleIpV4AddressValidator::WithCidr) << "192.1681.1.1:8080" << QValidator::Invalid << "192.1681.1.1:8080";
+    QTest::newRow("cidr: 192.16.8.1.1:80 80") << int(SimpleIpV4AddressValidator::WithCidr) << "192.16.8.1.1:80 80" << QValidator::Invalid << "192.16.8.1.1:80 80";
+    QTest::newRow("port: 192.168.1.1:080") << int(SimpleIpV4AddressValidator::WithPort) << "192.168.1.1:080" << QValidator::Acceptable << "192.168.1.1:080";
+    QTest::newRow("port: 010.6.1.1") << int(SimpleIpV4AddressValidator::WithPort) << "010.6.1.1" << QValidator::Intermediate << "10.6.1.1";
+    QTest::newRow("base: 010.1.111") << int(SimpleIpV4AddressValidator::Base) << "010.1.111" << QValidator::Intermediate << "10.1.111";
+    QTest::newRow("base: 1.2 3.4") << int(SimpleIpV4AddressValidator::Base) << "1.2 3.4" << QValidator::Intermediate << "1.0.4";
+    QTest::newRow("base:  1. 2.3,.1") << int(SimpleIpV4AddressValidator::Base) << " 1. 2.3,.1" << QValidator::Acceptable << "1.2.0.1";
+    QTest::newRow("base: ,.1.1.1") << int(SimpleIpV4AddressValidator::Base) << ",.1.1.1" << QValidator::Acceptable << "0.1.1.1";
+    QTest::newRow("base: 1.2.3.4 ") << int(SimpleIpV4AddressValidator::Base) << "1.2.3.4 " << QValidator::Acceptable << "1.2.3.4";
+    QTest::newRow("base: 1.2.3.04") << int(SimpleIpV4AddressValidator::Base) << "1.2.3.04" << QValidator::Acceptable << "1.2.3.4";
+    QTest::newRow("cidr: 1.2.3.") << int(SimpleIpV4AddressValidator::WithCidr) << "1.2.3." << QValidator::Intermediate << "1.2.3.";
+    QTest::newRow("cidr: 001.002.003.004/") << int(SimpleIpV4AddressValidator::WithCidr) << "001.002.003.004/" << QValidator::Intermediate << "1.2.3.4/";
+    QTest::newRow("cidr: 001.002.003.004/0") << int(SimpleIpV4AddressValidator::WithCidr) << "001.002.003.004/0" << QValidator::Acceptable << "1.2.3.4/0";
+    QTest::newRow("cidr: 1.2.3.4/123") << int(SimpleIpV4AddressValidator::WithCidr) << "1.2.3.4/123" << QValidator::Invalid << "1.2.3.4/123";
+    QTest::newRow("cidr: 1.2.3.4/1.") << int(SimpleIpV4AddressValidator::WithCidr) << "1.2.3.4/1." << QValidator::Invalid << "1.2.3.4/1.";
+    QTest::newRow("cidr: 1.2.3.4/ 1") << int(SimpleIpV4AddressValidator::WithCidr) << "1.2.3.4/ 1" << QValidator::Invalid << "1.2.3.4/ 1";
+    QTest::newRow("port: 1.2.3.4:123456") << int(SimpleIpV4AddressValidator::WithPort) << "1.2.3.4:123456" << QValidator::Invalid << "1.2.3.4:123456";
+    QTest::newRow("port: 1.2.3.4:99999") << int(SimpleIpV4AddressValidator::WithPort) << "1.2.3.4:99999" << QValidator::Invalid << "1.2.3.4:99999";
+    QTest::newRow("port: 1.2.3.4/80") << int(SimpleIpV4AddressValidator::WithPort) << "1.2.3.4/80" << QValidator::Invalid << "1.2.3.4/80";
+    QTest::newRow("base: 1.2.3.a") << int(SimpleIpV4AddressValidator::Base) << "1.2.3.a" << QValidator::Invalid << "1.2.3.a";
+}
+
+void SimpleIpv4Test::fuzzTest()
+{
+    int pos;
+
+    QFETCH(int, style);
+    QFETCH(QString, address);
+    QFETCH(QValidator::State, result);
+    QFETCH(QString, normalized);
+
+    SimpleIpV4AddressValidator validator(static_cast<SimpleIpV4AddressValidator::AddressStyle>(style));
+    QCOMPARE(validator.validate(address, pos), result);
+    if (result != QValidator::Invalid) {
+        QCOMPARE(address, normalized);
+    }
+}
+
+void SimpleIpv4Test::benchmark()
+{
+    const QStringList addresses = { "192.168.1.1/24", "10.0.0.1/8", "172.16.254.3/32", "0.0.0.0/0", "255.255.255.255/32", "1.2.3." };
+    int pos;
+
+    QBENCHMARK {
+        for (const QString &address : addresses) {
+            QString input = address;
+            m_vc.validate(input, pos);
+        }
+    }
+}
+
 QTEST_APPLESS_MAIN(SimpleIpv4Test)
 
 #include "simpleipv4test.moc"
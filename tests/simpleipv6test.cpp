@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "simpleipv6addressvalidator.h"
 #include <QTest>
+#include <QStringList>
 
 class SimpleIpv6Test : public QObject
 {
@@ -35,6 +36,9 @@ private slots:
     void cidrTest_data();
     void portTest();
     void portTest_data();
+    void fuzzTest();
+    void fuzzTest_data();
+    void benchmark();
 
 private:
     SimpleIpV6AddressValidator m_vb;
@@ -187,6 +191,79 @@ void SimpleIpv6Test::portTest()
     QCOMPARE(m_vp.validate(address, pos), result);
 }
 
+void SimpleIpv6Test::fuzzTest_data()
+{
+    QTest::addColumn<int>("style");
+    QTest::addColumn<QString>("address");
+    QTest::addColumn<QValidator::State>("result");
+
+    // Mutations of valid addresses, checked against the former regular expression based validator
+    QTest::newRow("base: [:1]:80") << int(SimpleIpV6AddressValidator::Base) << "[:1]:80" << QValidator::Invalid;
+    QTest::newRow("port: fe80:1/64") << int(SimpleIpV6AddressValidator::WithPort) << "fe80:1/64" << QValidator::Invalid;
+    QTest::newRow("cidr: 0001::1") << int(SimpleIpV6AddressValidator::WithCidr) << "0001::1" << QValidator::Intermediate;
+    QTest::newRow("port: 1:2:34:5:67::") << int(SimpleIpV6AddressValidator::WithPort) << "1:2:34:5:67::" << QValidator::Invalid;
+    QTest::newRow("base: 1:2:3:4:5:6:a::") << int(SimpleIpV6AddressValidator::Base) << "1:2:3:4:5:6:a::" << QValidator::Acceptable;
+    QTest::newRow("base: 000.1::1") << int(SimpleIpV6AddressValidator::Base) << "000.1::1" << QValidator::Invalid;
+    QTest::newRow("cidr: 20f01:db8::/32") << int(SimpleIpV6AddressValidator::WithCidr) << "20f01:db8::/32" << QValidator::Invalid;
+    QTest::newRow("cidr: [fe0::]]:") << int(SimpleIpV6AddressValidator::WithCidr) << "[fe0::]]:" << QValidator::Invalid;
+    QTest::newRow("cidr: a000::1") << int(SimpleIpV6AddressValidator::WithCidr) << "a000::1" << QValidator::Intermediate;
+    QTest::newRow("base: 9:1") << int(SimpleIpV6AddressValidator::Base) << "9:1" << QValidator::Intermediate;
+    QTest::newRow("cidr: [fe80::g:") << int(SimpleIpV6AddressValidator::WithCidr) << "[fe80::g:" << QValidator::Invalid;
+    QTest::newRow("cidr: :") << int(SimpleIpV6AddressValidator::WithCidr) << ":" << QValidator::Intermediate;
+    QTest::newRow("cidr: :F0") << int(SimpleIpV6AddressValidator::WithCidr) << ":F0" << QValidator::Intermediate;
+    QTest::newRow("cidr: :F0/64") << int(SimpleIpV6AddressValidator::WithCidr) << ":F0/64" << QValidator::Invalid;
+    QTest::newRow("cidr: 2001:]db8::/32") << int(SimpleIpV6AddressValidator::WithCidr) << "2001:]db8::/32" << QValidator::Invalid;
+    QTest::newRow("base: 1:2:3:4:96:7::") << int(SimpleIpV6AddressValidator::Base) << "1:2:3:4:96:7::" << QValidator::Intermediate;
+    QTest::newRow("base: 1:2:3:4:5:6:7:8:9") << int(SimpleIpV6AddressValidator::Base) << "1:2:3:4:5:6:7:8:9" << QValidator::Invalid;
+    QTest::newRow("base: 1:2:3:4:5:6:7::9") << int(SimpleIpV6AddressValidator::Base) << "1:2:3:4:5:6:7::9" << QValidator::Invalid;
+    QTest::newRow("base: :::") << int(SimpleIpV6AddressValidator::Base) << ":::" << QValidator::Invalid;
+    QTest::newRow("base: ::1::") << int(SimpleIpV6AddressValidator::Base) << "::1::" << QValidator::Invalid;
+    QTest::newRow("base: 00001::11") << int(SimpleIpV6AddressValidator::Base) << "00001::11" << QValidator::Acceptable;
+    QTest::newRow("base: 10000::") << int(SimpleIpV6AddressValidator::Base) << "10000::" << QValidator::Invalid;
+    QTest::newRow("base: 1 ::") << int(SimpleIpV6AddressValidator::Base) << "1 ::" << QValidator::Invalid;
+    QTest::newRow("cidr: f80::1/61") << int(SimpleIpV6AddressValidator::WithCidr) << "f80::1/61" << QValidator::Acceptable;
+    QTest::newRow("cidr: fe8::1/64") << int(SimpleIpV6AddressValidator::WithCidr) << "fe8::1/64" << QValidator::Acceptable;
+    QTest::newRow("cidr: ::f/1") << int(SimpleIpV6AddressValidator::WithCidr) << "::f/1" << QValidator::Acceptable;
+    QTest::newRow("cidr: ::/129") << int(SimpleIpV6AddressValidator::WithCidr) << "::/129" << QValidator::Invalid;
+    QTest::newRow("cidr: 1/") << int(SimpleIpV6AddressValidator::WithCidr) << "1/" << QValidator::Invalid;
+    QTest::newRow("cidr: 1:2:3:4:5:6:7:8:") << int(SimpleIpV6AddressValidator::WithCidr) << "1:2:3:4:5:6:7:8:" << QValidator::Invalid;
+    QTest::newRow("cidr: ::/12/") << int(SimpleIpV6AddressValidator::WithCidr) << "::/12/" << QValidator::Invalid;
+    QTest::newRow("port: [fe82::]:") << int(SimpleIpV6AddressValidator::WithPort) << "[fe82::]:" << QValidator::Intermediate;
+    QTest::newRow("port: [1e80::f:") << int(SimpleIpV6AddressValidator::WithPort) << "[1e80::f:" << QValidator::Intermediate;
+    QTest::newRow("port: [fe00::]") << int(SimpleIpV6AddressValidator::WithPort) << "[fe00::]" << QValidator::Intermediate;
+    QTest::newRow("port: [fe00::]80") << int(SimpleIpV6AddressValidator::WithPort) << "[fe00::]80" << QValidator::Invalid;
+    QTest::newRow("port: []:80") << int(SimpleIpV6AddressValidator::WithPort) << "[]:80" << QValidator::Invalid;
+    QTest::newRow("port: [1:2]:80") << int(SimpleIpV6AddressValidator::WithPort) << "[1:2]:80" << QValidator::Invalid;
+    QTest::newRow("port: [::1]:810") << int(SimpleIpV6AddressValidator::WithPort) << "[::1]:810" << QValidator::Acceptable;
+    QTest::newRow("port: [::1]:65536") << int(SimpleIpV6AddressValidator::WithPort) << "[::1]:65536" << QValidator::Invalid;
+    QTest::newRow("port: [::1]:123456") << int(SimpleIpV6AddressValidator::WithPort) << "[::1]:123456" << QValidator::Invalid;
+}
+
+void SimpleIpv6Test::fuzzTest()
+{
+    int pos;
+
+    QFETCH(int, style);
+    QFETCH(QString, address);
+    QFETCH(QValidator::State, result);
+
+    SimpleIpV6AddressValidator validator(static_cast<SimpleIpV6AddressValidator::AddressStyle>(style));
+    QCOMPARE(validator.validate(address, pos), result);
+}
+
+void SimpleIpv6Test::benchmark()
+{
+    const QStringList addresses = { "2001:db8::/32", "fe80::1/64", "::/0", "1234:2345:3456:4567:5678:6789:789a:89ab/128", "fd00:1:2::", "::ffff:1/96" };
+    int pos;
+
+    QBENCHMARK {
+        for (const QString &address : addresses) {
+            QString input = address;
+            m_vc.validate(input, pos);
+        }
+    }
+}
+
 QTEST_GUILESS_MAIN(SimpleIpv6Test)
 
 #include "simpleipv6test.moc"
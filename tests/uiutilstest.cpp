@@ -0,0 +1,138 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "uiutils.h"
+
+#include <KLocalizedString>
+
+#include <QDateTime>
+#include <QTest>
+
+class UiUtilsTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void labelsTest();
+    void sharedLabelsTest();
+    void clearLabelCacheTest();
+    void dateRelativeChangeTest();
+    void labelsBenchmark();
+    void labelsBaselineBenchmark();
+};
+
+void UiUtilsTest::labelsTest()
+{
+    QCOMPARE(UiUtils::labelFromWirelessSecurity(NetworkManager::Wpa2Psk), QStringLiteral("WPA2-PSK"));
+    QCOMPARE(UiUtils::labelFromWirelessSecurity(NetworkManager::UnknownSecurity), QStringLiteral("Unknown security type"));
+    QCOMPARE(UiUtils::connectionStateToString(NetworkManager::Device::Activated), QStringLiteral("Connected"));
+    QCOMPARE(UiUtils::connectionStateToString(NetworkManager::Device::Activated, QStringLiteral("Home")), QStringLiteral("Connected to Home"));
+    QCOMPARE(UiUtils::vpnConnectionStateToString(NetworkManager::VpnConnection::Activated), QStringLiteral("Activated"));
+    QCOMPARE(UiUtils::interfaceTypeLabel(NetworkManager::Device::Wifi, NetworkManager::Device::Ptr()), QStringLiteral("Wi-Fi"));
+    QCOMPARE(UiUtils::interfaceTypeLabel(NetworkManager::Device::Ethernet, NetworkManager::Device::Ptr()), QStringLiteral("Wired Ethernet"));
+    QCOMPARE(UiUtils::interfaceTypeLabel(NetworkManager::Device::Modem, NetworkManager::Device::Ptr()), QString());
+
+    QString title;
+    QCOMPARE(UiUtils::iconAndTitleForConnectionSettingsType(NetworkManager::ConnectionSettings::Wireless, title), QStringLiteral("network-wireless"));
+    QCOMPARE(title, QStringLiteral("Wi-Fi"));
+    QCOMPARE(UiUtils::iconAndTitleForConnectionSettingsType(NetworkManager::ConnectionSettings::Unknown, title), QStringLiteral("network-wired"));
+    QCOMPARE(title, QStringLiteral("Unknown connection type"));
+}
+
+void UiUtilsTest::sharedLabelsTest()
+{
+    // Repeated calls must not translate and allocate the label again
+    const QString first = UiUtils::labelFromWirelessSecurity(NetworkManager::WpaEap);
+    const QString second = UiUtils::labelFromWirelessSecurity(NetworkManager::WpaEap);
+    QCOMPARE(first.constData(), second.constData());
+
+    const QString firstState = UiUtils::connectionStateToString(NetworkManager::Device::Disconnected);
+    const QString secondState = UiUtils::connectionStateToString(NetworkManager::Device::Disconnected);
+    QCOMPARE(firstState.constData(), secondState.constData());
+}
+
+void UiUtilsTest::clearLabelCacheTest()
+{
+    const QString before = UiUtils::vpnConnectionStateToString(NetworkManager::VpnConnection::Connecting);
+
+    UiUtils::clearLabelCache();
+
+    const QString after = UiUtils::vpnConnectionStateToString(NetworkManager::VpnConnection::Connecting);
+    QCOMPARE(before, after);
+    QVERIFY(before.constData() != after.constData());
+}
+
+void UiUtilsTest::dateRelativeChangeTest()
+{
+    const QDateTime now = QDateTime::currentDateTime();
+    const QDateTime tomorrow(now.date().addDays(1), QTime(0, 0));
+
+    QVERIFY(!UiUtils::nextDateRelativeChange(QDateTime()).isValid());
+    QVERIFY(!UiUtils::nextDateRelativeChange(now.addDays(-3)).isValid());
+    QCOMPARE(UiUtils::nextDateRelativeChange(now.addDays(-1)), tomorrow);
+
+    // "5 minutes ago" turns into "6 minutes ago" a minute later, unless the day ends before
+    const QDateTime lastUsed = now.addSecs(-5 * 60 - 10);
+    if (lastUsed.date() == now.date()) {
+        QCOMPARE(UiUtils::nextDateRelativeChange(lastUsed), qMin(lastUsed.addSecs(6 * 60), tomorrow));
+    }
+
+    // The text must stay the same until the reported change
+    const QDateTime change = UiUtils::nextDateRelativeChange(now);
+    QVERIFY(change > now);
+    QVERIFY(change <= now.addSecs(60));
+}
+
+void UiUtilsTest::labelsBenchmark()
+{
+    // Roles evaluated by the models for each row on refresh
+    QBENCHMARK {
+        for (int row = 0; row < 100; ++row) {
+            UiUtils::labelFromWirelessSecurity((NetworkManager::WirelessSecurityType) (row % 10));
+            UiUtils::connectionStateToString((NetworkManager::Device::State) ((row % 12) * 10));
+            UiUtils::vpnConnectionStateToString((NetworkManager::VpnConnection::State) (row % 8));
+            QString title;
+            UiUtils::iconAndTitleForConnectionSettingsType((NetworkManager::ConnectionSettings::ConnectionType) (row % 20), title);
+        }
+    }
+}
+
+void UiUtilsTest::labelsBaselineBenchmark()
+{
+    // The same pattern translating every label on each call, as before the labels were shared
+    const char *securityLabels[] = {"Insecure", "WEP", "LEAP", "Dynamic WEP", "WPA-PSK", "WPA-EAP", "WPA2-PSK", "WPA2-EAP", "WPA3-SAE", "Unknown security type"};
+    const char *stateLabels[] = {"Unknown", "Unmanaged", "Unavailable", "Not connected", "Preparing to connect", "Configuring interface",
+                                 "Waiting for authorization", "Setting network address", "Checking further connectivity", "Waiting for a secondary connection",
+                                 "Connected", "Deactivating connection"};
+    const char *vpnStateLabels[] = {"Unknown", "Preparing to connect", "Needs authorization", "Connecting", "Setting network address", "Activated", "Failed", "Failed"};
+
+    QBENCHMARK {
+        for (int row = 0; row < 100; ++row) {
+            i18nc("@label security", securityLabels[row % 10]);
+            i18nc("network interface state", stateLabels[row % 12]);
+            i18nc("The state of the VPN connection", vpnStateLabels[row % 8]);
+            i18n("Wi-Fi");
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(UiUtilsTest)
+
+#include "uiutilstest.moc"
@@ -0,0 +1,170 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "vpnexportarchive.h"
+#include "openvpn.h"
+#include "vpnc.h"
+#include "nm-openvpn-service.h"
+#include "nm-vpnc-service.h"
+
+#include <KArchiveDirectory>
+#include <KMessageBox>
+#include <KTar>
+
+#include <NetworkManagerQt/VpnSetting>
+
+#include <QDir>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+
+#define TEST_PEM "-----BEGIN CERTIFICATE-----\nMIIBszCCAVmgAwIBAgIUTestCertificateForTheRoundTrip\n-----END CERTIFICATE-----\n"
+#define TEST_DER "\x30\x82\x01\xb3\x30\x82\x01\x59\xa0\x03\x02\x01\x02"
+
+class VpnExportArchiveTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void roundTripTest();
+
+private:
+    QTemporaryDir m_dir;
+    QString m_pemPath;
+    QString m_derPath;
+};
+
+static NetworkManager::ConnectionSettings::Ptr vpnConnection(const QString &id, const QString &serviceType, const NMStringMap &data, const NMStringMap &secrets)
+{
+    NetworkManager::ConnectionSettings::Ptr connection(new NetworkManager::ConnectionSettings(NetworkManager::ConnectionSettings::Vpn));
+    connection->setId(id);
+    connection->setUuid(NetworkManager::ConnectionSettings::createNewUuid());
+
+    NetworkManager::VpnSetting::Ptr vpnSetting = connection->setting(NetworkManager::Setting::Vpn).dynamicCast<NetworkManager::VpnSetting>();
+    vpnSetting->setServiceType(serviceType);
+    vpnSetting->setData(data);
+    vpnSetting->setSecrets(secrets);
+    return connection;
+}
+
+static NetworkManager::VpnSetting importedVpnSetting(const NMVariantMapMap &settings)
+{
+    NetworkManager::VpnSetting setting;
+    setting.fromMap(settings.value(QStringLiteral("vpn")));
+    return setting;
+}
+
+static QByteArray fileContents(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+static bool writeFile(const QString &path, const QByteArray &contents)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(contents) == contents.size();
+}
+
+void VpnExportArchiveTest::initTestCase()
+{
+    // Imported certificates are copied to the data directory
+    QStandardPaths::setTestModeEnabled(true);
+    // Don't ask whether to copy the certificates of imported OpenVPN files
+    KMessageBox::saveDontShowAgainYesNo(QStringLiteral("copyCertificatesDialog"), KMessageBox::No);
+
+    QVERIFY(m_dir.isValid());
+    m_pemPath = m_dir.filePath(QStringLiteral("ca.pem"));
+    QVERIFY(writeFile(m_pemPath, QByteArray(TEST_PEM)));
+    m_derPath = m_dir.filePath(QStringLiteral("ca.der"));
+    QVERIFY(writeFile(m_derPath, QByteArray(TEST_DER, sizeof(TEST_DER) - 1)));
+}
+
+void VpnExportArchiveTest::roundTripTest()
+{
+    OpenVpnUiPlugin openVpn;
+    VpncUiPlugin vpnc;
+
+    const QString archiveName = m_dir.filePath(QStringLiteral("export.tar.gz"));
+    {
+        VpnExportArchive archive(archiveName);
+        QVERIFY(archive.open());
+
+        const NMStringMap openVpnData = {{QStringLiteral(NM_OPENVPN_KEY_CONNECTION_TYPE), QStringLiteral(NM_OPENVPN_CONTYPE_TLS)},
+                                         {QStringLiteral(NM_OPENVPN_KEY_REMOTE), QStringLiteral("vpn.example.com")},
+                                         {QStringLiteral(NM_OPENVPN_KEY_PORT), QStringLiteral("1194")},
+                                         {QStringLiteral(NM_OPENVPN_KEY_CA), m_pemPath},
+                                         {QStringLiteral(NM_OPENVPN_KEY_CERT), m_pemPath},
+                                         {QStringLiteral(NM_OPENVPN_KEY_KEY), m_pemPath}};
+        QVERIFY(openVpn.exportConnectionSettingsToArchive(vpnConnection(QStringLiteral("Home"), QStringLiteral("org.freedesktop.NetworkManager.openvpn"),
+                                                                        openVpnData, NMStringMap()), &archive));
+
+        // Both refer to the same CA certificate, the secret needs escaping in the .pcf file
+        for (const QString &id : {QStringLiteral("Office"), QStringLiteral("Branch")}) {
+            const NMStringMap vpncData = {{QStringLiteral(NM_VPNC_KEY_GATEWAY), id.toLower() + QStringLiteral(".example.com")},
+                                          {QStringLiteral(NM_VPNC_KEY_ID), id.toLower()},
+                                          {QStringLiteral(NM_VPNC_KEY_XAUTH_USER), QStringLiteral("user")},
+                                          {QStringLiteral(NM_VPNC_KEY_CA_FILE), m_derPath}};
+            const NMStringMap vpncSecrets = {{QStringLiteral(NM_VPNC_KEY_SECRET), QStringLiteral(" group = secret; #1 ")}};
+            QVERIFY(vpnc.exportConnectionSettingsToArchive(vpnConnection(id, QStringLiteral("org.freedesktop.NetworkManager.vpnc"),
+                                                                         vpncData, vpncSecrets), &archive));
+        }
+
+        QVERIFY(archive.close());
+    }
+
+    KTar tar(archiveName);
+    QVERIFY(tar.open(QIODevice::ReadOnly));
+    const QString extracted = m_dir.filePath(QStringLiteral("extracted"));
+    QVERIFY(QDir().mkpath(extracted));
+    QVERIFY(tar.directory()->copyTo(extracted));
+
+    // PEM files are inlined, the shared CA of the vpnc connections is stored once
+    QCOMPARE(QDir(extracted + QStringLiteral("/certificates")).entryList(QDir::Files).count(), 1);
+
+    NMVariantMapMap imported = vpnc.importConnectionSettings(extracted + QStringLiteral("/Office.pcf"));
+    QCOMPARE(vpnc.lastError(), VpnUiPlugin::NoError);
+    QCOMPARE(imported.value(QStringLiteral("connection")).value(QStringLiteral("id")).toString(), QStringLiteral("Office"));
+    NetworkManager::VpnSetting vpncSetting = importedVpnSetting(imported);
+    QCOMPARE(vpncSetting.data().value(QStringLiteral(NM_VPNC_KEY_GATEWAY)), QStringLiteral("office.example.com"));
+    QCOMPARE(vpncSetting.data().value(QStringLiteral(NM_VPNC_KEY_ID)), QStringLiteral("office"));
+    QCOMPARE(vpncSetting.data().value(QStringLiteral(NM_VPNC_KEY_XAUTH_USER)), QStringLiteral("user"));
+    QCOMPARE(vpncSetting.secrets().value(QStringLiteral(NM_VPNC_KEY_SECRET)), QStringLiteral(" group = secret; #1 "));
+    QCOMPARE(fileContents(vpncSetting.data().value(QStringLiteral(NM_VPNC_KEY_CA_FILE))), fileContents(m_derPath));
+
+    imported = vpnc.importConnectionSettings(extracted + QStringLiteral("/Branch.pcf"));
+    vpncSetting = importedVpnSetting(imported);
+    QCOMPARE(vpncSetting.data().value(QStringLiteral(NM_VPNC_KEY_GATEWAY)), QStringLiteral("branch.example.com"));
+    QCOMPARE(fileContents(vpncSetting.data().value(QStringLiteral(NM_VPNC_KEY_CA_FILE))), fileContents(m_derPath));
+
+    imported = openVpn.importConnectionSettings(extracted + QStringLiteral("/Home_openvpn.conf"));
+    QVERIFY(!imported.isEmpty());
+    const NetworkManager::VpnSetting openVpnSetting = importedVpnSetting(imported);
+    QCOMPARE(openVpnSetting.data().value(QStringLiteral(NM_OPENVPN_KEY_REMOTE)), QStringLiteral("vpn.example.com"));
+    QCOMPARE(openVpnSetting.data().value(QStringLiteral(NM_OPENVPN_KEY_PORT)), QStringLiteral("1194"));
+    QCOMPARE(openVpnSetting.data().value(QStringLiteral(NM_OPENVPN_KEY_CONNECTION_TYPE)), QStringLiteral(NM_OPENVPN_CONTYPE_TLS));
+    QCOMPARE(fileContents(openVpnSetting.data().value(QStringLiteral(NM_OPENVPN_KEY_CA))), fileContents(m_pemPath));
+    QCOMPARE(fileContents(openVpnSetting.data().value(QStringLiteral(NM_OPENVPN_KEY_KEY))), fileContents(m_pemPath));
+}
+
+QTEST_MAIN(VpnExportArchiveTest)
+
+#include "vpnexportarchivetest.moc"
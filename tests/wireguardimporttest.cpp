@@ -0,0 +1,175 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "settings/wireguardinterfacewidget.h"
+#include "wireguardkeyvalidator.h"
+
+#include <QCryptographicHash>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <NetworkManagerQt/GenericTypes>
+
+class WireGuardImportTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void keyValidatorTest();
+    void importTest();
+    void invalidPeerTest();
+    void importBenchmark();
+
+private:
+    QString writeConfig(const QString &name, const QByteArray &contents);
+
+    QTemporaryDir m_directory;
+};
+
+// A valid key, different for each number
+static QString key(int number)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(QByteArray::number(number), QCryptographicHash::Sha256).toBase64());
+}
+
+void WireGuardImportTest::initTestCase()
+{
+    QVERIFY(m_directory.isValid());
+}
+
+QString WireGuardImportTest::writeConfig(const QString &name, const QByteArray &contents)
+{
+    const QString fileName = m_directory.path() + QLatin1Char('/') + name;
+    QFile file(fileName);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(contents);
+    }
+    return fileName;
+}
+
+void WireGuardImportTest::keyValidatorTest()
+{
+    WireGuardKeyValidator validator;
+    int pos = 0;
+
+    QString value = key(1);
+    QCOMPARE(validator.validate(value, pos), QValidator::Acceptable);
+    QVERIFY(WireGuardKeyValidator::isValidKey(value));
+
+    // Partially typed keys
+    value = QString();
+    QCOMPARE(validator.validate(value, pos), QValidator::Intermediate);
+    value = key(1).left(43);
+    QCOMPARE(validator.validate(value, pos), QValidator::Intermediate);
+    QVERIFY(!WireGuardKeyValidator::isValidKey(value));
+
+    // The 43rd character must leave the 2 LSB zeroed
+    value = QString(42, QLatin1Char('A')) + QStringLiteral("B=");
+    QCOMPARE(validator.validate(value, pos), QValidator::Invalid);
+    QVERIFY(!WireGuardKeyValidator::isValidKey(value));
+    value = QString(42, QLatin1Char('A')) + QStringLiteral("E=");
+    QVERIFY(WireGuardKeyValidator::isValidKey(value));
+
+    value = key(1) + QLatin1Char('A');
+    QCOMPARE(validator.validate(value, pos), QValidator::Invalid);
+    value = key(1).replace(10, 1, QLatin1Char('-'));
+    QCOMPARE(validator.validate(value, pos), QValidator::Invalid);
+    QVERIFY(!WireGuardKeyValidator::isValidKey(value));
+    value = key(1).replace(10, 1, QChar(0xe9));
+    QVERIFY(!WireGuardKeyValidator::isValidKey(value));
+}
+
+void WireGuardImportTest::importTest()
+{
+    const QByteArray config = "# Generated\n"
+                              "[Interface]\n"
+                              "PrivateKey = " + key(0).toLatin1() + "\n"
+                              "Address = 10.0.0.2/24, fd00::2/64 # both families\n"
+                              "ListenPort = 51820\n"
+                              "\n"
+                              "[Peer]\n"
+                              "PublicKey=" + key(1).toLatin1() + "\n"
+                              "PresharedKey = " + key(2).toLatin1() + "\n"
+                              "AllowedIPs = 10.0.0.0/24 , fd00::/64\n"
+                              "Endpoint = vpn.example.com:51820\n"
+                              "[Peer]\n"
+                              "PublicKey = " + key(3).toLatin1() + "\n"
+                              "AllowedIPs = 0.0.0.0/0\n";
+
+    const NMVariantMapMap result = WireGuardInterfaceWidget::importConnectionSettings(writeConfig(QStringLiteral("wg0.conf"), config));
+    QCOMPARE(result.value(QStringLiteral("connection")).value(QStringLiteral("id")).toString(), QStringLiteral("wg0"));
+    QVERIFY(result.contains(QStringLiteral("ipv4")));
+    QVERIFY(result.contains(QStringLiteral("ipv6")));
+
+    const QVariantMap wireguard = result.value(QStringLiteral("wireguard"));
+    QCOMPARE(wireguard.value(QStringLiteral("private-key")).toString(), key(0));
+    QCOMPARE(wireguard.value(QStringLiteral("listen-port")).toUInt(), 51820u);
+
+    const NMVariantMapList peers = wireguard.value(QStringLiteral("peers")).value<NMVariantMapList>();
+    QCOMPARE(peers.count(), 2);
+    QCOMPARE(peers.at(0).value(QStringLiteral("public-key")).toString(), key(1));
+    QCOMPARE(peers.at(0).value(QStringLiteral("preshared-key")).toString(), key(2));
+    QCOMPARE(peers.at(0).value(QStringLiteral("allowed-ips")).toStringList(), QStringList({QStringLiteral("10.0.0.0/24"), QStringLiteral("fd00::/64")}));
+    QCOMPARE(peers.at(0).value(QStringLiteral("endpoint")).toString(), QStringLiteral("vpn.example.com:51820"));
+    QCOMPARE(peers.at(1).value(QStringLiteral("public-key")).toString(), key(3));
+    QCOMPARE(peers.at(1).value(QStringLiteral("allowed-ips")).toStringList(), QStringList({QStringLiteral("0.0.0.0/0")}));
+}
+
+void WireGuardImportTest::invalidPeerTest()
+{
+    const QByteArray interface = "[Interface]\nPrivateKey = " + key(0).toLatin1() + "\n";
+
+    // A peer without a valid public key or without valid allowed IPs fails the import
+    QByteArray config = interface + "[Peer]\nPublicKey = " + key(1).left(43).toLatin1() + "\nAllowedIPs = 10.0.0.0/24\n";
+    QVERIFY(WireGuardInterfaceWidget::importConnectionSettings(writeConfig(QStringLiteral("invalid1.conf"), config)).isEmpty());
+
+    config = interface + "[Peer]\nPublicKey = " + key(1).toLatin1() + "\nAllowedIPs = 10.0.0.0/24, 10.0.1\n";
+    QVERIFY(WireGuardInterfaceWidget::importConnectionSettings(writeConfig(QStringLiteral("invalid2.conf"), config)).isEmpty());
+
+    config = interface + "[Peer]\nPublicKey = " + key(1).toLatin1() + "\nAllowedIPs = 10.0.0.0/24,\n";
+    QVERIFY(WireGuardInterfaceWidget::importConnectionSettings(writeConfig(QStringLiteral("invalid3.conf"), config)).isEmpty());
+}
+
+void WireGuardImportTest::importBenchmark()
+{
+    // A mesh network with 5000 peers
+    QByteArray config = "[Interface]\nPrivateKey = " + key(0).toLatin1() + "\nAddress = 10.0.0.1/16\n";
+    for (int i = 1; i <= 5000; ++i) {
+        config += "\n[Peer]\nPublicKey = " + key(i).toLatin1() + "\n"
+                  "AllowedIPs = 10.0." + QByteArray::number(i / 256) + '.' + QByteArray::number(i % 256) + "/32, "
+                  "fd00::" + QByteArray::number(i, 16) + "/128\n"
+                  "Endpoint = 192.0.2." + QByteArray::number(i % 250 + 1) + ":51820\n";
+    }
+    const QString fileName = writeConfig(QStringLiteral("mesh.conf"), config);
+
+    NMVariantMapMap result;
+    QBENCHMARK {
+        result = WireGuardInterfaceWidget::importConnectionSettings(fileName);
+    }
+
+    const NMVariantMapList peers = result.value(QStringLiteral("wireguard")).value(QStringLiteral("peers")).value<NMVariantMapList>();
+    QCOMPARE(peers.count(), 5000);
+    QCOMPARE(peers.last().value(QStringLiteral("public-key")).toString(), key(5000));
+}
+
+QTEST_GUILESS_MAIN(WireGuardImportTest)
+
+#include "wireguardimporttest.moc"
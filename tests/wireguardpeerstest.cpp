@@ -0,0 +1,225 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "settings/wireguardpeersmodel.h"
+#include "settings/wireguardtabwidget.h"
+
+#include <QCryptographicHash>
+#include <QDialogButtonBox>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSignalSpy>
+#include <QTableView>
+#include <QTest>
+
+class WireGuardPeersTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void endpointTest();
+    void modelTest();
+    void dialogTest();
+    void removeTest_data();
+    void removeTest();
+    void openBenchmark();
+};
+
+static QString key(int number)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(QByteArray::number(number), QCryptographicHash::Sha256).toBase64());
+}
+
+static QVariantMap peer(int number)
+{
+    QVariantMap result;
+    result.insert(QStringLiteral("public-key"), key(number));
+    result.insert(QStringLiteral("allowed-ips"), QStringList({QStringLiteral("10.0.%1.%2/32").arg(number / 256).arg(number % 256)}));
+    result.insert(QStringLiteral("endpoint"), QStringLiteral("192.0.2.%1:51820").arg(number % 250 + 1));
+    return result;
+}
+
+static NMVariantMapList peers(int count)
+{
+    NMVariantMapList result;
+    result.reserve(count);
+    for (int i = 1; i <= count; ++i) {
+        result.append(peer(i));
+    }
+    return result;
+}
+
+void WireGuardPeersTest::endpointTest()
+{
+    QString address;
+    QString port;
+
+    WireGuardPeersModel::splitEndpoint(QStringLiteral("vpn.example.com:51820"), &address, &port);
+    QCOMPARE(address, QStringLiteral("vpn.example.com"));
+    QCOMPARE(port, QStringLiteral("51820"));
+
+    WireGuardPeersModel::splitEndpoint(QStringLiteral("[fd00::1]:51820"), &address, &port);
+    QCOMPARE(address, QStringLiteral("fd00::1"));
+    QCOMPARE(port, QStringLiteral("51820"));
+
+    WireGuardPeersModel::splitEndpoint(QStringLiteral("vpn.example.com"), &address, &port);
+    QCOMPARE(address, QStringLiteral("vpn.example.com"));
+    QCOMPARE(port, QString());
+}
+
+void WireGuardPeersTest::modelTest()
+{
+    WireGuardPeersModel model;
+    QSignalSpy validityChanged(&model, &WireGuardPeersModel::validityChanged);
+
+    NMVariantMapList list = peers(3);
+    list[1].insert(QStringLiteral("allowed-ips"), QStringList({QStringLiteral("10.0.0")}));
+    model.setPeers(list);
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.columnCount(), int(WireGuardPeersModel::ColumnCount));
+    QVERIFY(model.isValid(0));
+    QVERIFY(!model.isValid(1));
+    QVERIFY(!model.allValid());
+    QCOMPARE(model.index(2, WireGuardPeersModel::PublicKeyColumn).data().toString(), key(3));
+    QCOMPARE(model.index(1, 0).data(WireGuardPeersModel::ValidRole).toBool(), false);
+
+    // Fixing the peer makes the whole list valid
+    validityChanged.clear();
+    model.setPeer(1, peer(2));
+    QVERIFY(model.allValid());
+    QCOMPARE(validityChanged.count(), 1);
+    QCOMPARE(model.peers(), peers(3));
+
+    // A stored preshared key must be valid
+    QVariantMap withPresharedKey = peer(4);
+    withPresharedKey.insert(QStringLiteral("preshared-key-flags"), int(NetworkManager::Setting::AgentOwned));
+    withPresharedKey.insert(QStringLiteral("preshared-key"), key(5).left(20));
+    model.appendPeer(withPresharedKey);
+    QVERIFY(!model.allValid());
+    withPresharedKey.insert(QStringLiteral("preshared-key-flags"), int(NetworkManager::Setting::NotRequired));
+    model.setPeer(3, withPresharedKey);
+    QVERIFY(model.allValid());
+
+    // An endpoint needs both the address and the port
+    QVariantMap withoutPort = peer(6);
+    withoutPort.insert(QStringLiteral("endpoint"), QStringLiteral("192.0.2.1"));
+    model.appendPeer(withoutPort);
+    QVERIFY(!model.allValid());
+    model.removePeer(4);
+    QVERIFY(model.allValid());
+    QCOMPARE(model.rowCount(), 4);
+}
+
+void WireGuardPeersTest::dialogTest()
+{
+    WireGuardTabWidget dialog(peers(3));
+    QTableView *view = dialog.findChild<QTableView *>(QStringLiteral("peersView"));
+    QLineEdit *publicKeyEdit = dialog.findChild<QLineEdit *>(QStringLiteral("publicKeyLineEdit"));
+    QPushButton *okButton = dialog.findChild<QDialogButtonBox *>(QStringLiteral("buttonBox"))->button(QDialogButtonBox::Ok);
+    QVERIFY(view);
+    QVERIFY(publicKeyEdit);
+
+    // The editor shows the current peer
+    QCOMPARE(publicKeyEdit->text(), key(1));
+    view->setCurrentIndex(view->model()->index(1, 0));
+    QCOMPARE(publicKeyEdit->text(), key(2));
+    QVERIFY(okButton->isEnabled());
+
+    // Edits go to the current row of the model
+    publicKeyEdit->setText(key(21));
+    QCOMPARE(dialog.setting().at(1).value(QStringLiteral("public-key")).toString(), key(21));
+    publicKeyEdit->setText(key(2).left(43));
+    QVERIFY(!okButton->isEnabled());
+    publicKeyEdit->setText(key(20));
+    QVERIFY(okButton->isEnabled());
+    QCOMPARE(dialog.setting().at(1).value(QStringLiteral("public-key")).toString(), key(20));
+    QCOMPARE(dialog.setting().at(0).value(QStringLiteral("public-key")).toString(), key(1));
+
+    dialog.slotRemovePeer();
+    QCOMPARE(dialog.setting().count(), 2);
+    QCOMPARE(dialog.setting().at(1).value(QStringLiteral("public-key")).toString(), key(3));
+    QCOMPARE(publicKeyEdit->text(), key(3));
+
+    // A new peer is empty and not valid until it's filled in
+    dialog.slotAddPeer();
+    QCOMPARE(dialog.setting().count(), 3);
+    QCOMPARE(publicKeyEdit->text(), QString());
+    QVERIFY(!okButton->isEnabled());
+}
+
+void WireGuardPeersTest::removeTest_data()
+{
+    QTest::addColumn<int>("row");
+    QTest::addColumn<int>("current");
+
+    QTest::newRow("first") << 0 << 0;
+    QTest::newRow("middle") << 1 << 1;
+    QTest::newRow("last") << 2 << 1;
+}
+
+void WireGuardPeersTest::removeTest()
+{
+    QFETCH(int, row);
+    QFETCH(int, current);
+
+    WireGuardTabWidget dialog(peers(3));
+    QTableView *view = dialog.findChild<QTableView *>(QStringLiteral("peersView"));
+    QLineEdit *publicKeyEdit = dialog.findChild<QLineEdit *>(QStringLiteral("publicKeyLineEdit"));
+    view->setCurrentIndex(view->model()->index(row, 0));
+
+    QStringList expected = {key(1), key(2), key(3)};
+    expected.removeAt(row);
+    dialog.slotRemovePeer();
+    QCOMPARE(view->currentIndex().row(), current);
+    QCOMPARE(publicKeyEdit->text(), expected.at(current));
+
+    // The table shows the edit right away and only the peer shown is changed
+    publicKeyEdit->setText(key(30));
+    QCOMPARE(view->model()->index(current, WireGuardPeersModel::PublicKeyColumn).data().toString(), key(30));
+    expected[current] = key(30);
+    const NMVariantMapList setting = dialog.setting();
+    QCOMPARE(setting.count(), 2);
+    for (int i = 0; i < setting.count(); ++i) {
+        QCOMPARE(setting.at(i).value(QStringLiteral("public-key")).toString(), expected.at(i));
+    }
+
+    // Removing all of them leaves an empty one to fill in
+    dialog.slotRemovePeer();
+    dialog.slotRemovePeer();
+    QCOMPARE(dialog.setting().count(), 1);
+    QCOMPARE(publicKeyEdit->text(), QString());
+}
+
+void WireGuardPeersTest::openBenchmark()
+{
+    const NMVariantMapList mesh = peers(5000);
+    const int widgetsWithOnePeer = WireGuardTabWidget(peers(1)).findChildren<QWidget *>().count();
+
+    QBENCHMARK {
+        WireGuardTabWidget dialog(mesh);
+        // The number of widgets, which take most of the memory, doesn't depend on the number of peers
+        QCOMPARE(dialog.findChildren<QWidget *>().count(), widgetsWithOnePeer);
+        QCOMPARE(dialog.setting().count(), 5000);
+    }
+}
+
+QTEST_MAIN(WireGuardPeersTest)
+
+#include "wireguardpeerstest.moc"
@@ -21,19 +21,28 @@
 
 #include "openconnectauth.h"
 #include "openconnectauthworkerthread.h"
+#include "openconnectgatewayprober.h"
+#include "openconnectlogmodel.h"
 #include "ui_openconnectauth.h"
 
 #include "debug.h"
 #include "passwordfield.h"
 
+#include <QAction>
+#include <QClipboard>
+#include <QNetworkProxy>
+#include <QUrl>
+#include <QDateTime>
 #include <QDialog>
 #include <QString>
 #include <QLabel>
 #include <QEventLoop>
 #include <QFormLayout>
+#include <QGuiApplication>
 #include <QIcon>
 #include <QDialogButtonBox>
 #include <QPushButton>
+#include <QScrollBar>
 #include <QComboBox>
 #include <QDomDocument>
 #include <QMutex>
@@ -42,12 +51,20 @@
 #include <QFile>
 #include <QTimer>
 #include <QPointer>
+#include <QSignalBlocker>
+#include <QStandardPaths>
 
+#include <KConfig>
+#include <KConfigGroup>
 #include <KIconLoader>
 #include <KLocalizedString>
 
+#include <NetworkManagerQt/ActiveConnection>
+#include <NetworkManagerQt/Manager>
+
 #include "nm-openconnect-service.h"
 
+#include <algorithm>
 #include <cstdarg>
 
 extern "C"
@@ -69,6 +86,9 @@ extern "C"
     static int updateToken(void*, const char*);
 #endif
 
+// Measured host rankings are reused for a day
+#define HOST_RANKING_MAX_AGE (24 * 60 * 60)
+
 // name/address: IP/domain name of the host (OpenConnect accepts both, so no difference here)
 // group: user group on the server
 typedef struct {
@@ -97,14 +117,30 @@ public:
     bool userQuit;
     bool formGroupChanged;
     int cancelPipes[2];
-    QList<QPair<QString, int> > serverLog;
+    OpenconnectLogModel serverLog;
+    QTimer logTimer;
+    OpenconnectGatewayProber prober;
+    bool connectWhenProbed = false;
     int passwordFormIndex;
     QByteArray tokenMode;
     Token token;
-
-    enum LogLevels {Error = 0, Info, Debug, Trace};
 };
 
+// openconnect takes "http://", "https://" and "socks://" proxy URLs, an
+// address without a scheme is an HTTP proxy
+static QNetworkProxy proxyFromUrl(const QString &proxy)
+{
+    const QUrl url(proxy.contains(QLatin1String("://")) ? proxy : QStringLiteral("http://") + proxy);
+    if (url.host().isEmpty()) {
+        return QNetworkProxy(QNetworkProxy::NoProxy);
+    }
+
+    const bool socks = url.scheme().startsWith(QLatin1String("socks"), Qt::CaseInsensitive);
+    return QNetworkProxy(socks ? QNetworkProxy::Socks5Proxy : QNetworkProxy::HttpProxy,
+                         url.host(), url.port(socks ? 1080 : 80),
+                         url.userName(), url.password());
+}
+
 
 OpenconnectAuthWidget::OpenconnectAuthWidget(const NetworkManager::VpnSetting::Ptr &setting, QWidget * parent)
     : SettingWidget(setting, parent)
@@ -122,6 +158,12 @@ OpenconnectAuthWidget::OpenconnectAuthWidget(const NetworkManager::VpnSetting::P
         d->cancelPipes[1] = -1;
     }
 
+    d->worker = new OpenconnectAuthWorkerThread(&d->mutex, &d->workerWaiting, &d->userQuit, &d->formGroupChanged, d->cancelPipes[0]);
+
+    // gets the pointer to struct openconnect_info (defined in openconnect.h), which contains data that OpenConnect needs,
+    // and which needs to be populated with settings we get from NM, like host, certificate or private key
+    d->vpninfo = d->worker->getOpenconnectInfo();
+
 #if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
     connect(d->ui.cmbLogLevel, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &OpenconnectAuthWidget::logLevelChanged);
 #else
@@ -130,19 +172,50 @@ OpenconnectAuthWidget::OpenconnectAuthWidget(const NetworkManager::VpnSetting::P
     connect(d->ui.viewServerLog, &QCheckBox::toggled, this, &OpenconnectAuthWidget::viewServerLogToggled);
     connect(d->ui.btnConnect, &QPushButton::clicked, this, &OpenconnectAuthWidget::connectHost);
 
-    d->ui.cmbLogLevel->setCurrentIndex(OpenconnectAuthWidgetPrivate::Debug);
+    // Only the visible lines of the log are rendered
+    d->ui.serverLog->setModel(&d->serverLog);
+    QAction *copyLogAction = new QAction(QIcon::fromTheme(QStringLiteral("edit-copy")), i18n("Copy"), d->ui.serverLog);
+    copyLogAction->setShortcut(QKeySequence::Copy);
+    copyLogAction->setShortcutContext(Qt::WidgetShortcut);
+    connect(copyLogAction, &QAction::triggered, this, [d] () {
+        QModelIndexList indexes = d->ui.serverLog->selectionModel()->selectedRows();
+        std::sort(indexes.begin(), indexes.end());
+        QStringList lines;
+        for (const QModelIndex &index : qAsConst(indexes)) {
+            lines << index.data().toString();
+        }
+        QGuiApplication::clipboard()->setText(lines.join(QLatin1Char('\n')));
+    });
+    d->ui.serverLog->addAction(copyLogAction);
+    d->ui.serverLog->setContextMenuPolicy(Qt::ActionsContextMenu);
+
+    d->ui.cmbLogLevel->setCurrentIndex(OpenconnectLogModel::Debug);
     d->ui.btnConnect->setIcon(QIcon::fromTheme("network-connect"));
     d->ui.viewServerLog->setChecked(false);
-
-    d->worker = new OpenconnectAuthWorkerThread(&d->mutex, &d->workerWaiting, &d->userQuit, &d->formGroupChanged, d->cancelPipes[0]);
-
-    // gets the pointer to struct openconnect_info (defined in openconnect.h), which contains data that OpenConnect needs,
-    // and which needs to be populated with settings we get from NM, like host, certificate or private key
-    d->vpninfo = d->worker->getOpenconnectInfo();
+    d->worker->setLogLevel(d->ui.cmbLogLevel->currentIndex());
+
+    // The worker queues its log messages, show them in batches instead of one by one
+    d->logTimer.setInterval(100);
+    connect(&d->logTimer, &QTimer::timeout, this, &OpenconnectAuthWidget::updateLog);
+    connect(&d->prober, &OpenconnectGatewayProber::finished, this, &OpenconnectAuthWidget::hostsProbed);
+    connect(d->ui.chkFastestHost, &QCheckBox::toggled, this, [d, this] (bool checked) {
+        if (checked) {
+            selectFastestHost();
+        } else if (d->prober.isRunning()) {
+            d->prober.abort();
+            if (d->connectWhenProbed) {
+                d->connectWhenProbed = false;
+                connectHost();
+            }
+        }
+    });
 
     connect(d->worker, QOverload<const QString &, const QString &, const QString &, bool*>::of(&OpenconnectAuthWorkerThread::validatePeerCert), this, &OpenconnectAuthWidget::validatePeerCert);
     connect(d->worker, &OpenconnectAuthWorkerThread::processAuthForm, this, &OpenconnectAuthWidget::processAuthForm);
-    connect(d->worker, &OpenconnectAuthWorkerThread::updateLog, this, &OpenconnectAuthWidget::updateLog);
+    connect(d->worker, &QThread::finished, this, [d, this] () {
+        updateLog();
+        d->logTimer.stop();
+    });
     connect(d->worker, QOverload<const QString&>::of(&OpenconnectAuthWorkerThread::writeNewConfig), this, &OpenconnectAuthWidget::writeNewConfig);
     connect(d->worker, &OpenconnectAuthWorkerThread::cookieObtained, this, &OpenconnectAuthWidget::workerFinished);
     connect(d->worker, &OpenconnectAuthWorkerThread::initTokens, this, &OpenconnectAuthWidget::initTokens);
@@ -214,6 +287,8 @@ void OpenconnectAuthWidget::readConfig()
     if (!dataMap[NM_OPENCONNECT_KEY_PROXY].isEmpty()) {
         const QByteArray proxy = QFile::encodeName(dataMap[NM_OPENCONNECT_KEY_PROXY]);
         openconnect_set_http_proxy(d->vpninfo, OC3DUP(proxy.data()));
+        // Probe the gateways the way openconnect is going to reach them
+        d->prober.setProxy(proxyFromUrl(dataMap[NM_OPENCONNECT_KEY_PROXY]));
     }
     if (!dataMap[NM_OPENCONNECT_KEY_USERCERT].isEmpty()) {
         const QByteArray crt = QFile::encodeName(dataMap[NM_OPENCONNECT_KEY_USERCERT]);
@@ -274,9 +349,19 @@ void OpenconnectAuthWidget::readSecrets()
         }
     }
 
+    if (d->secrets["fastest_host"] == "yes") {
+        // Probes the gateways through the toggled() connection
+        d->ui.chkFastestHost->setChecked(true);
+    }
+
     if (d->secrets["autoconnect"] == "yes") {
         d->ui.chkAutoconnect->setChecked(true);
-        QTimer::singleShot(0, this, &OpenconnectAuthWidget::connectHost);
+        // Connect to the fastest host once it's known
+        if (d->prober.isRunning()) {
+            d->connectWhenProbed = true;
+        } else {
+            QTimer::singleShot(0, this, &OpenconnectAuthWidget::connectHost);
+        }
     }
 
     if (d->secrets["save_passwords"] == "yes") {
@@ -318,6 +403,87 @@ void OpenconnectAuthWidget::readSecrets()
     }
 }
 
+static KConfigGroup hostRankingGroup(KConfig *config, const NetworkManager::VpnSetting::Ptr &setting)
+{
+    // The ranking depends on where we are, so it's kept per network we're connected to
+    const NetworkManager::ActiveConnection::Ptr primaryConnection = NetworkManager::primaryConnection();
+    const QString network = primaryConnection ? primaryConnection->uuid() : QStringLiteral("none");
+    KConfigGroup networkGroup(config, network);
+    return KConfigGroup(&networkGroup, setting->data().value(QLatin1String(NM_OPENCONNECT_KEY_GATEWAY)));
+}
+
+void OpenconnectAuthWidget::selectFastestHost()
+{
+    Q_D(OpenconnectAuthWidget);
+
+    if (d->hosts.size() < 2) {
+        return;
+    }
+
+    KConfig config(QStringLiteral("plasma-nm-openconnect"), KConfig::SimpleConfig, QStandardPaths::GenericCacheLocation);
+    const KConfigGroup group = hostRankingGroup(&config, d->setting);
+    const QStringList ranking = group.readEntry("Ranking", QStringList());
+    const QDateTime time = group.readEntry("Time", QDateTime());
+
+    if (!ranking.isEmpty()) {
+        preselectHost(ranking.first());
+        if (time.isValid() && time.secsTo(QDateTime::currentDateTime()) < HOST_RANKING_MAX_AGE) {
+            return;
+        }
+    }
+
+    QStringList addresses;
+    for (const VPNHost &host : qAsConst(d->hosts)) {
+        addresses << host.address;
+    }
+    d->prober.probe(addresses);
+}
+
+void OpenconnectAuthWidget::hostsProbed()
+{
+    Q_D(OpenconnectAuthWidget);
+
+    QStringList ranking;
+    const QVector<OpenconnectGatewayProber::Result> results = d->prober.results();
+    for (const OpenconnectGatewayProber::Result &result : results) {
+        qCDebug(PLASMA_NM) << "VPN host" << result.address << "latency" << result.latency;
+        if (result.latency >= 0) {
+            ranking << result.address;
+        }
+    }
+
+    if (!ranking.isEmpty()) {
+        KConfig config(QStringLiteral("plasma-nm-openconnect"), KConfig::SimpleConfig, QStandardPaths::GenericCacheLocation);
+        KConfigGroup group = hostRankingGroup(&config, d->setting);
+        group.writeEntry("Ranking", ranking);
+        group.writeEntry("Time", QDateTime::currentDateTime());
+
+        // Don't switch the host under the user's hands
+        if (!d->worker->isRunning()) {
+            preselectHost(ranking.first());
+        }
+    }
+
+    if (d->connectWhenProbed) {
+        d->connectWhenProbed = false;
+        connectHost();
+    }
+}
+
+void OpenconnectAuthWidget::preselectHost(const QString &address)
+{
+    Q_D(OpenconnectAuthWidget);
+
+    for (int i = 0; i < d->hosts.size(); i++) {
+        if (d->hosts.at(i).address == address) {
+            // Selecting a host connects to it, this is only a suggestion
+            const QSignalBlocker blocker(d->ui.cmbHosts);
+            d->ui.cmbHosts->setCurrentIndex(d->ui.cmbHosts->findData(i));
+            return;
+        }
+    }
+}
+
 void OpenconnectAuthWidget::acceptDialog()
 {
     // Find top-level widget as this should be the QDialog itself
@@ -338,6 +504,7 @@ void OpenconnectAuthWidget::connectHost()
 {
     Q_D(OpenconnectAuthWidget);
 
+    d->connectWhenProbed = false;
     d->userQuit = true;
     if (write(d->cancelPipes[1], "x", 1)) {
         // not a lot we can do
@@ -367,6 +534,7 @@ void OpenconnectAuthWidget::connectHost()
     }
     d->secrets["lasthost"] = host.name;
     addFormInfo(QLatin1String("dialog-information"), i18n("Contacting host, please wait..."));
+    d->logTimer.start();
     d->worker->start();
 }
 
@@ -404,6 +572,7 @@ QVariantMap OpenconnectAuthWidget::setting() const
     secrets.insert(QLatin1String(NM_OPENCONNECT_KEY_GWCERT), QLatin1String(fingerprint));
     secrets.insert(QLatin1String("autoconnect"), d->ui.chkAutoconnect->isChecked() ? "yes" : "no");
     secrets.insert(QLatin1String("save_passwords"), d->ui.chkStorePasswords->isChecked() ? "yes" : "no");
+    secrets.insert(QLatin1String("fastest_host"), d->ui.chkFastestHost->isChecked() ? "yes" : "no");
 
     NMStringMap::iterator i = secrets.begin();
     while (i != secrets.end()) {
@@ -439,51 +608,61 @@ void OpenconnectAuthWidget::writeNewConfig(const QString & buf)
     d->secrets["xmlconfig"] = buf;
 }
 
-void OpenconnectAuthWidget::updateLog(const QString &message, const int &level)
+void OpenconnectAuthWidget::updateLog()
 {
     Q_D(OpenconnectAuthWidget);
 
-    QPair<QString, int> pair;
-    pair.first = message;
-    if (pair.first.endsWith(QLatin1String("\n"))) {
-        pair.first.chop(1);
-    }
-    switch (level) {
-    case PRG_ERR:
-        pair.second = OpenconnectAuthWidgetPrivate::Error;
-        break;
-    case PRG_INFO:
-        pair.second = OpenconnectAuthWidgetPrivate::Info;
-        break;
-    case PRG_DEBUG:
-        pair.second = OpenconnectAuthWidgetPrivate::Debug;
-        break;
-    case PRG_TRACE:
-        pair.second = OpenconnectAuthWidgetPrivate::Trace;
-        break;
-    }
-    if (pair.second <= d->ui.cmbLogLevel->currentIndex()) {
-        d->ui.serverLog->append(pair.first);
-    }
-
-    d->serverLog.append(pair);
-    if (d->serverLog.size() > 100) {
-        d->serverLog.removeFirst();
+    QVector<OpenconnectLogQueue::Entry> entries;
+    const int dropped = d->worker->takeLog(entries);
+    if (dropped) {
+        entries.append({i18np("1 log message was dropped", "%1 log messages were dropped", dropped), PRG_INFO});
+    }
+
+    if (entries.isEmpty()) {
+        return;
+    }
+
+    QVector<OpenconnectLogModel::Entry> logEntries;
+    logEntries.reserve(entries.size());
+    for (const OpenconnectLogQueue::Entry &entry : qAsConst(entries)) {
+        OpenconnectLogModel::Entry logEntry;
+        logEntry.message = entry.message;
+        if (logEntry.message.endsWith(QLatin1String("\n"))) {
+            logEntry.message.chop(1);
+        }
+        switch (entry.level) {
+        case PRG_ERR:
+            logEntry.level = OpenconnectLogModel::Error;
+            break;
+        case PRG_INFO:
+            logEntry.level = OpenconnectLogModel::Info;
+            break;
+        case PRG_DEBUG:
+            logEntry.level = OpenconnectLogModel::Debug;
+            break;
+        default:
+            logEntry.level = OpenconnectLogModel::Trace;
+            break;
+        }
+        logEntries.append(logEntry);
+    }
+
+    // Keep following the log unless the user has scrolled up
+    QScrollBar *scrollBar = d->ui.serverLog->verticalScrollBar();
+    const bool atBottom = scrollBar->value() == scrollBar->maximum();
+    d->serverLog.append(logEntries);
+    if (atBottom) {
+        d->ui.serverLog->scrollToBottom();
     }
 }
 
 void OpenconnectAuthWidget::logLevelChanged(int newLevel)
 {
     Q_D(OpenconnectAuthWidget);
-    d->ui.serverLog->clear();
-    QList<QPair<QString, int> >::const_iterator i;
-
-    for (i = d->serverLog.constBegin(); i != d->serverLog.constEnd(); ++i) {
-        QPair<QString, int> pair = *i;
-        if(pair.second <= newLevel) {
-            d->ui.serverLog->append(pair.first);
-        }
-    }
+    // The log levels of the combo box are the PRG_* levels of libopenconnect
+    d->worker->setLogLevel(newLevel);
+    d->serverLog.setMaximumLevel(newLevel);
+    d->ui.serverLog->scrollToBottom();
 }
 
 void OpenconnectAuthWidget::addFormInfo(const QString &iconName, const QString &message)
@@ -740,16 +919,11 @@ void OpenconnectAuthWidget::workerFinished(const int &ret)
 {
     Q_D(OpenconnectAuthWidget);
 
+    // The error message is looked up in the log, make sure it's complete
+    updateLog();
+
     if (ret < 0) {
-        QString message;
-        QList<QPair<QString, int> >::const_iterator i;
-        for (i = d->serverLog.constEnd()-1; i >= d->serverLog.constBegin(); --i) {
-            QPair<QString, int> pair = *i;
-            if(pair.second <= OpenconnectAuthWidgetPrivate::Error) {
-                message = pair.first;
-                break;
-            }
-        }
+        QString message = d->serverLog.lastMessage(OpenconnectLogModel::Error);
         if (message.isEmpty()) {
             message = i18n("Connection attempt was unsuccessful.");
         }
@@ -781,7 +955,7 @@ void OpenconnectAuthWidget::viewServerLogToggled(bool toggled)
     d->ui.lblLogLevel->setVisible(toggled);
     d->ui.cmbLogLevel->setVisible(toggled);
     if (toggled) {
-        delete d->ui.verticalLayout->takeAt(5);
+        delete d->ui.verticalLayout->takeAt(d->ui.verticalLayout->count() - 1);
         QSizePolicy policy = d->ui.serverLogBox->sizePolicy();
         policy.setVerticalPolicy(QSizePolicy::Expanding);
         d->ui.serverLogBox->setSizePolicy(policy);
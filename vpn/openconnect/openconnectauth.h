@@ -50,12 +50,14 @@ private:
     void acceptDialog();
     void addFormInfo(const QString &, const QString &);
     void deleteAllFromLayout(QLayout *);
+    void selectFastestHost();
+    void preselectHost(const QString &address);
 
 private Q_SLOTS:
     void writeNewConfig(const QString &);
     void validatePeerCert(const QString &, const QString &, const QString &, bool*);
     void processAuthForm(struct oc_auth_form *);
-    void updateLog(const QString &, const int &);
+    void updateLog();
     void logLevelChanged(int);
     void formLoginClicked();
     void formGroupChanged();
@@ -63,6 +65,7 @@ private Q_SLOTS:
     void viewServerLogToggled(bool);
     void connectHost();
     void initTokens();
+    void hostsProbed();
 };
 
 #endif // OPENCONNECTAUTH_H
@@ -93,6 +93,7 @@ OpenconnectAuthWorkerThread::OpenconnectAuthWorkerThread(QMutex *mutex, QWaitCon
     , m_waitForUserInput(waitForUserInput)
     , m_userDecidedToQuit(userDecidedToQuit)
     , m_formGroupChanged(formGroupChanged)
+    , m_logLevel(PRG_TRACE)
 {
     m_openconnectInfo = openconnect_vpninfo_new((char*)"OpenConnect VPN Agent (PlasmaNM - running on KDE)",
                                                 OpenconnectAuthStaticWrapper::validatePeerCert,
@@ -129,6 +130,16 @@ struct openconnect_info* OpenconnectAuthWorkerThread::getOpenconnectInfo()
     return m_openconnectInfo;
 }
 
+void OpenconnectAuthWorkerThread::setLogLevel(int level)
+{
+    m_logLevel.storeRelease(level);
+}
+
+int OpenconnectAuthWorkerThread::takeLog(QVector<OpenconnectLogQueue::Entry> &entries)
+{
+    return m_log.takeAll(entries);
+}
+
 int OpenconnectAuthWorkerThread::writeNewConfig(const char *buf, int buflen)
 {
     Q_UNUSED(buflen)
@@ -226,9 +237,9 @@ int OpenconnectAuthWorkerThread::processAuthFormP(struct oc_auth_form *form)
 
 void OpenconnectAuthWorkerThread::writeProgress(int level, const char *fmt, va_list argPtr)
 {
-    if (*m_userDecidedToQuit) {
+    if (*m_userDecidedToQuit || level > m_logLevel.loadAcquire()) {
         return;
     }
-    const QString msg = QString::vasprintf(fmt, argPtr);
-    Q_EMIT updateLog(msg, level);
+    // The widget picks the messages up in batches, see OpenconnectAuthWidget::updateLog()
+    m_log.push(QString::vasprintf(fmt, argPtr), level);
 }
@@ -70,6 +70,8 @@ struct x509_st;
 #define OC3DUP(x)			strdup(x)
 #endif
 
+#include "openconnectlogqueue.h"
+
 #include <QThread>
 
 class QMutex;
@@ -84,11 +86,14 @@ public:
     OpenconnectAuthWorkerThread(QMutex *, QWaitCondition *, bool *, bool *, int);
     ~OpenconnectAuthWorkerThread() override;
     struct openconnect_info* getOpenconnectInfo();
+    // Messages above this PRG_* level are dropped before being formatted
+    void setLogLevel(int level);
+    // Move the log messages written so far to entries, returns the number of dropped ones
+    int takeLog(QVector<OpenconnectLogQueue::Entry> &entries);
 
 Q_SIGNALS:
     void validatePeerCert(const QString &, const QString &, const QString &, bool*);
     void processAuthForm(struct oc_auth_form *);
-    void updateLog(const QString &, const int&);
     void writeNewConfig(const QString &);
     void cookieObtained(const int&);
     void initTokens(void);
@@ -106,6 +111,8 @@ private:
     bool *m_userDecidedToQuit;
     bool *m_formGroupChanged;
     struct openconnect_info *m_openconnectInfo;
+    OpenconnectLogQueue m_log;
+    QAtomicInt m_logLevel;
 };
 
 #endif
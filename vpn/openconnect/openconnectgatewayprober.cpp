@@ -0,0 +1,198 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "openconnectgatewayprober.h"
+
+#include <QSslSocket>
+
+#include <algorithm>
+
+namespace
+{
+
+// Accepts "host", "host:port", "[ipv6]:port" and any of them with a scheme
+// in front and a path behind
+bool parseAddress(const QString &address, QString *host, quint16 *port)
+{
+    QString hostPort = address.trimmed();
+    const int scheme = hostPort.indexOf(QLatin1String("://"));
+    if (scheme >= 0) {
+        hostPort = hostPort.mid(scheme + 3);
+    }
+    hostPort = hostPort.left(hostPort.indexOf(QLatin1Char('/')));
+
+    int colon = -1;
+    if (hostPort.startsWith(QLatin1Char('['))) {
+        const int end = hostPort.indexOf(QLatin1Char(']'));
+        if (end < 0) {
+            return false;
+        }
+        *host = hostPort.mid(1, end - 1);
+        if (end + 1 < hostPort.size()) {
+            if (hostPort.at(end + 1) != QLatin1Char(':')) {
+                return false;
+            }
+            colon = end + 1;
+        }
+    } else {
+        // More than one colon is a bare IPv6 address without a port
+        if (hostPort.count(QLatin1Char(':')) == 1) {
+            colon = hostPort.indexOf(QLatin1Char(':'));
+        }
+        *host = colon >= 0 ? hostPort.left(colon) : hostPort;
+    }
+
+    *port = 443;
+    if (colon >= 0) {
+        bool ok = false;
+        const uint value = hostPort.midRef(colon + 1).toUInt(&ok);
+        if (!ok || value == 0 || value > 65535) {
+            return false;
+        }
+        *port = value;
+    }
+
+    return !host->isEmpty();
+}
+
+}
+
+OpenconnectGatewayProber::OpenconnectGatewayProber(QObject *parent)
+    : QObject(parent)
+{
+    m_timeoutTimer.setSingleShot(true);
+    m_timeoutTimer.setInterval(5000);
+    connect(&m_timeoutTimer, &QTimer::timeout, this, [this] () {
+        for (int i = 0; i < m_sockets.size(); ++i) {
+            probeFinished(i, -1);
+        }
+    });
+}
+
+OpenconnectGatewayProber::~OpenconnectGatewayProber()
+{
+    abort();
+}
+
+void OpenconnectGatewayProber::setTimeout(int msecs)
+{
+    m_timeoutTimer.setInterval(msecs);
+}
+
+void OpenconnectGatewayProber::setProxy(const QNetworkProxy &proxy)
+{
+    m_proxy = proxy;
+}
+
+void OpenconnectGatewayProber::probe(const QStringList &addresses)
+{
+    abort();
+
+    m_results.clear();
+    m_sockets.fill(nullptr, addresses.size());
+    m_elapsed.start();
+
+    for (int i = 0; i < addresses.size(); ++i) {
+        m_results.append({addresses.at(i), -1});
+
+        QString host;
+        quint16 port;
+        if (!parseAddress(addresses.at(i), &host, &port)) {
+            continue;
+        }
+
+        // Only the latency matters, openconnect verifies the certificate itself later on
+        QSslSocket *socket = new QSslSocket(this);
+        socket->setProxy(m_proxy);
+        socket->setPeerVerifyMode(QSslSocket::VerifyNone);
+        connect(socket, &QSslSocket::encrypted, this, [this, i] () {
+            probeFinished(i, m_elapsed.elapsed());
+        });
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+        connect(socket, QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::error), this, [this, i] () {
+#else
+        connect(socket, &QAbstractSocket::errorOccurred, this, [this, i] () {
+#endif
+            probeFinished(i, -1);
+        });
+
+        m_sockets[i] = socket;
+        ++m_pending;
+        socket->connectToHostEncrypted(host, port);
+    }
+
+    if (m_pending) {
+        m_timeoutTimer.start();
+    } else {
+        // Stay asynchronous, the caller might not be connected to finished() yet
+        QTimer::singleShot(0, this, &OpenconnectGatewayProber::finished);
+    }
+}
+
+void OpenconnectGatewayProber::abort()
+{
+    m_timeoutTimer.stop();
+    for (QSslSocket *socket : qAsConst(m_sockets)) {
+        if (socket) {
+            socket->disconnect(this);
+            socket->abort();
+            socket->deleteLater();
+        }
+    }
+    m_sockets.clear();
+    m_pending = 0;
+}
+
+bool OpenconnectGatewayProber::isRunning() const
+{
+    return m_pending > 0;
+}
+
+QVector<OpenconnectGatewayProber::Result> OpenconnectGatewayProber::results() const
+{
+    QVector<Result> results = m_results;
+    std::stable_sort(results.begin(), results.end(), [] (const Result &left, const Result &right) {
+        if (left.latency < 0 || right.latency < 0) {
+            return left.latency >= 0 && right.latency < 0;
+        }
+        return left.latency < right.latency;
+    });
+    return results;
+}
+
+void OpenconnectGatewayProber::probeFinished(int index, int latency)
+{
+    QSslSocket *socket = m_sockets.at(index);
+    if (!socket) {
+        return;
+    }
+
+    socket->disconnect(this);
+    socket->abort();
+    socket->deleteLater();
+    m_sockets[index] = nullptr;
+    m_results[index].latency = latency;
+
+    if (--m_pending == 0) {
+        m_timeoutTimer.stop();
+        Q_EMIT finished();
+    }
+}
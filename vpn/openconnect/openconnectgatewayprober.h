@@ -0,0 +1,81 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OPENCONNECTGATEWAYPROBER_H
+#define OPENCONNECTGATEWAYPROBER_H
+
+#include <QElapsedTimer>
+#include <QNetworkProxy>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+class QSslSocket;
+
+/**
+ * Measures how long the TCP and TLS handshakes with each of a list of gateways
+ * take, all of them at the same time, and ranks the gateways by that latency.
+ * Certificates are not verified here, openconnect does that when connecting.
+ */
+class OpenconnectGatewayProber : public QObject
+{
+    Q_OBJECT
+public:
+    struct Result {
+        QString address;
+        // Handshake time in milliseconds, -1 if the gateway couldn't be reached
+        int latency;
+    };
+
+    explicit OpenconnectGatewayProber(QObject *parent = nullptr);
+    ~OpenconnectGatewayProber() override;
+
+    // Gateways which don't complete the handshake within msecs count as unreachable
+    void setTimeout(int msecs);
+
+    // Gateways are reached directly unless a proxy is set
+    void setProxy(const QNetworkProxy &proxy);
+
+    // Addresses are given the way they are in the gateway list, with an optional
+    // scheme, port and path; the port defaults to 443
+    void probe(const QStringList &addresses);
+    void abort();
+    bool isRunning() const;
+
+    // Fastest gateway first, unreachable ones last in their original order
+    QVector<Result> results() const;
+
+Q_SIGNALS:
+    void finished();
+
+private:
+    void probeFinished(int index, int latency);
+
+    QVector<Result> m_results;
+    QVector<QSslSocket *> m_sockets;
+    QElapsedTimer m_elapsed;
+    QTimer m_timeoutTimer;
+    QNetworkProxy m_proxy = QNetworkProxy(QNetworkProxy::NoProxy);
+    int m_pending = 0;
+};
+
+#endif // OPENCONNECTGATEWAYPROBER_H
@@ -0,0 +1,188 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "openconnectlogmodel.h"
+
+OpenconnectLogModel::OpenconnectLogModel(int capacity, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_entries(qMax(capacity, 1))
+{
+    for (Rows &rows : m_rows) {
+        rows.sequences.resize(m_entries.size());
+    }
+}
+
+int OpenconnectLogModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_rows[m_level].count;
+}
+
+QVariant OpenconnectLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return QVariant();
+    }
+
+    const Entry &logEntry = entry(rowSequence(m_rows[m_level], index.row()));
+    switch (role) {
+    case Qt::DisplayRole:
+        return logEntry.message;
+    case LevelRole:
+        return logEntry.level;
+    default:
+        break;
+    }
+
+    return QVariant();
+}
+
+QHash<int, QByteArray> OpenconnectLogModel::roleNames() const
+{
+    QHash<int, QByteArray> roles = QAbstractListModel::roleNames();
+    roles[LevelRole] = "Level";
+    return roles;
+}
+
+int OpenconnectLogModel::capacity() const
+{
+    return m_entries.size();
+}
+
+int OpenconnectLogModel::maximumLevel() const
+{
+    return m_level;
+}
+
+void OpenconnectLogModel::setMaximumLevel(int level)
+{
+    level = qBound<int>(Error, level, Trace);
+    if (level == m_level) {
+        return;
+    }
+
+    // The rows of the level are ready, the view only needs to fetch the visible ones again
+    beginResetModel();
+    m_level = level;
+    endResetModel();
+}
+
+void OpenconnectLogModel::append(const QString &message, int level)
+{
+    append(QVector<Entry>{{message, level}});
+}
+
+void OpenconnectLogModel::append(const QVector<Entry> &entries)
+{
+    const int capacity = m_entries.size();
+    // Messages which would be dropped right away are skipped
+    const int skipped = qMax(entries.size() - capacity, 0);
+    const int added = entries.size() - skipped;
+    if (!added) {
+        return;
+    }
+
+    // Drop the oldest messages to make room
+    const int dropped = qMax(m_count + added - capacity, 0);
+    if (dropped) {
+        const quint64 oldest = m_next - m_count;
+        int droppedRows = 0;
+        for (int i = 0; i < dropped; ++i) {
+            if (entry(oldest + i).level <= m_level) {
+                ++droppedRows;
+            }
+        }
+
+        if (droppedRows) {
+            beginRemoveRows(QModelIndex(), 0, droppedRows - 1);
+        }
+        for (Rows &rows : m_rows) {
+            while (rows.count && rowSequence(rows, 0) < oldest + dropped) {
+                rows.first = (rows.first + 1) % capacity;
+                --rows.count;
+            }
+        }
+        m_count -= dropped;
+        if (droppedRows) {
+            endRemoveRows();
+        }
+    }
+
+    int addedRows = 0;
+    for (int i = skipped; i < entries.size(); ++i) {
+        if (entries.at(i).level <= m_level) {
+            ++addedRows;
+        }
+    }
+
+    if (addedRows) {
+        beginInsertRows(QModelIndex(), rowCount(), rowCount() + addedRows - 1);
+    }
+    for (int i = skipped; i < entries.size(); ++i) {
+        const Entry &newEntry = entries.at(i);
+        m_entries[int(m_next % capacity)] = newEntry;
+        for (int level = qMax<int>(newEntry.level, Error); level <= Trace; ++level) {
+            Rows &rows = m_rows[level];
+            rows.sequences[(rows.first + rows.count) % capacity] = m_next;
+            ++rows.count;
+        }
+        ++m_next;
+        ++m_count;
+    }
+    if (addedRows) {
+        endInsertRows();
+    }
+}
+
+void OpenconnectLogModel::clear()
+{
+    beginResetModel();
+    for (int i = 0; i < m_count; ++i) {
+        m_entries[int((m_next - m_count + i) % m_entries.size())].message.clear();
+    }
+    m_count = 0;
+    for (Rows &rows : m_rows) {
+        rows.first = 0;
+        rows.count = 0;
+    }
+    endResetModel();
+}
+
+QString OpenconnectLogModel::lastMessage(int level) const
+{
+    const Rows &rows = m_rows[qBound<int>(Error, level, Trace)];
+    if (!rows.count) {
+        return QString();
+    }
+    return entry(rowSequence(rows, rows.count - 1)).message;
+}
+
+const OpenconnectLogModel::Entry &OpenconnectLogModel::entry(quint64 sequence) const
+{
+    return m_entries.at(int(sequence % m_entries.size()));
+}
+
+quint64 OpenconnectLogModel::rowSequence(const Rows &rows, int row) const
+{
+    return rows.sequences.at((rows.first + row) % rows.sequences.size());
+}
@@ -0,0 +1,86 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OPENCONNECTLOGMODEL_H
+#define OPENCONNECTLOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QString>
+#include <QVector>
+
+/**
+ * The last messages of the openconnect server log, kept in a ring buffer of
+ * fixed capacity so the memory use doesn't grow during long reconnect loops.
+ * Only the messages up to the maximum level are shown. The rows of each level
+ * are indexed while the messages are added, changing the level doesn't need to
+ * look at the messages at all.
+ */
+class OpenconnectLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    // The log levels shown in the auth widget, less verbose levels come first
+    enum Level {Error = 0, Info, Debug, Trace};
+    enum Roles {LevelRole = Qt::UserRole + 1};
+
+    struct Entry {
+        QString message;
+        int level;
+    };
+
+    explicit OpenconnectLogModel(int capacity = 1000, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int capacity() const;
+    int maximumLevel() const;
+    void setMaximumLevel(int level);
+
+    void append(const QString &message, int level);
+    // Appends all the entries at once, the oldest messages are dropped when there are too many
+    void append(const QVector<Entry> &entries);
+    void clear();
+
+    // The most recent message of the given level or a less verbose one
+    QString lastMessage(int level) const;
+
+private:
+    // Sequence numbers of the messages shown at a level, a ring buffer as well
+    struct Rows {
+        QVector<quint64> sequences;
+        int first = 0;
+        int count = 0;
+    };
+
+    const Entry &entry(quint64 sequence) const;
+    quint64 rowSequence(const Rows &rows, int row) const;
+
+    QVector<Entry> m_entries;
+    // Sequence number of the next message, message n is stored at n % capacity
+    quint64 m_next = 0;
+    int m_count = 0;
+    Rows m_rows[Trace + 1];
+    int m_level = Debug;
+};
+
+#endif // OPENCONNECTLOGMODEL_H
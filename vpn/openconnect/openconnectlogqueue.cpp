@@ -0,0 +1,69 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "openconnectlogqueue.h"
+
+OpenconnectLogQueue::OpenconnectLogQueue(int capacity)
+    : m_head(0)
+    , m_tail(0)
+    , m_dropped(0)
+{
+    int size = 1;
+    while (size < capacity) {
+        size *= 2;
+    }
+    m_entries.resize(size);
+    m_mask = size - 1;
+}
+
+bool OpenconnectLogQueue::push(const QString &message, int level)
+{
+    const uint head = m_head.loadAcquire();
+    if (head - m_tail.loadAcquire() > m_mask) {
+        m_dropped.fetchAndAddRelaxed(1);
+        return false;
+    }
+
+    Entry &entry = m_entries[head & m_mask];
+    entry.message = message;
+    entry.level = level;
+    // Publish the entry only once it has been written
+    m_head.storeRelease(head + 1);
+    return true;
+}
+
+int OpenconnectLogQueue::takeAll(QVector<Entry> &entries)
+{
+    const uint head = m_head.loadAcquire();
+    uint tail = m_tail.loadAcquire();
+
+    entries.reserve(entries.size() + int(head - tail));
+    for (; tail != head; ++tail) {
+        Entry &entry = m_entries[tail & m_mask];
+        entries.append({entry.message, entry.level});
+        // Don't keep the string alive in the slot
+        entry.message.clear();
+    }
+    // Hand the slots back to the producer
+    m_tail.storeRelease(tail);
+
+    return m_dropped.fetchAndStoreRelaxed(0);
+}
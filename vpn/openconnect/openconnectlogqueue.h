@@ -0,0 +1,61 @@
+/*
+    Copyright 2020 Plasma-nm Developers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) version 3, or any
+    later version accepted by the membership of KDE e.V. (or its
+    successor approved by the membership of KDE e.V.), which shall
+    act as a proxy defined in Section 6 of version 3 of the license.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OPENCONNECTLOGQUEUE_H
+#define OPENCONNECTLOGQUEUE_H
+
+#include <QAtomicInteger>
+#include <QString>
+#include <QVector>
+
+/**
+ * Fixed size ring buffer passing log messages from the auth worker thread to
+ * the widget without locking. There must be exactly one thread pushing and one
+ * thread taking messages at a time. When the buffer is full new messages are
+ * dropped and counted instead of blocking the worker.
+ */
+class OpenconnectLogQueue
+{
+public:
+    struct Entry {
+        QString message;
+        int level;
+    };
+
+    // The capacity is rounded up to a power of two
+    explicit OpenconnectLogQueue(int capacity = 1024);
+
+    // Called from the producer thread only
+    bool push(const QString &message, int level);
+    // Called from the consumer thread only, appends the queued messages to
+    // entries and returns how many messages have been dropped since last time
+    int takeAll(QVector<Entry> &entries);
+
+private:
+    QVector<Entry> m_entries;
+    uint m_mask;
+    // Free running positions, only the producer writes m_head and only the consumer m_tail
+    QAtomicInteger<uint> m_head;
+    QAtomicInteger<uint> m_tail;
+    QAtomicInt m_dropped;
+};
+
+#endif // OPENCONNECTLOGQUEUE_H
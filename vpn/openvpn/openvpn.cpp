@@ -37,6 +37,7 @@
 
 #include "openvpnwidget.h"
 #include "openvpnauth.h"
+#include "vpnexportarchive.h"
 
 #include <arpa/inet.h>
 
@@ -151,7 +152,9 @@ bool isEncrypted(const QString &fileName)
     return encrypted;
 }
 
-OpenVpnUiPlugin::OpenVpnUiPlugin(QObject * parent, const QVariantList &) : VpnUiPlugin(parent)
+OpenVpnUiPlugin::OpenVpnUiPlugin(QObject * parent, const QVariantList &)
+    : VpnUiPlugin(parent)
+    , m_certificateStore(localCertPath())
 {
 }
 
@@ -412,7 +415,7 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
                 continue;
             }
             if (copyCertificates) {
-                const QString absoluteFilePath = tryToCopyToCertificatesDirectory(connectionName, unQuote(key_value[1], fileName));
+                const QString absoluteFilePath = tryToCopyToCertificatesDirectory(unQuote(key_value[1], fileName));
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CA), absoluteFilePath);
             } else {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CA), unQuote(key_value[1], fileName));
@@ -426,7 +429,7 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
                 continue;
             }
             if (copyCertificates) {
-                const QString absoluteFilePath = tryToCopyToCertificatesDirectory(connectionName, unQuote(key_value[1], fileName));
+                const QString absoluteFilePath = tryToCopyToCertificatesDirectory(unQuote(key_value[1], fileName));
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CERT), absoluteFilePath);
             } else {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CERT), unQuote(key_value[1], fileName));
@@ -440,7 +443,7 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
                 continue;
             }
             if (copyCertificates) {
-                const QString absoluteFilePath = tryToCopyToCertificatesDirectory(connectionName, unQuote(key_value[1], fileName));
+                const QString absoluteFilePath = tryToCopyToCertificatesDirectory(unQuote(key_value[1], fileName));
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_KEY), absoluteFilePath);
             } else {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_KEY), unQuote(key_value[1], fileName));
@@ -450,7 +453,7 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
         if (key_value[0] == SECRET_TAG && key_value.count() > 1) {
             key_value[1] = line.right(line.length() - line.indexOf(QRegExp("\\s"))); // Get whole string after key
             if (copyCertificates) {
-                const QString absoluteFilePath = tryToCopyToCertificatesDirectory(connectionName, unQuote(key_value[1], fileName));
+                const QString absoluteFilePath = tryToCopyToCertificatesDirectory(unQuote(key_value[1], fileName));
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_STATIC_KEY), absoluteFilePath);
             } else {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_STATIC_KEY), unQuote(key_value[1], fileName));
@@ -470,7 +473,7 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
             // We will copy inline certificate later when we reach <tls-auth> tag.
             if (key_value[1].trimmed() != QLatin1String("[inline]")) {
                 if (copyCertificates) {
-                    const QString absoluteFilePath = tryToCopyToCertificatesDirectory(connectionName, unQuote(key_value[1], fileName));
+                    const QString absoluteFilePath = tryToCopyToCertificatesDirectory(unQuote(key_value[1], fileName));
                     dataMap.insert(QLatin1String(NM_OPENVPN_KEY_TA), absoluteFilePath);
                 } else {
                     dataMap.insert(QLatin1String(NM_OPENVPN_KEY_TA), unQuote(key_value[1], fileName));
@@ -535,25 +538,25 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
         }
 
         if (key_value[0] == BEGIN_KEY_CA_TAG) {
-            const QString caAbsolutePath = saveFile(in, QLatin1String(END_KEY_CA_TAG), connectionName, "ca.crt");
+            const QString caAbsolutePath = saveFile(in, QLatin1String(END_KEY_CA_TAG), "crt");
             if (!caAbsolutePath.isEmpty()) {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CA), caAbsolutePath);
             }
             continue;
         } else if (key_value[0] == BEGIN_KEY_CERT_TAG) {
-            const QString certAbsolutePath = saveFile(in, QLatin1String(END_KEY_CERT_TAG), connectionName, "cert.crt");
+            const QString certAbsolutePath = saveFile(in, QLatin1String(END_KEY_CERT_TAG), "crt");
             if (!certAbsolutePath.isEmpty()) {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_CERT), certAbsolutePath);
             }
             continue;
         } else if (key_value[0] == BEGIN_KEY_KEY_TAG) {
-            const QString keyAbsolutePath = saveFile(in, QLatin1String(END_KEY_KEY_TAG), connectionName, "private.key");
+            const QString keyAbsolutePath = saveFile(in, QLatin1String(END_KEY_KEY_TAG), "key");
             if (!keyAbsolutePath.isEmpty()) {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_KEY), keyAbsolutePath);
             }
             continue;
         } else if (key_value[0] == BEGIN_KEY_SECRET_TAG) {
-            const QString secretAbsolutePath = saveFile(in, QLatin1String(END_KEY_SECRET_TAG), connectionName, "secret.key");
+            const QString secretAbsolutePath = saveFile(in, QLatin1String(END_KEY_SECRET_TAG), "key");
             if (!secretAbsolutePath.isEmpty()) {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_KEY), secretAbsolutePath);
                 have_sk = true;
@@ -564,7 +567,7 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
             }
             continue;
         } else if (key_value[0] == BEGIN_TLS_AUTH_TAG) {
-            const QString tlsAuthAbsolutePath = saveFile(in, QLatin1String(END_TLS_AUTH_TAG), connectionName, "tls_auth.key");
+            const QString tlsAuthAbsolutePath = saveFile(in, QLatin1String(END_TLS_AUTH_TAG), "key");
             if (!tlsAuthAbsolutePath.isEmpty()) {
                 dataMap.insert(QLatin1String(NM_OPENVPN_KEY_TA), tlsAuthAbsolutePath);
 
@@ -664,19 +667,9 @@ NMVariantMapMap OpenVpnUiPlugin::importConnectionSettings(const QString &fileNam
     return result;
 }
 
-QString OpenVpnUiPlugin::saveFile(QTextStream &in, const QString &endTag, const QString &connectionName, const QString &fileName)
+QString OpenVpnUiPlugin::saveFile(QTextStream &in, const QString &endTag, const QString &suffix)
 {
-    const QString certificatesDirectory = localCertPath() + connectionName;
-    const QString absoluteFilePath = certificatesDirectory + '/' + fileName;
-    QFile outFile(absoluteFilePath);
-
-    QDir().mkpath(certificatesDirectory);
-    if (!outFile.open(QFile::WriteOnly | QFile::Text)) {
-        KMessageBox::information(nullptr, i18n("Error saving file %1: %2", absoluteFilePath, outFile.errorString()));
-        return QString();
-    }
-
-    QTextStream out(&outFile);
+    QByteArray contents;
     while (!in.atEnd()) {
         const QString line = in.readLine();
 
@@ -684,23 +677,22 @@ QString OpenVpnUiPlugin::saveFile(QTextStream &in, const QString &endTag, const
             break;
         }
 
-        out << line << "\n";
+        contents += line.toUtf8() + '\n';
     }
 
-    outFile.close();
+    // Inline blocks shared by many profiles are stored only once
+    const QString absoluteFilePath = m_certificateStore.store(contents, suffix);
+    if (absoluteFilePath.isEmpty()) {
+        KMessageBox::information(nullptr, m_certificateStore.errorString());
+    }
     return absoluteFilePath;
 }
 
-QString OpenVpnUiPlugin::tryToCopyToCertificatesDirectory(const QString &connectionName, const QString &sourceFilePath)
+QString OpenVpnUiPlugin::tryToCopyToCertificatesDirectory(const QString &sourceFilePath)
 {
-    const QString certificatesDirectory = localCertPath();
-    const QString absoluteFilePath = certificatesDirectory + connectionName + '_' + QFileInfo(sourceFilePath).fileName();
-
-    QFile sourceFile(sourceFilePath);
-
-    QDir().mkpath(certificatesDirectory);
-    if (!sourceFile.copy(absoluteFilePath)) {
-        KMessageBox::information(nullptr, i18n("Error copying certificate to %1: %2", absoluteFilePath, sourceFile.errorString()));
+    const QString absoluteFilePath = m_certificateStore.storeFile(sourceFilePath);
+    if (absoluteFilePath.isEmpty()) {
+        KMessageBox::information(nullptr, i18n("Error copying certificate to %1: %2", m_certificateStore.directory(), m_certificateStore.errorString()));
         return sourceFilePath;
     }
 
@@ -716,6 +708,68 @@ bool OpenVpnUiPlugin::exportConnectionSettings(const NetworkManager::ConnectionS
         return false;
     }
 
+    QByteArray httpAuth;
+    expFile.write(exportedConfiguration(connection, fileName + "-httpauthfile", &httpAuth, nullptr));
+    expFile.close();
+
+    // If there is a username, need to write an authfile
+    if (!httpAuth.isEmpty()) {
+        QFile authFile(fileName + "-httpauthfile");
+        if (authFile.open(QFile::WriteOnly | QFile::Text)) {
+            authFile.write(httpAuth);
+            authFile.close();
+        }
+    }
+    return true;
+}
+
+bool OpenVpnUiPlugin::exportConnectionSettingsToArchive(const NetworkManager::ConnectionSettings::Ptr &connection, VpnExportArchive *archive)
+{
+    const QString fileName = archive->reserveFileName(suggestedFileName(connection));
+
+    QByteArray httpAuth;
+    const QByteArray configuration = exportedConfiguration(connection, fileName + "-httpauthfile", &httpAuth, archive);
+    if (!archive->writeFile(fileName, configuration) ||
+        (!httpAuth.isEmpty() && !archive->writeFile(fileName + "-httpauthfile", httpAuth))) {
+        mError = VpnUiPlugin::Error;
+        mErrorMessage = archive->errorString();
+        return false;
+    }
+
+    mError = VpnUiPlugin::NoError;
+    return true;
+}
+
+// Refers to the file at path with the tag. When exporting into an archive PEM
+// files are inlined, other files are referred to by their copy in the archive
+static QByteArray fileDirective(const char *tag, const QString &path, const QString &direction, VpnExportArchive *archive)
+{
+    if (archive) {
+        QByteArray contents = archive->fileContents(path);
+        if (contents.contains("-----BEGIN")) {
+            if (!contents.endsWith('\n')) {
+                contents += '\n';
+            }
+            QByteArray block = '<' + QByteArray(tag) + ">\n" + contents + "</" + QByteArray(tag) + ">\n";
+            if (!direction.isEmpty()) {
+                block += (QString(KEY_DIRECTION_TAG) + ' ' + direction + '\n').toLatin1();
+            }
+            return block;
+        }
+
+        const QString archivePath = archive->addSharedFile(path);
+        if (!archivePath.isEmpty()) {
+            return fileDirective(tag, archivePath, direction, nullptr);
+        }
+    }
+
+    return (QString("%1 \"%2\"").arg(tag, path) + (direction.isEmpty() ? "\n" : (' ' + direction) + '\n')).toLatin1();
+}
+
+QByteArray OpenVpnUiPlugin::exportedConfiguration(const NetworkManager::ConnectionSettings::Ptr &connection, const QString &httpAuthFileName,
+                                                  QByteArray *httpAuth, VpnExportArchive *archive) const
+{
+    QByteArray configuration;
     NMStringMap dataMap;
     NMStringMap secretData;
 
@@ -727,10 +781,10 @@ bool OpenVpnUiPlugin::exportConnectionSettings(const NetworkManager::ConnectionS
     QString cacert, user_cert, private_key;
 
     line = QString(CLIENT_TAG) + '\n';
-    expFile.write(line.toLatin1());
+    configuration += line.toLatin1();
     line = QString(REMOTE_TAG) + ' ' + dataMap[NM_OPENVPN_KEY_REMOTE] +
            (dataMap[NM_OPENVPN_KEY_PORT].isEmpty() ? "\n" : (' ' + dataMap[NM_OPENVPN_KEY_PORT]) + '\n');
-    expFile.write(line.toLatin1());
+    configuration += line.toLatin1();
     if (dataMap[NM_OPENVPN_KEY_CONNECTION_TYPE] == NM_OPENVPN_CONTYPE_TLS ||
             dataMap[NM_OPENVPN_KEY_CONNECTION_TYPE] == NM_OPENVPN_CONTYPE_PASSWORD ||
             dataMap[NM_OPENVPN_KEY_CONNECTION_TYPE] == NM_OPENVPN_CONTYPE_PASSWORD_TLS) {
@@ -750,20 +804,16 @@ bool OpenVpnUiPlugin::exportConnectionSettings(const NetworkManager::ConnectionS
     // Handle PKCS#12 (all certs are the same file)
     if (!cacert.isEmpty() && !user_cert.isEmpty() && !private_key.isEmpty()
                           && cacert == user_cert && cacert == private_key) {
-        line = QString("%1 \"%2\"\n").arg(PKCS12_TAG, cacert);
-        expFile.write(line.toLatin1());
+        configuration += fileDirective(PKCS12_TAG, cacert, QString(), archive);
     } else {
         if (!cacert.isEmpty()) {
-            line = QString("%1 \"%2\"\n").arg(CA_TAG, cacert);
-            expFile.write(line.toLatin1());
+            configuration += fileDirective(CA_TAG, cacert, QString(), archive);
         }
         if (!user_cert.isEmpty()) {
-            line = QString("%1 \"%2\"\n").arg(CERT_TAG, user_cert);
-            expFile.write(line.toLatin1());
+            configuration += fileDirective(CERT_TAG, user_cert, QString(), archive);
         }
         if (!private_key.isEmpty()) {
-            line = QString("%1 \"%2\"\n").arg(KEY_TAG, private_key);
-            expFile.write(line.toLatin1());
+            configuration += fileDirective(KEY_TAG, private_key, QString(), archive);
         }
     }
     if (dataMap[NM_OPENVPN_KEY_CONNECTION_TYPE] == NM_OPENVPN_CONTYPE_TLS ||
@@ -771,50 +821,46 @@ bool OpenVpnUiPlugin::exportConnectionSettings(const NetworkManager::ConnectionS
         dataMap[NM_OPENVPN_KEY_CONNECTION_TYPE] == NM_OPENVPN_CONTYPE_PASSWORD ||
         dataMap[NM_OPENVPN_KEY_CONNECTION_TYPE] == NM_OPENVPN_CONTYPE_PASSWORD_TLS) {
         line = QString(AUTH_USER_PASS_TAG) + '\n';
-        expFile.write(line.toLatin1());
+        configuration += line.toLatin1();
         if (!dataMap[NM_OPENVPN_KEY_TLS_REMOTE].isEmpty()) {
             line = QString(TLS_REMOTE_TAG) + " \"" + dataMap[NM_OPENVPN_KEY_TLS_REMOTE] + "\"\n";
-            expFile.write(line.toLatin1());
+            configuration += line.toLatin1();
         }
         if (!dataMap[NM_OPENVPN_KEY_TA].isEmpty()) {
-            line = QString(TLS_AUTH_TAG) + " \"" + dataMap[NM_OPENVPN_KEY_TA] + '\"' + (dataMap[NM_OPENVPN_KEY_TA_DIR].isEmpty() ?
-                                "\n" : (' ' + dataMap[NM_OPENVPN_KEY_TA_DIR]) + '\n');
-            expFile.write(line.toLatin1());
+            configuration += fileDirective(TLS_AUTH_TAG, dataMap[NM_OPENVPN_KEY_TA], dataMap[NM_OPENVPN_KEY_TA_DIR], archive);
         }
     }
     if (dataMap[NM_OPENVPN_KEY_CONNECTION_TYPE] == NM_OPENVPN_CONTYPE_STATIC_KEY) {
-        line = QString(SECRET_TAG) + " \"" + dataMap[NM_OPENVPN_KEY_STATIC_KEY] + '\"' + (dataMap[NM_OPENVPN_KEY_STATIC_KEY_DIRECTION].isEmpty() ?
-                          "\n" : (' ' + dataMap[NM_OPENVPN_KEY_STATIC_KEY_DIRECTION]) + '\n');
-        expFile.write(line.toLatin1());
+        configuration += fileDirective(SECRET_TAG, dataMap[NM_OPENVPN_KEY_STATIC_KEY], dataMap[NM_OPENVPN_KEY_STATIC_KEY_DIRECTION], archive);
     }
     if (dataMap.contains(NM_OPENVPN_KEY_RENEG_SECONDS) && !dataMap[NM_OPENVPN_KEY_RENEG_SECONDS].isEmpty()) {
         line = QString(RENEG_SEC_TAG) + ' ' + dataMap[NM_OPENVPN_KEY_RENEG_SECONDS] + '\n';
-        expFile.write(line.toLatin1());
+        configuration += line.toLatin1();
     }
     if (!dataMap[NM_OPENVPN_KEY_CIPHER].isEmpty()) {
         line = QString(CIPHER_TAG) + ' ' + dataMap[NM_OPENVPN_KEY_CIPHER] + '\n';
-        expFile.write(line.toLatin1());
+        configuration += line.toLatin1();
     }
     if (dataMap[NM_OPENVPN_KEY_COMP_LZO] == "yes") {
         line = QString(COMP_TAG) + " yes\n";
-        expFile.write(line.toLatin1());
+        configuration += line.toLatin1();
     }
     if (dataMap[NM_OPENVPN_KEY_MSSFIX] == "yes") {
         line = QString(MSSFIX_TAG) + '\n';
-        expFile.write(line.toLatin1());
+        configuration += line.toLatin1();
     }
     if (!dataMap[NM_OPENVPN_KEY_TUNNEL_MTU].isEmpty()) {
         line = QString(TUNMTU_TAG) + ' ' + dataMap[NM_OPENVPN_KEY_TUNNEL_MTU] + '\n';
-        expFile.write(line.toLatin1());
+        configuration += line.toLatin1();
     }
     if (!dataMap[NM_OPENVPN_KEY_FRAGMENT_SIZE].isEmpty()) {
         line = QString(FRAGMENT_TAG) + ' ' + dataMap[NM_OPENVPN_KEY_FRAGMENT_SIZE] + '\n';
-        expFile.write(line.toLatin1());
+        configuration += line.toLatin1();
     }
     line = QString(DEV_TAG) + (dataMap[NM_OPENVPN_KEY_TAP_DEV] == "yes" ? " tap\n" : " tun\n");
-    expFile.write(line.toLatin1());
+    configuration += line.toLatin1();
     line = QString(PROTO_TAG) + (dataMap[NM_OPENVPN_KEY_PROTO_TCP] == "yes" ? " tcp\n" : " udp\n");
-    expFile.write(line.toLatin1());
+    configuration += line.toLatin1();
     // Proxy stuff
     if (!dataMap[NM_OPENVPN_KEY_PROXY_TYPE].isEmpty()) {
         QString proxy_port = dataMap[NM_OPENVPN_KEY_PROXY_PORT];
@@ -824,31 +870,27 @@ bool OpenVpnUiPlugin::exportConnectionSettings(const NetworkManager::ConnectionS
                 proxy_port = "8080";
             }
             line = QString(HTTP_PROXY_TAG) + ' ' + dataMap[NM_OPENVPN_KEY_PROXY_SERVER] + ' ' + proxy_port +
-                    (dataMap[NM_OPENVPN_KEY_HTTP_PROXY_USERNAME].isEmpty() ? "\n" : (' ' + fileName + "-httpauthfile") + '\n');
-            expFile.write(line.toLatin1());
+                    (dataMap[NM_OPENVPN_KEY_HTTP_PROXY_USERNAME].isEmpty() ? "\n" : (' ' + httpAuthFileName) + '\n');
+            configuration += line.toLatin1();
             if (dataMap[NM_OPENVPN_KEY_PROXY_RETRY] == "yes") {
                 line = QString(HTTP_PROXY_RETRY_TAG) + '\n';
-                expFile.write(line.toLatin1());
+                configuration += line.toLatin1();
             }
-            // If there is a username, need to write an authfile
+            // If there is a username, the authfile is needed as well
             if (!dataMap[NM_OPENVPN_KEY_HTTP_PROXY_USERNAME].isEmpty()) {
-                QFile authFile(fileName + "-httpauthfile");
-                if (authFile.open(QFile::WriteOnly | QFile::Text)) {
-                    line = dataMap[NM_OPENVPN_KEY_HTTP_PROXY_USERNAME] + (dataMap[NM_OPENVPN_KEY_HTTP_PROXY_PASSWORD].isEmpty()?
-                                                                         "\n" : (dataMap[NM_OPENVPN_KEY_HTTP_PROXY_PASSWORD] + '\n'));
-                    authFile.write(line.toLatin1());
-                    authFile.close();
-                }
+                line = dataMap[NM_OPENVPN_KEY_HTTP_PROXY_USERNAME] + (dataMap[NM_OPENVPN_KEY_HTTP_PROXY_PASSWORD].isEmpty()?
+                                                                     "\n" : (dataMap[NM_OPENVPN_KEY_HTTP_PROXY_PASSWORD] + '\n'));
+                *httpAuth = line.toLatin1();
             }
         } else if (dataMap[NM_OPENVPN_KEY_PROXY_TYPE] == "socks" && !dataMap[NM_OPENVPN_KEY_PROXY_SERVER].isEmpty() && dataMap.contains(NM_OPENVPN_KEY_PROXY_PORT)) {
             if (proxy_port.toInt() == 0) {
                 proxy_port = "1080";
             }
             line = QString(SOCKS_PROXY_TAG) + dataMap[NM_OPENVPN_KEY_PROXY_SERVER] + ' ' + proxy_port + '\n';
-            expFile.write(line.toLatin1());
+            configuration += line.toLatin1();
             if (dataMap[NM_OPENVPN_KEY_PROXY_RETRY] == "yes") {
                 line = QString(SOCKS_PROXY_RETRY_TAG) + '\n';
-                expFile.write(line.toLatin1());
+                configuration += line.toLatin1();
             }
         }
     }
@@ -862,19 +904,18 @@ bool OpenVpnUiPlugin::exportConnectionSettings(const NetworkManager::ConnectionS
         }
         if (!routes.isEmpty()) {
             routes = "X-NM-Routes " + routes.trimmed();
-            expFile.write(routes.toLatin1() + '\n');
+            configuration += routes.toLatin1() + '\n';
         }
     }
     // Add hard-coded stuff
-    expFile.write("nobind\n"
-                  "auth-nocache\n"
-                  "script-security 2\n"
-                  "persist-key\n"
-                  "persist-tun\n"
-                  "user nobody\n"
-                  "group nobody\n");
-    expFile.close();
-    return true;
+    configuration += "nobind\n"
+                     "auth-nocache\n"
+                     "script-security 2\n"
+                     "persist-key\n"
+                     "persist-tun\n"
+                     "user nobody\n"
+                     "group nobody\n";
+    return configuration;
 }
 
 #include "openvpn.moc"
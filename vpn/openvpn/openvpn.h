@@ -24,6 +24,7 @@
 #ifndef PLASMANM_OPENVPN_H
 #define PLASMANM_OPENVPN_H
 
+#include "certificatestore.h"
 #include "vpnuiplugin.h"
 
 #include <QVariant>
@@ -42,10 +43,15 @@ public:
     QString supportedFileExtensions() const override;
     NMVariantMapMap importConnectionSettings(const QString &fileName) override;
     bool exportConnectionSettings(const NetworkManager::ConnectionSettings::Ptr &connection, const QString &fileName) override;
+    bool exportConnectionSettingsToArchive(const NetworkManager::ConnectionSettings::Ptr &connection, VpnExportArchive *archive) override;
 
 private:
-    QString saveFile(QTextStream &in, const QString &endTag, const QString &connectionName, const QString &fileName);
-    QString tryToCopyToCertificatesDirectory(const QString &connectionName, const QString &sourceFilePath);
+    QByteArray exportedConfiguration(const NetworkManager::ConnectionSettings::Ptr &connection, const QString &httpAuthFileName,
+                                     QByteArray *httpAuth, VpnExportArchive *archive) const;
+    QString saveFile(QTextStream &in, const QString &endTag, const QString &suffix);
+    QString tryToCopyToCertificatesDirectory(const QString &sourceFilePath);
+
+    CertificateStore m_certificateStore;
 };
 
 #endif //  PLASMANM_OPENVPN_H
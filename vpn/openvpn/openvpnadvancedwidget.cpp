@@ -27,14 +27,25 @@
 #include <QStandardPaths>
 #include <QUrl>
 #include <QComboBox>
+#include <QFile>
 
+#include <KConfig>
+#include <KConfigGroup>
 #include <KLocalizedString>
 #include <KProcess>
 #include <KAcceleratorManager>
 
+#include <sys/stat.h>
+
+// What "openvpn --show-ciphers" and "openvpn --version" print is cached per
+// binary and only asked for again when the binary changes
+#define OPENVPN_CACHE_FILE "plasma-nm-openvpn"
+
 class OpenVpnAdvancedWidget::Private {
 public:
     NetworkManager::VpnSetting::Ptr setting;
+    QString openVpnBinary;
+    QString openVpnBinaryStamp;
     KProcess *openvpnCipherProcess = nullptr;
     KProcess *openvpnVersionProcess = nullptr;
     QByteArray openvpnCiphers;
@@ -99,27 +110,6 @@ OpenVpnAdvancedWidget::OpenVpnAdvancedWidget(const NetworkManager::VpnSetting::P
         }
     });
 
-    // start openVPN process and get its cipher list
-    const QString openVpnBinary = QStandardPaths::findExecutable("openvpn", QStringList() << "/sbin" << "/usr/sbin");
-    const QStringList ciphersArgs(QLatin1String("--show-ciphers"));
-    const QStringList versionArgs(QLatin1String("--version"));
-
-    d->openvpnCipherProcess = new KProcess(this);
-    d->openvpnCipherProcess->setOutputChannelMode(KProcess::OnlyStdoutChannel);
-    d->openvpnCipherProcess->setReadChannel(QProcess::StandardOutput);
-    connect(d->openvpnCipherProcess, &KProcess::errorOccurred, this, &OpenVpnAdvancedWidget::openVpnCipherError);
-    connect(d->openvpnCipherProcess, &KProcess::readyReadStandardOutput, this, &OpenVpnAdvancedWidget::gotOpenVpnCipherOutput);
-    connect(d->openvpnCipherProcess, QOverload<int, QProcess::ExitStatus>::of(&KProcess::finished), this, &OpenVpnAdvancedWidget::openVpnCipherFinished);
-    d->openvpnCipherProcess->setProgram(openVpnBinary, ciphersArgs);
-
-    d->openvpnVersionProcess = new KProcess(this);
-    d->openvpnVersionProcess->setOutputChannelMode(KProcess::OnlyStdoutChannel);
-    d->openvpnVersionProcess->setReadChannel(QProcess::StandardOutput);
-    connect(d->openvpnVersionProcess, &KProcess::errorOccurred, this, &OpenVpnAdvancedWidget::openVpnVersionError);
-    connect(d->openvpnVersionProcess, &KProcess::readyReadStandardOutput, this, &OpenVpnAdvancedWidget::gotOpenVpnVersionOutput);
-    connect(d->openvpnVersionProcess, QOverload<int, QProcess::ExitStatus>::of(&KProcess::finished), this, &OpenVpnAdvancedWidget::openVpnVersionFinished);
-    d->openvpnVersionProcess->setProgram(openVpnBinary, versionArgs);
-
     connect(m_ui->buttonBox, &QDialogButtonBox::accepted, this, &OpenVpnAdvancedWidget::accept);
     connect(m_ui->buttonBox, &QDialogButtonBox::rejected, this, &OpenVpnAdvancedWidget::reject);
 
@@ -135,10 +125,78 @@ OpenVpnAdvancedWidget::~OpenVpnAdvancedWidget()
     delete d;
 }
 
+// Identifies the binary, the stamp changes whenever the binary is replaced or modified
+static QString openVpnBinaryStamp(const QString &binary)
+{
+    struct stat info;
+    if (binary.isEmpty() || ::stat(QFile::encodeName(binary).constData(), &info)) {
+        return QString();
+    }
+    return QStringLiteral("%1:%2:%3:%4").arg(info.st_dev).arg(info.st_ino).arg(info.st_size).arg(info.st_mtime);
+}
+
 void OpenVpnAdvancedWidget::init()
 {
-    d->openvpnCipherProcess->start();
-    d->openvpnVersionProcess->start();
+    d->openVpnBinary = QStandardPaths::findExecutable("openvpn", QStringList() << "/sbin" << "/usr/sbin");
+    d->openVpnBinaryStamp = openVpnBinaryStamp(d->openVpnBinary);
+
+    bool cachedCiphers = false;
+    bool cachedVersion = false;
+    if (!d->openVpnBinaryStamp.isEmpty()) {
+        KConfig config(QLatin1String(OPENVPN_CACHE_FILE), KConfig::SimpleConfig, QStandardPaths::GenericCacheLocation);
+        const KConfigGroup group(&config, d->openVpnBinary);
+        if (group.readEntry("Stamp", QString()) == d->openVpnBinaryStamp) {
+            cachedCiphers = group.hasKey("Ciphers");
+            cachedVersion = group.hasKey("Version");
+            if (cachedCiphers) {
+                setOpenVpnCiphers(group.readEntry("Ciphers", QStringList()));
+            }
+            if (cachedVersion) {
+                setOpenVpnVersion(group.readEntry("Version", QString()));
+            }
+        }
+    }
+
+    // start openVPN process and get its cipher list
+    if (!cachedCiphers) {
+        const QStringList ciphersArgs(QLatin1String("--show-ciphers"));
+        d->openvpnCipherProcess = new KProcess(this);
+        d->openvpnCipherProcess->setOutputChannelMode(KProcess::OnlyStdoutChannel);
+        d->openvpnCipherProcess->setReadChannel(QProcess::StandardOutput);
+        connect(d->openvpnCipherProcess, &KProcess::errorOccurred, this, &OpenVpnAdvancedWidget::openVpnCipherError);
+        connect(d->openvpnCipherProcess, &KProcess::readyReadStandardOutput, this, &OpenVpnAdvancedWidget::gotOpenVpnCipherOutput);
+        connect(d->openvpnCipherProcess, QOverload<int, QProcess::ExitStatus>::of(&KProcess::finished), this, &OpenVpnAdvancedWidget::openVpnCipherFinished);
+        d->openvpnCipherProcess->setProgram(d->openVpnBinary, ciphersArgs);
+        d->openvpnCipherProcess->start();
+    }
+
+    if (!cachedVersion) {
+        const QStringList versionArgs(QLatin1String("--version"));
+        d->openvpnVersionProcess = new KProcess(this);
+        d->openvpnVersionProcess->setOutputChannelMode(KProcess::OnlyStdoutChannel);
+        d->openvpnVersionProcess->setReadChannel(QProcess::StandardOutput);
+        connect(d->openvpnVersionProcess, &KProcess::errorOccurred, this, &OpenVpnAdvancedWidget::openVpnVersionError);
+        connect(d->openvpnVersionProcess, &KProcess::readyReadStandardOutput, this, &OpenVpnAdvancedWidget::gotOpenVpnVersionOutput);
+        connect(d->openvpnVersionProcess, QOverload<int, QProcess::ExitStatus>::of(&KProcess::finished), this, &OpenVpnAdvancedWidget::openVpnVersionFinished);
+        d->openvpnVersionProcess->setProgram(d->openVpnBinary, versionArgs);
+        d->openvpnVersionProcess->start();
+    }
+}
+
+void OpenVpnAdvancedWidget::cacheOpenVpnOutput(const QString &key, const QVariant &value)
+{
+    if (d->openVpnBinaryStamp.isEmpty()) {
+        return;
+    }
+
+    KConfig config(QLatin1String(OPENVPN_CACHE_FILE), KConfig::SimpleConfig, QStandardPaths::GenericCacheLocation);
+    KConfigGroup group(&config, d->openVpnBinary);
+    if (group.readEntry("Stamp", QString()) != d->openVpnBinaryStamp) {
+        // Drop what the previous binary printed
+        group.deleteGroup();
+        group.writeEntry("Stamp", d->openVpnBinaryStamp);
+    }
+    group.writeEntry(key, value);
 }
 
 void OpenVpnAdvancedWidget::gotOpenVpnCipherOutput()
@@ -154,30 +212,41 @@ void OpenVpnAdvancedWidget::openVpnCipherError(QProcess::ProcessError)
 
 void OpenVpnAdvancedWidget::openVpnCipherFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
-    m_ui->cboCipher->removeItem(0);
     if (!exitCode && exitStatus == QProcess::NormalExit) {
-        m_ui->cboCipher->addItem(i18nc("@item::inlist Default openvpn cipher item", "Default"));
+        QStringList ciphers;
         const QList<QByteArray> rawOutputLines = d->openvpnCiphers.split('\n');
         bool foundFirstSpace = false;
         for (const QByteArray &cipher : rawOutputLines) {
             if (cipher.length() == 0) {
                 foundFirstSpace = true;
             } else if (foundFirstSpace) {
-                m_ui->cboCipher->addItem(QString::fromLocal8Bit(cipher.left(cipher.indexOf(' '))));
+                ciphers << QString::fromLocal8Bit(cipher.left(cipher.indexOf(' ')));
             }
         }
-
-        if (m_ui->cboCipher->count()) {
-            m_ui->cboCipher->setEnabled(true);
-        } else {
-            m_ui->cboCipher->addItem(i18nc("@item:inlistbox Item added when OpenVPN cipher lookup failed", "No OpenVPN ciphers found"));
-        }
+        cacheOpenVpnOutput(QStringLiteral("Ciphers"), ciphers);
+        setOpenVpnCiphers(ciphers);
     } else {
+        m_ui->cboCipher->removeItem(0);
         m_ui->cboCipher->addItem(i18nc("@item:inlistbox Item added when OpenVPN cipher lookup failed", "OpenVPN cipher lookup failed"));
+        d->gotOpenVpnCiphers = true;
     }
-    delete d->openvpnCipherProcess;
+
+    d->openvpnCipherProcess->deleteLater();
     d->openvpnCipherProcess = nullptr;
     d->openvpnCiphers = QByteArray();
+}
+
+void OpenVpnAdvancedWidget::setOpenVpnCiphers(const QStringList &ciphers)
+{
+    m_ui->cboCipher->removeItem(0);
+    m_ui->cboCipher->addItem(i18nc("@item::inlist Default openvpn cipher item", "Default"));
+    m_ui->cboCipher->addItems(ciphers);
+
+    if (m_ui->cboCipher->count()) {
+        m_ui->cboCipher->setEnabled(true);
+    } else {
+        m_ui->cboCipher->addItem(i18nc("@item:inlistbox Item added when OpenVPN cipher lookup failed", "No OpenVPN ciphers found"));
+    }
     d->gotOpenVpnCiphers = true;
 
     if (d->readConfig) {
@@ -203,26 +272,35 @@ void OpenVpnAdvancedWidget::openVpnVersionFinished(int exitCode, QProcess::ExitS
 {
     // OpenVPN returns 1 when you use "--help" and unfortunately returns 1 even when some error occurs
     if (exitCode == 1 && exitStatus == QProcess::NormalExit) {
+        QString version;
         QStringList list = QString(d->openVpnVersion).split(QLatin1Char(' '));
         if (list.count() > 2) {
-            const QStringList versionList = list.at(1).split(QLatin1Char('.'));
-            if (versionList.count() == 3) {
-                d->versionX = versionList.at(0).toInt();
-                d->versionY = versionList.at(1).toInt();
-                d->versionZ = versionList.at(2).toInt();
-
-                if (compareVersion(2, 4, 0) >= 0) {
-                    disableLegacySubjectMatch();
-                }
-            }
+            version = list.at(1);
         }
+        cacheOpenVpnOutput(QStringLiteral("Version"), version);
+        setOpenVpnVersion(version);
     } else {
         disableLegacySubjectMatch();
+        setOpenVpnVersion(QString());
     }
 
-    delete d->openvpnVersionProcess;
+    d->openvpnVersionProcess->deleteLater();
     d->openvpnVersionProcess = nullptr;
     d->openVpnVersion = QByteArray();
+}
+
+void OpenVpnAdvancedWidget::setOpenVpnVersion(const QString &version)
+{
+    const QStringList versionList = version.split(QLatin1Char('.'));
+    if (versionList.count() == 3) {
+        d->versionX = versionList.at(0).toInt();
+        d->versionY = versionList.at(1).toInt();
+        d->versionZ = versionList.at(2).toInt();
+
+        if (compareVersion(2, 4, 0) >= 0) {
+            disableLegacySubjectMatch();
+        }
+    }
     d->gotOpenVpnVersion = true;
 
     if (d->readConfig) {
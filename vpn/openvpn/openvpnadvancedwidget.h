@@ -64,6 +64,9 @@ private Q_SLOTS:
 
 private:
     int compareVersion(const int x, const int y, const int z) const;
+    void cacheOpenVpnOutput(const QString &key, const QVariant &value);
+    void setOpenVpnCiphers(const QStringList &ciphers);
+    void setOpenVpnVersion(const QString &version);
     void disableLegacySubjectMatch();
     void loadConfig();
     void fillOnePasswordCombo(PasswordField *passwordField, NetworkManager::Setting::SecretFlags type);
@@ -0,0 +1,258 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ciscodecrypt.h"
+
+#include <QCryptographicHash>
+
+// Layout of the decoded entry: IV and key material, SHA-1 of the ciphertext, ciphertext
+#define CISCO_DECRYPT_SEED_SIZE 20
+#define CISCO_DECRYPT_HASH_SIZE 20
+#define CISCO_DECRYPT_HEADER_SIZE (CISCO_DECRYPT_SEED_SIZE + CISCO_DECRYPT_HASH_SIZE)
+#define CISCO_DECRYPT_BLOCK_SIZE 8
+
+namespace
+{
+
+// Tables of FIPS 46-3, bit positions counted from 1 at the most significant bit
+const quint8 initialPermutation[64] = {
+    58, 50, 42, 34, 26, 18, 10, 2, 60, 52, 44, 36, 28, 20, 12, 4,
+    62, 54, 46, 38, 30, 22, 14, 6, 64, 56, 48, 40, 32, 24, 16, 8,
+    57, 49, 41, 33, 25, 17, 9, 1, 59, 51, 43, 35, 27, 19, 11, 3,
+    61, 53, 45, 37, 29, 21, 13, 5, 63, 55, 47, 39, 31, 23, 15, 7
+};
+
+const quint8 finalPermutation[64] = {
+    40, 8, 48, 16, 56, 24, 64, 32, 39, 7, 47, 15, 55, 23, 63, 31,
+    38, 6, 46, 14, 54, 22, 62, 30, 37, 5, 45, 13, 53, 21, 61, 29,
+    36, 4, 44, 12, 52, 20, 60, 28, 35, 3, 43, 11, 51, 19, 59, 27,
+    34, 2, 42, 10, 50, 18, 58, 26, 33, 1, 41, 9, 49, 17, 57, 25
+};
+
+const quint8 expansion[48] = {
+    32, 1, 2, 3, 4, 5, 4, 5, 6, 7, 8, 9,
+    8, 9, 10, 11, 12, 13, 12, 13, 14, 15, 16, 17,
+    16, 17, 18, 19, 20, 21, 20, 21, 22, 23, 24, 25,
+    24, 25, 26, 27, 28, 29, 28, 29, 30, 31, 32, 1
+};
+
+const quint8 roundPermutation[32] = {
+    16, 7, 20, 21, 29, 12, 28, 17, 1, 15, 23, 26, 5, 18, 31, 10,
+    2, 8, 24, 14, 32, 27, 3, 9, 19, 13, 30, 6, 22, 11, 4, 25
+};
+
+const quint8 keyPermutation1[56] = {
+    57, 49, 41, 33, 25, 17, 9, 1, 58, 50, 42, 34, 26, 18,
+    10, 2, 59, 51, 43, 35, 27, 19, 11, 3, 60, 52, 44, 36,
+    63, 55, 47, 39, 31, 23, 15, 7, 62, 54, 46, 38, 30, 22,
+    14, 6, 61, 53, 45, 37, 29, 21, 13, 5, 28, 20, 12, 4
+};
+
+const quint8 keyPermutation2[48] = {
+    14, 17, 11, 24, 1, 5, 3, 28, 15, 6, 21, 10,
+    23, 19, 12, 4, 26, 8, 16, 7, 27, 20, 13, 2,
+    41, 52, 31, 37, 47, 55, 30, 40, 51, 45, 33, 48,
+    44, 49, 39, 56, 34, 53, 46, 42, 50, 36, 29, 32
+};
+
+const quint8 keyShifts[16] = {
+    1, 1, 2, 2, 2, 2, 2, 2, 1, 2, 2, 2, 2, 2, 2, 1
+};
+
+const quint8 substitution[8][64] = {
+    {14, 4, 13, 1, 2, 15, 11, 8, 3, 10, 6, 12, 5, 9, 0, 7,
+     0, 15, 7, 4, 14, 2, 13, 1, 10, 6, 12, 11, 9, 5, 3, 8,
+     4, 1, 14, 8, 13, 6, 2, 11, 15, 12, 9, 7, 3, 10, 5, 0,
+     15, 12, 8, 2, 4, 9, 1, 7, 5, 11, 3, 14, 10, 0, 6, 13},
+    {15, 1, 8, 14, 6, 11, 3, 4, 9, 7, 2, 13, 12, 0, 5, 10,
+     3, 13, 4, 7, 15, 2, 8, 14, 12, 0, 1, 10, 6, 9, 11, 5,
+     0, 14, 7, 11, 10, 4, 13, 1, 5, 8, 12, 6, 9, 3, 2, 15,
+     13, 8, 10, 1, 3, 15, 4, 2, 11, 6, 7, 12, 0, 5, 14, 9},
+    {10, 0, 9, 14, 6, 3, 15, 5, 1, 13, 12, 7, 11, 4, 2, 8,
+     13, 7, 0, 9, 3, 4, 6, 10, 2, 8, 5, 14, 12, 11, 15, 1,
+     13, 6, 4, 9, 8, 15, 3, 0, 11, 1, 2, 12, 5, 10, 14, 7,
+     1, 10, 13, 0, 6, 9, 8, 7, 4, 15, 14, 3, 11, 5, 2, 12},
+    {7, 13, 14, 3, 0, 6, 9, 10, 1, 2, 8, 5, 11, 12, 4, 15,
+     13, 8, 11, 5, 6, 15, 0, 3, 4, 7, 2, 12, 1, 10, 14, 9,
+     10, 6, 9, 0, 12, 11, 7, 13, 15, 1, 3, 14, 5, 2, 8, 4,
+     3, 15, 0, 6, 10, 1, 13, 8, 9, 4, 5, 11, 12, 7, 2, 14},
+    {2, 12, 4, 1, 7, 10, 11, 6, 8, 5, 3, 15, 13, 0, 14, 9,
+     14, 11, 2, 12, 4, 7, 13, 1, 5, 0, 15, 10, 3, 9, 8, 6,
+     4, 2, 1, 11, 10, 13, 7, 8, 15, 9, 12, 5, 6, 3, 0, 14,
+     11, 8, 12, 7, 1, 14, 2, 13, 6, 15, 0, 9, 10, 4, 5, 3},
+    {12, 1, 10, 15, 9, 2, 6, 8, 0, 13, 3, 4, 14, 7, 5, 11,
+     10, 15, 4, 2, 7, 12, 9, 5, 6, 1, 13, 14, 0, 11, 3, 8,
+     9, 14, 15, 5, 2, 8, 12, 3, 7, 0, 4, 10, 1, 13, 11, 6,
+     4, 3, 2, 12, 9, 5, 15, 10, 11, 14, 1, 7, 6, 0, 8, 13},
+    {4, 11, 2, 14, 15, 0, 8, 13, 3, 12, 9, 7, 5, 10, 6, 1,
+     13, 0, 11, 7, 4, 9, 1, 10, 14, 3, 5, 12, 2, 15, 8, 6,
+     1, 4, 11, 13, 12, 3, 7, 14, 10, 15, 6, 8, 0, 5, 9, 2,
+     6, 11, 13, 8, 1, 4, 10, 7, 9, 5, 0, 15, 14, 2, 3, 12},
+    {13, 2, 8, 4, 6, 15, 11, 1, 10, 9, 3, 14, 5, 0, 12, 7,
+     1, 15, 13, 8, 10, 3, 7, 4, 12, 5, 6, 11, 0, 14, 9, 2,
+     7, 11, 4, 1, 9, 12, 14, 2, 0, 6, 10, 13, 15, 3, 5, 8,
+     2, 1, 14, 7, 4, 10, 8, 13, 15, 12, 9, 0, 3, 5, 6, 11}
+};
+
+quint64 permute(quint64 in, const quint8 *table, int outBits, int inBits)
+{
+    quint64 out = 0;
+    for (int i = 0; i < outBits; ++i) {
+        out = (out << 1) | ((in >> (inBits - table[i])) & 1);
+    }
+    return out;
+}
+
+class Des
+{
+public:
+    explicit Des(const uchar *key)
+    {
+        quint64 cd = permute(readBlock(key), keyPermutation1, 56, 64);
+        quint32 c = quint32(cd >> 28) & 0x0fffffff;
+        quint32 d = quint32(cd) & 0x0fffffff;
+        for (int i = 0; i < 16; ++i) {
+            c = ((c << keyShifts[i]) | (c >> (28 - keyShifts[i]))) & 0x0fffffff;
+            d = ((d << keyShifts[i]) | (d >> (28 - keyShifts[i]))) & 0x0fffffff;
+            m_subkeys[i] = permute((quint64(c) << 28) | d, keyPermutation2, 48, 56);
+        }
+    }
+
+    quint64 encrypt(quint64 block) const
+    {
+        return crypt(block, false);
+    }
+
+    quint64 decrypt(quint64 block) const
+    {
+        return crypt(block, true);
+    }
+
+    static quint64 readBlock(const uchar *data)
+    {
+        quint64 block = 0;
+        for (int i = 0; i < CISCO_DECRYPT_BLOCK_SIZE; ++i) {
+            block = (block << 8) | data[i];
+        }
+        return block;
+    }
+
+    static void writeBlock(quint64 block, uchar *data)
+    {
+        for (int i = CISCO_DECRYPT_BLOCK_SIZE - 1; i >= 0; --i) {
+            data[i] = uchar(block);
+            block >>= 8;
+        }
+    }
+
+private:
+    static quint32 feistel(quint32 right, quint64 subkey)
+    {
+        const quint64 mixed = permute(right, expansion, 48, 32) ^ subkey;
+        quint32 out = 0;
+        for (int i = 0; i < 8; ++i) {
+            const int bits = int(mixed >> (42 - 6 * i)) & 0x3f;
+            // Outer bits select the row, inner ones the column
+            const int row = ((bits >> 4) & 0x2) | (bits & 0x1);
+            const int column = (bits >> 1) & 0xf;
+            out = (out << 4) | substitution[i][row * 16 + column];
+        }
+        return quint32(permute(out, roundPermutation, 32, 32));
+    }
+
+    quint64 crypt(quint64 block, bool decrypt) const
+    {
+        block = permute(block, initialPermutation, 64, 64);
+        quint32 left = quint32(block >> 32);
+        quint32 right = quint32(block);
+        for (int i = 0; i < 16; ++i) {
+            const quint32 next = left ^ feistel(right, m_subkeys[decrypt ? 15 - i : i]);
+            left = right;
+            right = next;
+        }
+        return permute((quint64(right) << 32) | left, finalPermutation, 64, 64);
+    }
+
+    quint64 m_subkeys[16];
+};
+
+}
+
+QString CiscoDecrypt::decrypt(const QString &encrypted, bool *ok)
+{
+    if (ok) {
+        *ok = false;
+    }
+
+    // QByteArray::fromHex() skips invalid characters, the entry must not have any
+    const QByteArray hex = encrypted.trimmed().toLatin1();
+    if (hex.size() % 2) {
+        return QString();
+    }
+    const QByteArray data = QByteArray::fromHex(hex);
+    if (data.toHex() != hex.toLower()) {
+        return QString();
+    }
+    const int length = data.size() - CISCO_DECRYPT_HEADER_SIZE;
+    if (length < CISCO_DECRYPT_BLOCK_SIZE || length % CISCO_DECRYPT_BLOCK_SIZE) {
+        return QString();
+    }
+
+    const QByteArray seed = data.left(CISCO_DECRYPT_SEED_SIZE);
+    const QByteArray ciphertext = data.mid(CISCO_DECRYPT_HEADER_SIZE);
+    if (QCryptographicHash::hash(ciphertext, QCryptographicHash::Sha1) != data.mid(CISCO_DECRYPT_SEED_SIZE, CISCO_DECRYPT_HASH_SIZE)) {
+        return QString();
+    }
+
+    // The 3DES key is the SHA-1 of the seed with its last byte incremented by one,
+    // followed by the start of the SHA-1 of it incremented by three
+    QByteArray tweaked = seed;
+    tweaked[CISCO_DECRYPT_SEED_SIZE - 1] = char(seed.at(CISCO_DECRYPT_SEED_SIZE - 1) + 1);
+    QByteArray key = QCryptographicHash::hash(tweaked, QCryptographicHash::Sha1);
+    tweaked[CISCO_DECRYPT_SEED_SIZE - 1] = char(seed.at(CISCO_DECRYPT_SEED_SIZE - 1) + 3);
+    key += QCryptographicHash::hash(tweaked, QCryptographicHash::Sha1).left(3 * CISCO_DECRYPT_BLOCK_SIZE - key.size());
+
+    const uchar *keyData = reinterpret_cast<const uchar *>(key.constData());
+    const Des des1(keyData);
+    const Des des2(keyData + CISCO_DECRYPT_BLOCK_SIZE);
+    const Des des3(keyData + 2 * CISCO_DECRYPT_BLOCK_SIZE);
+
+    QByteArray plaintext(length, Qt::Uninitialized);
+    const uchar *in = reinterpret_cast<const uchar *>(ciphertext.constData());
+    uchar *out = reinterpret_cast<uchar *>(plaintext.data());
+    // The IV is the start of the seed
+    quint64 previous = Des::readBlock(reinterpret_cast<const uchar *>(seed.constData()));
+    for (int i = 0; i < length; i += CISCO_DECRYPT_BLOCK_SIZE) {
+        const quint64 block = Des::readBlock(in + i);
+        Des::writeBlock(des1.decrypt(des2.encrypt(des3.decrypt(block))) ^ previous, out + i);
+        previous = block;
+    }
+
+    const int padding = uchar(plaintext.at(length - 1));
+    if (padding < 1 || padding > CISCO_DECRYPT_BLOCK_SIZE) {
+        return QString();
+    }
+    plaintext.truncate(length - padding);
+
+    if (ok) {
+        *ok = true;
+    }
+    return QString::fromUtf8(plaintext);
+}
@@ -0,0 +1,42 @@
+/*
+Copyright 2020 Plasma-nm Developers
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PLASMA_NM_CISCO_DECRYPT_H
+#define PLASMA_NM_CISCO_DECRYPT_H
+
+#include <QString>
+
+/**
+ * Decodes the obfuscated passwords of Cisco VPN client profiles, the
+ * enc_GroupPwd and enc_UserPassword entries of .pcf files, the way the
+ * cisco-decrypt tool of vpnc does: 3DES in CBC mode with a key derived
+ * from the first 20 bytes, checked against the SHA-1 of the ciphertext.
+ */
+class CiscoDecrypt
+{
+public:
+    /**
+     * @p encrypted the hexadecimal value of the entry
+     * @p ok set to false when it isn't a valid obfuscated password
+     */
+    static QString decrypt(const QString &encrypted, bool *ok = nullptr);
+};
+
+#endif // PLASMA_NM_CISCO_DECRYPT_H
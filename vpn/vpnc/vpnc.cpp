@@ -23,10 +23,12 @@
 
 #include "debug.h"
 #include "vpnc.h"
+#include "ciscodecrypt.h"
 
-#include <QStandardPaths>
+#include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QTemporaryDir>
 
 #include <KPluginFactory>
 #include <KSharedConfig>
@@ -42,11 +44,10 @@
 
 #include "vpncwidget.h"
 #include "vpncauth.h"
+#include "vpnexportarchive.h"
 
 VpncUiPluginPrivate::VpncUiPluginPrivate()
 {
-    decryptedPasswd.clear();
-    ciscoDecrypt = nullptr;
 }
 
 VpncUiPluginPrivate::~VpncUiPluginPrivate()
@@ -64,34 +65,6 @@ QString VpncUiPluginPrivate::readStringKeyValue(const KConfigGroup & configGroup
     }
 }
 
-void VpncUiPluginPrivate::gotCiscoDecryptOutput()
-{
-    QByteArray output = ciscoDecrypt->readAll();
-    if (!output.isEmpty()) {
-        QList<QByteArray> lines = output.split('\n');
-        if (!lines.isEmpty()) {
-            decryptedPasswd = QString::fromUtf8(lines.first());
-        }
-    }
-}
-
-void VpncUiPluginPrivate::ciscoDecryptFinished(int exitCode, QProcess::ExitStatus exitStatus)
-{
-    if (exitCode || exitStatus != QProcess::NormalExit) {
-        decryptedPasswd.clear();
-    }
-}
-
-void VpncUiPluginPrivate::ciscoDecryptError(QProcess::ProcessError pError)
-{
-    if (!pError) {
-        qCWarning(PLASMA_NM) << "Error in executing cisco-decrypt";
-        KMessageBox::error(nullptr, i18n("Error decrypting the obfuscated password"), i18n("Error"), KMessageBox::Notify);
-    }
-    decryptedPasswd.clear();
-}
-
-
 #define NM_VPNC_LOCAL_PORT_DEFAULT 500
 
 K_PLUGIN_CLASS_WITH_JSON(VpncUiPlugin, "plasmanetworkmanagement_vpncui.json")
@@ -150,20 +123,7 @@ NMVariantMapMap VpncUiPlugin::importConnectionSettings(const QString &fileName)
 
     KConfigGroup cg(config, "main");   // Keys&Values are stored under [main]
     if (cg.exists()) {
-        // Setup cisco-decrypt binary to decrypt the passwords
-        const QString ciscoDecryptBinary = QStandardPaths::findExecutable("cisco-decrypt");
-        if (ciscoDecryptBinary.isEmpty()) {
-            mErrorMessage = i18n("Needed executable cisco-decrypt could not be found.");
-            return result;
-        }
-
         decrPlugin = new VpncUiPluginPrivate();
-        decrPlugin->ciscoDecrypt = new KProcess(decrPlugin);
-        decrPlugin->ciscoDecrypt->setOutputChannelMode(KProcess::OnlyStdoutChannel);
-        decrPlugin->ciscoDecrypt->setReadChannel(QProcess::StandardOutput);
-        connect(decrPlugin->ciscoDecrypt, &KProcess::errorOccurred, decrPlugin, &VpncUiPluginPrivate::ciscoDecryptError);
-        connect(decrPlugin->ciscoDecrypt, QOverload<int, QProcess::ExitStatus>::of(&KProcess::finished), decrPlugin, &VpncUiPluginPrivate::ciscoDecryptFinished);
-        connect(decrPlugin->ciscoDecrypt, &KProcess::readyReadStandardOutput, decrPlugin, &VpncUiPluginPrivate::gotCiscoDecryptOutput);
 
         NMStringMap data;
         NMStringMap secretData;
@@ -176,14 +136,14 @@ NMVariantMapMap VpncUiPlugin::importConnectionSettings(const QString &fileName)
         // user password
         if (!decrPlugin->readStringKeyValue(cg,"UserPassword").isEmpty()) {
             secretData.insert(NM_VPNC_KEY_XAUTH_PASSWORD, decrPlugin->readStringKeyValue(cg,"UserPassword"));
-        } else if (!decrPlugin->readStringKeyValue(cg,"enc_UserPassword").isEmpty() && !ciscoDecryptBinary.isEmpty()) {
+        } else if (!decrPlugin->readStringKeyValue(cg,"enc_UserPassword").isEmpty()) {
             // Decrypt the password and insert into map
-            decrPlugin->ciscoDecrypt->setProgram(ciscoDecryptBinary);
-            decrPlugin->ciscoDecrypt->start();
-            decrPlugin->ciscoDecrypt->waitForStarted();
-            decrPlugin->ciscoDecrypt->write(decrPlugin->readStringKeyValue(cg,"enc_UserPassword").toUtf8());
-            if (decrPlugin->ciscoDecrypt->waitForFinished()) {
-                secretData.insert(NM_VPNC_KEY_XAUTH_PASSWORD, decrPlugin->decryptedPasswd);
+            bool ok;
+            const QString password = CiscoDecrypt::decrypt(decrPlugin->readStringKeyValue(cg,"enc_UserPassword"), &ok);
+            if (ok) {
+                secretData.insert(NM_VPNC_KEY_XAUTH_PASSWORD, password);
+            } else {
+                qCWarning(PLASMA_NM) << "Failed to decrypt the obfuscated user password of" << fileName;
             }
         }
         // Save user password
@@ -203,15 +163,15 @@ NMVariantMapMap VpncUiPlugin::importConnectionSettings(const QString &fileName)
         if (!decrPlugin->readStringKeyValue(cg,"GroupPwd").isEmpty()) {
             secretData.insert(NM_VPNC_KEY_SECRET, decrPlugin->readStringKeyValue(cg,"GroupPwd"));
             data.insert(NM_VPNC_KEY_SECRET"-flags", QString::number(NetworkManager::Setting::AgentOwned));
-        } else if (!decrPlugin->readStringKeyValue(cg,"enc_GroupPwd").isEmpty() && !ciscoDecryptBinary.isEmpty()) {
+        } else if (!decrPlugin->readStringKeyValue(cg,"enc_GroupPwd").isEmpty()) {
             //Decrypt the password and insert into map
-            decrPlugin->ciscoDecrypt->setProgram(ciscoDecryptBinary);
-            decrPlugin->ciscoDecrypt->start();
-            decrPlugin->ciscoDecrypt->waitForStarted();
-            decrPlugin->ciscoDecrypt->write(decrPlugin->readStringKeyValue(cg,"enc_GroupPwd").toUtf8());
-            if (decrPlugin->ciscoDecrypt->waitForFinished()) {
-                secretData.insert(NM_VPNC_KEY_SECRET, decrPlugin->decryptedPasswd);
+            bool ok;
+            const QString password = CiscoDecrypt::decrypt(decrPlugin->readStringKeyValue(cg,"enc_GroupPwd"), &ok);
+            if (ok) {
+                secretData.insert(NM_VPNC_KEY_SECRET, password);
                 data.insert(NM_VPNC_KEY_SECRET"-flags", QString::number(NetworkManager::Setting::AgentOwned));
+            } else {
+                qCWarning(PLASMA_NM) << "Failed to decrypt the obfuscated group password of" << fileName;
             }
         }
 
@@ -263,6 +223,15 @@ NMVariantMapMap VpncUiPlugin::importConnectionSettings(const QString &fileName)
         }
         // DH Group
         data.insert(NM_VPNC_KEY_DHGROUP, decrPlugin->readStringKeyValue(cg,"DHGroup"));
+        // CA certificate, relative paths are those of exported archives
+        if (!decrPlugin->readStringKeyValue(cg,"CertPath").isEmpty()) {
+            const QFileInfo certInfo(QFileInfo(fileName).dir(), decrPlugin->readStringKeyValue(cg,"CertPath"));
+            if (certInfo.isFile()) {
+                data.insert(NM_VPNC_KEY_CA_FILE, certInfo.absoluteFilePath());
+            } else {
+                qCWarning(PLASMA_NM) << "CA certificate" << certInfo.filePath() << "of" << fileName << "not found";
+            }
+        }
         // Tunneling Mode - not supported by vpnc
         if (cg.readEntry("TunnelingMode").toInt() == 1) {
             KMessageBox::error(nullptr, i18n("The VPN settings file '%1' specifies that VPN traffic should be tunneled through TCP which is currently not supported in the vpnc software.\n\nThe connection can still be created, with TCP tunneling disabled, however it may not work as expected.", fileName), i18n("Not supported"), KMessageBox::Notify);
@@ -323,7 +292,9 @@ NMVariantMapMap VpncUiPlugin::importConnectionSettings(const QString &fileName)
     return result;
 }
 
-bool VpncUiPlugin::exportConnectionSettings(const NetworkManager::ConnectionSettings::Ptr &connection, const QString &fileName)
+// Writes the [main] group of the exported .pcf file. When exporting into an
+// archive the CA certificate is added to it as well
+static void writeEntries(KConfigGroup &cg, const NetworkManager::ConnectionSettings::Ptr &connection, VpnExportArchive *archive)
 {
     NMStringMap data;
     NMStringMap secretData;
@@ -332,13 +303,6 @@ bool VpncUiPlugin::exportConnectionSettings(const NetworkManager::ConnectionSett
     data = vpnSetting->data();
     secretData = vpnSetting->secrets();
 
-    KSharedConfig::Ptr config = KSharedConfig::openConfig(fileName);
-    if (!config) {
-        mErrorMessage = i18n("%1: file could not be created", fileName);
-        return false;
-    }
-    KConfigGroup cg(config,"main");
-
     cg.writeEntry("Description", connection->id());
     cg.writeEntry("Host", data.value(NM_VPNC_KEY_GATEWAY));
     if (data.value(NM_VPNC_KEY_AUTHMODE) == QLatin1String("hybrid")) {
@@ -369,7 +333,11 @@ bool VpncUiPlugin::exportConnectionSettings(const NetworkManager::ConnectionSett
     cg.writeEntry("BackupServer", "");
     cg.writeEntry("CertStore", "0");
     cg.writeEntry("CertName", "");
-    cg.writeEntry("CertPath", "");
+    if (archive && !data.value(NM_VPNC_KEY_CA_FILE).isEmpty()) {
+        cg.writeEntry("CertPath", archive->addSharedFile(data.value(NM_VPNC_KEY_CA_FILE)));
+    } else {
+        cg.writeEntry("CertPath", "");
+    }
     cg.writeEntry("CertSubjectName", "");
     cg.writeEntry("CertSerialHash", "");
     cg.writeEntry("DHGroup", data.value(NM_VPNC_KEY_DHGROUP));
@@ -408,11 +376,61 @@ bool VpncUiPlugin::exportConnectionSettings(const NetworkManager::ConnectionSett
         }
         cg.writeEntry("X-NM-Routes", routes.trimmed());
     }
+}
+
+bool VpncUiPlugin::exportConnectionSettings(const NetworkManager::ConnectionSettings::Ptr &connection, const QString &fileName)
+{
+    KSharedConfig::Ptr config = KSharedConfig::openConfig(fileName);
+    if (!config) {
+        mErrorMessage = i18n("%1: file could not be created", fileName);
+        return false;
+    }
+    KConfigGroup cg(config,"main");
 
+    writeEntries(cg, connection, nullptr);
     cg.sync();
 
     mError = VpncUiPlugin::NoError;
     return true;
 }
 
+bool VpncUiPlugin::exportConnectionSettingsToArchive(const NetworkManager::ConnectionSettings::Ptr &connection, VpnExportArchive *archive)
+{
+    // Written by KConfig like a single exported file, into a private directory as it contains secrets
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        mError = VpncUiPlugin::Error;
+        mErrorMessage = i18n("Could not create a temporary directory");
+        return false;
+    }
+
+    const QString fileName = dir.filePath(QStringLiteral("export.pcf"));
+    {
+        KConfig config(fileName, KConfig::SimpleConfig);
+        KConfigGroup cg(&config, "main");
+        writeEntries(cg, connection, archive);
+        if (!config.sync()) {
+            mError = VpncUiPlugin::Error;
+            mErrorMessage = i18n("%1: file could not be created", fileName);
+            return false;
+        }
+    }
+
+    QFile pcf(fileName);
+    if (!pcf.open(QIODevice::ReadOnly)) {
+        mError = VpncUiPlugin::Error;
+        mErrorMessage = pcf.errorString();
+        return false;
+    }
+
+    if (!archive->writeFile(archive->reserveFileName(suggestedFileName(connection)), pcf.readAll())) {
+        mError = VpncUiPlugin::Error;
+        mErrorMessage = archive->errorString();
+        return false;
+    }
+
+    mError = VpncUiPlugin::NoError;
+    return true;
+}
+
 #include "vpnc.moc"
@@ -28,7 +28,6 @@
 
 #include <QVariant>
 
-#include <KProcess>
 #include <KConfigGroup>
 
 class VpncUiPluginPrivate: public QObject
@@ -38,13 +37,6 @@ public:
     VpncUiPluginPrivate();
     ~VpncUiPluginPrivate() override;
     QString readStringKeyValue(const KConfigGroup & configGroup, const QString & key);
-    KProcess * ciscoDecrypt;
-    QString decryptedPasswd;
-
-public Q_SLOTS:
-    void gotCiscoDecryptOutput();
-    void ciscoDecryptError(QProcess::ProcessError pError);
-    void ciscoDecryptFinished(int exitCode, QProcess::ExitStatus exitStatus);
 };
 
 class Q_DECL_EXPORT VpncUiPlugin : public VpnUiPlugin
@@ -61,6 +53,7 @@ public:
     QString supportedFileExtensions() const override;
     NMVariantMapMap importConnectionSettings(const QString &fileName) override;
     bool exportConnectionSettings(const NetworkManager::ConnectionSettings::Ptr &connection, const QString &fileName) override;
+    bool exportConnectionSettingsToArchive(const NetworkManager::ConnectionSettings::Ptr &connection, VpnExportArchive *archive) override;
 };
 
 #endif // PLASMA_NM_VPNC_H